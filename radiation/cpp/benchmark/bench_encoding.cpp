@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Benchmarks for trajectory encoding and decoding.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <encoding.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <movement_2d.h>
+
+#include <benchmark/benchmark.h>
+#include <glog/logging.h>
+#include <random>
+#include <vector>
+
+namespace radiation {
+
+namespace {
+const unsigned int kSeed = 0;
+const unsigned int kGridSize = 100;
+const unsigned int kNumTrajectories = 256;
+
+// Generate random legal trajectories from the center of a large grid, along
+// with their 64-bit ids.
+void RandomTrajectories(const Context2D& context, unsigned int num_steps,
+                        std::vector< std::vector<Movement2D> >& movements,
+                        std::vector<Id64>& ids) {
+  std::default_random_engine rng(kSeed);
+  const GridPose2D initial_pose(context, 0.5 * kGridSize, 0.5 * kGridSize,
+                                0.0);
+
+  movements.clear();
+  ids.clear();
+  while (movements.size() < kNumTrajectories) {
+    GridPose2D pose = initial_pose;
+    std::vector<Movement2D> trajectory;
+    while (trajectory.size() < num_steps) {
+      const Movement2D step(context, rng);
+      if (pose.MoveBy(step))
+        trajectory.push_back(step);
+    }
+
+    Id64 id = 0;
+    CHECK(EncodeTrajectory(trajectory, context, id));
+    movements.push_back(trajectory);
+    ids.push_back(id);
+  }
+}
+} // namespace
+
+// Encode trajectories. Argument: number of steps.
+void BM_EncodeTrajectory(benchmark::State& state) {
+  const unsigned int num_steps = state.range(0);
+  const Context2D context(kGridSize, kGridSize);
+  std::vector< std::vector<Movement2D> > movements;
+  std::vector<Id64> ids;
+  RandomTrajectories(context, num_steps, movements, ids);
+
+  for (auto _ : state) {
+    for (const auto& trajectory : movements) {
+      Id64 id = 0;
+      EncodeTrajectory(trajectory, context, id);
+      benchmark::DoNotOptimize(id);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumTrajectories);
+}
+BENCHMARK(BM_EncodeTrajectory)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(12);
+
+// Decode trajectories. Argument: number of steps.
+void BM_DecodeTrajectory(benchmark::State& state) {
+  const unsigned int num_steps = state.range(0);
+  const Context2D context(kGridSize, kGridSize);
+  std::vector< std::vector<Movement2D> > movements;
+  std::vector<Id64> ids;
+  RandomTrajectories(context, num_steps, movements, ids);
+
+  const GridPose2D initial_pose(context, 0.5 * kGridSize, 0.5 * kGridSize,
+                                0.0);
+  std::vector<GridPose2D> trajectory;
+  for (auto _ : state) {
+    for (const auto& id : ids) {
+      DecodeTrajectory(id, num_steps, initial_pose, trajectory);
+      benchmark::DoNotOptimize(trajectory.data());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumTrajectories);
+}
+BENCHMARK(BM_DecodeTrajectory)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(12);
+
+} // namespace radiation
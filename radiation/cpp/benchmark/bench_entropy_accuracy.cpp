@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Accuracy versus throughput of conditional entropy estimators. On grids
+// small enough to enumerate every legal trajectory and every placement of
+// sources, the exact [h_{Z|X}] is computed once per configuration, and each
+// estimator is timed and scored against it as a function of sample count.
+// Besides time, every run reports these counters, averaged over iterations:
+//   coverage          fraction of legal trajectories that were sampled
+//   mean_abs_error    mean |estimate - truth| over sampled trajectories
+//   bias              mean (estimate - truth) over sampled trajectories
+//   argmax_agreement  fraction of runs whose pick is a true arg max
+//   regret            true max entropy minus true entropy of the pick
+// To get curves, run e.g.
+//   run_benchmarks --benchmark_filter=EntropyAccuracy
+//                  --benchmark_out=accuracy.csv --benchmark_out_format=csv
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <grid_map_2d.h>
+#include <conditional_generator.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <movement_2d.h>
+#include <radix_codec.h>
+#include <entropy_estimators.h>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <glog/logging.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+const unsigned int kSeed = 0;
+const double kFov = 0.5 * M_PI;
+const double kRegularizer = 1.0;
+const unsigned int kNumMeasurements = 3;
+
+// Configurations small enough to enumerate. Benchmarks take an index into
+// this table.
+struct Configuration {
+  unsigned int grid_size;
+  unsigned int num_sources;
+  unsigned int num_steps;
+};
+
+const Configuration kConfigurations[] = {
+  { 4, 1, 2 },
+  { 5, 2, 2 },
+  { 5, 2, 3 }
+};
+
+// Exact conditional entropies of every legal trajectory, in increasing id
+// order, and the largest of them.
+struct GroundTruth {
+  std::vector<Id64> trajectory_ids;
+  std::vector<double> hzx;
+  double max_hzx;
+};
+
+// A map with a non-uniform belief from a fixed set of measurements, and the
+// pose to plan from. The context must outlive the map.
+void MakeScene(const Context2D& context, unsigned int num_sources,
+               GridMap2D& map, GridPose2D& pose) {
+  std::default_random_engine rng(kSeed);
+  std::uniform_int_distribution<unsigned int>
+    unif(0, context.GetNumRows() - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  std::vector<Source2D> sources;
+  for (unsigned int ii = 0; ii < num_sources; ii++)
+    sources.push_back(Source2D(unif(rng), unif(rng)));
+
+  for (unsigned int ii = 0; ii < kNumMeasurements; ii++) {
+    const Sensor2D sensor(GridPose2D(context, unif(rng), unif(rng),
+                                     unif_angle(rng)), kFov);
+    map.Update(sensor, sources, ii + 1 == kNumMeasurements);
+  }
+
+  map.Seed(kSeed);
+  pose = GridPose2D(context, 0.5 * context.GetNumRows(),
+                    0.5 * context.GetNumCols(), 0.0);
+}
+
+// Compute [h_{Z|X}] exactly. Sources are drawn independently from the
+// normalized belief, as in GridMap2D::GenerateSources(), and each visible
+// source adds one to the measurement, so P(Z | X) is a sum over all ordered
+// tuples of source locations.
+void ComputeGroundTruth(GridMap2D& map, unsigned int num_steps,
+                        const GridPose2D& pose, GroundTruth& truth) {
+  const Context2D& context = map.GetContext();
+  const unsigned int num_rows = context.GetNumRows();
+  const unsigned int num_cells = num_rows * context.GetNumCols();
+  const unsigned int num_sources = map.GetNumSources();
+  const Eigen::MatrixXd& belief = map.GetImmutableBelief();
+  const double total_belief = belief.sum();
+
+  const unsigned int num_movements = TrajectoryBase(context);
+  const unsigned int num_xy =
+    context.GetNumDeltaXs() * context.GetNumDeltaYs();
+  const RadixCodec<Id64> trajectory_codec(num_movements, num_steps);
+  const RadixCodec<unsigned int> measurement_codec(num_sources + 1, num_steps);
+  const unsigned int num_measurements =
+    pow(num_sources + 1, num_steps);
+
+  Id64 num_trajectories = 1;
+  for (unsigned int ii = 0; ii < num_steps; ii++)
+    num_trajectories *= num_movements;
+
+  truth.trajectory_ids.clear();
+  truth.hzx.clear();
+  truth.max_hzx = 0.0;
+
+  std::vector<unsigned int> digits(num_steps);
+  std::vector<unsigned char> visible(num_steps * num_cells);
+  std::vector<unsigned int> cells(num_sources);
+  std::vector<unsigned int> measurements(num_steps);
+  std::vector<double> pz(num_measurements);
+  std::vector<Source2D> source(1, Source2D(0u, 0u));
+  for (Id64 id = 0; id < num_trajectories; id++) {
+    trajectory_codec.Decode(id, digits.data());
+
+    // Skip trajectories that leave the grid, and record which cells are
+    // visible from each pose of the rest.
+    GridPose2D current_pose = pose;
+    bool legal = true;
+    for (unsigned int ss = 0; ss < num_steps && legal; ss++) {
+      const unsigned int digit = digits[ss];
+      const Movement2D step(context, digit % context.GetNumDeltaXs(),
+                            (digit / context.GetNumDeltaXs()) %
+                            context.GetNumDeltaYs(),
+                            digit / num_xy);
+      legal = current_pose.MoveBy(step);
+
+      const Sensor2D sensor(current_pose, kFov);
+      for (unsigned int cc = 0; cc < num_cells && legal; cc++) {
+        source[0] = Source2D(cc % num_rows, cc / num_rows);
+        visible[ss * num_cells + cc] = map.Sense(sensor, source);
+      }
+    }
+
+    if (!legal)
+      continue;
+
+    // Sum over all tuples of source locations, odometer style.
+    std::fill(pz.begin(), pz.end(), 0.0);
+    std::fill(cells.begin(), cells.end(), 0);
+    while (true) {
+      double probability = 1.0;
+      std::fill(measurements.begin(), measurements.end(), 0);
+      for (unsigned int kk = 0; kk < num_sources; kk++) {
+        probability *= belief.data()[cells[kk]] / total_belief;
+        for (unsigned int ss = 0; ss < num_steps; ss++)
+          measurements[ss] += visible[ss * num_cells + cells[kk]];
+      }
+
+      pz[measurement_codec.Encode(measurements.data())] += probability;
+
+      unsigned int kk = 0;
+      while (kk < num_sources && ++cells[kk] == num_cells)
+        cells[kk++] = 0;
+      if (kk == num_sources)
+        break;
+    }
+
+    double entropy = 0.0;
+    for (const auto& p : pz) {
+      if (p > 0.0)
+        entropy -= p * log(p);
+    }
+
+    truth.trajectory_ids.push_back(id);
+    truth.hzx.push_back(entropy);
+    truth.max_hzx = std::max(truth.max_hzx, entropy);
+  }
+}
+
+// Ground truth for each configuration, computed on first use.
+const GroundTruth& GetGroundTruth(unsigned int index) {
+  static std::map<unsigned int, GroundTruth> truths;
+  if (truths.count(index) == 0) {
+    const Configuration& config = kConfigurations[index];
+    const Context2D context(config.grid_size, config.grid_size);
+    GridMap2D map(context, config.num_sources, kRegularizer);
+    GridPose2D pose(context, 0.0, 0.0, 0.0);
+    MakeScene(context, config.num_sources, map, pose);
+    ComputeGroundTruth(map, config.num_steps, pose, truths[index]);
+  }
+
+  return truths[index];
+}
+
+// An estimator of [h_{Z|X}], with the same arguments as
+// GridMap2D::GenerateEntropyVector() plus a seed that changes every call.
+typedef void (*Estimator)(GridMap2D& map, unsigned int num_samples,
+                          unsigned int num_steps, const GridPose2D& pose,
+                          double sensor_fov, unsigned int seed,
+                          Eigen::VectorXd& hzx,
+                          std::vector<Id64>& trajectory_ids);
+
+// The sampler used for planning, with each entropy estimator. The map's
+// generator is seeded first, so every estimator sees the same samples on
+// the same iteration.
+template <EntropyEstimator kEstimator>
+void EstimateSampled(GridMap2D& map, unsigned int num_samples,
+                     unsigned int num_steps, const GridPose2D& pose,
+                     double sensor_fov, unsigned int seed,
+                     Eigen::VectorXd& hzx, std::vector<Id64>& trajectory_ids) {
+  map.Seed(seed);
+  map.GenerateEntropyVector(num_samples, num_steps, pose, sensor_fov,
+                            hzx, trajectory_ids, kEstimator);
+}
+
+// Plug-in entropies of the columns of [P_{Z|X}] from the conditional
+// generator, on one thread. Times include computing [h_{M|Z}].
+void EstimateConditionals(GridMap2D& map, unsigned int num_samples,
+                          unsigned int num_steps, const GridPose2D& pose,
+                          double sensor_fov, unsigned int seed,
+                          Eigen::VectorXd& hzx,
+                          std::vector<Id64>& trajectory_ids) {
+  Conditionals conditionals;
+  GenerateConditionals(map, num_samples, num_steps, pose, sensor_fov, 1, seed,
+                       conditionals);
+
+  trajectory_ids = conditionals.trajectory_ids;
+  hzx = Eigen::VectorXd::Zero(conditionals.pzx.cols());
+  for (int jj = 0; jj < conditionals.pzx.outerSize(); jj++) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(conditionals.pzx, jj);
+         it; ++it) {
+      if (it.value() > 0.0)
+        hzx(jj) -= it.value() * log(it.value());
+    }
+  }
+}
+} // namespace
+
+// Every configuration, at each sample count.
+void AccuracyArguments(benchmark::internal::Benchmark* bench) {
+  bench
+    ->ArgsProduct({ {0, 1, 2}, {100, 300, 1000, 3000, 10000, 30000, 100000} })
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+// Score an estimator against ground truth. Arguments: index into
+// 'kConfigurations', number of samples. Times are wall times, since the
+// conditional generator works on its own threads.
+void BM_EntropyAccuracy(benchmark::State& state, Estimator estimator) {
+  const unsigned int index = state.range(0);
+  const unsigned int num_samples = state.range(1);
+  const Configuration& config = kConfigurations[index];
+  const GroundTruth& truth = GetGroundTruth(index);
+
+  const Context2D context(config.grid_size, config.grid_size);
+  GridMap2D map(context, config.num_sources, kRegularizer);
+  GridPose2D pose(context, 0.0, 0.0, 0.0);
+  MakeScene(context, config.num_sources, map, pose);
+
+  double coverage = 0.0, mean_abs_error = 0.0, bias = 0.0;
+  double argmax_agreement = 0.0, regret = 0.0;
+  unsigned int seed = kSeed;
+
+  Eigen::VectorXd hzx;
+  std::vector<Id64> trajectory_ids;
+  for (auto _ : state) {
+    estimator(map, num_samples, config.num_steps, pose, kFov, seed++,
+              hzx, trajectory_ids);
+    benchmark::DoNotOptimize(hzx.data());
+
+    // Score outside of the timed region.
+    state.PauseTiming();
+    double abs_error = 0.0, error = 0.0, max_value = -1.0, picked = 0.0;
+    for (size_t ii = 0; ii < trajectory_ids.size(); ii++) {
+      const auto iter =
+        std::lower_bound(truth.trajectory_ids.begin(),
+                         truth.trajectory_ids.end(), trajectory_ids[ii]);
+      CHECK(iter != truth.trajectory_ids.end() &&
+            *iter == trajectory_ids[ii]) << "Sampled an illegal trajectory.";
+
+      const double exact = truth.hzx[iter - truth.trajectory_ids.begin()];
+      abs_error += fabs(hzx(ii) - exact);
+      error += hzx(ii) - exact;
+
+      // Pick the arg max the same way SelectTrajectory() does.
+      if (hzx(ii) > max_value) {
+        max_value = hzx(ii);
+        picked = exact;
+      }
+    }
+
+    const double num_sampled = std::max<size_t>(1, trajectory_ids.size());
+    coverage += static_cast<double>(trajectory_ids.size()) /
+      truth.trajectory_ids.size();
+    mean_abs_error += abs_error / num_sampled;
+    bias += error / num_sampled;
+    argmax_agreement += (picked >= truth.max_hzx - 1e-9) ? 1.0 : 0.0;
+    regret += truth.max_hzx - picked;
+    state.ResumeTiming();
+  }
+
+  state.counters["coverage"] =
+    benchmark::Counter(coverage, benchmark::Counter::kAvgIterations);
+  state.counters["mean_abs_error"] =
+    benchmark::Counter(mean_abs_error, benchmark::Counter::kAvgIterations);
+  state.counters["bias"] =
+    benchmark::Counter(bias, benchmark::Counter::kAvgIterations);
+  state.counters["argmax_agreement"] =
+    benchmark::Counter(argmax_agreement, benchmark::Counter::kAvgIterations);
+  state.counters["regret"] =
+    benchmark::Counter(regret, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * num_samples);
+}
+BENCHMARK_CAPTURE(BM_EntropyAccuracy, ClippedPlugIn,
+                  &EstimateSampled<EntropyEstimator::kClippedPlugIn>)
+  ->Apply(AccuracyArguments);
+BENCHMARK_CAPTURE(BM_EntropyAccuracy, PlugIn,
+                  &EstimateSampled<EntropyEstimator::kPlugIn>)
+  ->Apply(AccuracyArguments);
+BENCHMARK_CAPTURE(BM_EntropyAccuracy, MillerMadow,
+                  &EstimateSampled<EntropyEstimator::kMillerMadow>)
+  ->Apply(AccuracyArguments);
+BENCHMARK_CAPTURE(BM_EntropyAccuracy, Jackknife,
+                  &EstimateSampled<EntropyEstimator::kJackknife>)
+  ->Apply(AccuracyArguments);
+BENCHMARK_CAPTURE(BM_EntropyAccuracy, ChaoShen,
+                  &EstimateSampled<EntropyEstimator::kChaoShen>)
+  ->Apply(AccuracyArguments);
+BENCHMARK_CAPTURE(BM_EntropyAccuracy, Conditionals, &EstimateConditionals)
+  ->Apply(AccuracyArguments);
+
+} // namespace radiation
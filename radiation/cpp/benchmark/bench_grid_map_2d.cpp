@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Benchmarks for the GridMap2D class. Maps are seeded, and non-uniform
+// beliefs come from a fixed sequence of measurements, so every run measures
+// exactly the same work.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <grid_map_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+const unsigned int kSeed = 0;
+const double kFov = 0.5 * M_PI;
+const double kRegularizer = 1.0;
+const unsigned int kNumMeasurements = 5;
+
+// Random sources and sensors on a square grid, from a fixed seed.
+void RandomScene(const Context2D& context, unsigned int num_sources,
+                 std::vector<Source2D>& sources,
+                 std::vector<Sensor2D>& sensors) {
+  std::default_random_engine rng(kSeed);
+  std::uniform_int_distribution<unsigned int>
+    unif(0, context.GetNumRows() - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  sources.clear();
+  for (unsigned int ii = 0; ii < num_sources; ii++)
+    sources.push_back(Source2D(unif(rng), unif(rng)));
+
+  sensors.clear();
+  for (unsigned int ii = 0; ii < kNumMeasurements; ii++)
+    sensors.push_back(Sensor2D(GridPose2D(context, unif(rng), unif(rng),
+                                          unif_angle(rng)), kFov));
+}
+
+// Bring a map's belief away from uniform with a fixed set of measurements.
+void Measure(GridMap2D& map, const std::vector<Source2D>& sources,
+             const std::vector<Sensor2D>& sensors) {
+  for (size_t ii = 0; ii + 1 < sensors.size(); ii++)
+    map.Update(sensors[ii], sources, false);
+  map.Update(sensors.back(), sources, true);
+}
+} // namespace
+
+// Draw sources from the belief. Arguments: grid size, number of sources.
+void BM_GenerateSources(benchmark::State& state) {
+  const unsigned int grid_size = state.range(0);
+  const unsigned int num_sources = state.range(1);
+  const Context2D context(grid_size, grid_size);
+  GridMap2D map(context, num_sources, kRegularizer);
+  map.Seed(kSeed);
+
+  std::vector<Source2D> sources;
+  for (auto _ : state) {
+    map.GenerateSources(sources);
+    benchmark::DoNotOptimize(sources.data());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateSources)->ArgsProduct({ {5, 10, 20, 40}, {1, 3, 10} });
+
+// Sample a conditional entropy vector. Arguments: grid size, number of
+// sources, number of steps, number of samples.
+void BM_GenerateEntropyVector(benchmark::State& state) {
+  const unsigned int grid_size = state.range(0);
+  const unsigned int num_sources = state.range(1);
+  const unsigned int num_steps = state.range(2);
+  const unsigned int num_samples = state.range(3);
+  const Context2D context(grid_size, grid_size);
+  const GridPose2D pose(context, 0.5 * grid_size, 0.5 * grid_size, 0.0);
+
+  GridMap2D map(context, num_sources, kRegularizer);
+  map.Seed(kSeed);
+
+  Eigen::VectorXd hzx;
+  std::vector<Id64> trajectory_ids;
+  for (auto _ : state) {
+    map.GenerateEntropyVector(num_samples, num_steps, pose, kFov,
+                              hzx, trajectory_ids);
+    benchmark::DoNotOptimize(hzx.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_samples);
+}
+BENCHMARK(BM_GenerateEntropyVector)
+  ->ArgsProduct({ {5, 10, 20}, {1, 3}, {1, 2, 4}, {1000, 10000} })
+  ->Unit(benchmark::kMillisecond);
+
+// Update the belief with a measurement and solve the least squares problem.
+// Arguments: grid size, number of sources.
+void BM_Update(benchmark::State& state) {
+  const unsigned int grid_size = state.range(0);
+  const unsigned int num_sources = state.range(1);
+  const Context2D context(grid_size, grid_size);
+
+  std::vector<Source2D> sources;
+  std::vector<Sensor2D> sensors;
+  RandomScene(context, num_sources, sources, sensors);
+
+  // Every iteration solves the same problem, so start from a fresh map.
+  for (auto _ : state) {
+    state.PauseTiming();
+    GridMap2D map(context, num_sources, kRegularizer);
+    map.Seed(kSeed);
+    for (size_t ii = 0; ii + 1 < sensors.size(); ii++)
+      map.Update(sensors[ii], sources, false);
+    state.ResumeTiming();
+
+    map.Update(sensors.back(), sources, true);
+    benchmark::DoNotOptimize(map.GetImmutableBelief().data());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Update)->ArgsProduct({ {5, 10, 20}, {1, 3} })
+  ->Unit(benchmark::kMillisecond);
+
+// Compute the entropy of a non-uniform belief. Arguments: grid size, number
+// of sources.
+void BM_Entropy(benchmark::State& state) {
+  const unsigned int grid_size = state.range(0);
+  const unsigned int num_sources = state.range(1);
+  const Context2D context(grid_size, grid_size);
+
+  std::vector<Source2D> sources;
+  std::vector<Sensor2D> sensors;
+  RandomScene(context, num_sources, sources, sensors);
+
+  GridMap2D map(context, num_sources, kRegularizer);
+  map.Seed(kSeed);
+  Measure(map, sources, sensors);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(map.Entropy());
+
+  state.SetItemsProcessed(state.iterations() * grid_size * grid_size);
+}
+BENCHMARK(BM_Entropy)->ArgsProduct({ {5, 10, 20, 40}, {1, 3} });
+
+} // namespace radiation
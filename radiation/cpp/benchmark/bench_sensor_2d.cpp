@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Benchmarks for the Sensor2D class.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sensor_2d.h>
+#include <source_2d.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+const unsigned int kSeed = 0;
+const double kFov = 0.5 * M_PI;
+} // namespace
+
+// Count sources in view. Argument: number of sources.
+void BM_SensorSense(benchmark::State& state) {
+  const unsigned int kGridSize = 20;
+  const unsigned int num_sources = state.range(0);
+
+  std::default_random_engine rng(kSeed);
+  std::uniform_int_distribution<unsigned int> unif(0, kGridSize - 1);
+  std::vector<Source2D> sources;
+  for (unsigned int ii = 0; ii < num_sources; ii++)
+    sources.push_back(Source2D(unif(rng), unif(rng)));
+
+  const Context2D context(kGridSize, kGridSize);
+  const GridPose2D pose(context, 0.5 * kGridSize, 0.5 * kGridSize, 0.3);
+  const Sensor2D sensor(pose, kFov);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(sensor.Sense(sources));
+
+  state.SetItemsProcessed(state.iterations() * num_sources);
+}
+BENCHMARK(BM_SensorSense)->RangeMultiplier(4)->Range(1, 64);
+
+// Check every voxel of the grid. Argument: grid size.
+void BM_SensorVoxelInView(benchmark::State& state) {
+  const unsigned int grid_size = state.range(0);
+  const Context2D context(grid_size, grid_size);
+  const GridPose2D pose(context, 0.5 * grid_size, 0.5 * grid_size, 0.3);
+  const Sensor2D sensor(pose, kFov);
+
+  for (auto _ : state) {
+    unsigned int num_in_view = 0;
+    for (unsigned int ii = 0; ii < grid_size; ii++)
+      for (unsigned int jj = 0; jj < grid_size; jj++)
+        num_in_view += sensor.VoxelInView(ii, jj);
+
+    benchmark::DoNotOptimize(num_in_view);
+  }
+
+  state.SetItemsProcessed(state.iterations() * grid_size * grid_size);
+}
+BENCHMARK(BM_SensorVoxelInView)->Arg(5)->Arg(10)->Arg(20)->Arg(40);
+
+} // namespace radiation
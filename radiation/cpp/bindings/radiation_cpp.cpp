@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Python bindings for the core of the C++ library, built as the module
+// 'radiation_cpp' when BUILD_PYTHON is enabled. Method names follow the C++
+// (and pure Python) classes. Methods which fill output arguments in C++
+// return them instead.
+//
+// Arrays are handed to NumPy without copying. Beliefs are returned as
+// read-only views into the map, which keep the map alive, and results
+// computed in C++ (including the sample histograms behind entropy vectors)
+// are moved into buffers owned by the returned arrays.
+// The GIL is released while sampling, solving, and planning, so several
+// Python threads can drive independent maps at once.
+//
+// As in C++, poses and movements refer to their context. Objects built
+// from a context keep it alive, but poses returned in lists (e.g. planned
+// trajectories) do not, so keep the context or explorer around while
+// using them.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <context_2d.h>
+#include <source_2d.h>
+#include <grid_pose_2d.h>
+#include <movement_2d.h>
+#include <sensor_2d.h>
+#include <grid_map_2d.h>
+#include <explorer_lp.h>
+#include <conditional_generator.h>
+#include <encoding.h>
+#include <entropy_estimators.h>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <Eigen/Core>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+using namespace radiation;
+
+namespace {
+// Move a vector onto the heap and hand it to NumPy without copying. The
+// array owns the vector through a capsule.
+template <typename T>
+py::array_t<T> ToArray(std::vector<T>&& values) {
+  std::vector<T>* owner = new std::vector<T>(std::move(values));
+  py::capsule free_owner(owner, [](void* ptr) {
+      delete static_cast<std::vector<T>*>(ptr);
+    });
+
+  return py::array_t<T>(owner->size(), owner->data(), free_owner);
+}
+
+py::array_t<double> ToArray(Eigen::VectorXd&& values) {
+  Eigen::VectorXd* owner = new Eigen::VectorXd(std::move(values));
+  py::capsule free_owner(owner, [](void* ptr) {
+      delete static_cast<Eigen::VectorXd*>(ptr);
+    });
+
+  return py::array_t<double>(owner->size(), owner->data(), free_owner);
+}
+
+// Eigen matrices are column-major, so they become Fortran-ordered arrays.
+py::array_t<double, py::array::f_style> ToArray(Eigen::MatrixXd&& values) {
+  Eigen::MatrixXd* owner = new Eigen::MatrixXd(std::move(values));
+  py::capsule free_owner(owner, [](void* ptr) {
+      delete static_cast<Eigen::MatrixXd*>(ptr);
+    });
+
+  return py::array_t<double, py::array::f_style>(
+    {owner->rows(), owner->cols()}, owner->data(), free_owner);
+}
+} // namespace
+
+PYBIND11_MODULE(radiation_cpp, m) {
+  m.doc() = "Python bindings for the radiation C++ library.";
+
+  // Conditional entropy estimators.
+  py::enum_<EntropyEstimator>(m, "EntropyEstimator")
+    .value("kClippedPlugIn", EntropyEstimator::kClippedPlugIn)
+    .value("kPlugIn", EntropyEstimator::kPlugIn)
+    .value("kMillerMadow", EntropyEstimator::kMillerMadow)
+    .value("kJackknife", EntropyEstimator::kJackknife)
+    .value("kChaoShen", EntropyEstimator::kChaoShen);
+
+  // Context. Maps and poses keep a reference to their context, so they
+  // keep the Python object alive too.
+  py::class_<Context2D>(m, "Context2D")
+    .def(py::init<unsigned int, unsigned int>(),
+         py::arg("num_rows"), py::arg("num_cols"))
+    .def("SetDeltaXs", &Context2D::SetDeltaXs)
+    .def("SetDeltaYs", &Context2D::SetDeltaYs)
+    .def("SetDeltaAngles", &Context2D::SetDeltaAngles)
+    .def("SetAngularStep", &Context2D::SetAngularStep)
+    .def("SetObstacle", &Context2D::SetObstacle,
+         py::arg("ii"), py::arg("jj"), py::arg("obstacle") = true)
+    .def("GetNumRows", &Context2D::GetNumRows)
+    .def("GetNumCols", &Context2D::GetNumCols)
+    .def("GetAngularStep", &Context2D::GetAngularStep)
+    .def("IsObstacle", &Context2D::IsObstacle)
+    .def("HasObstacles", &Context2D::HasObstacles);
+
+  py::class_<Source2D>(m, "Source2D")
+    .def(py::init<double, double>(), py::arg("x"), py::arg("y"))
+    .def("GetX", &Source2D::GetX)
+    .def("GetY", &Source2D::GetY)
+    .def("GetIndexX", &Source2D::GetIndexX)
+    .def("GetIndexY", &Source2D::GetIndexY);
+
+  py::class_<GridPose2D>(m, "GridPose2D")
+    .def(py::init<const Context2D&, double, double, double>(),
+         py::arg("context"), py::arg("x"), py::arg("y"), py::arg("a"),
+         py::keep_alive<1, 2>())
+    .def("GetX", &GridPose2D::GetX)
+    .def("GetY", &GridPose2D::GetY)
+    .def("GetAngle", &GridPose2D::GetAngle)
+    .def("GetIndexX", &GridPose2D::GetIndexX)
+    .def("GetIndexY", &GridPose2D::GetIndexY)
+    .def("MoveBy", &GridPose2D::MoveBy);
+
+  py::class_<Movement2D>(m, "Movement2D")
+    .def(py::init<const Context2D&, unsigned int, unsigned int,
+                  unsigned int>(),
+         py::arg("context"), py::arg("x_id"), py::arg("y_id"),
+         py::arg("a_id"), py::keep_alive<1, 2>())
+    .def("GetIndexX", &Movement2D::GetIndexX)
+    .def("GetIndexY", &Movement2D::GetIndexY)
+    .def("GetIndexAngle", &Movement2D::GetIndexAngle);
+
+  py::class_<Sensor2D>(m, "Sensor2D")
+    .def(py::init<double, double, double, double>(),
+         py::arg("x"), py::arg("y"), py::arg("a"), py::arg("fov"))
+    .def(py::init<const GridPose2D&, double>(),
+         py::arg("pose"), py::arg("fov"))
+    .def("GetX", &Sensor2D::GetX)
+    .def("GetY", &Sensor2D::GetY)
+    .def("GetAngle", &Sensor2D::GetAngle)
+    .def("GetFov", &Sensor2D::GetFov)
+    .def("MoveTo", &Sensor2D::MoveTo)
+    .def("Sense", &Sensor2D::Sense)
+    .def("SourceInView", &Sensor2D::SourceInView)
+    .def("VoxelInView", &Sensor2D::VoxelInView)
+    .def("VoxelsInView", [](const Sensor2D& sensor, unsigned int num_rows,
+                            unsigned int num_cols) {
+           std::vector<unsigned int> voxels;
+           sensor.VoxelsInView(num_rows, num_cols, voxels);
+           return ToArray(std::move(voxels));
+         });
+
+  py::class_<GridMap2D>(m, "GridMap2D")
+    .def(py::init<const Context2D&, unsigned int, double>(),
+         py::arg("context"), py::arg("num_sources"), py::arg("regularizer"),
+         py::keep_alive<1, 2>())
+    .def(py::init<const Context2D&, const Eigen::MatrixXd&,
+                  unsigned int, double>(),
+         py::arg("context"), py::arg("belief"), py::arg("num_sources"),
+         py::arg("regularizer"), py::keep_alive<1, 2>())
+    .def("GetNumRows", &GridMap2D::GetNumRows)
+    .def("GetNumCols", &GridMap2D::GetNumCols)
+    .def("GetNumSources", &GridMap2D::GetNumSources)
+    .def("GetRegularizer", &GridMap2D::GetRegularizer)
+    .def("Seed", &GridMap2D::Seed)
+    .def("GenerateSources", [](GridMap2D& map) {
+           std::vector<Source2D> sources;
+           if (!map.GenerateSources(sources))
+             throw std::runtime_error("Unable to generate sources.");
+           return sources;
+         })
+    .def("Sense", &GridMap2D::Sense)
+    .def("GenerateEntropyVector",
+         [](GridMap2D& map, unsigned int num_samples, unsigned int num_steps,
+            const GridPose2D& pose, double sensor_fov,
+            EntropyEstimator estimator) {
+           Eigen::VectorXd hzx;
+           std::vector<Id64> trajectory_ids;
+           {
+             py::gil_scoped_release release;
+             map.GenerateEntropyVector(num_samples, num_steps, pose,
+                                       sensor_fov, hzx, trajectory_ids,
+                                       estimator);
+           }
+
+           return py::make_tuple(ToArray(std::move(hzx)),
+                                 ToArray(std::move(trajectory_ids)));
+         },
+         py::arg("num_samples"), py::arg("num_steps"), py::arg("pose"),
+         py::arg("sensor_fov"),
+         py::arg("estimator") = EntropyEstimator::kClippedPlugIn)
+    .def("SampleHistogram",
+         [](GridMap2D& map, unsigned int num_samples, unsigned int num_steps,
+            const GridPose2D& pose, double sensor_fov) {
+           Eigen::VectorXd hzx;
+           std::vector<Id64> trajectory_ids;
+           Eigen::MatrixXd histogram;
+           {
+             py::gil_scoped_release release;
+             map.GenerateEntropyVector(num_samples, num_steps, pose,
+                                       sensor_fov, hzx, trajectory_ids,
+                                       EntropyEstimator::kClippedPlugIn,
+                                       &histogram);
+           }
+
+           return py::make_tuple(ToArray(std::move(histogram)),
+                                 ToArray(std::move(trajectory_ids)));
+         },
+         py::arg("num_samples"), py::arg("num_steps"), py::arg("pose"),
+         py::arg("sensor_fov"))
+    .def("Update", &GridMap2D::Update,
+         py::arg("sensor"), py::arg("sources"), py::arg("solve") = true,
+         py::call_guard<py::gil_scoped_release>())
+    .def("Entropy", &GridMap2D::Entropy)
+    .def("ExpectedMeasurement", &GridMap2D::ExpectedMeasurement)
+    .def("GetBelief", &GridMap2D::GetImmutableBelief,
+         py::return_value_policy::reference_internal);
+
+  py::class_<ExplorerLP>(m, "ExplorerLP")
+    .def(py::init<const Context2D&, unsigned int, double, unsigned int,
+                  double, unsigned int>(),
+         py::arg("context"), py::arg("num_sources"), py::arg("regularizer"),
+         py::arg("num_steps"), py::arg("fov"), py::arg("num_samples"))
+    .def(py::init<const Context2D&, unsigned int, double, unsigned int,
+                  double, unsigned int, unsigned int>(),
+         py::arg("context"), py::arg("num_sources"), py::arg("regularizer"),
+         py::arg("num_steps"), py::arg("fov"), py::arg("num_samples"),
+         py::arg("seed"))
+    .def("PlanAhead", [](ExplorerLP& explorer) {
+           std::vector<GridPose2D> trajectory;
+           bool success = false;
+           {
+             py::gil_scoped_release release;
+             success = explorer.PlanAhead(trajectory);
+           }
+
+           if (!success)
+             throw std::runtime_error("Planning failed.");
+           return trajectory;
+         })
+    .def("PlanAheadFrontier", [](ExplorerLP& explorer,
+                                 unsigned int num_headings) {
+           std::vector<GridPose2D> trajectory;
+           bool success = false;
+           {
+             py::gil_scoped_release release;
+             success = explorer.PlanAheadFrontier(num_headings, trajectory);
+           }
+
+           if (!success)
+             throw std::runtime_error("Planning failed.");
+           return trajectory;
+         })
+    .def("TakeStep", &ExplorerLP::TakeStep,
+         py::call_guard<py::gil_scoped_release>())
+    .def("Entropy", &ExplorerLP::Entropy)
+    .def("SetEntropyEstimator", &ExplorerLP::SetEntropyEstimator)
+    .def("GetMap", &ExplorerLP::GetMap,
+         py::return_value_policy::reference_internal)
+    .def("GetPose", &ExplorerLP::GetPose,
+         py::return_value_policy::reference_internal)
+    .def("GetSources", &ExplorerLP::GetSources);
+
+  // Conditionals for the LP formulation. P_{Z|X} is returned as a
+  // scipy.sparse matrix.
+  m.def("GenerateConditionals",
+        [](const GridMap2D& map, unsigned int num_samples,
+           unsigned int num_steps, const GridPose2D& pose, double sensor_fov,
+           unsigned int num_threads, unsigned int seed) {
+          Conditionals conditionals;
+          {
+            py::gil_scoped_release release;
+            GenerateConditionals(map, num_samples, num_steps, pose,
+                                 sensor_fov, num_threads, seed, conditionals);
+          }
+
+          return py::make_tuple(
+            conditionals.pzx, ToArray(std::move(conditionals.hzm)),
+            ToArray(std::move(conditionals.trajectory_ids)),
+            ToArray(std::move(conditionals.measurement_ids)));
+        },
+        py::arg("map"), py::arg("num_samples"), py::arg("num_steps"),
+        py::arg("pose"), py::arg("sensor_fov"), py::arg("num_threads") = 0,
+        py::arg("seed") = 0);
+
+  // Encoders. Trajectory ids are 64 bits wide.
+  m.def("EncodeTrajectory",
+        [](const std::vector<Movement2D>& movements,
+           const Context2D& context) {
+          Id64 id = 0;
+          if (!EncodeTrajectory(movements, context, id))
+            throw std::overflow_error("Trajectory id overflow.");
+          return id;
+        },
+        py::arg("movements"), py::arg("context"));
+  m.def("DecodeTrajectory",
+        [](Id64 id, unsigned int num_steps, const GridPose2D& initial_pose) {
+          std::vector<GridPose2D> trajectory;
+          DecodeTrajectory(id, num_steps, initial_pose, trajectory);
+          return trajectory;
+        },
+        py::arg("id"), py::arg("num_steps"), py::arg("initial_pose"));
+  m.def("DecodeTrajectories",
+        [](const std::vector<Id64>& ids, unsigned int num_steps,
+           const GridPose2D& initial_pose) {
+          std::vector< std::vector<GridPose2D> > trajectories;
+          DecodeTrajectories(ids, num_steps, initial_pose, trajectories);
+          return trajectories;
+        },
+        py::arg("ids"), py::arg("num_steps"), py::arg("initial_pose"));
+  m.def("EncodeMeasurements",
+        [](const std::vector<unsigned int>& measurements,
+           unsigned int max_measurement) {
+          Id64 id = 0;
+          if (!EncodeMeasurements(measurements, max_measurement, id))
+            throw std::overflow_error("Measurement id overflow.");
+          return id;
+        },
+        py::arg("measurements"), py::arg("max_measurement"));
+  m.def("DecodeMeasurements",
+        [](Id64 id, unsigned int max_measurement,
+           unsigned int num_measurements) {
+          std::vector<unsigned int> measurements;
+          DecodeMeasurements(id, max_measurement, num_measurements,
+                             measurements);
+          return ToArray(std::move(measurements));
+        },
+        py::arg("id"), py::arg("max_measurement"),
+        py::arg("num_measurements"));
+  m.def("EncodeMap",
+        [](const std::vector<Source2D>& sources, unsigned int num_rows,
+           unsigned int num_cols) {
+          Id64 id = 0;
+          if (!EncodeMap(sources, num_rows, num_cols, id))
+            throw std::overflow_error("Map id overflow.");
+          return id;
+        },
+        py::arg("sources"), py::arg("num_rows"), py::arg("num_cols"));
+  m.def("DecodeMap",
+        [](Id64 id, unsigned int num_rows, unsigned int num_cols,
+           unsigned int num_sources) {
+          std::vector<Source2D> sources;
+          DecodeMap(id, num_rows, num_cols, num_sources, sources);
+          return sources;
+        },
+        py::arg("id"), py::arg("num_rows"), py::arg("num_cols"),
+        py::arg("num_sources"));
+}
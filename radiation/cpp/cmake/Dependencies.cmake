@@ -11,6 +11,10 @@ find_package( Ceres REQUIRED )
 include_directories(SYSTEM ${CERES_INCLUDE_DIRS})
 list(APPEND radiation_LIBRARIES ${CERES_LIBRARIES})
 
+# Find threads.
+find_package( Threads REQUIRED )
+list(APPEND radiation_LIBRARIES ${CMAKE_THREAD_LIBS_INIT})
+
 # Find OpenGL.
 find_package( OpenGL REQUIRED )
 include_directories(SYSTEM ${OPENGL_INCLUDE_DIRS})
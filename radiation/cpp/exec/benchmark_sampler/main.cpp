@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Benchmark for the sampling loop in GridMap2D::GenerateEntropyVector.
+// Reports time per call and per sample, and counts heap allocations by
+// replacing global operator new. Once the map's scratch buffers have grown,
+// the number of allocations per call should not depend on the number of
+// samples, i.e. the sample loop itself should never allocate. Eigen calls
+// malloc directly, so the returned matrices are not counted.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <grid_map_2d.h>
+#include <grid_pose_2d.h>
+#include <context_2d.h>
+
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include <math.h>
+
+DEFINE_int32(num_rows, 5, "Number of rows in the grid.");
+DEFINE_int32(num_cols, 5, "Number of columns in the grid.");
+DEFINE_double(angular_step, 0.1 * M_PI, "Angular step size in radians.");
+DEFINE_int32(num_sources, 2, "Number of sources.");
+DEFINE_int32(num_steps, 4, "Number of steps in each trajectory.");
+DEFINE_int32(num_samples, 20000, "Largest number of samples per call.");
+DEFINE_double(fov, 0.1 * M_PI, "Sensor field of view in radians.");
+DEFINE_int32(num_calls, 10, "Number of timed calls per sample count.");
+
+// Count every heap allocation made through operator new.
+static std::atomic<size_t> num_allocations(0);
+
+void* operator new(size_t size) {
+  num_allocations++;
+  void* ptr = std::malloc(size > 0 ? size : 1);
+  if (ptr == NULL)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+using namespace radiation;
+
+// Set everything up and go!
+int main(int argc, char** argv) {
+  // Set up logging.
+  google::InitGoogleLogging(argv[0]);
+
+  // Parse flags.
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  Context2D context(FLAGS_num_rows, FLAGS_num_cols);
+  context.SetAngularStep(FLAGS_angular_step);
+
+  GridMap2D map(context, FLAGS_num_sources, 1.0);
+  const GridPose2D pose(context, 0.5 * FLAGS_num_rows, 0.5 * FLAGS_num_cols,
+                        0.0);
+
+  Eigen::VectorXd hzx;
+  std::vector<Id64> trajectory_ids;
+
+  // Warm up at the largest sample count, so scratch buffers, output vectors,
+  // and the visibility cache all reach their steady-state size.
+  for (int ii = 0; ii < 2; ii++)
+    map.GenerateEntropyVector(FLAGS_num_samples, FLAGS_num_steps, pose,
+                              FLAGS_fov, hzx, trajectory_ids);
+
+  // Time calls at a range of sample counts, and count allocations.
+  typedef std::chrono::steady_clock Clock;
+  std::vector<double> allocations_per_call;
+  for (int num_samples = FLAGS_num_samples / 4;
+       num_samples <= FLAGS_num_samples; num_samples *= 2) {
+    const size_t allocations_start = num_allocations;
+    const Clock::time_point start = Clock::now();
+
+    for (int ii = 0; ii < FLAGS_num_calls; ii++)
+      map.GenerateEntropyVector(num_samples, FLAGS_num_steps, pose,
+                                FLAGS_fov, hzx, trajectory_ids);
+
+    const double elapsed =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    const double allocations =
+      static_cast<double>(num_allocations - allocations_start) /
+      FLAGS_num_calls;
+    allocations_per_call.push_back(allocations);
+
+    std::cout << "samples: " << num_samples
+              << "  time/call: " << 1e3 * elapsed / FLAGS_num_calls << " ms"
+              << "  time/sample: "
+              << 1e9 * elapsed / (FLAGS_num_calls * num_samples) << " ns"
+              << "  allocations/call: " << allocations << std::endl;
+  }
+
+  // The sample loop is allocation-free if the number of allocations per call
+  // does not grow with the number of samples.
+  const bool allocation_free =
+    allocations_per_call.back() <= allocations_per_call.front();
+  std::cout << "Sample loop is "
+            << (allocation_free ? "allocation-free." : "ALLOCATING.")
+            << std::endl;
+
+  return allocation_free ? 0 : 1;
+}
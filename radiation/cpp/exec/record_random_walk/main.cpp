@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Record a dataset of maps, random walks, and corresponding measurements, as
+// python/scripts/record_random_walk.py does, in parallel. Each simulation
+// places sources uniformly at random, starts from a random pose, and takes
+// random valid steps, sensing after each one.
+//
+// Simulations are split into shards of a fixed size. Shard s always uses a
+// random number generator seeded with (seed, s), so the output depends only
+// on the flags and not on the number of threads. Workers claim shards in
+// order, and the main thread writes finished shards in order as soon as
+// they are available. At most a few shards per thread are held in memory.
+//
+// CSV output matches the Python script: one map id per line in the maps
+// file, and one row of 'num_steps' pose ids and measurements per simulation
+// in the other two files. Pose ids are x + y * rows + angle * rows * angles,
+// where angle is the index of the heading on a grid of 'num_angles'.
+//
+// Columnar output (see columnar_file.h) holds the same data in columns
+// "maps", "trajectories", and "measurements" of a single file, along with
+// the flags used to generate it. The file is sized up front, so workers
+// write shards straight into the mapping and nothing is held in memory.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <context_2d.h>
+#include <source_2d.h>
+#include <grid_pose_2d.h>
+#include <movement_2d.h>
+#include <sensor_2d.h>
+#include <encoding.h>
+#include <columnar_file.h>
+
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <math.h>
+
+DEFINE_int32(num_simulations, 100000, "Number of random walks to record.");
+DEFINE_int32(num_rows, 5, "Number of rows in the grid.");
+DEFINE_int32(num_cols, 5, "Number of columns in the grid.");
+DEFINE_int32(num_sources, 3, "Number of sources.");
+DEFINE_int32(num_steps, 10, "Number of steps in each random walk.");
+DEFINE_int32(num_angles, 8, "Number of headings in a full turn.");
+DEFINE_double(fov, 0.5 * M_PI, "Sensor field of view in radians.");
+DEFINE_int32(seed, 0, "Base random seed. Shard s is seeded with (seed, s).");
+DEFINE_int32(shard_size, 1000, "Number of simulations per shard.");
+DEFINE_int32(num_threads, 0,
+             "Number of worker threads. Zero means one per hardware thread.");
+DEFINE_string(format, "csv",
+              "Output format, either \"csv\" or \"columnar\".");
+DEFINE_string(dataset_file, "random_walks.rcol",
+              "File to write the whole dataset to, in columnar format.");
+DEFINE_string(maps_file, "maps.csv", "File to write map ids to.");
+DEFINE_string(trajectories_file, "trajectories.csv",
+              "File to write pose ids to.");
+DEFINE_string(measurements_file, "measurements.csv",
+              "File to write measurements to.");
+
+using namespace radiation;
+
+// Run the given range of simulations with a generator seeded for this shard,
+// writing one map id, and 'num_steps' pose ids and measurements, per
+// simulation.
+void SimulateShard(const Context2D& context, unsigned int shard,
+                   unsigned int count, uint64_t* maps,
+                   uint32_t* trajectories, uint32_t* measurements) {
+  std::seed_seq seed({ static_cast<unsigned int>(FLAGS_seed), shard });
+  std::default_random_engine rng(seed);
+
+  std::uniform_int_distribution<unsigned int> unif_rows(0, FLAGS_num_rows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, FLAGS_num_cols - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+  const double angular_step = context.GetAngularStep();
+
+  std::vector<Source2D> sources;
+  for (unsigned int ii = 0; ii < count; ii++) {
+    // Generate random sources on the grid.
+    sources.clear();
+    for (int jj = 0; jj < FLAGS_num_sources; jj++)
+      sources.push_back(Source2D(unif_rows(rng), unif_cols(rng)));
+
+    Id64 map_id = 0;
+    CHECK(EncodeMap(sources, FLAGS_num_rows, FLAGS_num_cols, map_id))
+      << "Map id overflow. Try fewer sources.";
+    maps[ii] = map_id;
+
+    // Generate a valid random walk of the given length, sensing after
+    // every step.
+    uint32_t* pose_ids = trajectories + ii * FLAGS_num_steps;
+    uint32_t* values = measurements + ii * FLAGS_num_steps;
+
+    GridPose2D current_pose(context, unif_rows(rng), unif_cols(rng),
+                            unif_angle(rng));
+    int num_taken = 0;
+    while (num_taken < FLAGS_num_steps) {
+      const Movement2D step(context, rng);
+      if (!current_pose.MoveBy(step))
+        continue;
+
+      const unsigned int angle_id = static_cast<unsigned int>(
+        floor(current_pose.GetAngle() / angular_step)) % FLAGS_num_angles;
+      pose_ids[num_taken] = current_pose.GetIndexX() +
+        current_pose.GetIndexY() * FLAGS_num_rows +
+        angle_id * FLAGS_num_rows * FLAGS_num_angles;
+
+      const Sensor2D sensor(current_pose, FLAGS_fov);
+      values[num_taken] = sensor.Sense(sources);
+      num_taken++;
+    }
+  }
+}
+
+// Rows of all three CSV files for one shard.
+struct Shard {
+  std::string maps_;
+  std::string trajectories_;
+  std::string measurements_;
+}; // struct Shard
+
+// Append comma-separated rows of 'width' values each.
+void AppendRows(const uint32_t* values, size_t count, size_t width,
+                std::string& rows) {
+  for (size_t ii = 0; ii < count; ii++) {
+    for (size_t jj = 0; jj < width; jj++) {
+      if (jj > 0)
+        rows += ',';
+      rows += std::to_string(values[ii * width + jj]);
+    }
+
+    rows += '\n';
+  }
+}
+
+// Simulate a shard and format it as CSV.
+void SimulateShard(const Context2D& context, unsigned int shard,
+                   unsigned int count, Shard& output) {
+  std::vector<uint64_t> maps(count);
+  std::vector<uint32_t> trajectories(count * FLAGS_num_steps);
+  std::vector<uint32_t> measurements(count * FLAGS_num_steps);
+  SimulateShard(context, shard, count, maps.data(), trajectories.data(),
+                measurements.data());
+
+  for (size_t ii = 0; ii < count; ii++) {
+    output.maps_ += std::to_string(maps[ii]);
+    output.maps_ += '\n';
+  }
+
+  AppendRows(trajectories.data(), count, FLAGS_num_steps,
+             output.trajectories_);
+  AppendRows(measurements.data(), count, FLAGS_num_steps,
+             output.measurements_);
+}
+
+// Number of simulations in the given shard.
+unsigned int ShardCount(unsigned int shard) {
+  const unsigned int first = shard * FLAGS_shard_size;
+  return std::min(static_cast<unsigned int>(FLAGS_shard_size),
+                  static_cast<unsigned int>(FLAGS_num_simulations) - first);
+}
+
+// Record the dataset in columnar format. Shards go straight into the
+// mapping, so workers never wait on each other.
+void RecordColumnar(const Context2D& context, unsigned int num_shards,
+                    unsigned int num_threads) {
+  const uint64_t num_simulations = FLAGS_num_simulations;
+  const uint64_t num_steps = FLAGS_num_steps;
+
+  std::vector<ColumnSpec> columns;
+  columns.push_back(ColumnSpec{"maps", ColumnType::kUInt64,
+                               num_simulations, 1});
+  columns.push_back(ColumnSpec{"trajectories", ColumnType::kUInt32,
+                               num_simulations, num_steps});
+  columns.push_back(ColumnSpec{"measurements", ColumnType::kUInt32,
+                               num_simulations, num_steps});
+
+  // Record every flag that affects the data.
+  std::map<std::string, std::string> parameters;
+  parameters["num_simulations"] = std::to_string(FLAGS_num_simulations);
+  parameters["num_rows"] = std::to_string(FLAGS_num_rows);
+  parameters["num_cols"] = std::to_string(FLAGS_num_cols);
+  parameters["num_sources"] = std::to_string(FLAGS_num_sources);
+  parameters["num_steps"] = std::to_string(FLAGS_num_steps);
+  parameters["num_angles"] = std::to_string(FLAGS_num_angles);
+  std::ostringstream fov;
+  fov << std::setprecision(17) << FLAGS_fov;
+  parameters["fov"] = fov.str();
+  parameters["seed"] = std::to_string(FLAGS_seed);
+  parameters["shard_size"] = std::to_string(FLAGS_shard_size);
+
+  ColumnarFile file;
+  CHECK(file.Create(FLAGS_dataset_file, columns, parameters))
+    << "Could not create " << FLAGS_dataset_file << ".";
+  uint64_t* maps = file.GetMutableData<uint64_t>("maps");
+  uint32_t* trajectories = file.GetMutableData<uint32_t>("trajectories");
+  uint32_t* measurements = file.GetMutableData<uint32_t>("measurements");
+
+  std::atomic<unsigned int> next_shard(0);
+  std::vector<std::thread> workers;
+  for (unsigned int ii = 0; ii < num_threads; ii++) {
+    workers.push_back(std::thread([&]() {
+          for (unsigned int shard = next_shard++; shard < num_shards;
+               shard = next_shard++) {
+            const size_t first =
+              static_cast<size_t>(shard) * FLAGS_shard_size;
+            SimulateShard(context, shard, ShardCount(shard), maps + first,
+                          trajectories + first * num_steps,
+                          measurements + first * num_steps);
+          }
+        }));
+  }
+
+  for (auto& worker : workers)
+    worker.join();
+}
+
+// Record the dataset in CSV format. Workers format shards, and the main
+// thread writes them in order.
+void RecordCsv(const Context2D& context, unsigned int num_shards,
+               unsigned int num_threads) {
+  std::ofstream maps_file(FLAGS_maps_file.c_str());
+  std::ofstream trajectories_file(FLAGS_trajectories_file.c_str());
+  std::ofstream measurements_file(FLAGS_measurements_file.c_str());
+  CHECK(maps_file.is_open()) << "Could not open " << FLAGS_maps_file << ".";
+  CHECK(trajectories_file.is_open())
+    << "Could not open " << FLAGS_trajectories_file << ".";
+  CHECK(measurements_file.is_open())
+    << "Could not open " << FLAGS_measurements_file << ".";
+
+  const unsigned int max_shards_in_flight = 2 * num_threads;
+
+  // Finished shards waiting to be written, and the next one to write.
+  // Workers do not start a shard too far ahead of the writer.
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::map<unsigned int, Shard> finished;
+  unsigned int next_to_write = 0;
+  std::atomic<unsigned int> next_shard(0);
+
+  std::vector<std::thread> workers;
+  for (unsigned int ii = 0; ii < num_threads; ii++) {
+    workers.push_back(std::thread([&]() {
+          for (unsigned int shard = next_shard++; shard < num_shards;
+               shard = next_shard++) {
+            {
+              std::unique_lock<std::mutex> lock(mutex);
+              changed.wait(lock, [&]() {
+                  return shard < next_to_write + max_shards_in_flight;
+                });
+            }
+
+            Shard output;
+            SimulateShard(context, shard, ShardCount(shard), output);
+
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              finished[shard] = std::move(output);
+            }
+            changed.notify_all();
+          }
+        }));
+  }
+
+  // Write shards in order as they finish.
+  while (next_to_write < num_shards) {
+    Shard output;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&]() { return finished.count(next_to_write) > 0; });
+
+      output = std::move(finished[next_to_write]);
+      finished.erase(next_to_write);
+      next_to_write++;
+    }
+    changed.notify_all();
+
+    maps_file << output.maps_;
+    trajectories_file << output.trajectories_;
+    measurements_file << output.measurements_;
+  }
+
+  for (auto& worker : workers)
+    worker.join();
+
+  CHECK(maps_file.good() && trajectories_file.good() &&
+        measurements_file.good()) << "Error writing dataset.";
+}
+
+// Set everything up and go!
+int main(int argc, char** argv) {
+  // Set up logging.
+  google::InitGoogleLogging(argv[0]);
+
+  // Parse flags.
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  CHECK(FLAGS_num_simulations >= 0);
+  CHECK(FLAGS_shard_size > 0);
+  CHECK(FLAGS_num_angles > 0);
+  CHECK(FLAGS_format == "csv" || FLAGS_format == "columnar")
+    << "Unknown format \"" << FLAGS_format << "\".";
+
+  // Set up the grid and movements.
+  Context2D context(FLAGS_num_rows, FLAGS_num_cols);
+  context.SetAngularStep(2.0 * M_PI / static_cast<double>(FLAGS_num_angles));
+
+  unsigned int num_threads = (FLAGS_num_threads > 0) ?
+    FLAGS_num_threads : std::thread::hardware_concurrency();
+  if (num_threads == 0)
+    num_threads = 1;
+
+  const unsigned int num_shards =
+    (FLAGS_num_simulations + FLAGS_shard_size - 1) / FLAGS_shard_size;
+
+  std::cout << "Recording " << FLAGS_num_simulations << " random walks in "
+            << num_shards << " shards on " << num_threads << " threads."
+            << std::endl;
+
+  if (FLAGS_format == "columnar")
+    RecordColumnar(context, num_shards, num_threads);
+  else
+    RecordCsv(context, num_shards, num_threads);
+
+  std::cout << "Successfully saved to disk." << std::endl;
+
+  return 0;
+}
@@ -35,13 +35,20 @@
  */
 
 #include <explorer_lp.h>
-#include <movement_2d.h>
+#include <async_explorer_lp.h>
+#include <context_2d.h>
 #include <grid_pose_2d.h>
+#include <entropy_estimators.h>
+#include <trace.h>
+#include <explorer_window.h>
 
-#include <GLUT/glut.h>
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 #include <iostream>
+#include <memory>
+#include <stdlib.h>
+#include <sstream>
+#include <string>
 #include <math.h>
 
 DEFINE_int32(refresh_rate, 1000, "Refresh rate in milliseconds.");
@@ -56,85 +63,34 @@ DEFINE_int32(num_samples, 20000,
 DEFINE_double(angular_step, 0.07 * M_PI, "Angular step size.");
 DEFINE_double(fov, 0.1 * M_PI, "Sensor field of view.");
 DEFINE_double(regularizer, 1.0, "Regularization parameter for belief update.");
+DEFINE_bool(pipelined, false,
+            "Plan the next step while updating belief for the current one?");
+DEFINE_double(replan_threshold, 0.5,
+              "Replan if a pipelined measurement is off by more than this.");
+DEFINE_int32(num_candidates, 0,
+             "If positive, plan coarse-to-fine from this many candidates.");
+DEFINE_int32(num_finalists, 10,
+             "Number of candidates refined at full resolution.");
+DEFINE_int32(coarse_level, 2, "Quadtree level used to score candidates.");
+DEFINE_int32(num_headings, 0,
+             "If positive, use this many headings for frontier planning, "
+             "either alone or to seed coarse-to-fine candidates.");
+DEFINE_string(obstacles, "",
+              "Obstacle voxels, as row,col pairs separated by semicolons.");
+DEFINE_string(entropy_estimator, "clipped_plug_in",
+              "Conditional entropy estimator: clipped_plug_in, plug_in, "
+              "miller_madow, jackknife, or chao_shen.");
+DEFINE_string(trace_file, "",
+              "If set, write a Chrome trace of planning, belief updates, and "
+              "rendering here on exit. Requires building with ENABLE_TRACING.");
 
 using namespace radiation;
 
-// Create a globally-defined ExplorerLP.
-ExplorerLP* explorer = NULL;
-
-// Create a globally-defined step counter.
-unsigned int step_count = 0;
-
-// Initialize OpenGL.
-void InitGL() {
-  // Set the "clearing" or background color as black/opaque.
-  glClearColor(0.0, 0.0, 0.0, 1.0);
-
-  // Set up alpha blending.
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glEnable( GL_BLEND );
-}
-
-// Timer callback. Re-render at the specified rate.
-void Timer(int value) {
-  glutPostRedisplay();
-  glutTimerFunc(FLAGS_refresh_rate, Timer, 0);
-}
-
-// Reshape the window to maintain the correct aspect ratio.
-void Reshape(GLsizei width, GLsizei height) {
-  if (height == 0)
-    height = 1;
-
-  // Compute aspect ratio fo the new window.
-  const GLfloat kAspectRatio =
-    static_cast<GLfloat>(width) / static_cast<GLfloat>(height);
-
-  // Set the viewport to cover the new window.
-  glViewport(0, 0, width, height);
-
-  // Set the clipping area to be a square in the positive quadrant.
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  if (width >= height) {
-    // Larger width than height.
-    gluOrtho2D(0.0, static_cast<GLfloat>(FLAGS_num_rows) * kAspectRatio,
-               0.0, static_cast<GLfloat>(FLAGS_num_cols));
-  } else {
-    // Larger height than width.
-    gluOrtho2D(0.0, static_cast<GLfloat>(FLAGS_num_rows),
-               0.0, static_cast<GLfloat>(FLAGS_num_cols) / kAspectRatio);
-  }
-}
-
-// Run a single iteration of the exploration algorithm.
-void SingleIteration() {
-  CHECK_NOTNULL(explorer);
-
-  // Only plan ahead if we haven't exceeded the step count and the entropy
-  // is still large.
-  if ((FLAGS_iterate_forever || step_count < FLAGS_num_iterations) &&
-      (explorer->Entropy() > 1.0)) {
-    // Plan ahead.
-    std::vector<GridPose2D> trajectory;
-    if (!explorer->PlanAhead(trajectory)) {
-      std::cout << "error in exploration" << std::endl << std::flush;
-      VLOG(1) << "Explorer encountered an error. Skipping this iteration.";
-      return;
-    }
-
-    // Take a step.
-    const double entropy = explorer->TakeStep(trajectory);
-    step_count++;
-    std::cout << "Entropy after step " << step_count <<
-      " is " << entropy << "." << std::endl << std::flush;
-  }
-
-  // No matter what, visualize.
-  explorer->Visualize();
-
-  // Swap buffers.
-  glutSwapBuffers();
+// Write the trace file, if requested. GLUT exits from inside its main loop,
+// so this runs at exit.
+void WriteTraceFile() {
+  if (!FLAGS_trace_file.empty() && WriteTrace(FLAGS_trace_file))
+    std::cout << "Wrote trace to " << FLAGS_trace_file << "." << std::endl;
 }
 
 // Set everything up and go!
@@ -145,28 +101,81 @@ int main(int argc, char** argv) {
   // Parse flags.
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  // Set static variables.
-  GridPose2D::SetNumRows(FLAGS_num_rows);
-  GridPose2D::SetNumCols(FLAGS_num_cols);
-  Movement2D::SetAngularStep(FLAGS_angular_step);
-
-  // Set ExplorerLP pointer.
-  explorer = new ExplorerLP(FLAGS_num_rows, FLAGS_num_cols, FLAGS_num_sources,
-                            FLAGS_regularizer, FLAGS_num_steps, FLAGS_fov,
-                            FLAGS_num_samples);
-
-  // Set up OpenGL window.
-  glutInit(&argc, argv);
-  glutInitDisplayMode(GLUT_DOUBLE);
-  glutInitWindowSize(320, 320);
-  glutInitWindowPosition(50, 50);
-  glutCreateWindow("ExplorerLP");
-  glutDisplayFunc(SingleIteration);
-  glutReshapeFunc(Reshape);
-  glutTimerFunc(0, Timer, 0);
-  InitGL();
-  glutMainLoop();
-
-  delete explorer;
+  // Set up grid dimensions and movements.
+  Context2D context(FLAGS_num_rows, FLAGS_num_cols);
+  context.SetAngularStep(FLAGS_angular_step);
+
+  // Add obstacles.
+  std::stringstream obstacles(FLAGS_obstacles);
+  std::string obstacle;
+  while (std::getline(obstacles, obstacle, ';')) {
+    unsigned int ii = 0, jj = 0;
+    char comma = 0;
+    std::stringstream pair(obstacle);
+    CHECK((pair >> ii >> comma >> jj) && comma == ',')
+      << "Could not parse obstacle: " << obstacle;
+    context.SetObstacle(ii, jj);
+  }
+
+  // Parse the entropy estimator.
+  EntropyEstimator estimator;
+  CHECK(ParseEntropyEstimator(FLAGS_entropy_estimator, estimator))
+    << "Unknown entropy estimator: " << FLAGS_entropy_estimator;
+
+  // Write the trace on exit.
+  atexit(WriteTraceFile);
+
+  // Set up the explorer. If running pipelined, 'explorer' points to the
+  // same object as 'async_explorer'.
+  std::unique_ptr<ExplorerLP> explorer;
+  AsyncExplorerLP* async_explorer = NULL;
+  if (FLAGS_pipelined) {
+    async_explorer =
+      new AsyncExplorerLP(context, FLAGS_num_sources,
+                          FLAGS_regularizer, FLAGS_num_steps, FLAGS_fov,
+                          FLAGS_num_samples, FLAGS_replan_threshold);
+    explorer.reset(async_explorer);
+  } else {
+    explorer.reset(new ExplorerLP(context, FLAGS_num_sources,
+                                  FLAGS_regularizer, FLAGS_num_steps,
+                                  FLAGS_fov, FLAGS_num_samples));
+  }
+
+  explorer->SetEntropyEstimator(estimator);
+
+  // Plan ahead and take a step, or, if pipelined, take a step while
+  // planning the next one.
+  ExplorerLP& explorer_ref = *explorer;
+  ExplorerCallbacks callbacks;
+  callbacks.entropy = [&explorer_ref]() { return explorer_ref.Entropy(); };
+  callbacks.visualize = [&explorer_ref]() { explorer_ref.Visualize(); };
+  callbacks.step = [&explorer_ref, async_explorer](double& entropy) {
+    if (async_explorer != NULL)
+      return async_explorer->PipelinedStep(entropy);
+
+    std::vector<GridPose2D> trajectory;
+    bool success = false;
+    if (FLAGS_num_candidates > 0)
+      success = explorer_ref.PlanAheadCoarseToFine(FLAGS_num_candidates,
+                                                   FLAGS_num_finalists,
+                                                   FLAGS_coarse_level,
+                                                   trajectory,
+                                                   FLAGS_num_headings);
+    else if (FLAGS_num_headings > 0)
+      success = explorer_ref.PlanAheadFrontier(FLAGS_num_headings,
+                                               trajectory);
+    else
+      success = explorer_ref.PlanAhead(trajectory);
+    if (!success)
+      return false;
+
+    entropy = explorer_ref.TakeStep(trajectory);
+    return true;
+  };
+
+  // Open the window and run.
+  RunExplorerWindow(&argc, argv, "ExplorerLP",
+                    FLAGS_num_rows, FLAGS_num_cols, FLAGS_refresh_rate,
+                    FLAGS_num_iterations, FLAGS_iterate_forever, callbacks);
   return 0;
 }
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Headless batch runner. Runs many independent ExplorerLP episodes in
+// parallel, sweeping over every combination of the listed configurations,
+// and writes one line of metrics per episode to a CSV file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <episode_runner.h>
+
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <math.h>
+
+DEFINE_int32(num_threads, 0,
+             "Number of worker threads. Zero means one per hardware thread.");
+DEFINE_int32(num_episodes, 100, "Number of episodes per configuration.");
+DEFINE_int32(seed, 0,
+             "Seed of the first episode. Episode i of every configuration "
+             "uses seed + i, so all configurations see the same scenarios.");
+DEFINE_string(num_rows, "5", "Comma-separated numbers of rows in the grid.");
+DEFINE_string(num_cols, "5", "Comma-separated numbers of columns in the grid.");
+DEFINE_string(angular_step, "0.2199114857512855",
+              "Comma-separated angular step sizes, in radians.");
+DEFINE_string(num_sources, "2", "Comma-separated numbers of sources.");
+DEFINE_string(num_steps, "4", "Comma-separated trajectory lengths.");
+DEFINE_string(num_samples, "20000", "Comma-separated sample counts.");
+DEFINE_string(fov, "0.3141592653589793",
+              "Comma-separated sensor fields of view, in radians.");
+DEFINE_string(entropy_estimator, "clipped_plug_in",
+              "Comma-separated conditional entropy estimators: "
+              "clipped_plug_in, plug_in, miller_madow, jackknife, or "
+              "chao_shen.");
+DEFINE_double(regularizer, 1.0, "Regularization parameter for belief update.");
+DEFINE_double(entropy_threshold, 1.0, "Stop an episode below this entropy.");
+DEFINE_int32(max_iterations, 100, "Maximum number of steps per episode.");
+DEFINE_string(results_file, "episodes.csv", "File to write results to.");
+DEFINE_string(cache_directory, "",
+              "Directory of cached conditional entropy vectors, shared by "
+              "all episodes. Empty means no caching.");
+
+using namespace radiation;
+
+// Parse a comma-separated list of numbers.
+template <typename T>
+std::vector<T> ParseList(const std::string& list) {
+  std::vector<T> values;
+  std::stringstream stream(list);
+  std::string token;
+  while (std::getline(stream, token, ',')) {
+    std::stringstream token_stream(token);
+    T value;
+    CHECK(token_stream >> value) << "Could not parse \"" << token << "\".";
+    values.push_back(value);
+  }
+
+  CHECK(!values.empty()) << "Empty list \"" << list << "\".";
+  return values;
+}
+
+// Parse a comma-separated list of entropy estimator names.
+std::vector<EntropyEstimator> ParseEstimators(const std::string& list) {
+  std::vector<EntropyEstimator> estimators;
+  std::stringstream stream(list);
+  std::string token;
+  while (std::getline(stream, token, ',')) {
+    EntropyEstimator estimator;
+    CHECK(ParseEntropyEstimator(token, estimator))
+      << "Unknown entropy estimator \"" << token << "\".";
+    estimators.push_back(estimator);
+  }
+
+  CHECK(!estimators.empty()) << "Empty list \"" << list << "\".";
+  return estimators;
+}
+
+// Expand each configuration into one copy per value of the given field.
+template <typename T>
+std::vector<EpisodeOptions> Sweep(const std::vector<EpisodeOptions>& configs,
+                                  const std::vector<T>& values,
+                                  T EpisodeOptions::* field) {
+  std::vector<EpisodeOptions> expanded;
+  for (const auto& config : configs) {
+    for (const auto& value : values) {
+      EpisodeOptions options = config;
+      options.*field = value;
+      expanded.push_back(options);
+    }
+  }
+
+  return expanded;
+}
+
+// Set everything up and go!
+int main(int argc, char** argv) {
+  // Set up logging.
+  google::InitGoogleLogging(argv[0]);
+
+  // Parse flags.
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Build the list of episodes, sweeping over all configurations.
+  const std::vector<unsigned int> num_rows =
+    ParseList<unsigned int>(FLAGS_num_rows);
+  const std::vector<unsigned int> num_cols =
+    ParseList<unsigned int>(FLAGS_num_cols);
+  const std::vector<double> angular_steps =
+    ParseList<double>(FLAGS_angular_step);
+  const std::vector<unsigned int> num_sources =
+    ParseList<unsigned int>(FLAGS_num_sources);
+  const std::vector<unsigned int> num_steps =
+    ParseList<unsigned int>(FLAGS_num_steps);
+  const std::vector<unsigned int> num_samples =
+    ParseList<unsigned int>(FLAGS_num_samples);
+  const std::vector<double> fovs = ParseList<double>(FLAGS_fov);
+  const std::vector<EntropyEstimator> estimators =
+    ParseEstimators(FLAGS_entropy_estimator);
+
+  // Sweep over all combinations of the listed values.
+  std::vector<EpisodeOptions> configurations(1);
+  configurations[0].regularizer = FLAGS_regularizer;
+  configurations[0].entropy_threshold = FLAGS_entropy_threshold;
+  configurations[0].max_iterations = FLAGS_max_iterations;
+  if (!FLAGS_cache_directory.empty())
+    configurations[0].cache.reset(
+      new ConditionalCache(FLAGS_cache_directory));
+
+  configurations = Sweep(configurations, num_rows, &EpisodeOptions::num_rows);
+  configurations = Sweep(configurations, num_cols, &EpisodeOptions::num_cols);
+  configurations =
+    Sweep(configurations, angular_steps, &EpisodeOptions::angular_step);
+  configurations =
+    Sweep(configurations, num_sources, &EpisodeOptions::num_sources);
+  configurations = Sweep(configurations, num_steps, &EpisodeOptions::num_steps);
+  configurations =
+    Sweep(configurations, num_samples, &EpisodeOptions::num_samples);
+  configurations = Sweep(configurations, fovs, &EpisodeOptions::fov);
+  configurations =
+    Sweep(configurations, estimators, &EpisodeOptions::estimator);
+
+  // Seed by the index within each configuration, so every configuration
+  // is evaluated on the same source layouts and initial poses.
+  std::vector<EpisodeOptions> episodes;
+  for (const auto& configuration : configurations) {
+    for (int ii = 0; ii < FLAGS_num_episodes; ii++) {
+      EpisodeOptions options = configuration;
+      options.seed = FLAGS_seed + ii;
+      episodes.push_back(options);
+    }
+  }
+
+  // Run all episodes, handing them out to workers one at a time.
+  unsigned int num_threads = (FLAGS_num_threads > 0) ?
+    FLAGS_num_threads : std::thread::hardware_concurrency();
+  if (num_threads == 0)
+    num_threads = 1;
+
+  std::cout << "Running " << episodes.size() << " episodes on "
+            << num_threads << " threads." << std::endl;
+
+  // Open the results file first, so that a bad path fails before any work.
+  std::ofstream file(FLAGS_results_file.c_str());
+  CHECK(file.is_open()) << "Could not open " << FLAGS_results_file << ".";
+
+  file << "seed,num_rows,num_cols,angular_step,"
+       << "num_sources,num_steps,num_samples,fov,entropy_estimator,"
+       << "num_iterations,reached_threshold,planning_failed,final_entropy,"
+       << "total_plan_time,mean_plan_time,total_update_time,mean_update_time,"
+       << "total_samples,total_solver_iterations" << std::endl;
+
+  // Workers mark episodes finished; the main thread writes them in order
+  // as soon as they are, flushing each line so that an interrupted run
+  // keeps every episode written so far.
+  std::vector<EpisodeMetrics> results(episodes.size());
+  std::vector<bool> finished(episodes.size(), false);
+  std::mutex mutex;
+  std::condition_variable finished_condition;
+  std::atomic<size_t> next_episode(0);
+  std::vector<std::thread> workers;
+  for (unsigned int ii = 0; ii < num_threads; ii++) {
+    workers.push_back(std::thread([&]() {
+          for (size_t jj = next_episode++; jj < episodes.size();
+               jj = next_episode++) {
+            const EpisodeMetrics metrics = RunEpisode(episodes[jj]);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            results[jj] = metrics;
+            finished[jj] = true;
+            finished_condition.notify_one();
+          }
+        }));
+  }
+
+  for (size_t ii = 0; ii < episodes.size(); ii++) {
+    EpisodeMetrics metrics;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      finished_condition.wait(lock, [&]() { return finished[ii]; });
+      metrics = results[ii];
+    }
+
+    const EpisodeOptions& options = episodes[ii];
+    const double num_iterations =
+      std::max(1.0, static_cast<double>(metrics.num_iterations));
+
+    file << options.seed << "," << options.num_rows << ","
+         << options.num_cols << "," << options.angular_step << ","
+         << options.num_sources << ","
+         << options.num_steps << "," << options.num_samples << ","
+         << options.fov << ","
+         << EntropyEstimatorName(options.estimator) << ","
+         << metrics.num_iterations << ","
+         << metrics.reached_threshold << "," << metrics.planning_failed << ","
+         << metrics.final_entropy << "," << metrics.total_plan_time << ","
+         << metrics.total_plan_time / num_iterations << ","
+         << metrics.total_update_time << ","
+         << metrics.total_update_time / num_iterations << ","
+         << metrics.total_samples << ","
+         << metrics.total_solver_iterations << std::endl;
+  }
+
+  for (auto& worker : workers)
+    worker.join();
+
+  std::cout << "Wrote results to " << FLAGS_results_file << "." << std::endl;
+  return 0;
+}
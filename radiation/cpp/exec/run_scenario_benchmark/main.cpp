@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// End-to-end scenario benchmark. Runs a fixed catalog of seeded ExplorerLP
+// missions, records wall time per phase, samples drawn, solver iterations,
+// and steps taken to reach the entropy threshold, and compares them against
+// a baseline written by an earlier run. Exits with a nonzero status if any
+// scenario regressed by more than the given tolerances.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <episode_runner.h>
+
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+DEFINE_int32(num_repetitions, 3,
+             "Number of times to run each scenario. Times are medians.");
+DEFINE_string(results_file, "scenarios.csv", "File to write results to.");
+DEFINE_string(baseline_file, "",
+              "Results of an earlier run to compare against. Empty means "
+              "no comparison.");
+DEFINE_double(time_tolerance, 0.1,
+              "Largest allowed relative increase in phase wall times.");
+DEFINE_double(min_time_difference, 1e-2,
+              "Ignore increases in phase wall times below this many seconds.");
+DEFINE_double(count_tolerance, 0.0,
+              "Largest allowed relative increase in steps, samples, and "
+              "solver iterations. Episodes are seeded, so these should not "
+              "change unless behavior does.");
+
+using namespace radiation;
+
+// A named mission in the catalog.
+struct Scenario {
+  std::string name;
+  EpisodeOptions options;
+};
+
+// Results of a scenario, with times taken as medians over repetitions.
+typedef std::map<std::string, double> Results;
+
+// Names of the metrics in 'Results', in the order they are written.
+static const char* kMetrics[] = {
+  "num_iterations", "reached_threshold", "final_entropy",
+  "plan_time", "update_time", "total_samples", "total_solver_iterations"
+};
+static const size_t kNumMetrics = sizeof(kMetrics) / sizeof(kMetrics[0]);
+
+// Build a scenario with the parameters that vary across the catalog.
+Scenario MakeScenario(const std::string& name,
+                      unsigned int num_rows, unsigned int num_cols,
+                      unsigned int num_sources, unsigned int num_steps,
+                      unsigned int num_samples, unsigned int seed) {
+  Scenario scenario;
+  scenario.name = name;
+  scenario.options.num_rows = num_rows;
+  scenario.options.num_cols = num_cols;
+  scenario.options.angular_step = 0.2199114857512855;
+  scenario.options.num_sources = num_sources;
+  scenario.options.regularizer = 1.0;
+  scenario.options.num_steps = num_steps;
+  scenario.options.fov = 0.3141592653589793;
+  scenario.options.num_samples = num_samples;
+  scenario.options.estimator = EntropyEstimator::kClippedPlugIn;
+  scenario.options.entropy_threshold = 1.0;
+  scenario.options.max_iterations = 100;
+  scenario.options.seed = seed;
+  return scenario;
+}
+
+// The fixed catalog. Never change an existing entry, since that invalidates
+// every stored baseline; add new entries instead.
+std::vector<Scenario> Catalog() {
+  std::vector<Scenario> catalog;
+  catalog.push_back(MakeScenario("small_1src_h2", 5, 5, 1, 2, 2000, 1));
+  catalog.push_back(MakeScenario("small_2src_h3", 5, 5, 2, 3, 5000, 2));
+  catalog.push_back(MakeScenario("medium_2src_h3", 8, 8, 2, 3, 5000, 3));
+  catalog.push_back(MakeScenario("medium_3src_h4", 8, 8, 3, 4, 10000, 4));
+  catalog.push_back(MakeScenario("large_3src_h3", 12, 12, 3, 3, 10000, 5));
+  return catalog;
+}
+
+// Median of a nonempty list.
+double Median(std::vector<double> values) {
+  CHECK(!values.empty());
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  return (values.size() % 2 == 1) ?
+    values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+}
+
+// Run a scenario 'num_repetitions' times.
+Results RunScenario(const Scenario& scenario, unsigned int num_repetitions) {
+  CHECK(num_repetitions > 0);
+
+  std::vector<double> plan_times, update_times;
+  EpisodeMetrics first;
+  for (unsigned int ii = 0; ii < num_repetitions; ii++) {
+    const EpisodeMetrics metrics = RunEpisode(scenario.options);
+    plan_times.push_back(metrics.total_plan_time);
+    update_times.push_back(metrics.total_update_time);
+
+    if (ii == 0) {
+      first = metrics;
+    } else if (metrics.num_iterations != first.num_iterations ||
+               metrics.total_samples != first.total_samples ||
+               metrics.total_solver_iterations !=
+               first.total_solver_iterations) {
+      LOG(WARNING) << "Scenario " << scenario.name
+                   << " is not reproducible across repetitions.";
+    }
+  }
+
+  Results results;
+  results["num_iterations"] = first.num_iterations;
+  results["reached_threshold"] = first.reached_threshold;
+  results["final_entropy"] = first.final_entropy;
+  results["plan_time"] = Median(plan_times);
+  results["update_time"] = Median(update_times);
+  results["total_samples"] = first.total_samples;
+  results["total_solver_iterations"] = first.total_solver_iterations;
+  return results;
+}
+
+// Read results written by an earlier run, keyed by scenario name.
+std::map<std::string, Results> ReadResults(const std::string& filename) {
+  std::ifstream file(filename.c_str());
+  CHECK(file.is_open()) << "Could not open " << filename << ".";
+
+  std::map<std::string, Results> all_results;
+  std::string line;
+  std::vector<std::string> header;
+  while (std::getline(file, line)) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ','))
+      fields.push_back(field);
+
+    if (header.empty()) {
+      header = fields;
+      CHECK(!header.empty() && header[0] == "scenario")
+        << "Malformed header in " << filename << ".";
+      continue;
+    }
+
+    CHECK(fields.size() == header.size())
+      << "Malformed line \"" << line << "\" in " << filename << ".";
+
+    Results& results = all_results[fields[0]];
+    for (size_t ii = 1; ii < fields.size(); ii++)
+      results[header[ii]] = atof(fields[ii].c_str());
+  }
+
+  return all_results;
+}
+
+// Compare results against a baseline, and print one line per regression.
+// Return the number of regressions. Metrics absent from the baseline are
+// skipped, so old baselines stay usable as metrics are added.
+unsigned int Compare(const std::string& name, const Results& results,
+                     const Results& baseline) {
+  unsigned int num_regressions = 0;
+  for (const auto& entry : results) {
+    const std::string& metric = entry.first;
+    const double current = entry.second;
+    const auto iter = baseline.find(metric);
+    if (iter == baseline.end())
+      continue;
+
+    const double previous = iter->second;
+    bool regressed = false;
+    if (metric == "plan_time" || metric == "update_time") {
+      regressed = current > previous * (1.0 + FLAGS_time_tolerance) &&
+        current - previous > FLAGS_min_time_difference;
+    } else if (metric == "reached_threshold") {
+      regressed = previous > 0.5 && current < 0.5;
+    } else if (metric != "final_entropy") {
+      regressed = current > previous * (1.0 + FLAGS_count_tolerance);
+    }
+
+    if (regressed) {
+      std::cout << "REGRESSION " << name << " " << metric << ": "
+                << previous << " -> " << current << std::endl;
+      num_regressions++;
+    }
+  }
+
+  return num_regressions;
+}
+
+// Set everything up and go!
+int main(int argc, char** argv) {
+  // Set up logging.
+  google::InitGoogleLogging(argv[0]);
+
+  // Parse flags.
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Load the baseline before running, so a bad path fails fast.
+  std::map<std::string, Results> baseline;
+  if (!FLAGS_baseline_file.empty())
+    baseline = ReadResults(FLAGS_baseline_file);
+
+  // Run every scenario, one at a time so that wall times are not skewed by
+  // competing threads.
+  const std::vector<Scenario> catalog = Catalog();
+  std::vector<Results> all_results;
+  for (const auto& scenario : catalog) {
+    all_results.push_back(RunScenario(scenario, FLAGS_num_repetitions));
+
+    const Results& results = all_results.back();
+    std::cout << scenario.name << ": "
+              << results.at("num_iterations") << " steps, "
+              << results.at("plan_time") << " s planning, "
+              << results.at("update_time") << " s updating, "
+              << results.at("total_samples") << " samples, "
+              << results.at("total_solver_iterations")
+              << " solver iterations." << std::endl;
+  }
+
+  // Write results to disk, in a form that can serve as the next baseline.
+  std::ofstream file(FLAGS_results_file.c_str());
+  CHECK(file.is_open()) << "Could not open " << FLAGS_results_file << ".";
+
+  file << "scenario";
+  for (size_t ii = 0; ii < kNumMetrics; ii++)
+    file << "," << kMetrics[ii];
+  file << std::endl;
+
+  file.precision(17);
+  for (size_t ii = 0; ii < catalog.size(); ii++) {
+    file << catalog[ii].name;
+    for (size_t jj = 0; jj < kNumMetrics; jj++)
+      file << "," << all_results[ii].at(kMetrics[jj]);
+    file << std::endl;
+  }
+
+  std::cout << "Wrote results to " << FLAGS_results_file << "." << std::endl;
+
+  // Compare against the baseline.
+  if (FLAGS_baseline_file.empty())
+    return 0;
+
+  unsigned int num_regressions = 0;
+  for (size_t ii = 0; ii < catalog.size(); ii++) {
+    const auto iter = baseline.find(catalog[ii].name);
+    if (iter == baseline.end()) {
+      std::cout << "Scenario " << catalog[ii].name
+                << " is not in the baseline." << std::endl;
+      continue;
+    }
+
+    num_regressions += Compare(catalog[ii].name, all_results[ii],
+                               iter->second);
+  }
+
+  std::cout << num_regressions << " regressions against "
+            << FLAGS_baseline_file << "." << std::endl;
+  return (num_regressions > 0) ? 1 : 0;
+}
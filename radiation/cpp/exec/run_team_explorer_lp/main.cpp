@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+#include <team_explorer_lp.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <entropy_estimators.h>
+#include <explorer_window.h>
+
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+#include <vector>
+#include <math.h>
+
+DEFINE_int32(refresh_rate, 1000, "Refresh rate in milliseconds.");
+DEFINE_bool(iterate_forever, false, "Iterate ad inifinitum?");
+DEFINE_int32(num_iterations, 10, "Number of iterations to run exploration.");
+DEFINE_int32(num_robots, 3, "Number of robots in the team.");
+DEFINE_int32(num_rows, 5, "Number of rows in the grid.");
+DEFINE_int32(num_cols, 5, "Number of columns in the grid.");
+DEFINE_int32(num_sources, 2, "Number of sources on the grid.");
+DEFINE_int32(num_steps, 4, "Number of steps in each trajectory.");
+DEFINE_int32(num_samples, 20000,
+              "Number of samples used to approximate distributions.");
+DEFINE_int32(num_candidates, 20,
+             "Number of top trajectories per robot to check for overlap.");
+DEFINE_double(angular_step, 0.07 * M_PI, "Angular step size.");
+DEFINE_double(fov, 0.1 * M_PI, "Sensor field of view.");
+DEFINE_double(regularizer, 1.0, "Regularization parameter for belief update.");
+DEFINE_string(entropy_estimator, "clipped_plug_in",
+              "Conditional entropy estimator: clipped_plug_in, plug_in, "
+              "miller_madow, jackknife, or chao_shen.");
+
+using namespace radiation;
+
+// Set everything up and go!
+int main(int argc, char** argv) {
+  // Set up logging.
+  google::InitGoogleLogging(argv[0]);
+
+  // Parse flags.
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Set up grid dimensions and movements.
+  Context2D context(FLAGS_num_rows, FLAGS_num_cols);
+  context.SetAngularStep(FLAGS_angular_step);
+
+  // Set up the explorer.
+  TeamExplorerLP explorer(context, FLAGS_num_robots, FLAGS_num_sources,
+                          FLAGS_regularizer, FLAGS_num_steps, FLAGS_fov,
+                          FLAGS_num_samples, FLAGS_num_candidates);
+
+  EntropyEstimator estimator;
+  CHECK(ParseEntropyEstimator(FLAGS_entropy_estimator, estimator))
+    << "Unknown entropy estimator: " << FLAGS_entropy_estimator;
+  explorer.SetEntropyEstimator(estimator);
+
+  // Plan ahead for all robots, and take a step with every robot.
+  ExplorerCallbacks callbacks;
+  callbacks.entropy = [&explorer]() { return explorer.Entropy(); };
+  callbacks.visualize = [&explorer]() { explorer.Visualize(); };
+  callbacks.step = [&explorer](double& entropy) {
+    std::vector< std::vector<GridPose2D> > trajectories;
+    if (!explorer.PlanAhead(trajectories))
+      return false;
+
+    entropy = explorer.TakeStep(trajectories);
+    return true;
+  };
+
+  // Open the window and run.
+  RunExplorerWindow(&argc, argv, "TeamExplorerLP",
+                    FLAGS_num_rows, FLAGS_num_cols, FLAGS_refresh_rate,
+                    FLAGS_num_iterations, FLAGS_iterate_forever, callbacks);
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Pipelined exploration on a 2D grid. Behaves like ExplorerLP, but while the
+// belief update for the current step is being solved, the next trajectory is
+// planned speculatively on a worker thread from the predicted post-step pose,
+// using a snapshot of the pre-update belief. Once the real measurement arrives
+// the speculative plan is kept if the measurement was close to what the
+// snapshot belief predicted, and otherwise replanned from the updated belief.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_ASYNC_EXPLORER_LP_H
+#define RADIATION_ASYNC_EXPLORER_LP_H
+
+#include <explorer_lp.h>
+
+#include <vector>
+
+namespace radiation {
+
+class AsyncExplorerLP : public ExplorerLP {
+ public:
+  AsyncExplorerLP(const Context2D& context,
+                  unsigned int num_sources, double regularizer,
+                  unsigned int num_steps, double fov,
+                  unsigned int num_samples, double replan_threshold);
+  ~AsyncExplorerLP();
+
+  // Construct with an explicit random seed, for reproducible episodes.
+  AsyncExplorerLP(const Context2D& context,
+                  unsigned int num_sources, double regularizer,
+                  unsigned int num_steps, double fov,
+                  unsigned int num_samples, double replan_threshold,
+                  unsigned int seed);
+
+  // Take a step along the current plan while planning the next one in the
+  // background. Returns false if no valid plan could be found, in which case
+  // no step is taken. Otherwise 'entropy' is set to the map entropy after the
+  // step.
+  bool PipelinedStep(double& entropy);
+
+  // Number of speculative plans that were kept/discarded.
+  unsigned int GetNumAccepted() const;
+  unsigned int GetNumReplanned() const;
+
+  // Absolute difference between the real and expected measurements at the
+  // last pipelined step, or zero if there has not been one.
+  double GetLastDivergence() const;
+
+ private:
+  // Current plan. Empty if we have not planned yet or the last plan failed.
+  std::vector<GridPose2D> plan_;
+
+  // If the actual measurement differs from the expected measurement (under
+  // the snapshot belief) by more than this, replan from the updated belief.
+  const double replan_threshold_;
+
+  // Bookkeeping.
+  unsigned int num_accepted_;
+  unsigned int num_replanned_;
+  double last_divergence_;
+}; // class AsyncExplorerLP
+
+} // namespace radiation
+
+#endif
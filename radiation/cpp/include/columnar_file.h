@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a simple binary columnar file format for simulation outputs, and a
+// class which creates and opens such files through mmap. Each file holds
+// any number of named columns, each a 2D array of one numeric type stored
+// row-major, plus a list of string key/value parameters describing how the
+// data was generated. python/columnar.py reads and writes the same format
+// with NumPy, using np.memmap.
+//
+// Layout, all integers little-endian:
+//   [0, 64)     header: magic "RADCOL01", uint32 version, uint32 number
+//               of columns, uint64 offset and uint64 size of parameters,
+//               zero padding
+//   [64, ...)   one 64-byte descriptor per column: char name[32] (NUL
+//               padded), uint32 type, uint32 zero, uint64 number of rows,
+//               uint64 width (values per row), uint64 offset of data
+//   ...         parameters as "key=value\n" lines
+//   ...         column data, each starting on a 64-byte boundary
+//
+// New files are sized up front and mapped read-write, so callers (or many
+// threads) fill columns in place, and the operating system writes pages
+// back as it sees fit. Opened files are mapped read-only, so loading costs
+// nothing until data is touched.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_COLUMNAR_FILE_H
+#define RADIATION_COLUMNAR_FILE_H
+
+#include <glog/logging.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace radiation {
+
+// Element types. Values are stored in files, so never renumber them.
+enum class ColumnType : uint32_t {
+  kUInt8 = 1, kUInt16 = 2, kUInt32 = 3, kUInt64 = 4,
+  kInt32 = 5, kInt64 = 6, kFloat32 = 7, kFloat64 = 8
+};
+
+// Size of one element of the given type, in bytes.
+size_t ColumnTypeSize(ColumnType type);
+
+// Element type for each supported C++ type.
+template <typename T> struct ColumnTypeOf;
+template <> struct ColumnTypeOf<uint8_t> {
+  static const ColumnType kType = ColumnType::kUInt8; };
+template <> struct ColumnTypeOf<uint16_t> {
+  static const ColumnType kType = ColumnType::kUInt16; };
+template <> struct ColumnTypeOf<uint32_t> {
+  static const ColumnType kType = ColumnType::kUInt32; };
+template <> struct ColumnTypeOf<uint64_t> {
+  static const ColumnType kType = ColumnType::kUInt64; };
+template <> struct ColumnTypeOf<int32_t> {
+  static const ColumnType kType = ColumnType::kInt32; };
+template <> struct ColumnTypeOf<int64_t> {
+  static const ColumnType kType = ColumnType::kInt64; };
+template <> struct ColumnTypeOf<float> {
+  static const ColumnType kType = ColumnType::kFloat32; };
+template <> struct ColumnTypeOf<double> {
+  static const ColumnType kType = ColumnType::kFloat64; };
+
+// Name, type, and shape of a column.
+struct ColumnSpec {
+  std::string name;
+  ColumnType type;
+  uint64_t num_rows;
+  uint64_t width;
+};
+
+class ColumnarFile {
+ public:
+  ColumnarFile();
+  ~ColumnarFile();
+
+  // Not copyable, since each instance owns its mapping.
+  ColumnarFile(const ColumnarFile&) = delete;
+  ColumnarFile& operator=(const ColumnarFile&) = delete;
+
+  // Create a file with the given columns and parameters, and map it
+  // read-write. Column data starts out zeroed. Returns false on I/O errors.
+  bool Create(const std::string& path, const std::vector<ColumnSpec>& columns,
+              const std::map<std::string, std::string>& parameters);
+
+  // Open an existing file and map it read-only. Returns false if the file
+  // cannot be read or is not a valid columnar file.
+  bool Open(const std::string& path);
+
+  // Unmap the file, flushing any changes. Called by the destructor.
+  void Close();
+
+  // Getters.
+  bool IsOpen() const { return data_ != NULL; }
+  const std::vector<ColumnSpec>& GetColumns() const { return columns_; }
+  const std::map<std::string, std::string>& GetParameters() const {
+    return parameters_;
+  }
+
+  // Find a column by name. Returns NULL if there is no such column.
+  const ColumnSpec* FindColumn(const std::string& name) const;
+
+  // Typed access to a column's data, in row-major order. CHECKs that the
+  // column exists and has the requested type, and for mutable access that
+  // the file was created rather than opened.
+  template <typename T>
+  const T* GetData(const std::string& name) const {
+    return static_cast<const T*>(
+      ColumnData(name, ColumnTypeOf<T>::kType));
+  }
+
+  template <typename T>
+  T* GetMutableData(const std::string& name) {
+    CHECK(writable_) << "File was opened read-only.";
+    return static_cast<T*>(ColumnData(name, ColumnTypeOf<T>::kType));
+  }
+
+ private:
+  // Pointer to a column's data, after checking its type.
+  void* ColumnData(const std::string& name, ColumnType type) const;
+
+  // Columns, offsets of their data, and parameters.
+  std::vector<ColumnSpec> columns_;
+  std::vector<uint64_t> offsets_;
+  std::map<std::string, std::string> parameters_;
+
+  // Mapped file, its size, and whether it is writable.
+  char* data_;
+  size_t size_;
+  bool writable_;
+}; // class ColumnarFile
+
+} // namespace radiation
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a persistent, on-disk cache of sampled conditional entropy vectors
+// [h_{Z|X}] and their trajectory ids. Entries are keyed by a 64-bit FNV-1a
+// hash of everything that determines the sampled vector: the grid, movement
+// set, and obstacles of the context, the number of sources, steps, and
+// samples, the sensor field of view, the starting pose, the estimator, and
+// the belief, quantized to a fixed step so that beliefs equal up to
+// round-off share an entry. The sampler is then seeded from the key itself
+// (see SamplerSeed()), so a hit returns exactly what sampling would have
+// produced, whichever episode stored it. Episodes with different seeds
+// share entries whenever they reach the same configuration and belief, and
+// a seeded episode plays out the same with a warm or a cold cache.
+//
+// Only [h_{Z|X}] is cached, which is all that planning needs. The full
+// conditional distributions p(Z|X) and p(Z|M) are not; see
+// conditional_generator.h for those.
+//
+// Each entry is a columnar file (see columnar_file.h) named by its key, read
+// through a read-only mapping. Entries are written to a temporary file and
+// renamed into place, so readers in any number of threads or processes only
+// ever see complete entries, and concurrent writers of the same key simply
+// replace each other's (equally valid) results.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_CONDITIONAL_CACHE_H
+#define RADIATION_CONDITIONAL_CACHE_H
+
+#include <grid_map_2d.h>
+#include <grid_pose_2d.h>
+#include <encoding.h>
+#include <entropy_estimators.h>
+
+#include <Eigen/Core>
+#include <string>
+#include <vector>
+
+namespace radiation {
+
+class ConditionalCache {
+ public:
+  // Entries live in the given directory, which is created if necessary.
+  // Belief values are quantized to multiples of 'quantum' for hashing.
+  explicit ConditionalCache(const std::string& directory,
+                            double quantum = 1e-9);
+  ~ConditionalCache();
+
+  // Key for the conditionals sampled from the given map and pose, and
+  // estimated with the given estimator.
+  Id64 Key(const GridMap2D& map, unsigned int num_samples,
+           unsigned int num_steps, const GridPose2D& pose,
+           double sensor_fov,
+           EntropyEstimator estimator =
+           EntropyEstimator::kClippedPlugIn) const;
+
+  // Seed with which to sample the entry for the given key.
+  static unsigned int SamplerSeed(Id64 key);
+
+  // Look up an entry. Returns false if there is none.
+  bool Lookup(Id64 key, Eigen::VectorXd& hzx,
+              std::vector<Id64>& trajectory_ids) const;
+
+  // Store an entry, replacing any existing one. Returns false on I/O errors.
+  bool Store(Id64 key, const Eigen::VectorXd& hzx,
+             const std::vector<Id64>& trajectory_ids) const;
+
+  // Getters.
+  const std::string& GetDirectory() const { return directory_; }
+
+ private:
+  // Path of the entry with the given key.
+  std::string EntryPath(Id64 key) const;
+
+  // Directory holding entries, and quantization step for beliefs.
+  const std::string directory_;
+  const double quantum_;
+}; // class ConditionalCache
+
+} // namespace radiation
+
+#endif
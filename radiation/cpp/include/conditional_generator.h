@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Generates the conditionals used by the LP formulation, as in
+// python/problem.py, by starting from a given pose, sampling random legal
+// trajectories and random maps from the current belief, and recording the
+// measurements along each trajectory:
+//   [P_{Z|X}], whose (i, j)-entry is the frequency of measurement sequence i
+//              given trajectory j, so that every column sums to unity;
+//   [h_{M|Z}], whose i-entry is the entropy of the map given measurement
+//              sequence i.
+//
+// Joint counts are kept in hash tables keyed by (trajectory, measurement) and
+// (measurement, map) pairs, so memory grows with the number of distinct pairs
+// actually observed rather than with the number of possible maps. Only
+// observed trajectories and measurement sequences get a column or row, and
+// they are listed in increasing id order. Samples are split across threads,
+// each drawing from its own snapshot of the belief, and the tables are merged
+// at the end.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_CONDITIONAL_GENERATOR_H
+#define RADIATION_CONDITIONAL_GENERATOR_H
+
+#include <grid_map_2d.h>
+#include <grid_pose_2d.h>
+#include <encoding.h>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <stddef.h>
+#include <vector>
+
+namespace radiation {
+
+// Sampled conditionals.
+struct Conditionals {
+  // Ids of the observed trajectories and measurement sequences, labeling the
+  // columns and rows of 'pzx' respectively.
+  std::vector<Id64> trajectory_ids;
+  std::vector<unsigned int> measurement_ids;
+
+  // [P_{Z|X}] and [h_{M|Z}], with one entry of 'hzm' per row of 'pzx'.
+  Eigen::SparseMatrix<double> pzx;
+  Eigen::VectorXd hzm;
+
+  // Number of valid samples, and of distinct (measurement, map) pairs.
+  size_t num_samples;
+  size_t num_joint_entries;
+};
+
+// Generate conditionals from 'num_samples' samples of 'num_steps'-step
+// trajectories starting at the given pose, with maps drawn from the given
+// map's belief. Uses 'num_threads' threads, or one per hardware thread if
+// zero. Results depend only on 'seed' and the number of threads.
+void GenerateConditionals(const GridMap2D& map, unsigned int num_samples,
+                          unsigned int num_steps, const GridPose2D& pose,
+                          double sensor_fov, unsigned int num_threads,
+                          unsigned int seed, Conditionals& conditionals);
+
+} // namespace radiation
+
+#endif
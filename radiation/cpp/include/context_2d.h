@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines the configuration shared by poses, movements, maps, and encoders on
+// a 2D grid: the grid dimensions, the set of allowed movements, and which
+// voxels are obstacles. Obstacles block both movement and sensing. Objects
+// that depend on a context keep a reference to it, so the context must
+// outlive them. Contexts are not modified by anything that uses them, so one
+// context may be shared freely across threads once it has been set up.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_CONTEXT_2D_H
+#define RADIATION_CONTEXT_2D_H
+
+#include <vector>
+
+namespace radiation {
+
+class Context2D {
+public:
+  // Construct with the default movement set, i.e. dx, dy, da each in
+  // {-1, 0, 1}, with an angular step of 0.5 radians.
+  Context2D(unsigned int num_rows, unsigned int num_cols);
+  ~Context2D();
+
+  // Setters. These should only be called before the context is shared.
+  void SetDeltaXs(const std::vector<double>& delta_xs);
+  void SetDeltaYs(const std::vector<double>& delta_ys);
+  void SetDeltaAngles(const std::vector<double>& delta_as);
+  void SetAngularStep(double angular_step);
+  void SetObstacle(unsigned int ii, unsigned int jj, bool obstacle = true);
+
+  // Getters.
+  unsigned int GetNumRows() const;
+  unsigned int GetNumCols() const;
+
+  unsigned int GetNumDeltaXs() const;
+  unsigned int GetNumDeltaYs() const;
+  unsigned int GetNumDeltaAngles() const;
+  double GetAngularStep() const;
+
+  // Look up the movement corresponding to each index. The real change in
+  // angle is angular_step_ * delta_as_[ii].
+  double GetDeltaX(unsigned int ii) const;
+  double GetDeltaY(unsigned int ii) const;
+  double GetDeltaAngle(unsigned int ii) const;
+
+  // Obstacles. All voxels are free unless marked otherwise.
+  bool IsObstacle(unsigned int ii, unsigned int jj) const;
+  bool HasObstacles() const;
+
+  // Check whether the segment from (x, y) to the center of voxel (ii, jj)
+  // is clear, i.e. it does not pass through any obstacle other than the
+  // voxels at either end. Traverses the voxels along the segment as in
+  // Amanatides and Woo, "A Fast Voxel Traversal Algorithm for Ray Tracing".
+  bool LineOfSight(double x, double y, unsigned int ii, unsigned int jj) const;
+
+private:
+  // Grid dimensions.
+  unsigned int num_rows_;
+  unsigned int num_cols_;
+
+  // Sets of dx, dy, da, and the angular step size.
+  std::vector<double> delta_xs_;
+  std::vector<double> delta_ys_;
+  std::vector<double> delta_as_;
+  double angular_step_;
+
+  // Obstacle flag for each voxel, in column-major order, and their count.
+  std::vector<bool> obstacles_;
+  unsigned int num_obstacles_;
+}; // class Context2D
+
+} // namespace radiation
+
+#endif
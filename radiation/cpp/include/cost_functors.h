@@ -56,6 +56,7 @@
 #include <Eigen/Core>
 #include <glog/logging.h>
 #include <vector>
+#include <utility>
 #include <math.h>
 
 namespace radiation {
@@ -119,12 +120,14 @@ struct BeliefError {
 struct BeliefRegularization {
   // Inputs: true number of sources and regularization tradeoff parameter.
   // Optimization variables are the probability that each voxel contains a
-  // source.
+  // source. If some voxels are held fixed outside the optimization, their
+  // total belief should be subtracted from the number of sources, which may
+  // then be fractional.
   const unsigned int num_parameters_;
-  const unsigned int num_sources_;
+  const double num_sources_;
   const double regularizer_;
 
-  BeliefRegularization(unsigned int num_parameters, int num_sources,
+  BeliefRegularization(unsigned int num_parameters, double num_sources,
                        double regularizer)
     : num_parameters_(num_parameters),
       num_sources_(num_sources),
@@ -148,7 +151,7 @@ struct BeliefRegularization {
   // Factory method.
   static ceres::CostFunction* Create(unsigned int num_rows,
                                      unsigned int num_cols,
-                                     unsigned int num_sources,
+                                     double num_sources,
                                      double regularizer) {
     // Only a single residual.
     const int kNumResiduals = 1;
@@ -171,6 +174,121 @@ struct BeliefRegularization {
   }
 };  // struct BeliefRegularization
 
+// Tiled belief error is the analogue of BeliefError for a belief state which
+// is split into square tiles, each of which is a separate parameter block.
+// Only the tiles containing voxels in view are passed to the functor.
+struct TiledBeliefError {
+  // Inputs: for each tile in view, the list of (column-major) offsets of
+  // voxels in view within that tile, and the measurement.
+  const std::vector< std::vector<unsigned int> >* offsets_;
+  const unsigned int measurement_;
+
+  TiledBeliefError(const std::vector< std::vector<unsigned int> >* offsets,
+                   unsigned int measurement)
+    : offsets_(offsets), measurement_(measurement) {
+    CHECK_NOTNULL(offsets);
+  }
+
+  template <typename T>
+  bool operator()(T const* const* belief, T* expected_error) const {
+    *expected_error = -static_cast<T>(measurement_);
+
+    for (size_t ii = 0; ii < offsets_->size(); ii++) {
+      for (const auto& offset : (*offsets_)[ii])
+        *expected_error += belief[ii][offset];
+    }
+
+    return true;
+  }
+
+  // Factory method.
+  static ceres::CostFunction* Create(
+    unsigned int tile_size,
+    const std::vector< std::vector<unsigned int> >* offsets,
+    unsigned int measurement) {
+    // Only a single residual.
+    const int kNumResiduals = 1;
+
+    // One parameter block per tile in view.
+    const int kNumParameters = static_cast<int>(tile_size * tile_size);
+
+    // Stride. Number of derivatives to calculate. See below for details:
+    // http://ceres-solver.org/nnls_modeling.html#dynamicautodiffcostfunction
+    const int kStride = 4;
+
+    ceres::DynamicAutoDiffCostFunction<TiledBeliefError, kStride>* cost =
+      new ceres::DynamicAutoDiffCostFunction<TiledBeliefError, kStride>(
+        new TiledBeliefError(offsets, measurement));
+    for (size_t ii = 0; ii < offsets->size(); ii++)
+      cost->AddParameterBlock(kNumParameters);
+    cost->SetNumResiduals(kNumResiduals);
+    return cost;
+  }
+};  // struct TiledBeliefError
+
+// Tiled belief regularization is the analogue of BeliefRegularization for a
+// tiled belief state. Voxels in unallocated tiles are held at a constant
+// prior, so their total is folded into the target sum.
+struct TiledBeliefRegularization {
+  // Inputs: tile size, number of rows and columns of each tile which lie
+  // within the map bounds, target sum over all tiles, and regularization
+  // tradeoff parameter.
+  const unsigned int tile_size_;
+  const std::vector< std::pair<unsigned int, unsigned int> > extents_;
+  const double target_;
+  const double regularizer_;
+
+  TiledBeliefRegularization(
+    unsigned int tile_size,
+    const std::vector< std::pair<unsigned int, unsigned int> >& extents,
+    double target, double regularizer)
+    : tile_size_(tile_size),
+      extents_(extents),
+      target_(target),
+      regularizer_(sqrt(regularizer)) {}
+
+  template <typename T>
+  bool operator()(T const* const* belief, T* expected_error) const {
+    *expected_error = -static_cast<T>(target_);
+
+    for (size_t ii = 0; ii < extents_.size(); ii++) {
+      for (size_t jj = 0; jj < extents_[ii].second; jj++)
+        for (size_t kk = 0; kk < extents_[ii].first; kk++)
+          *expected_error += belief[ii][kk + jj * tile_size_];
+    }
+
+    *expected_error *= static_cast<T>(regularizer_);
+
+    return true;
+  }
+
+  // Factory method.
+  static ceres::CostFunction* Create(
+    unsigned int tile_size,
+    const std::vector< std::pair<unsigned int, unsigned int> >& extents,
+    double target, double regularizer) {
+    // Only a single residual.
+    const int kNumResiduals = 1;
+
+    // One parameter block per allocated tile.
+    const int kNumParameters = static_cast<int>(tile_size * tile_size);
+
+    // Stride. Number of derivatives to calculate. See below for details:
+    // http://ceres-solver.org/nnls_modeling.html#dynamicautodiffcostfunction
+    const int kStride = 4;
+
+    ceres::DynamicAutoDiffCostFunction<TiledBeliefRegularization, kStride>*
+      cost = new ceres::DynamicAutoDiffCostFunction<TiledBeliefRegularization,
+                                                   kStride>(
+        new TiledBeliefRegularization(tile_size, extents,
+                                      target, regularizer));
+    for (size_t ii = 0; ii < extents.size(); ii++)
+      cost->AddParameterBlock(kNumParameters);
+    cost->SetNumResiduals(kNumResiduals);
+    return cost;
+  }
+};  // struct TiledBeliefRegularization
+
 }  // namespace radiation
 
 #endif
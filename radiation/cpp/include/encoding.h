@@ -38,23 +38,146 @@
 //
 // Encode and decode measurements, trajectories, and maps (list of sources).
 //
+// Each is a sequence of digits, e.g. one movement index per step, packed into
+// an integer id in mixed radix, with the first digit least significant. Ids
+// come in three widths: unsigned int, Id64, and Id128. Wide encoders return
+// false rather than silently wrapping when an id does not fit, and the
+// unsigned int encoders CHECK that it fits. For sequences too long for any
+// fixed width, EncodingKey packs digits into as many 64-bit words as needed
+// and carries a precomputed hash, so it can key hash tables directly.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef RADIATION_ENCODING_H
 #define RADIATION_ENCODING_H
 
 #include "source_2d.h"
+#include "context_2d.h"
 #include "grid_pose_2d.h"
-#include "grid_map_2d.h"
 #include "movement_2d.h"
+#include "context_3d.h"
+#include "grid_pose_3d.h"
+#include "movement_3d.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
 
 namespace radiation {
 
-  // Encode/decode trajectories.
-  unsigned int EncodeTrajectory(const std::vector<Movement2D>& movements);
+  // Wide id types. Id128 relies on the GCC/Clang __int128 extension.
+  typedef uint64_t Id64;
+  typedef unsigned __int128 Id128;
+
+  // Pack digits, each less than 'base', into an id. Return false if the id
+  // does not fit in IdType. Decoding pads with zeros up to 'num_digits'.
+  // Instantiated for unsigned int, Id64, and Id128.
+  template <typename IdType>
+  bool EncodeDigits(const std::vector<unsigned int>& digits,
+                    unsigned int base, IdType& id);
+  template <typename IdType>
+  void DecodeDigits(IdType id, unsigned int base, unsigned int num_digits,
+                    std::vector<unsigned int>& digits);
+
+  // Variable-length key holding a sequence of digits in a fixed base.
+  class EncodingKey {
+  public:
+    EncodingKey();
+    EncodingKey(const std::vector<unsigned int>& digits, unsigned int base);
+    ~EncodingKey();
+
+    // Getters.
+    unsigned int GetBase() const;
+    unsigned int GetNumDigits() const;
+    size_t GetHash() const;
+
+    // Recover the digits.
+    void GetDigits(std::vector<unsigned int>& digits) const;
+
+    // Comparison, so keys work in both ordered and unordered containers.
+    bool operator==(const EncodingKey& other) const;
+    bool operator!=(const EncodingKey& other) const;
+    bool operator<(const EncodingKey& other) const;
+
+  private:
+    // Base, number of digits, and how many digits are packed in each word.
+    unsigned int base_;
+    unsigned int num_digits_;
+    unsigned int digits_per_word_;
+
+    // Packed digits, and a hash of the above.
+    std::vector<Id64> words_;
+    size_t hash_;
+  }; // class EncodingKey
+
+  // Hash functor for unordered containers.
+  struct EncodingKeyHash {
+    size_t operator()(const EncodingKey& key) const { return key.GetHash(); }
+  }; // struct EncodingKeyHash
+
+  // Base of trajectory ids, i.e. the number of distinct movements, and the
+  // digit for a single movement.
+  unsigned int TrajectoryBase(const Context2D& context);
+  unsigned int TrajectoryBase(const Context3D& context);
+  unsigned int MovementDigit(const Movement2D& movement,
+                             const Context2D& context);
+  unsigned int MovementDigit(const Movement3D& movement,
+                             const Context3D& context);
+
+  // Encode/decode trajectories. Movements are decoded using the context of
+  // the initial pose.
+  unsigned int EncodeTrajectory(const std::vector<Movement2D>& movements,
+                                const Context2D& context);
+  void DecodeTrajectory(unsigned int id, unsigned int num_steps,
+                        const GridPose2D& initial_pose,
+                        std::vector<GridPose2D>& trajectory);
+
+  // Encode/decode trajectories on a 3D grid.
+  unsigned int EncodeTrajectory(const std::vector<Movement3D>& movements,
+                                const Context3D& context);
   void DecodeTrajectory(unsigned int id, unsigned int num_steps,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory);
+
+  // Wide and variable-length trajectory ids.
+  template <typename IdType>
+  bool EncodeTrajectory(const std::vector<Movement2D>& movements,
+                        const Context2D& context, IdType& id);
+  template <typename IdType>
+  bool EncodeTrajectory(const std::vector<Movement3D>& movements,
+                        const Context3D& context, IdType& id);
+  template <typename IdType>
+  void DecodeTrajectory(IdType id, unsigned int num_steps,
+                        const GridPose2D& initial_pose,
+                        std::vector<GridPose2D>& trajectory);
+  template <typename IdType>
+  void DecodeTrajectory(IdType id, unsigned int num_steps,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory);
+
+  // Decode a batch of trajectory ids, all from the same initial pose, using
+  // RadixCodec.
+  template <typename IdType>
+  void DecodeTrajectories(const std::vector<IdType>& ids,
+                          unsigned int num_steps,
+                          const GridPose2D& initial_pose,
+                          std::vector< std::vector<GridPose2D> >& trajectories);
+  template <typename IdType>
+  void DecodeTrajectories(const std::vector<IdType>& ids,
+                          unsigned int num_steps,
+                          const GridPose3D& initial_pose,
+                          std::vector< std::vector<GridPose3D> >& trajectories);
+
+  EncodingKey EncodeTrajectoryKey(const std::vector<Movement2D>& movements,
+                                  const Context2D& context);
+  EncodingKey EncodeTrajectoryKey(const std::vector<Movement3D>& movements,
+                                  const Context3D& context);
+  void DecodeTrajectory(const EncodingKey& key,
                         const GridPose2D& initial_pose,
                         std::vector<GridPose2D>& trajectory);
+  void DecodeTrajectory(const EncodingKey& key,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory);
 
   // Encode/decode measurements.
   unsigned int EncodeMeasurements(const std::vector<unsigned int>& measurements,
@@ -63,12 +186,38 @@ namespace radiation {
                           unsigned int num_measurements,
                           std::vector<unsigned int>& measurements);
 
+  // Wide and variable-length measurement ids.
+  template <typename IdType>
+  bool EncodeMeasurements(const std::vector<unsigned int>& measurements,
+                          unsigned int max_measurement, IdType& id);
+  template <typename IdType>
+  void DecodeMeasurements(IdType id, unsigned int max_measurement,
+                          unsigned int num_measurements,
+                          std::vector<unsigned int>& measurements);
+
+  EncodingKey EncodeMeasurementsKey(
+    const std::vector<unsigned int>& measurements,
+    unsigned int max_measurement);
+
   // Encode/decode list of sources (map).
   unsigned int EncodeMap(const std::vector<Source2D>& sources,
                          unsigned int num_rows, unsigned int num_cols);
   void DecodeMap(unsigned int id, unsigned int num_rows, unsigned int num_cols,
                  unsigned int num_sources, std::vector<Source2D>& sources);
 
+  // Wide and variable-length map ids.
+  template <typename IdType>
+  bool EncodeMap(const std::vector<Source2D>& sources,
+                 unsigned int num_rows, unsigned int num_cols, IdType& id);
+  template <typename IdType>
+  void DecodeMap(IdType id, unsigned int num_rows, unsigned int num_cols,
+                 unsigned int num_sources, std::vector<Source2D>& sources);
+
+  EncodingKey EncodeMapKey(const std::vector<Source2D>& sources,
+                           unsigned int num_rows, unsigned int num_cols);
+  void DecodeMap(const EncodingKey& key, unsigned int num_rows,
+                 std::vector<Source2D>& sources);
+
 } // namespace radiation
 
 #endif
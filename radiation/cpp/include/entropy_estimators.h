@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Estimators of the entropy of a categorical distribution from a histogram
+// of raw counts, e.g. one column of P_{Z|X} before normalization. The
+// plug-in estimate -sum p log(p) with p = n / N is biased low when many
+// outcomes are rarely seen, so the corrected estimators below need fewer
+// samples to rank distributions by entropy:
+//   kClippedPlugIn  plug-in, skipping p < 0.01 or p > 0.99; the original
+//                   behavior of GenerateEntropyVector
+//   kPlugIn         plug-in
+//   kMillerMadow    plug-in + (K - 1) / 2N, with K the number of nonzero
+//                   counts
+//   kJackknife      N H - (N - 1) / N sum_i n_i H_{-i}, where H_{-i} is the
+//                   plug-in estimate with one sample removed from bin i
+//   kChaoShen       Horvitz-Thompson sum over coverage-adjusted p, after
+//                   Chao and Shen (2003)
+// All estimates are in nats, and zero for an empty histogram.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_ENTROPY_ESTIMATORS_H
+#define RADIATION_ENTROPY_ESTIMATORS_H
+
+#include <stddef.h>
+#include <string>
+
+namespace radiation {
+
+  enum class EntropyEstimator {
+    kClippedPlugIn, kPlugIn, kMillerMadow, kJackknife, kChaoShen
+  };
+
+  // Estimate entropy from the 'n' nonnegative counts 'counts'.
+  double EstimateEntropy(const double* counts, size_t n,
+                         EntropyEstimator estimator);
+
+  // Convert between estimators and their names, e.g. "miller_madow", for
+  // command line flags. Parsing returns false for an unknown name.
+  const char* EntropyEstimatorName(EntropyEstimator estimator);
+  bool ParseEntropyEstimator(const std::string& name,
+                             EntropyEstimator& estimator);
+
+} // namespace radiation
+
+#endif
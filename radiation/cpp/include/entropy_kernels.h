@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Entropy kernels over contiguous arrays of probabilities, for the entropy
+// of a Bernoulli map (sum over voxels of the entropy of each voxel's
+// occupancy) and the entropy of a categorical distribution (e.g. one column
+// of P_{Z|X}).
+//
+// Both kernels use FastLog, which reduces its argument to m * 2^e with m in
+// [sqrt(1/2), sqrt(2)) and evaluates log(m) = 2 atanh((m - 1) / (m + 1)) by
+// a truncated series. Its error is below 1e-13 * max(1, |log(x)|) for all
+// positive normal inputs. Probabilities outside the given bounds are clamped before
+// taking logs, and their terms masked out afterwards, so there are no
+// branches in the inner loop. Kernels use AVX2 or SSE2 when the compiler
+// targets them, and a scalar loop with the same approximation otherwise and
+// for the leftover tail of each array.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_ENTROPY_KERNELS_H
+#define RADIATION_ENTROPY_KERNELS_H
+
+#include <stddef.h>
+
+namespace radiation {
+
+  // Approximate natural log of a positive normal double.
+  double FastLog(double x);
+
+  // Sum of the Bernoulli entropies -p log(p) - (1 - p) log(1 - p) of the
+  // 'n' probabilities 'p', skipping any p <= 'threshold' or
+  // p >= 1 - 'threshold'.
+  double SumBernoulliEntropies(const double* p, size_t n,
+                               double threshold = 1e-8);
+
+  // Sum of -p log(p) over the 'n' probabilities 'p', skipping any
+  // p < 'min_p' or p > 'max_p'. Requires 0 < min_p <= max_p. Each input is
+  // multiplied by 'scale' first, so raw counts may be passed along with the
+  // reciprocal of their total.
+  double CategoricalEntropy(const double* p, size_t n,
+                            double min_p, double max_p, double scale = 1.0);
+
+} // namespace radiation
+
+#endif
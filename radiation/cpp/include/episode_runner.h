@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Runs a single headless ExplorerLP episode from a fixed seed, until the map
+// entropy drops below a threshold or an iteration limit is reached, and
+// records how long planning and belief updates took along the way.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_EPISODE_RUNNER_H
+#define RADIATION_EPISODE_RUNNER_H
+
+#include <conditional_cache.h>
+#include <entropy_estimators.h>
+
+#include <memory>
+
+namespace radiation {
+
+// Parameters of a single episode.
+struct EpisodeOptions {
+  unsigned int num_rows;
+  unsigned int num_cols;
+  double angular_step;
+  unsigned int num_sources;
+  double regularizer;
+  unsigned int num_steps;
+  double fov;
+  unsigned int num_samples;
+  EntropyEstimator estimator;
+
+  // Stop once entropy falls below 'entropy_threshold', or after
+  // 'max_iterations' steps, whichever comes first.
+  double entropy_threshold;
+  unsigned int max_iterations;
+
+  // Seed for every random number generator used in the episode.
+  unsigned int seed;
+
+  // Optional cache of conditional entropy vectors, shared across episodes.
+  std::shared_ptr<const ConditionalCache> cache;
+};
+
+// Results of a single episode. Times are wall times, in seconds.
+struct EpisodeMetrics {
+  unsigned int num_iterations;
+  bool reached_threshold;
+  bool planning_failed;
+  double final_entropy;
+  double total_plan_time;
+  double total_update_time;
+
+  // Samples drawn while planning, which is zero for steps planned from
+  // cached entropy vectors, and least squares iterations over all updates.
+  unsigned long long total_samples;
+  unsigned long long total_solver_iterations;
+};
+
+// Run an episode. Episodes share no state, so this may be called from several
+// threads at once.
+EpisodeMetrics RunEpisode(const EpisodeOptions& options);
+
+} // namespace radiation
+
+#endif
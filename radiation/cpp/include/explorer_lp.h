@@ -48,37 +48,92 @@
 
 #include <source_2d.h>
 #include <sensor_2d.h>
+#include <context_2d.h>
 #include <grid_map_2d.h>
 #include <grid_pose_2d.h>
 #include <movement_2d.h>
 #include <encoding.h>
+#include <information_field_2d.h>
+#include <conditional_cache.h>
+#include <entropy_estimators.h>
 
 #include <Eigen/Core>
+#include <memory>
+#include <random>
 #include <vector>
 
 namespace radiation {
 
 class ExplorerLP {
  public:
-  ExplorerLP(unsigned int num_rows, unsigned int num_cols,
+  // The explorer keeps its own copy of the context.
+  ExplorerLP(const Context2D& context,
              unsigned int num_sources, double regularizer,
              unsigned int num_steps, double fov,
              unsigned int num_samples);
-  ~ExplorerLP();
+  virtual ~ExplorerLP();
+
+  // Construct with an explicit random seed, for reproducible episodes.
+  ExplorerLP(const Context2D& context,
+             unsigned int num_sources, double regularizer,
+             unsigned int num_steps, double fov,
+             unsigned int num_samples, unsigned int seed);
 
   // Plan a new trajectory.
   bool PlanAhead(std::vector<GridPose2D>& trajectory);
 
+  // Plan a new trajectory coarse-to-fine. Score 'num_candidates' random
+  // trajectories against the given level of a quadtree over the current
+  // belief, then estimate the conditional entropy of only the best
+  // 'num_finalists' at full resolution and pick the largest.
+  // If 'num_headings' is positive, the frontier trajectory below is added
+  // to the candidates.
+  bool PlanAheadCoarseToFine(unsigned int num_candidates,
+                             unsigned int num_finalists, unsigned int level,
+                             std::vector<GridPose2D>& trajectory,
+                             unsigned int num_headings = 0);
+
+  // Plan a new trajectory greedily, without sampling. Fields of the variance
+  // of the measurement from every cell and each of 'num_headings' headings
+  // are computed by FFT, and each step moves to the pose with the largest
+  // variance, discounted by its distance to the best pose on the grid.
+  // Poses already visited are treated as having zero variance.
+  bool PlanAheadFrontier(unsigned int num_headings,
+                         std::vector<GridPose2D>& trajectory);
+
   // Take a step along the given trajectory. Return resulting entropy.
   double TakeStep(const std::vector<GridPose2D>& trajectory);
 
   // Compute map entropy.
   double Entropy() const;
 
+  // Get the map, current pose, and true sources.
+  const GridMap2D& GetMap() const;
+  const GridPose2D& GetPose() const;
+  const std::vector<Source2D>& GetSources() const;
+
+  // Look up conditional entropy vectors in the given cache before sampling
+  // them, and store newly sampled ones. Pass NULL to stop caching. The
+  // cache may be shared with other explorers, in any thread.
+  void SetCache(const std::shared_ptr<const ConditionalCache>& cache);
+
+  // Estimate conditional entropies with the given estimator when planning.
+  // Defaults to the clipped plug-in estimator.
+  void SetEntropyEstimator(EntropyEstimator estimator);
+
   // Visualize the current belief state.
   void Visualize() const;
 
- private:
+ protected:
+  // Plan a new trajectory starting from the given pose, using the given map.
+  // Does not touch the explorer's own map or pose, so it is safe to call
+  // from another thread on a separate map.
+  bool PlanAhead(GridMap2D& map, const GridPose2D& pose,
+                 std::vector<GridPose2D>& trajectory) const;
+
+  // Grid dimensions and movement set.
+  const Context2D context_;
+
   // Problem parameters.
   unsigned int num_steps_;
   unsigned int num_samples_;
@@ -91,6 +146,24 @@ class ExplorerLP {
 
   // List of past poses.
   std::vector<GridPose2D> past_poses_;
+
+  // Random number generator for coarse-to-fine planning.
+  std::default_random_engine rng_;
+
+ private:
+  // Greedily build a frontier trajectory, along with its movements.
+  void PlanFrontier(unsigned int num_headings,
+                    std::vector<Movement2D>& movements,
+                    std::vector<GridPose2D>& trajectory);
+
+  // Information field, rebuilt whenever the number of headings changes.
+  std::unique_ptr<InformationField2D> field_;
+
+  // Optional cache of conditional entropy vectors.
+  std::shared_ptr<const ConditionalCache> cache_;
+
+  // Estimator of conditional entropies.
+  EntropyEstimator estimator_;
 }; // class ExplorerLP
 
 } // namespace radiation
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// OpenGL scaffolding shared by the interactive explorers: drawing the belief
+// grid, robots, and sources, and running a GLUT window which steps an
+// explorer and redraws it at a fixed rate.
+//
+// Coordinates are grid coordinates, so voxel (ii, jj) covers the unit square
+// with its bottom left corner at (ii, jj).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_EXPLORER_WINDOW_H
+#define RADIATION_EXPLORER_WINDOW_H
+
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <source_2d.h>
+
+#include <Eigen/Core>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace radiation {
+
+  // Draw each voxel as a gray square, as bright as its belief. Obstacles are
+  // drawn in brown.
+  void DrawBelief(const Eigen::MatrixXd& belief, const Context2D& context);
+
+  // Draw a robot and its field of view, which extends across the whole grid.
+  void DrawRobot(const GridPose2D& pose, double fov);
+
+  // Draw a small circle at each source.
+  void DrawSources(const std::vector<Source2D>& sources);
+
+  // Callbacks for one explorer. 'step' plans and takes a single step,
+  // storing the resulting entropy, and returns false on error. 'visualize'
+  // draws the current state.
+  struct ExplorerCallbacks {
+    std::function<double()> entropy;
+    std::function<bool(double&)> step;
+    std::function<void()> visualize;
+  }; // struct ExplorerCallbacks
+
+  // Open a GLUT window on a grid of the given size and run its main loop,
+  // which does not return. On every redraw, step the explorer (if fewer than
+  // 'num_iterations' steps have been taken, or 'iterate_forever' is set, and
+  // its entropy is still above 1), report the new entropy, and draw it.
+  void RunExplorerWindow(int* argc, char** argv, const std::string& title,
+                         unsigned int num_rows, unsigned int num_cols,
+                         unsigned int refresh_rate,
+                         unsigned int num_iterations, bool iterate_forever,
+                         const ExplorerCallbacks& callbacks);
+
+} // namespace radiation
+
+#endif
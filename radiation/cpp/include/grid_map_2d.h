@@ -45,7 +45,12 @@
 
 #include <source_2d.h>
 #include <sensor_2d.h>
+#include <context_2d.h>
 #include <grid_pose_2d.h>
+#include <movement_2d.h>
+#include <visibility_cache_2d.h>
+#include <encoding.h>
+#include <trajectory_sampler.h>
 
 #include <Eigen/Core>
 
@@ -56,34 +61,86 @@ namespace radiation {
 
 class GridMap2D {
  public:
-  GridMap2D(unsigned int num_rows, unsigned int num_cols,
+  // Types used by the sampler and planner in trajectory_sampler.h.
+  typedef Context2D ContextType;
+  typedef GridPose2D PoseType;
+  typedef Movement2D MovementType;
+  typedef Sensor2D SensorType;
+  typedef Source2D SourceType;
+
+  // The map takes its dimensions and movement set from the given context,
+  // which must outlive it.
+  GridMap2D(const Context2D& context,
             unsigned int num_sources, double regularizer);
   ~GridMap2D();
 
+  // Construct from an existing belief state, e.g. a snapshot of another map.
+  // The new map has no record of past measurements.
+  GridMap2D(const Context2D& context, const Eigen::MatrixXd& belief,
+            unsigned int num_sources, double regularizer);
+
+  // Same as above, but share the given visibility cache (e.g. that of the
+  // map being snapshotted) rather than starting a cold one.
+  GridMap2D(const Context2D& context, const Eigen::MatrixXd& belief,
+            unsigned int num_sources, double regularizer,
+            const VisibilityCache2D& visibility);
+
   // Getters.
+  const Context2D& GetContext() const;
+  const VisibilityCache2D& GetVisibility() const;
   unsigned int GetNumRows() const;
   unsigned int GetNumCols() const;
+  unsigned int GetNumSources() const;
+  double GetRegularizer() const;
+
+  // Reseed the random number generator.
+  void Seed(unsigned int seed);
+
+  // Draw a seed from the random number generator.
+  unsigned int DrawSeed();
 
   // Generate random sources according to the current belief state.
   bool GenerateSources(std::vector<Source2D>& sources);
 
+  // Count the sources visible from the sensor, accounting for any obstacles
+  // in the context.
+  unsigned int Sense(const Sensor2D& sensor,
+                     const std::vector<Source2D>& sources);
+
   // Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
-  // is the entropy of Z given trajectory X = i, starting from the given pose.
+  // is the entropy of Z given trajectory X = i, starting from the given pose,
+  // as estimated by 'estimator' from the sampled measurements. If
+  // 'histogram' is given, it receives the sample counts behind the estimates
+  // (see SampleEntropyVector).
   void GenerateEntropyVector(unsigned int num_samples, unsigned int num_steps,
                             const GridPose2D& pose, double sensor_fov,
                             Eigen::VectorXd& hzx,
-                            std::vector<unsigned int>& trajectory_ids);
+                            std::vector<Id64>& trajectory_ids,
+                            EntropyEstimator estimator =
+                            EntropyEstimator::kClippedPlugIn,
+                            Eigen::MatrixXd* histogram = nullptr);
 
   // Take a measurement from the given sensor and update belief accordingly.
+  // Sensing accounts for any obstacles in the context.
   bool Update(const Sensor2D& sensor,
               const std::vector<Source2D>& sources, bool solve = true);
 
   // Compute entropy.
   double Entropy() const;
 
+  // Compute the expected measurement from the given sensor under the current
+  // belief state, i.e. the total belief over all visible voxels.
+  double ExpectedMeasurement(const Sensor2D& sensor) const;
+
   // Get a reference to immutable 'belief'.
   const Eigen::MatrixXd& GetImmutableBelief() const;
 
+  // Running totals over the life of the map, for profiling: the number of
+  // samples drawn by GenerateEntropyVector(), and the number of least squares
+  // solver iterations over all belief updates.
+  unsigned long long GetNumSamplesDrawn() const;
+  unsigned long long GetNumSolverIterations() const;
+
  private:
   // Solve least squares problem to update belief state.
   bool SolveLeastSquares();
@@ -91,7 +148,9 @@ class GridMap2D {
   // Belief state.
   Eigen::MatrixXd belief_;
 
-  // Problem parameters.
+  // Context, and problem parameters.
+  const Context2D& context_;
+  VisibilityCache2D visibility_;
   const unsigned int num_rows_;
   const unsigned int num_cols_;
   const unsigned int num_sources_;
@@ -104,6 +163,14 @@ class GridMap2D {
   std::vector< std::vector<unsigned int> > viewed_;
   std::vector<unsigned int> measurements_;
 
+  // Scratch space for sampling, reused across calls.
+  SamplerScratch<Source2D> scratch_;
+  std::vector<double> cdf_evals_;
+
+  // Running totals, for profiling.
+  unsigned long long num_samples_drawn_;
+  unsigned long long num_solver_iterations_;
+
   // Random number generator.
   std::random_device rd_;
   std::default_random_engine rng_;
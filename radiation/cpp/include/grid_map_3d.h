@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 3D grid map whose belief is stored sparsely. Voxels are hashed
+// by their index ii + jj * num_rows + kk * num_rows * num_cols, and a voxel
+// is only allocated once it has been viewed; every other voxel implicitly
+// holds the prior probability that the map was initialized with. Memory
+// therefore grows with the explored volume rather than with the map bounds.
+//
+// The set of voxels visible from each sensor pose is computed once and
+// cached, so repeated sensing from the same pose, as in the sampler, costs a
+// lookup per source. The cache is keyed on the sensor's voxel and its heading
+// rounded to one of a fixed number of evenly spaced directions, and holds a
+// bounded number of poses, evicting the oldest first. Within the map, every
+// sensor therefore sits at the center of its voxel and looks along the
+// nearest of those directions (by default, to within half a degree). Sensors
+// outside the map bounds are rasterized exactly, without touching the cache.
+//
+// Obstacles in the context block sensing. Visible sets only hold voxels with
+// a clear line of sight (see Context3D::LineOfSight), which is checked once,
+// when the set is computed, so sensing through the cache costs the same with
+// or without obstacles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_GRID_MAP_3D_H
+#define RADIATION_GRID_MAP_3D_H
+
+#include <source_3d.h>
+#include <sensor_3d.h>
+#include <context_3d.h>
+#include <grid_pose_3d.h>
+#include <movement_3d.h>
+#include <encoding.h>
+#include <trajectory_sampler.h>
+
+#include <Eigen/Core>
+
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace radiation {
+
+class GridMap3D {
+ public:
+  // Types used by the sampler and planner in trajectory_sampler.h.
+  typedef Context3D ContextType;
+  typedef GridPose3D PoseType;
+  typedef Movement3D MovementType;
+  typedef Sensor3D SensorType;
+  typedef Source3D SourceType;
+
+  // The map takes its dimensions and movement set from the given context,
+  // which must outlive it. Belief is initialized to be uniform. Sensor
+  // headings are rounded to one of 'num_headings' directions, and at most
+  // 'max_cached_poses' visible sets are cached.
+  GridMap3D(const Context3D& context,
+            unsigned int num_sources, double regularizer,
+            unsigned int num_headings = 360,
+            unsigned int max_cached_poses = 4096);
+  ~GridMap3D();
+
+  // Getters.
+  const Context3D& GetContext() const;
+  unsigned int GetNumRows() const;
+  unsigned int GetNumCols() const;
+  unsigned int GetNumLayers() const;
+  unsigned int GetNumSources() const;
+  double GetRegularizer() const;
+  double GetPrior() const;
+  unsigned int GetNumAllocated() const;
+  unsigned int GetNumCachedPoses() const;
+
+  // Reseed the random number generator.
+  void Seed(unsigned int seed);
+
+  // Generate random sources according to the current belief state.
+  bool GenerateSources(std::vector<Source3D>& sources);
+
+  // Count the sources visible from the sensor, using the cached visible set.
+  // Sources are assumed to lie at voxel centers.
+  unsigned int Sense(const Sensor3D& sensor,
+                     const std::vector<Source3D>& sources);
+
+  // Get the sorted indices of all voxels visible from the sensor, computing
+  // and caching them if necessary. The result is only valid until the next
+  // call.
+  const std::vector<unsigned int>& VisibleVoxels(const Sensor3D& sensor);
+
+  // Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
+  // is the entropy of Z given trajectory X = i, starting from the given pose,
+  // as estimated by 'estimator' from the sampled measurements.
+  void GenerateEntropyVector(unsigned int num_samples, unsigned int num_steps,
+                             const GridPose3D& pose, double sensor_fov,
+                             Eigen::VectorXd& hzx,
+                             std::vector<Id64>& trajectory_ids,
+                             EntropyEstimator estimator =
+                             EntropyEstimator::kClippedPlugIn);
+
+  // Take a measurement from the given sensor and update belief accordingly.
+  bool Update(const Sensor3D& sensor,
+              const std::vector<Source3D>& sources, bool solve = true);
+
+  // Compute entropy.
+  double Entropy() const;
+
+  // Get the belief for a single voxel.
+  double GetBelief(unsigned int ii, unsigned int jj, unsigned int kk) const;
+
+ private:
+  // Remove voxels without a clear line of sight from (x, y, z).
+  void RemoveOccluded(double x, double y, double z,
+                      std::vector<unsigned int>& voxels) const;
+
+  // Find the slot of a voxel in 'belief_', allocating it if necessary.
+  unsigned int FindOrAllocate(unsigned int voxel);
+
+  // Solve least squares problem to update belief state.
+  bool SolveLeastSquares();
+
+  // Context, and problem parameters.
+  const Context3D& context_;
+  const unsigned int num_rows_;
+  const unsigned int num_cols_;
+  const unsigned int num_layers_;
+  const unsigned int num_sources_;
+  const double prior_;
+
+  // Regularizer for belief update. Enforeces consistency across all voxels.
+  const double regularizer_;
+
+  // Allocated voxels. 'slots_' maps each voxel index to its slot in
+  // 'belief_' and 'voxels_', which are only ever appended to.
+  std::unordered_map<unsigned int, unsigned int> slots_;
+  std::vector<unsigned int> voxels_;
+  std::vector<double> belief_;
+
+  // Slots viewed in each measurement, and the corresponding measurements.
+  std::vector< std::vector<unsigned int> > viewed_;
+  std::vector<unsigned int> measurements_;
+
+  // Cached visible sets, keyed by sensor voxel * 'num_headings_' + heading,
+  // in order of insertion. Each remembers the field of view it was computed
+  // for, and is recomputed if sensed with another.
+  struct VisibleSet {
+    double fov;
+    std::vector<unsigned int> voxels;
+  }; // struct VisibleSet
+
+  const unsigned int num_headings_;
+  const unsigned int max_cached_poses_;
+  std::unordered_map<Id64, VisibleSet> visible_;
+  std::deque<Id64> visible_order_;
+
+  // Visible set for a sensor outside the map bounds.
+  std::vector<unsigned int> uncached_visible_;
+
+  // Scratch space for sampling, reused across calls.
+  SamplerScratch<Source3D> scratch_;
+  std::vector<double> cdf_evals_;
+
+  // Random number generator.
+  std::random_device rd_;
+  std::default_random_engine rng_;
+}; // class GridMap3D
+
+} // namespace radiation
+
+#endif
@@ -43,21 +43,21 @@
 #ifndef RADIATION_GRID_POSE_2D_H
 #define RADIATION_GRID_POSE_2D_H
 
+#include "context_2d.h"
 #include "movement_2d.h"
 
 namespace radiation {
 
 class GridPose2D {
 public:
-  GridPose2D(double x, double y, double a);
-  GridPose2D(unsigned int x, unsigned int y, double a);
+  GridPose2D(const Context2D& context, double x, double y, double a);
+  GridPose2D(const Context2D& context,
+             unsigned int x, unsigned int y, double a);
   ~GridPose2D();
 
-  // Static setters.
-  static void SetNumRows(unsigned int num_rows);
-  static void SetNumCols(unsigned int num_cols);
-
   // Getters.
+  const Context2D& GetContext() const;
+
   double GetX() const;
   double GetY() const;
   double GetAngle() const;
@@ -69,12 +69,11 @@ public:
   bool MoveBy(const Movement2D& movement);
 
 private:
+  // Context defining the grid dimensions.
+  const Context2D* context_;
+
   // Position and orientation angle.
   double x_, y_, a_;
-
-  // Static dimensions.
-  static unsigned int num_rows_;
-  static unsigned int num_cols_;
 }; // struct GridPose2D
 
 } // namespace radiation
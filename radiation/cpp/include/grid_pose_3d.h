@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a pose on the 3D grid, i.e. a position and a yaw angle.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_GRID_POSE_3D_H
+#define RADIATION_GRID_POSE_3D_H
+
+#include "context_3d.h"
+#include "movement_3d.h"
+
+namespace radiation {
+
+class GridPose3D {
+public:
+  GridPose3D(const Context3D& context, double x, double y, double z, double a);
+  GridPose3D(const Context3D& context,
+             unsigned int x, unsigned int y, unsigned int z, double a);
+  ~GridPose3D();
+
+  // Getters.
+  const Context3D& GetContext() const;
+
+  double GetX() const;
+  double GetY() const;
+  double GetZ() const;
+  double GetAngle() const;
+
+  unsigned int GetIndexX() const;
+  unsigned int GetIndexY() const;
+  unsigned int GetIndexZ() const;
+
+  // Move by the given amount if it is legal.
+  bool MoveBy(const Movement3D& movement);
+
+private:
+  // Context defining the grid dimensions.
+  const Context3D* context_;
+
+  // Position and yaw angle.
+  double x_, y_, z_, a_;
+}; // struct GridPose3D
+
+} // namespace radiation
+
+#endif
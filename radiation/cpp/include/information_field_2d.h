@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines fields of the expected measurement and its variance over every
+// (cell, heading) pose at once. Ignoring obstacles, the set of voxels in view
+// from a sensor at a cell center depends only on the heading, up to
+// translation, so for each heading the expected measurement is the
+// cross-correlation of the belief with a fixed kernel. Since sources are
+// independent, the variance is the cross-correlation of p * (1 - p) with the
+// same kernel.
+//
+// Kernel transforms are precomputed for each heading, so computing all fields
+// costs two forward transforms of the belief plus one inverse transform per
+// heading and field, i.e. O(N log N) per heading for N voxels.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_INFORMATION_FIELD_2D_H
+#define RADIATION_INFORMATION_FIELD_2D_H
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace radiation {
+
+class InformationField2D {
+ public:
+  // Headings are evenly spaced, with heading hh at angle 2 pi hh / H.
+  InformationField2D(unsigned int num_rows, unsigned int num_cols,
+                     double fov, unsigned int num_headings);
+  ~InformationField2D();
+
+  // Getters.
+  unsigned int GetNumRows() const;
+  unsigned int GetNumCols() const;
+  unsigned int GetNumHeadings() const;
+  double GetHeading(unsigned int hh) const;
+
+  // Index of the heading nearest the given angle.
+  unsigned int NearestHeading(double angle) const;
+
+  // Compute the expected measurement and its variance from every cell
+  // center, for every heading, given a belief matrix.
+  void Compute(const Eigen::MatrixXd& belief,
+               std::vector<Eigen::MatrixXd>& means,
+               std::vector<Eigen::MatrixXd>& variances) const;
+
+ private:
+  // Grid dimensions, and dimensions of the zero-padded transforms.
+  const unsigned int num_rows_;
+  const unsigned int num_cols_;
+  const unsigned int num_padded_rows_;
+  const unsigned int num_padded_cols_;
+
+  // Field of view and headings.
+  const double fov_;
+  const unsigned int num_headings_;
+
+  // Conjugated transform of each heading's kernel.
+  std::vector<Eigen::MatrixXcd> kernels_;
+}; // class InformationField2D
+
+} // namespace radiation
+
+#endif
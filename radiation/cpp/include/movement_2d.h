@@ -43,6 +43,8 @@
 #ifndef RADIATION_MOVEMENT_2D_H
 #define RADIATION_MOVEMENT_2D_H
 
+#include "context_2d.h"
+
 #include <vector>
 #include <random>
 
@@ -52,21 +54,15 @@ class Movement2D {
 public:
   ~Movement2D();
 
-  // Default constructor picks a random perturbation dx, dy, da.
-  // Alternatively, construct by specifying indices into delta arrays.
-  Movement2D();
-  Movement2D(unsigned int x_id, unsigned int y_id, unsigned int a_id);
-
-  // Static setters.
-  static void SetDeltaXs(const std::vector<double>& delta_xs);
-  static void SetDeltaYs(const std::vector<double>& delta_ys);
-  static void SetDeltaAngles(const std::vector<double>& delta_as);
-  static void SetAngularStep(double angular_step);
+  // Pick a random perturbation dx, dy, da from the context's movement set,
+  // using the given random number generator. Alternatively, construct by
+  // specifying indices into the context's delta arrays.
+  Movement2D(const Context2D& context, std::default_random_engine& rng);
+  Movement2D(const Context2D& context,
+             unsigned int x_id, unsigned int y_id, unsigned int a_id);
 
   // Getters.
-  static unsigned int GetNumDeltaXs();
-  static unsigned int GetNumDeltaYs();
-  static unsigned int GetNumDeltaAngles();
+  const Context2D& GetContext() const;
 
   unsigned int GetIndexX() const;
   unsigned int GetIndexY() const;
@@ -77,17 +73,10 @@ public:
   double GetDeltaAngle() const;
 
 private:
-  // Static variables. Sets of dx, dy, da, where actually the real change in
-  // angle will be angular_step_ * delta_as_. Also a random number generator.
-  static std::vector<double> delta_xs_;
-  static std::vector<double> delta_ys_;
-  static std::vector<double> delta_as_;
-  static double angular_step_;
-
-  static std::random_device rd_;
-  static std::default_random_engine rng_;
+  // Context defining the set of possible movements.
+  const Context2D* context_;
 
-  // Non-static variables. Indices in the static delta vectors.
+  // Indices in the context's delta vectors.
   unsigned int xx_, yy_, aa_;
 }; // struct Movement2D
 
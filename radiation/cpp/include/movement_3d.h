@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a movement on a 3D grid.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_MOVEMENT_3D_H
+#define RADIATION_MOVEMENT_3D_H
+
+#include "context_3d.h"
+
+#include <vector>
+#include <random>
+
+namespace radiation {
+
+class Movement3D {
+public:
+  ~Movement3D();
+
+  // Pick a random perturbation dx, dy, dz, da from the context's movement set,
+  // using the given random number generator. Alternatively, construct by
+  // specifying indices into the context's delta arrays.
+  Movement3D(const Context3D& context, std::default_random_engine& rng);
+  Movement3D(const Context3D& context, unsigned int x_id, unsigned int y_id,
+             unsigned int z_id, unsigned int a_id);
+
+  // Getters.
+  const Context3D& GetContext() const;
+
+  unsigned int GetIndexX() const;
+  unsigned int GetIndexY() const;
+  unsigned int GetIndexZ() const;
+  unsigned int GetIndexAngle() const;
+
+  double GetDeltaX() const;
+  double GetDeltaY() const;
+  double GetDeltaZ() const;
+  double GetDeltaAngle() const;
+
+private:
+  // Context defining the set of possible movements.
+  const Context3D* context_;
+
+  // Indices in the context's delta vectors.
+  unsigned int xx_, yy_, zz_, aa_;
+}; // struct Movement3D
+
+} // namespace radiation
+
+#endif
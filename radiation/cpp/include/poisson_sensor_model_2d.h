@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a Poisson count model for a set of 2D sensor poses. A source at
+// distance d from a sensor, within its field of view and line of sight,
+// contributes strength / max(d^2, kMinDistanceSq) to the expected count rate,
+// and every sensor also sees a constant background rate.
+//
+// The weights for every (pose, voxel) pair are precomputed into a sparse
+// sensitivity matrix with one row per pose, so the expected counts for a
+// sampled map are sparse dot products. Log-factorials, Poisson entropies, and
+// Poisson pmfs are tabulated up front, so likelihoods and measurement
+// entropies need no calls to lgamma, and entropies and pmfs need no calls to
+// exp. Pmfs of mixtures, i.e. of the count at one pose marginalized over
+// sampled maps, are accumulated row by row from the pmf table.
+//
+// The model is not yet wired into trajectory planning: SampleEntropyVector
+// histograms joint measurements over a small alphabet of source counts,
+// which does not carry over to unbounded Poisson counts.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_POISSON_SENSOR_MODEL_2D_H
+#define RADIATION_POISSON_SENSOR_MODEL_2D_H
+
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <source_2d.h>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <random>
+#include <vector>
+
+namespace radiation {
+
+class PoissonSensorModel2D {
+ public:
+  // Squared distance below which the inverse-square law is clamped, i.e.
+  // a source in the sensor's own voxel.
+  static const double kMinDistanceSq;
+
+  // Largest count with a tabulated log-factorial.
+  static const unsigned int kMaxCount = 128;
+
+  // Grid on which Poisson entropies are tabulated. The grid is uniform in
+  // the square root of the rate, which keeps interpolation accurate near
+  // zero, where entropy has unbounded slope.
+  static const double kMaxTabulatedRate;
+  static const double kSqrtRateStep;
+
+  // Grid on which Poisson pmfs over counts 0, ..., kMaxCount are tabulated,
+  // also uniform in the square root of the rate, and up to the same rate.
+  static const double kPmfSqrtRateStep;
+
+  // Precompute weights for each of the given poses, with the given field of
+  // view, source strength (rate at unit distance), and background rate.
+  // Obstacles in the context block line of sight.
+  PoissonSensorModel2D(const Context2D& context,
+                       const std::vector<GridPose2D>& poses, double fov,
+                       double strength, double background);
+  ~PoissonSensorModel2D();
+
+  // Getters.
+  unsigned int GetNumPoses() const;
+  double GetStrength() const;
+  double GetBackground() const;
+  const Eigen::SparseMatrix<double, Eigen::RowMajor>& GetSensitivity() const;
+
+  // Expected count rate at a single pose, given a set of sources.
+  double ExpectedCount(unsigned int pose,
+                       const std::vector<Source2D>& sources) const;
+
+  // Expected count rates at all poses, given a set of sources, or given a
+  // belief matrix, i.e. the expected number of sources in each voxel.
+  void ExpectedCounts(const std::vector<Source2D>& sources,
+                      Eigen::VectorXd& rates) const;
+  void ExpectedCounts(const Eigen::MatrixXd& belief,
+                      Eigen::VectorXd& rates) const;
+
+  // Draw a random count at a single pose, given a set of sources.
+  unsigned int Sense(unsigned int pose, const std::vector<Source2D>& sources,
+                     std::default_random_engine& rng) const;
+
+  // Poisson log-likelihood of a count given a rate, and the natural log of
+  // count!. Counts above kMaxCount fall back to lgamma.
+  double LogLikelihood(unsigned int count, double rate) const;
+  double LogFactorial(unsigned int count) const;
+
+  // Entropy (in nats) of a Poisson random variable with the given rate.
+  // Rates up to kMaxTabulatedRate are interpolated from the table, and
+  // larger rates use the asymptotic expansion.
+  double Entropy(double rate) const;
+
+  // Poisson probability of a count given a rate. Rates up to
+  // kMaxTabulatedRate and counts up to kMaxCount are interpolated from the
+  // table, and anything else is computed directly.
+  double Pmf(unsigned int count, double rate) const;
+
+  // Add 'weight' times the Poisson pmf with the given rate to
+  // pmf[0], ..., pmf[kMaxCount]. Probability beyond kMaxCount is dropped,
+  // which is negligible for tabulated rates.
+  void AccumulatePmf(double rate, double weight, double* pmf) const;
+
+  // Pmf over counts 0, ..., kMaxCount of the equally weighted mixture of
+  // Poisson distributions with the given rates, e.g. the expected counts at
+  // one pose under each of a set of sampled maps, and its entropy (in nats).
+  void MixturePmf(const std::vector<double>& rates,
+                  Eigen::VectorXd& pmf) const;
+  double MixtureEntropy(const std::vector<double>& rates) const;
+
+ private:
+  // Compute entropy by direct summation, used to fill the table.
+  double ComputeEntropy(double rate) const;
+
+  // Grid dimensions.
+  const unsigned int num_rows_;
+  const unsigned int num_cols_;
+
+  // Model parameters.
+  const double strength_;
+  const double background_;
+
+  // Sensitivity matrix. Entry (pose, voxel) is the rate contributed by a
+  // source in the given (column-major) voxel.
+  Eigen::SparseMatrix<double, Eigen::RowMajor> sensitivity_;
+
+  // Tabulated log(k!) for k <= kMaxCount, entropies on the grid, and pmfs
+  // on the pmf grid, with one row of kMaxCount + 1 counts per grid point.
+  std::vector<double> log_factorials_;
+  std::vector<double> entropies_;
+  std::vector<double> pmfs_;
+}; // class PoissonSensorModel2D
+
+} // namespace radiation
+
+#endif
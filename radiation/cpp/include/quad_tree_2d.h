@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a quadtree over a 2D belief map. Each node covers a rectangle of
+// voxels and stores the total belief (i.e. the expected number of sources)
+// and the total entropy of the voxels it covers. Nodes are split in half
+// along each dimension until they cover a single voxel, so leaves are at
+// the deepest level and the root is at level 0.
+//
+// The tree supports sampling sources top-down, which only visits the nodes
+// along the path to each sampled voxel, and computing the expected sensor
+// measurement at a coarse level, which only refines nodes that straddle the
+// edge of the sensor's field of view. How far those are refined depends on
+// how much belief they hold, and obstacles are accounted for through the
+// sensor's view (see VisibilityCache2D).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_QUAD_TREE_2D_H
+#define RADIATION_QUAD_TREE_2D_H
+
+#include <source_2d.h>
+#include <sensor_2d.h>
+
+#include <Eigen/Core>
+
+#include <random>
+#include <vector>
+
+namespace radiation {
+
+class QuadTree2D {
+ public:
+  // Each node covers rows [row_, row_ + num_rows_) and columns
+  // [col_, col_ + num_cols_).
+  struct Node {
+    unsigned int row_;
+    unsigned int col_;
+    unsigned int num_rows_;
+    unsigned int num_cols_;
+    unsigned int level_;
+
+    // Aggregate belief and entropy.
+    double sum_;
+    double entropy_;
+
+    // Indices of child nodes. Empty for leaves.
+    std::vector<unsigned int> children_;
+  };
+
+  // Visibility of a node from a sensor.
+  enum Visibility { kOutOfView, kPartiallyInView, kInView };
+
+  // Build from a belief matrix, e.g. GridMap2D::GetImmutableBelief().
+  explicit QuadTree2D(const Eigen::MatrixXd& belief);
+  ~QuadTree2D();
+
+  // Rebuild from a new belief matrix.
+  void Build(const Eigen::MatrixXd& belief);
+
+  // Getters.
+  unsigned int GetNumLevels() const;
+  unsigned int GetNumNodes() const;
+  const Node& GetNode(unsigned int id) const;
+  double GetSum() const;
+  double GetEntropy() const;
+
+  // Check whether a node is entirely in view, entirely out of view, or
+  // somewhere in between. A voxel is in view iff its center is, exactly as
+  // in Sensor2D::VoxelInView. Leaves are always classified exactly; other
+  // nodes may be reported as partially in view conservatively.
+  Visibility NodeInView(const Sensor2D& sensor, unsigned int id) const;
+
+  // Compute the expected measurement from the given sensor, refining no
+  // deeper than the given level. Nodes at that level which are partially in
+  // view contribute their total belief times the fraction of their corner
+  // voxels which are in view. At the deepest level this is exact.
+  double ExpectedMeasurement(const Sensor2D& sensor, unsigned int level) const;
+
+  // Same as above, but refine by belief as well as by level. Partially
+  // visible nodes holding more than 'max_mass' are refined past the given
+  // level, and those holding at most 'min_mass' are not refined at all,
+  // since they cannot change the estimate by more than that. If 'view' is
+  // given (e.g. from VisibilityCache2D::GetView()), only voxels in it count
+  // as in view. Since an obstacle may then hide part of a node inside the
+  // field of view, every node in the field of view is refined as if it were
+  // partially visible.
+  double ExpectedMeasurement(const Sensor2D& sensor, unsigned int level,
+                             double max_mass, double min_mass,
+                             const std::vector<bool>* view) const;
+
+  // Sample nodes at the given level (or leaves above it) with probability
+  // proportional to their belief, descending from the root.
+  void SampleNodes(std::default_random_engine& rng, unsigned int num_sources,
+                   unsigned int level, std::vector<unsigned int>& nodes) const;
+
+  // Generate random sources according to belief, by sampling leaves.
+  bool GenerateSources(std::default_random_engine& rng,
+                       unsigned int num_sources,
+                       std::vector<Source2D>& sources) const;
+
+ private:
+  // Recursively build the subtree covering the given rectangle, and return
+  // the index of its root.
+  unsigned int BuildNode(const Eigen::MatrixXd& belief,
+                         unsigned int row, unsigned int col,
+                         unsigned int num_rows, unsigned int num_cols,
+                         unsigned int level);
+
+  // Recursive helper for ExpectedMeasurement().
+  double ExpectedMeasurement(const Sensor2D& sensor, unsigned int level,
+                             double max_mass, double min_mass,
+                             const std::vector<bool>* view,
+                             unsigned int id) const;
+
+  // Check whether a voxel is in view, using the view if given.
+  bool VoxelInView(const Sensor2D& sensor, const std::vector<bool>* view,
+                   unsigned int ii, unsigned int jj) const;
+
+  // Nodes, with the root first.
+  std::vector<Node> nodes_;
+  unsigned int num_levels_;
+}; // class QuadTree2D
+
+} // namespace radiation
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a codec for ids made of a fixed number of digits in a fixed base,
+// with the first digit least significant, matching EncodeDigits and
+// DecodeDigits in encoding.h. The codec is built once per (base, number of
+// digits) pair, and CHECKs at construction that every such id fits in IdType,
+// so encoding needs no overflow checks and is just a multiply-add per digit.
+//
+// Decoding avoids a hardware division per digit. Ids are first split into
+// chunks of as many digits as fit in 32 bits, and digits are peeled off each
+// chunk using a precomputed reciprocal of the base, as in Lemire, Kaser, and
+// Kurz, "Faster Remainder by Direct Computation". This relies on the GCC/Clang
+// unsigned __int128 extension.
+//
+// Batch versions work on digits in structure-of-arrays layout, i.e. digit dd
+// of id ii is at digits[dd * stride + ii], so the inner loops run over ids
+// with unit stride.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_RADIX_CODEC_H
+#define RADIATION_RADIX_CODEC_H
+
+#include <glog/logging.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+namespace radiation {
+
+template <typename IdType>
+class RadixCodec {
+ public:
+  RadixCodec(unsigned int base, unsigned int num_digits);
+  ~RadixCodec() {}
+
+  // Check whether every id with 'num_digits' digits in 'base' fits in IdType.
+  static bool Fits(unsigned int base, unsigned int num_digits);
+
+  // Getters.
+  unsigned int GetBase() const { return base_; }
+  unsigned int GetNumDigits() const { return num_digits_; }
+
+  // Encode/decode a single id. Consecutive digits are 'stride' apart.
+  IdType Encode(const unsigned int* digits, size_t stride = 1) const;
+  void Decode(IdType id, unsigned int* digits, size_t stride = 1) const;
+
+  // Encode/decode 'num_ids' ids at once. Digits are in structure-of-arrays
+  // layout, with rows of length 'stride', which defaults to 'num_ids'.
+  void EncodeBatch(const unsigned int* digits, size_t num_ids,
+                   IdType* ids, size_t stride = 0) const;
+  void DecodeBatch(const IdType* ids, size_t num_ids,
+                   unsigned int* digits, size_t stride = 0) const;
+
+ private:
+  // Divide a 32-bit value by the base using the precomputed reciprocal, and
+  // return the remainder.
+  uint32_t DivideByBase(uint32_t& value) const {
+    const uint32_t quotient = static_cast<uint32_t>(
+      (static_cast<unsigned __int128>(reciprocal_) * value) >> 64);
+    const uint32_t remainder = value - quotient * base_;
+    value = quotient;
+    return remainder;
+  }
+
+  // Base and number of digits.
+  const unsigned int base_;
+  const unsigned int num_digits_;
+
+  // Number of digits in each 32-bit chunk, and base^digits_per_chunk_.
+  unsigned int digits_per_chunk_;
+  IdType chunk_base_;
+
+  // ceil(2^64 / base), or zero if the base is one.
+  uint64_t reciprocal_;
+}; // class RadixCodec
+
+// Implementation.
+template <typename IdType>
+RadixCodec<IdType>::RadixCodec(unsigned int base, unsigned int num_digits)
+  : base_(base), num_digits_(num_digits),
+    digits_per_chunk_(1), chunk_base_(base),
+    reciprocal_((base > 1) ? ~static_cast<uint64_t>(0) / base + 1 : 0) {
+  CHECK(base_ > 0);
+  CHECK(Fits(base_, num_digits_))
+    << "Ids with " << num_digits_ << " digits in base " << base_
+    << " do not fit.";
+
+  // Grow chunks while they still fit in 32 bits and in an id.
+  if (base_ > 1) {
+    uint64_t chunk_base = base_;
+    while (digits_per_chunk_ < num_digits_ &&
+           chunk_base * base_ <= static_cast<uint64_t>(~static_cast<uint32_t>(0))) {
+      chunk_base *= base_;
+      digits_per_chunk_++;
+    }
+
+    chunk_base_ = static_cast<IdType>(chunk_base);
+  }
+}
+
+template <typename IdType>
+bool RadixCodec<IdType>::Fits(unsigned int base, unsigned int num_digits) {
+  if (base <= 1)
+    return true;
+
+  // Largest id is base^num_digits - 1. Check base^num_digits - 1 <= kMax
+  // one digit at a time, without overflowing.
+  const IdType kMax = ~static_cast<IdType>(0);
+  IdType place_value = 1;
+  for (unsigned int ii = 0; ii < num_digits; ii++) {
+    // Need place_value * base - 1 <= kMax.
+    if (place_value - 1 > (kMax - (base - 1)) / base)
+      return false;
+
+    if (ii + 1 < num_digits)
+      place_value *= base;
+  }
+
+  return true;
+}
+
+template <typename IdType>
+IdType RadixCodec<IdType>::Encode(const unsigned int* digits,
+                                  size_t stride) const {
+  // Horner's rule, most significant digit first.
+  IdType id = 0;
+  for (unsigned int dd = num_digits_; dd > 0; dd--)
+    id = id * base_ + digits[(dd - 1) * stride];
+
+  return id;
+}
+
+template <typename IdType>
+void RadixCodec<IdType>::Decode(IdType id, unsigned int* digits,
+                                size_t stride) const {
+  if (base_ == 1) {
+    for (unsigned int dd = 0; dd < num_digits_; dd++)
+      digits[dd * stride] = 0;
+    return;
+  }
+
+  for (unsigned int dd = 0; dd < num_digits_; ) {
+    // Split off a chunk. The last chunk is all that remains of the id.
+    const unsigned int num_chunk_digits =
+      std::min(digits_per_chunk_, num_digits_ - dd);
+    uint32_t chunk = 0;
+    if (dd + num_chunk_digits < num_digits_) {
+      chunk = static_cast<uint32_t>(id % chunk_base_);
+      id /= chunk_base_;
+    } else {
+      chunk = static_cast<uint32_t>(id);
+    }
+
+    for (unsigned int jj = 0; jj < num_chunk_digits; jj++, dd++)
+      digits[dd * stride] = DivideByBase(chunk);
+  }
+}
+
+template <typename IdType>
+void RadixCodec<IdType>::EncodeBatch(const unsigned int* digits,
+                                     size_t num_ids, IdType* ids,
+                                     size_t stride) const {
+  if (stride == 0)
+    stride = num_ids;
+
+  std::fill(ids, ids + num_ids, static_cast<IdType>(0));
+  for (unsigned int dd = num_digits_; dd > 0; dd--) {
+    const unsigned int* row = digits + (dd - 1) * stride;
+    for (size_t ii = 0; ii < num_ids; ii++)
+      ids[ii] = ids[ii] * base_ + row[ii];
+  }
+}
+
+template <typename IdType>
+void RadixCodec<IdType>::DecodeBatch(const IdType* ids, size_t num_ids,
+                                     unsigned int* digits,
+                                     size_t stride) const {
+  if (stride == 0)
+    stride = num_ids;
+
+  if (base_ == 1) {
+    for (unsigned int dd = 0; dd < num_digits_; dd++)
+      std::fill(digits + dd * stride, digits + dd * stride + num_ids, 0u);
+    return;
+  }
+
+  // Work chunk by chunk across all ids, so each inner loop has a single
+  // operation applied to every id.
+  std::vector<IdType> rest(ids, ids + num_ids);
+  std::vector<uint32_t> chunks(num_ids);
+  for (unsigned int dd = 0; dd < num_digits_; ) {
+    const unsigned int num_chunk_digits =
+      std::min(digits_per_chunk_, num_digits_ - dd);
+    if (dd + num_chunk_digits < num_digits_) {
+      for (size_t ii = 0; ii < num_ids; ii++) {
+        chunks[ii] = static_cast<uint32_t>(rest[ii] % chunk_base_);
+        rest[ii] /= chunk_base_;
+      }
+    } else {
+      for (size_t ii = 0; ii < num_ids; ii++)
+        chunks[ii] = static_cast<uint32_t>(rest[ii]);
+    }
+
+    for (unsigned int jj = 0; jj < num_chunk_digits; jj++, dd++) {
+      unsigned int* row = digits + dd * stride;
+      for (size_t ii = 0; ii < num_ids; ii++)
+        row[ii] = DivideByBase(chunks[ii]);
+    }
+  }
+}
+
+} // namespace radiation
+
+#endif
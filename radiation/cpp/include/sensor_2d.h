@@ -61,6 +61,7 @@ public:
   double GetX() const;
   double GetY() const;
   double GetAngle() const;
+  double GetFov() const;
 
   unsigned int GetIndexX() const;
   unsigned int GetIndexY() const;
@@ -75,6 +76,14 @@ public:
   bool SourceInView(const Source2D& source) const;
   bool VoxelInView(unsigned int ii, unsigned int jj) const;
 
+  // Find all voxels in view on a grid of the given size, and return their
+  // column-major indices ii + jj * num_rows in row order. Agrees exactly with
+  // VoxelInView, but only tests voxels near the edges of the field of view,
+  // so the cost is proportional to the number of rows plus the number of
+  // voxels in view.
+  void VoxelsInView(unsigned int num_rows, unsigned int num_cols,
+                    std::vector<unsigned int>& voxels) const;
+
 private:
   // Position and orientation angle.
   double x_, y_, a_;
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 3D radiation sensor with a conic field of view. The cone's axis
+// is horizontal, pointing along the sensor's yaw angle, and its apex angle is
+// the field of view. Returns a noiseless count of the sources in view. The
+// sensor itself knows nothing of obstacles; GridMap3D removes occluded voxels
+// from its visible sets.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_SENSOR_3D_H
+#define RADIATION_SENSOR_3D_H
+
+#include <source_3d.h>
+#include <grid_pose_3d.h>
+
+#include <vector>
+
+namespace radiation {
+
+class Sensor3D {
+public:
+  Sensor3D(double x, double y, double z, double a, double fov);
+  Sensor3D(const GridPose3D& pose, double fov);
+  ~Sensor3D();
+
+  // Getters.
+  double GetX() const;
+  double GetY() const;
+  double GetZ() const;
+  double GetAngle() const;
+  double GetFov() const;
+
+  // Sense the specified sources.
+  unsigned int Sense(const std::vector<Source3D>& sources) const;
+
+  // Check if a source or voxel is in view.
+  bool SourceInView(const Source3D& source) const;
+  bool VoxelInView(unsigned int ii, unsigned int jj, unsigned int kk) const;
+
+  // Find all voxels in view on a grid of the given size, and return their
+  // indices ii + jj * num_rows + kk * num_rows * num_cols in increasing
+  // order. Agrees exactly with VoxelInView. For fields of view narrower than
+  // pi, the cone meets each vertical line of voxels in a single interval, so
+  // only voxels in or next to that interval are tested.
+  void VoxelsInView(unsigned int num_rows, unsigned int num_cols,
+                    unsigned int num_layers,
+                    std::vector<unsigned int>& voxels) const;
+
+private:
+  // Position and yaw angle.
+  const double x_, y_, z_, a_;
+
+  // Field of view, i.e. the apex angle of the cone.
+  const double fov_;
+}; // class Sensor3D
+
+} // namespace radiation
+
+#endif
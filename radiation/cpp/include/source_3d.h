@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 3D radiation source.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_SOURCE_3D_H
+#define RADIATION_SOURCE_3D_H
+
+namespace radiation {
+
+class Source3D {
+public:
+  // Construct from doubles or from unsigned ints.
+  Source3D(double x, double y, double z) : x_(x), y_(y), z_(z) {}
+  Source3D(unsigned int x, unsigned int y, unsigned int z)
+    : x_(static_cast<double>(x) + 0.5),
+      y_(static_cast<double>(y) + 0.5),
+      z_(static_cast<double>(z) + 0.5) {}
+
+  // Get x/y/z coordinates/indices.
+  double GetX() const { return x_; }
+  double GetY() const { return y_; }
+  double GetZ() const { return z_; }
+
+  unsigned int GetIndexX() const { return static_cast<unsigned int>(x_); }
+  unsigned int GetIndexY() const { return static_cast<unsigned int>(y_); }
+  unsigned int GetIndexZ() const { return static_cast<unsigned int>(z_); }
+
+private:
+  double x_, y_, z_;
+}; // class Source3D
+
+} // namespace radiation
+
+#endif
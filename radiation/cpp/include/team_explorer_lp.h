@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Cooperative exploration on a 2D grid with a team of robots sharing a single
+// belief map. Each robot's candidate trajectories are sampled in parallel (one
+// thread per robot, each on its own snapshot of the shared belief). Robots
+// then choose trajectories one at a time, in order, discounting candidates
+// whose views overlap those already claimed by earlier robots. All robots'
+// measurements are folded into a single belief solve per step.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_TEAM_EXPLORER_LP_H
+#define RADIATION_TEAM_EXPLORER_LP_H
+
+#include <source_2d.h>
+#include <sensor_2d.h>
+#include <context_2d.h>
+#include <grid_map_2d.h>
+#include <grid_pose_2d.h>
+#include <movement_2d.h>
+#include <encoding.h>
+#include <entropy_estimators.h>
+
+#include <Eigen/Core>
+#include <random>
+#include <vector>
+
+namespace radiation {
+
+class TeamExplorerLP {
+ public:
+  // The explorer keeps its own copy of the context.
+  TeamExplorerLP(const Context2D& context, unsigned int num_robots,
+                 unsigned int num_sources, double regularizer,
+                 unsigned int num_steps, double fov,
+                 unsigned int num_samples, unsigned int num_candidates);
+  ~TeamExplorerLP();
+
+  // Construct with an explicit random seed, for reproducible episodes. The
+  // sources and first robot's pose depend only on the seed, not on the
+  // number of robots.
+  TeamExplorerLP(const Context2D& context, unsigned int num_robots,
+                 unsigned int num_sources, double regularizer,
+                 unsigned int num_steps, double fov,
+                 unsigned int num_samples, unsigned int num_candidates,
+                 unsigned int seed);
+
+  // Plan a new trajectory for each robot.
+  bool PlanAhead(std::vector< std::vector<GridPose2D> >& trajectories);
+
+  // Move each robot one step along its trajectory, and update the shared map
+  // with all measurements at once. Return resulting entropy.
+  double TakeStep(const std::vector< std::vector<GridPose2D> >& trajectories);
+
+  // Compute map entropy.
+  double Entropy() const;
+
+  // Estimate conditional entropies with the given estimator when planning.
+  // Defaults to the clipped plug-in estimator.
+  void SetEntropyEstimator(EntropyEstimator estimator);
+
+  // Visualize the current belief state.
+  void Visualize() const;
+
+ private:
+  // Mark all voxels viewed along the given trajectory.
+  void MarkViewed(const std::vector<GridPose2D>& trajectory,
+                  std::vector<bool>& viewed) const;
+
+  // Grid dimensions and movement set.
+  const Context2D context_;
+
+  // Problem parameters.
+  unsigned int num_steps_;
+  unsigned int num_samples_;
+  double fov_;
+
+  // Number of top-scoring candidate trajectories (per robot) to consider
+  // when discounting overlapping views.
+  unsigned int num_candidates_;
+
+  // Shared map, one pose per robot, and sources.
+  GridMap2D map_;
+  std::vector<GridPose2D> poses_;
+  std::vector<Source2D> sources_;
+
+  // List of past poses for each robot.
+  std::vector< std::vector<GridPose2D> > past_poses_;
+
+  // Estimator of conditional entropies.
+  EntropyEstimator estimator_;
+
+  // Random number generator used to seed each planning snapshot.
+  std::default_random_engine rng_;
+}; // class TeamExplorerLP
+
+} // namespace radiation
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 2D grid map whose belief is stored in fixed-size square tiles.
+// Tiles are only allocated once some voxel inside them has been viewed; every
+// other voxel implicitly holds the prior probability that the map was
+// initialized with. Each tile caches its total belief and entropy, so
+// sampling sources and computing entropy only walk allocated tiles, and
+// memory grows with the explored area rather than with the map bounds.
+//
+// The map takes its bounds, movement set, and obstacles from a Context2D,
+// and senses through a VisibilityCache2D, exactly like GridMap2D. It defines
+// the same member types and GenerateEntropyVector(), so the sampler and
+// planner in trajectory_sampler.h (e.g. PlanTrajectory) run on it directly.
+//
+// Map bounds may be grown at runtime, by switching to a larger context.
+// Newly added voxels start at the prior, and past measurements are assumed
+// not to have covered them. Growing rescales the prior so that the expected
+// number of sources over the new bounds is still the number of sources.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_TILED_GRID_MAP_2D_H
+#define RADIATION_TILED_GRID_MAP_2D_H
+
+#include <source_2d.h>
+#include <sensor_2d.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <movement_2d.h>
+#include <visibility_cache_2d.h>
+#include <encoding.h>
+#include <trajectory_sampler.h>
+
+#include <Eigen/Core>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace radiation {
+
+class TiledGridMap2D {
+ public:
+  // Types used by the sampler and planner in trajectory_sampler.h.
+  typedef Context2D ContextType;
+  typedef GridPose2D PoseType;
+  typedef Movement2D MovementType;
+  typedef Sensor2D SensorType;
+  typedef Source2D SourceType;
+
+  // Number of rows and columns in each tile.
+  static const unsigned int kTileSize = 16;
+
+  // The map takes its bounds, movement set, and obstacles from the given
+  // context, which must outlive it. Belief is initialized to be uniform over
+  // the initial bounds.
+  TiledGridMap2D(const Context2D& context,
+                 unsigned int num_sources, double regularizer);
+  ~TiledGridMap2D();
+
+  // Getters.
+  const Context2D& GetContext() const;
+  unsigned int GetNumRows() const;
+  unsigned int GetNumCols() const;
+  unsigned int GetNumSources() const;
+  double GetRegularizer() const;
+  double GetPrior() const;
+  unsigned int GetNumTiles() const;
+
+  // Reseed the random number generator.
+  void Seed(unsigned int seed);
+
+  // Grow the map bounds to those of the given context, which replaces the
+  // current one and must also outlive the map. Bounds may only increase. The
+  // prior is spread over every voxel not yet covered by an allocated tile,
+  // including the new ones, so that allocated and background belief still
+  // sum to 'num_sources'. Poses passed in afterwards should refer to the new
+  // context.
+  void Grow(const Context2D& context);
+
+  // Generate random sources according to the current belief state.
+  bool GenerateSources(std::vector<Source2D>& sources);
+
+  // Count the sources visible from the sensor, accounting for any obstacles
+  // in the context.
+  unsigned int Sense(const Sensor2D& sensor,
+                     const std::vector<Source2D>& sources);
+
+  // Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
+  // is the entropy of Z given trajectory X = i, starting from the given pose,
+  // as estimated by 'estimator' from the sampled measurements.
+  void GenerateEntropyVector(unsigned int num_samples, unsigned int num_steps,
+                             const GridPose2D& pose, double sensor_fov,
+                             Eigen::VectorXd& hzx,
+                             std::vector<Id64>& trajectory_ids,
+                             EntropyEstimator estimator =
+                             EntropyEstimator::kClippedPlugIn);
+
+  // Take a measurement from the given sensor and update belief accordingly.
+  // Sensing accounts for any obstacles in the context.
+  bool Update(const Sensor2D& sensor,
+              const std::vector<Source2D>& sources, bool solve = true);
+
+  // Compute entropy.
+  double Entropy() const;
+
+  // Compute the expected measurement from the given sensor under the current
+  // belief state, i.e. the total belief over all visible voxels.
+  double ExpectedMeasurement(const Sensor2D& sensor) const;
+
+  // Get belief at a single voxel, or copy the whole map into a dense matrix.
+  double GetBelief(unsigned int ii, unsigned int jj) const;
+  void GetBelief(Eigen::MatrixXd& belief) const;
+
+ private:
+  // Tiles are indexed by (tile row, tile column).
+  typedef std::pair<unsigned int, unsigned int> TileKey;
+
+  // Belief within a tile is stored in column-major order, as in GridMap2D.
+  // Voxels that lie outside the current bounds hold the prior and are left
+  // out of the cached sum and entropy.
+  struct Tile {
+    std::vector<double> belief_;
+    double sum_;
+    double entropy_;
+  };
+
+  // A single measurement, along with the voxels it viewed, grouped by tile.
+  struct Measurement {
+    std::vector<TileKey> tiles_;
+    std::vector< std::vector<unsigned int> > offsets_;
+    unsigned int measurement_;
+  };
+
+  // Solve least squares problem to update belief state.
+  bool SolveLeastSquares();
+
+  // Find the tile with the given key, allocating it at the prior if needed.
+  Tile& FindOrAllocateTile(const TileKey& key);
+
+  // Number of rows/columns of the given tile which lie inside the bounds.
+  unsigned int TileRowsInBounds(const TileKey& key) const;
+  unsigned int TileColsInBounds(const TileKey& key) const;
+
+  // Recompute cached sum and entropy for a tile.
+  void RefreshTile(const TileKey& key, Tile& tile) const;
+
+  // Recompute all caches, e.g. after solving or growing.
+  void RefreshAllTiles();
+
+  // Number of in-bounds voxels not covered by any allocated tile.
+  unsigned int NumBackgroundVoxels() const;
+
+  // Allocated tiles.
+  std::map<TileKey, Tile> tiles_;
+
+  // Number of in-bounds voxels covered by allocated tiles.
+  unsigned int num_allocated_voxels_;
+
+  // Context, and problem parameters. The context, its visibility cache, and
+  // the bounds change when the map grows.
+  const Context2D* context_;
+  std::unique_ptr<VisibilityCache2D> visibility_;
+  unsigned int num_rows_;
+  unsigned int num_cols_;
+  const unsigned int num_sources_;
+
+  // Belief of every voxel which has not yet been allocated. Rescaled when
+  // the map grows.
+  double prior_;
+
+  // Regularizer for belief update. Enforces consistency across all voxels.
+  const double regularizer_;
+
+  // List of measurements.
+  std::vector<Measurement> measurements_;
+
+  // Scratch space for sampling, reused across calls.
+  SamplerScratch<Source2D> scratch_;
+  std::vector<double> cdf_evals_;
+
+  // Random number generator.
+  std::random_device rd_;
+  std::default_random_engine rng_;
+}; // class TiledGridMap2D
+
+} // namespace radiation
+
+#endif
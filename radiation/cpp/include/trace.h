@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Lightweight tracing of hot paths. RADIATION_TRACE_SCOPE("name") records
+// the wall time spent in the enclosing scope as a complete event, and
+// WriteTrace() dumps all recorded events as Chrome trace-event JSON, which
+// chrome://tracing and ui.perfetto.dev both open.
+//
+// Tracing is compiled in only when RADIATION_ENABLE_TRACING is defined
+// (cmake -DENABLE_TRACING=ON); otherwise the macro expands to nothing and
+// WriteTrace() writes an empty trace. When enabled, each thread records into
+// its own fixed-size ring buffer, so recording an event is two clock reads
+// and a few stores, with no locks or allocation. Once a buffer is full, the
+// oldest events are overwritten. When a thread exits, its buffer (and its
+// events) are kept and handed to the next thread that starts tracing, so
+// short-lived worker threads do not each cost a new buffer.
+//
+// Event names must be string literals, since only the pointer is stored.
+// WriteTrace() and ClearTrace() should be called while no traced code is
+// running, e.g. between steps or at exit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_TRACE_H
+#define RADIATION_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace radiation {
+
+// Monotonic clock, in nanoseconds.
+uint64_t TraceClock();
+
+// Record a complete event on the calling thread's buffer.
+void RecordTraceEvent(const char* name, uint64_t start, uint64_t end);
+
+// Write all recorded events to the given file as Chrome trace-event JSON.
+// Returns false if the file cannot be written.
+bool WriteTrace(const std::string& path);
+
+// Discard all recorded events.
+void ClearTrace();
+
+// Number of per-thread buffers allocated so far. This is bounded by the peak
+// number of threads tracing at once.
+size_t GetNumTraceBuffers();
+
+// Records the lifetime of a scope.
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(const char* name)
+    : name_(name), start_(TraceClock()) {}
+  ~ScopedTrace() { RecordTraceEvent(name_, start_, TraceClock()); }
+
+ private:
+  const char* const name_;
+  const uint64_t start_;
+}; // class ScopedTrace
+
+} // namespace radiation
+
+#define RADIATION_TRACE_CONCAT_INNER(a, b) a##b
+#define RADIATION_TRACE_CONCAT(a, b) RADIATION_TRACE_CONCAT_INNER(a, b)
+
+#ifdef RADIATION_ENABLE_TRACING
+#define RADIATION_TRACE_SCOPE(name)                                     \
+  const ::radiation::ScopedTrace                                        \
+  RADIATION_TRACE_CONCAT(radiation_trace_, __LINE__)(name)
+#else
+#define RADIATION_TRACE_SCOPE(name) ((void) 0)
+#endif
+
+#endif
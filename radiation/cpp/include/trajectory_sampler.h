@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sampling and planning shared by grid maps of any dimension. A map type
+// must define the member types ContextType, PoseType, MovementType,
+// SensorType, and SourceType, and provide
+//   const ContextType& GetContext() const;
+//   unsigned int GetNumSources() const;
+//   bool GenerateSources(std::vector<SourceType>& sources);
+//   unsigned int Sense(const SensorType& sensor,
+//                      const std::vector<SourceType>& sources);
+//   void GenerateEntropyVector(...);  // same signature as below
+// Trajectories are encoded with RadixCodec, using the TrajectoryBase and
+// MovementDigit overloads for the map's context and movement types, and
+// decoded with the matching DecodeTrajectory overload.
+//
+// Everything here is a template, so each map gets its own instantiation and
+// there is no runtime dispatch in the sampling loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_TRAJECTORY_SAMPLER_H
+#define RADIATION_TRAJECTORY_SAMPLER_H
+
+#include <encoding.h>
+#include <entropy_estimators.h>
+#include <radix_codec.h>
+#include <trace.h>
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+
+#include <math.h>
+#include <algorithm>
+#include <utility>
+#include <random>
+#include <vector>
+
+namespace radiation {
+
+// Scratch buffers for SampleEntropyVector. Each map owns one and passes it
+// in on every call, so buffers keep their capacity from one plan to the
+// next and the sample loop does not touch the heap once they have grown.
+template <typename SourceType>
+struct SamplerScratch {
+  // Sources for the current sample.
+  std::vector<SourceType> sources_;
+
+  // Movement and measurement digits for all samples, in structure-of-arrays
+  // layout, i.e. step ss of sample ii is at [ss * num_samples + ii].
+  std::vector<unsigned int> movement_digits_;
+  std::vector<unsigned int> measurement_digits_;
+
+  // Trajectory and measurement ids for all samples, and (trajectory id,
+  // measurement id) pairs for sorting.
+  std::vector<Id64> trajectory_ids_;
+  std::vector<unsigned int> measurement_ids_;
+  std::vector< std::pair<Id64, unsigned int> > samples_;
+}; // struct SamplerScratch
+
+// Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
+// is the entropy of Z given trajectory X = i, starting from the given pose.
+// Random sources are drawn from the map's belief, and random trajectories
+// are drawn using 'rng'. Entropies are estimated from each trajectory's
+// histogram of measurement sequences with the given estimator. If
+// 'histogram' is given, the histograms are moved into it, with one row per
+// measurement id and one column per entry of 'trajectory_ids'.
+template <typename MapType>
+void SampleEntropyVector(MapType& map, std::default_random_engine& rng,
+                         unsigned int num_samples, unsigned int num_steps,
+                         const typename MapType::PoseType& pose,
+                         double sensor_fov,
+                         SamplerScratch<typename MapType::SourceType>& scratch,
+                         Eigen::VectorXd& hzx,
+                         std::vector<Id64>& trajectory_ids,
+                         EntropyEstimator estimator =
+                         EntropyEstimator::kClippedPlugIn,
+                         Eigen::MatrixXd* histogram = nullptr) {
+  RADIATION_TRACE_SCOPE("SampleEntropyVector");
+  typedef typename MapType::PoseType PoseType;
+  typedef typename MapType::MovementType MovementType;
+  typedef typename MapType::SensorType SensorType;
+
+  // Compute the number of possible measurement vectors.
+  const unsigned int num_sources = map.GetNumSources();
+  const unsigned int kNumMeasurements = pow(num_sources + 1, num_steps);
+
+  // Codecs for trajectory and measurement ids.
+  const unsigned int num_movements = TrajectoryBase(map.GetContext());
+  CHECK(RadixCodec<Id64>::Fits(num_movements, num_steps))
+    << "Trajectory id overflow. Try fewer steps.";
+  const RadixCodec<Id64> trajectory_codec(num_movements, num_steps);
+  const RadixCodec<unsigned int> measurement_codec(num_sources + 1, num_steps);
+
+  // Size scratch buffers up front. This only allocates if they have never
+  // been this large before.
+  scratch.sources_.reserve(num_sources);
+  scratch.movement_digits_.resize(num_steps * num_samples);
+  scratch.measurement_digits_.resize(num_steps * num_samples);
+  scratch.trajectory_ids_.resize(num_samples);
+  scratch.measurement_ids_.resize(num_samples);
+  scratch.samples_.resize(num_samples);
+
+  // Generate a ton of sampled data.
+  unsigned int num_valid_samples = 0;
+  {
+    RADIATION_TRACE_SCOPE("SampleEntropyVector/sample");
+    for (unsigned int ii = 0; ii < num_samples; ii++) {
+      // Generate random sources on the grid according to the current
+      // 'belief'.
+      if (!map.GenerateSources(scratch.sources_)) {
+        VLOG(1) << "Unable to generate sources. Skipping this sample.";
+        continue;
+      }
+
+      // Pick a random trajectory starting at the given pose. At each step,
+      // take a measurement and record the data.
+      PoseType current_pose = pose;
+      unsigned int num_taken = 0;
+      while (num_taken < num_steps) {
+        const MovementType step(map.GetContext(), rng);
+        if (current_pose.MoveBy(step)) {
+          const SensorType sensor(current_pose, sensor_fov);
+          const unsigned int kIndex =
+            num_taken * num_samples + num_valid_samples;
+          scratch.movement_digits_[kIndex] =
+            MovementDigit(step, map.GetContext());
+          scratch.measurement_digits_[kIndex] =
+            map.Sense(sensor, scratch.sources_);
+          num_taken++;
+        }
+      }
+
+      num_valid_samples++;
+    }
+  }
+
+  // Compute trajectory and measurement sequence ids.
+  {
+    RADIATION_TRACE_SCOPE("SampleEntropyVector/encode");
+    trajectory_codec.EncodeBatch(scratch.movement_digits_.data(),
+                                 num_valid_samples,
+                                 scratch.trajectory_ids_.data(), num_samples);
+    measurement_codec.EncodeBatch(scratch.measurement_digits_.data(),
+                                  num_valid_samples,
+                                  scratch.measurement_ids_.data(),
+                                  num_samples);
+  }
+
+  // Sort samples by trajectory, so that each trajectory's samples are
+  // contiguous and trajectories come out in increasing id order.
+  {
+    RADIATION_TRACE_SCOPE("SampleEntropyVector/sort");
+    for (unsigned int ii = 0; ii < num_valid_samples; ii++)
+      scratch.samples_[ii] = std::make_pair(scratch.trajectory_ids_[ii],
+                                            scratch.measurement_ids_[ii]);
+
+    std::sort(scratch.samples_.begin(),
+              scratch.samples_.begin() + num_valid_samples);
+  }
+
+  // Count samples for each trajectory into a matrix joint distribution.
+  trajectory_ids.clear();
+  for (unsigned int ii = 0; ii < num_valid_samples; ii++) {
+    const Id64 trajectory_id = scratch.samples_[ii].first;
+    if (trajectory_ids.empty() || trajectory_id != trajectory_ids.back())
+      trajectory_ids.push_back(trajectory_id);
+  }
+
+  const unsigned int kNumTrajectories = trajectory_ids.size();
+  Eigen::MatrixXd pzx;
+  {
+    RADIATION_TRACE_SCOPE("SampleEntropyVector/histogram");
+    pzx = Eigen::MatrixXd::Zero(kNumMeasurements, kNumTrajectories);
+
+    int idx = -1;
+    for (unsigned int ii = 0; ii < num_valid_samples; ii++) {
+      if (idx < 0 || scratch.samples_[ii].first != trajectory_ids[idx])
+        idx++;
+
+      pzx(scratch.samples_[ii].second, idx) += 1.0;
+    }
+  }
+
+  // Compute [h_{Z|X}], the conditional entropy vector, from the counts in
+  // each column.
+  RADIATION_TRACE_SCOPE("SampleEntropyVector/entropy");
+  hzx.resize(kNumTrajectories);
+  for (unsigned int jj = 0; jj < kNumTrajectories; jj++) {
+    hzx(jj) = EstimateEntropy(pzx.col(jj).data(), kNumMeasurements,
+                              estimator);
+
+    // Make sure entropies are non-negative.
+    CHECK(hzx(jj) >= 0.0);
+  }
+
+  if (histogram != nullptr)
+    histogram->swap(pzx);
+}
+
+// Pick the trajectory with the greatest conditional entropy from the given
+// entropy vector, and decode it starting from the given pose. Returns false
+// if no trajectory could be found.
+template <typename PoseType>
+bool SelectTrajectory(const Eigen::VectorXd& hzx,
+                      const std::vector<Id64>& trajectory_ids,
+                      unsigned int num_steps, const PoseType& pose,
+                      std::vector<PoseType>& trajectory) {
+  CHECK(hzx.rows() == trajectory_ids.size());
+
+  // Compute the arg max of this conditional entropy vector.
+  double max_value = -1.0;
+  Id64 trajectory_id = 0;
+  for (unsigned int ii = 0; ii < hzx.rows(); ii++) {
+    if (hzx(ii) > max_value) {
+      max_value = hzx(ii);
+      trajectory_id = trajectory_ids[ii];
+    }
+  }
+
+  // Check that we found a valid trajectory (with non-negative entropy).
+  if (max_value < 0.0) {
+    VLOG(1) << "Could not find a positive conditional entropy trajectory.";
+    return false;
+  }
+
+  // Decode this trajectory id.
+  trajectory.clear();
+  DecodeTrajectory(trajectory_id, num_steps, pose, trajectory);
+  return true;
+}
+
+// Plan a trajectory of 'num_steps' poses starting from the given pose, by
+// choosing the sampled trajectory with the greatest conditional entropy.
+// Returns false if no trajectory could be found.
+template <typename MapType>
+bool PlanTrajectory(MapType& map, unsigned int num_samples,
+                    unsigned int num_steps,
+                    const typename MapType::PoseType& pose, double sensor_fov,
+                    std::vector<typename MapType::PoseType>& trajectory,
+                    EntropyEstimator estimator =
+                    EntropyEstimator::kClippedPlugIn) {
+  // Generate conditional entropy vector.
+  Eigen::VectorXd hzx;
+  std::vector<Id64> trajectory_ids;
+  map.GenerateEntropyVector(num_samples, num_steps, pose, sensor_fov,
+                            hzx, trajectory_ids, estimator);
+
+  return SelectTrajectory(hzx, trajectory_ids, num_steps, pose, trajectory);
+}
+
+} // namespace radiation
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a cache of the voxels visible from each sensor pose, accounting
+// for obstacles in the given context. A voxel is visible if its center is in
+// the sensor's field of view and the segment to it is not blocked by an
+// obstacle. Line of sight does not depend on heading or field of view, so
+// the cache stores one bitmap of unobstructed voxels per sensor cell, keyed
+// on the cell index, and tests the field of view exactly (and cheaply) on
+// every query. Sensors which are not at a voxel center are ray cast without
+// touching the cache.
+//
+// The cache holds at most a fixed number of cells, evicting the oldest
+// first. Copies share the same cache, so snapshots of a map (e.g. one per
+// planning thread) reuse the ray casts of the original. Access is guarded by
+// a mutex.
+//
+// For sensing, each copy also keeps its own bounded table of views: bitmaps
+// of the voxels visible from an exact sensor pose and field of view. Once a
+// pose has been seen, sensing from it is a bit probe per source, with no
+// lock, no shared reference count, no trigonometry, and no ray casts, even
+// for sensors off a voxel center. That table is not guarded, so a single
+// copy must not be used from several threads at once; give each thread its
+// own copy (e.g. its own map snapshot) instead.
+//
+// When the context has no obstacles, nothing is cached and sensing falls
+// through to Sensor2D directly.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADIATION_VISIBILITY_CACHE_2D_H
+#define RADIATION_VISIBILITY_CACHE_2D_H
+
+#include <context_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace radiation {
+
+class VisibilityCache2D {
+ public:
+  // Bitmap of voxels (in column-major order) visible from one sensor.
+  typedef std::vector<bool> View;
+
+  // The context must outlive the cache (and all copies of it). At most
+  // 'max_cached' cells are shared by all copies, and each copy holds at most
+  // 'max_views' views of its own.
+  explicit VisibilityCache2D(const Context2D& context,
+                             unsigned int max_cached = 1024,
+                             unsigned int max_views = 4096);
+  ~VisibilityCache2D();
+
+  // Copies share the cache of cells, but start without views.
+  VisibilityCache2D(const VisibilityCache2D& other);
+
+  // Get the (column-major) indices of all voxels visible from the sensor,
+  // computing and caching line of sight if necessary.
+  void VisibleVoxels(const Sensor2D& sensor,
+                     std::vector<unsigned int>& voxels);
+
+  // Same as above, but never touches the cache.
+  void ComputeVisibleVoxels(const Sensor2D& sensor,
+                            std::vector<unsigned int>& voxels) const;
+
+  // Get this copy's view from the sensor, computing it if necessary.
+  // Returns null if the context has no obstacles. The view stays valid until
+  // this copy's table of views fills up and is cleared.
+  const View* GetView(const Sensor2D& sensor);
+
+  // Count the sources visible from the sensor. Sources are assumed to lie at
+  // voxel centers.
+  unsigned int Sense(const Sensor2D& sensor,
+                     const std::vector<Source2D>& sources);
+
+  // Same as above, given the sensor's view (or null if there are no
+  // obstacles). Never locks.
+  unsigned int Sense(const Sensor2D& sensor, const View* view,
+                     const std::vector<Source2D>& sources) const;
+
+  // Number of cached cells, and number of this copy's views.
+  unsigned int GetNumCached() const;
+  unsigned int GetNumViews() const;
+
+  // Clear the cache (for all copies), and this copy's views.
+  void Clear();
+
+ private:
+  // Bitmap of voxels with a clear line of sight from a cell's center.
+  typedef std::vector<bool> LineOfSightMap;
+
+  // Cached bitmaps, indexed by (column-major) cell, in order of insertion.
+  struct Table {
+    std::mutex mutex;
+    std::vector< std::shared_ptr<const LineOfSightMap> > cells;
+    std::deque<unsigned int> order;
+  }; // struct Table
+
+  // Find the bitmap for the sensor's cell, computing it if necessary. Return
+  // null if the sensor is not at a voxel center.
+  std::shared_ptr<const LineOfSightMap> Lookup(const Sensor2D& sensor);
+
+  // Sensor pose and field of view, as a key into this copy's views.
+  struct ViewKey {
+    double x;
+    double y;
+    double a;
+    double fov;
+    bool operator==(const ViewKey& other) const {
+      return x == other.x && y == other.y && a == other.a && fov == other.fov;
+    }
+  }; // struct ViewKey
+
+  struct ViewKeyHash {
+    size_t operator()(const ViewKey& key) const {
+      const std::hash<double> hash;
+      size_t seed = hash(key.x);
+      seed = seed * 31 + hash(key.y);
+      seed = seed * 31 + hash(key.a);
+      return seed * 31 + hash(key.fov);
+    }
+  }; // struct ViewKeyHash
+
+  const Context2D& context_;
+  const unsigned int max_cached_;
+  const unsigned int max_views_;
+  std::shared_ptr<Table> table_;
+
+  // This copy's views, and scratch space for computing them.
+  std::unordered_map<ViewKey, View, ViewKeyHash> views_;
+  std::vector<unsigned int> voxels_;
+}; // class VisibilityCache2D
+
+} // namespace radiation
+
+#endif
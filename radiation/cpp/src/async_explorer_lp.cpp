@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Pipelined exploration on a 2D grid. Behaves like ExplorerLP, but while the
+// belief update for the current step is being solved, the next trajectory is
+// planned speculatively on a worker thread from the predicted post-step pose,
+// using a snapshot of the pre-update belief. Once the real measurement arrives
+// the speculative plan is kept if the measurement was close to what the
+// snapshot belief predicted, and otherwise replanned from the updated belief.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <async_explorer_lp.h>
+
+#include <glog/logging.h>
+#include <future>
+#include <math.h>
+
+namespace radiation {
+
+// Constructor/destructor.
+AsyncExplorerLP::~AsyncExplorerLP() {}
+AsyncExplorerLP::AsyncExplorerLP(const Context2D& context,
+                                 unsigned int num_sources, double regularizer,
+                                 unsigned int num_steps, double fov,
+                                 unsigned int num_samples,
+                                 double replan_threshold)
+  : ExplorerLP(context, num_sources, regularizer,
+               num_steps, fov, num_samples),
+    replan_threshold_(replan_threshold),
+    num_accepted_(0),
+    num_replanned_(0),
+    last_divergence_(0.0) {}
+AsyncExplorerLP::AsyncExplorerLP(const Context2D& context,
+                                 unsigned int num_sources, double regularizer,
+                                 unsigned int num_steps, double fov,
+                                 unsigned int num_samples,
+                                 double replan_threshold, unsigned int seed)
+  : ExplorerLP(context, num_sources, regularizer,
+               num_steps, fov, num_samples, seed),
+    replan_threshold_(replan_threshold),
+    num_accepted_(0),
+    num_replanned_(0),
+    last_divergence_(0.0) {}
+
+// Getters.
+unsigned int AsyncExplorerLP::GetNumAccepted() const { return num_accepted_; }
+unsigned int AsyncExplorerLP::GetNumReplanned() const { return num_replanned_; }
+double AsyncExplorerLP::GetLastDivergence() const { return last_divergence_; }
+
+// Take a step along the current plan while planning the next one in the
+// background.
+bool AsyncExplorerLP::PipelinedStep(double& entropy) {
+  // The very first step (or the step after a failure) has nothing to overlap
+  // with, so plan synchronously.
+  if (plan_.empty() && !PlanAhead(plan_))
+    return false;
+
+  // Predict the post-step pose and the measurement we expect to see there.
+  const GridPose2D predicted_pose = plan_[0];
+  const double expected_measurement =
+    map_.ExpectedMeasurement(Sensor2D(predicted_pose, fov_));
+
+  // Launch the speculative plan on a snapshot of the current belief. The
+  // snapshot is owned by the worker, so the update below can proceed freely.
+  // Seed it here, so that episodes are reproducible.
+  const Eigen::MatrixXd snapshot = map_.GetImmutableBelief();
+  const unsigned int seed = rng_();
+  const unsigned int num_sources = map_.GetNumSources();
+  const double regularizer = map_.GetRegularizer();
+
+  std::vector<GridPose2D> next_plan;
+  std::future<bool> speculation = std::async(std::launch::async, [&]() {
+      GridMap2D snapshot_map(context_, snapshot, num_sources, regularizer,
+                             map_.GetVisibility());
+      snapshot_map.Seed(seed);
+      return PlanAhead(snapshot_map, predicted_pose, next_plan);
+    });
+
+  // Meanwhile, take the step and solve for the updated belief. Sense through
+  // the map, so the measurement is occluded exactly as in the update.
+  const unsigned int measurement =
+    map_.Sense(Sensor2D(predicted_pose, fov_), sources_);
+  entropy = TakeStep(plan_);
+
+  // Validate the speculative plan against the real measurement.
+  const bool planned = speculation.get();
+  last_divergence_ =
+    fabs(static_cast<double>(measurement) - expected_measurement);
+  if (planned && last_divergence_ <= replan_threshold_) {
+    plan_.swap(next_plan);
+    num_accepted_++;
+    return true;
+  }
+
+  // The measurement was surprising (or speculation failed), so patch the plan
+  // by replanning from the updated belief.
+  VLOG(1) << "Discarding speculative plan. Measured " << measurement
+          << ", expected " << expected_measurement << ".";
+  num_replanned_++;
+  if (!PlanAhead(plan_))
+    plan_.clear();
+
+  return true;
+}
+
+} // namespace radiation
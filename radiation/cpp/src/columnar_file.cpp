@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a simple binary columnar file format for simulation outputs, and a
+// class which creates and opens such files through mmap. See header for the
+// layout.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <columnar_file.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace radiation {
+
+namespace {
+const char kMagic[8] = { 'R', 'A', 'D', 'C', 'O', 'L', '0', '1' };
+const uint32_t kVersion = 1;
+const size_t kHeaderSize = 64;
+const size_t kDescriptorSize = 64;
+const size_t kMaxNameLength = 31;
+const size_t kAlignment = 64;
+
+// Round up to the next multiple of 'kAlignment'.
+uint64_t Align(uint64_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Copy plain values in and out of the mapping.
+template <typename T>
+void Put(char* data, size_t offset, T value) {
+  memcpy(data + offset, &value, sizeof(value));
+}
+
+template <typename T>
+T Get(const char* data, size_t offset) {
+  T value;
+  memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+bool IsValidType(uint32_t type) {
+  return type >= static_cast<uint32_t>(ColumnType::kUInt8) &&
+    type <= static_cast<uint32_t>(ColumnType::kFloat64);
+}
+} // namespace
+
+// Size of one element of the given type, in bytes.
+size_t ColumnTypeSize(ColumnType type) {
+  switch (type) {
+  case ColumnType::kUInt8:
+    return 1;
+  case ColumnType::kUInt16:
+    return 2;
+  case ColumnType::kUInt32:
+  case ColumnType::kInt32:
+  case ColumnType::kFloat32:
+    return 4;
+  case ColumnType::kUInt64:
+  case ColumnType::kInt64:
+  case ColumnType::kFloat64:
+    return 8;
+  }
+
+  LOG(FATAL) << "Unknown column type " << static_cast<uint32_t>(type) << ".";
+  return 0;
+}
+
+ColumnarFile::ColumnarFile() : data_(NULL), size_(0), writable_(false) {}
+ColumnarFile::~ColumnarFile() { Close(); }
+
+// Create a file with the given columns and parameters.
+bool ColumnarFile::Create(
+  const std::string& path, const std::vector<ColumnSpec>& columns,
+  const std::map<std::string, std::string>& parameters) {
+  Close();
+
+  // Serialize parameters.
+  std::string parameter_text;
+  for (const auto& entry : parameters) {
+    CHECK(!entry.first.empty() &&
+          entry.first.find_first_of("=\n") == std::string::npos)
+      << "Invalid parameter name \"" << entry.first << "\".";
+    CHECK(entry.second.find('\n') == std::string::npos)
+      << "Parameter \"" << entry.first << "\" contains a newline.";
+    parameter_text += entry.first + "=" + entry.second + "\n";
+  }
+
+  // Lay out the file.
+  const uint64_t parameters_offset =
+    kHeaderSize + kDescriptorSize * columns.size();
+  uint64_t offset = Align(parameters_offset + parameter_text.size());
+
+  std::vector<uint64_t> offsets;
+  for (const auto& column : columns) {
+    CHECK(!column.name.empty() && column.name.size() <= kMaxNameLength)
+      << "Column names must have 1 to " << kMaxNameLength << " characters.";
+    for (size_t ii = 0; ii < offsets.size(); ii++)
+      CHECK(columns[ii].name != column.name)
+        << "Duplicate column \"" << column.name << "\".";
+
+    offsets.push_back(offset);
+    offset = Align(offset + column.num_rows * column.width *
+                   ColumnTypeSize(column.type));
+  }
+
+  const uint64_t size = offset;
+
+  // Create the file at full size, and map it.
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LOG(ERROR) << "Could not create " << path << ": " << strerror(errno);
+    return false;
+  }
+
+  if (ftruncate(fd, size) != 0) {
+    LOG(ERROR) << "Could not resize " << path << ": " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Could not map " << path << ": " << strerror(errno);
+    return false;
+  }
+
+  data_ = static_cast<char*>(data);
+  size_ = size;
+  writable_ = true;
+  columns_ = columns;
+  offsets_ = offsets;
+  parameters_ = parameters;
+
+  // Write header, descriptors, and parameters. The rest is already zero.
+  memcpy(data_, kMagic, sizeof(kMagic));
+  Put<uint32_t>(data_, 8, kVersion);
+  Put<uint32_t>(data_, 12, columns_.size());
+  Put<uint64_t>(data_, 16, parameters_offset);
+  Put<uint64_t>(data_, 24, parameter_text.size());
+
+  for (size_t ii = 0; ii < columns_.size(); ii++) {
+    const size_t descriptor = kHeaderSize + kDescriptorSize * ii;
+    memcpy(data_ + descriptor, columns_[ii].name.data(),
+           columns_[ii].name.size());
+    Put<uint32_t>(data_, descriptor + 32,
+                  static_cast<uint32_t>(columns_[ii].type));
+    Put<uint64_t>(data_, descriptor + 40, columns_[ii].num_rows);
+    Put<uint64_t>(data_, descriptor + 48, columns_[ii].width);
+    Put<uint64_t>(data_, descriptor + 56, offsets_[ii]);
+  }
+
+  memcpy(data_ + parameters_offset, parameter_text.data(),
+         parameter_text.size());
+  return true;
+}
+
+// Open an existing file and map it read-only.
+bool ColumnarFile::Open(const std::string& path) {
+  Close();
+
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << "Could not open " << path << ": " << strerror(errno);
+    return false;
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < kHeaderSize) {
+    LOG(ERROR) << path << " is too small to be a columnar file.";
+    close(fd);
+    return false;
+  }
+
+  const size_t size = status.st_size;
+  void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Could not map " << path << ": " << strerror(errno);
+    return false;
+  }
+
+  data_ = static_cast<char*>(data);
+  size_ = size;
+  writable_ = false;
+
+  // Parse and validate everything before handing out pointers.
+  const uint32_t num_columns = Get<uint32_t>(data_, 12);
+  const uint64_t parameters_offset = Get<uint64_t>(data_, 16);
+  const uint64_t parameters_size = Get<uint64_t>(data_, 24);
+  if (memcmp(data_, kMagic, sizeof(kMagic)) != 0 ||
+      Get<uint32_t>(data_, 8) != kVersion ||
+      kHeaderSize + kDescriptorSize * static_cast<uint64_t>(num_columns) >
+      size_ || parameters_offset > size_ ||
+      parameters_size > size_ - parameters_offset) {
+    LOG(ERROR) << path << " is not a valid columnar file.";
+    Close();
+    return false;
+  }
+
+  for (uint32_t ii = 0; ii < num_columns; ii++) {
+    const size_t descriptor = kHeaderSize + kDescriptorSize * ii;
+    const uint32_t type = Get<uint32_t>(data_, descriptor + 32);
+
+    ColumnSpec column;
+    column.name = std::string(data_ + descriptor,
+                              strnlen(data_ + descriptor, 32));
+    column.type = static_cast<ColumnType>(type);
+    column.num_rows = Get<uint64_t>(data_, descriptor + 40);
+    column.width = Get<uint64_t>(data_, descriptor + 48);
+    const uint64_t offset = Get<uint64_t>(data_, descriptor + 56);
+
+    // Check the column fits, without overflowing.
+    const uint64_t element_size = IsValidType(type) ?
+      ColumnTypeSize(column.type) : 0;
+    const bool fits = element_size > 0 && offset <= size_ &&
+      (column.width == 0 ||
+       column.num_rows <= (size_ - offset) / element_size / column.width);
+    if (!fits || offset % kAlignment != 0) {
+      LOG(ERROR) << "Column \"" << column.name << "\" in " << path
+                 << " is invalid.";
+      Close();
+      return false;
+    }
+
+    columns_.push_back(column);
+    offsets_.push_back(offset);
+  }
+
+  // Parse parameters.
+  const std::string parameter_text(data_ + parameters_offset, parameters_size);
+  size_t start = 0;
+  while (start < parameter_text.size()) {
+    size_t end = parameter_text.find('\n', start);
+    if (end == std::string::npos)
+      end = parameter_text.size();
+
+    const std::string line = parameter_text.substr(start, end - start);
+    const size_t equals = line.find('=');
+    if (equals != std::string::npos)
+      parameters_[line.substr(0, equals)] = line.substr(equals + 1);
+
+    start = end + 1;
+  }
+
+  return true;
+}
+
+// Unmap the file, flushing any changes.
+void ColumnarFile::Close() {
+  if (data_ != NULL) {
+    if (writable_)
+      msync(data_, size_, MS_SYNC);
+    munmap(data_, size_);
+  }
+
+  data_ = NULL;
+  size_ = 0;
+  writable_ = false;
+  columns_.clear();
+  offsets_.clear();
+  parameters_.clear();
+}
+
+// Find a column by name.
+const ColumnSpec* ColumnarFile::FindColumn(const std::string& name) const {
+  for (const auto& column : columns_) {
+    if (column.name == name)
+      return &column;
+  }
+
+  return NULL;
+}
+
+// Pointer to a column's data, after checking its type.
+void* ColumnarFile::ColumnData(const std::string& name,
+                               ColumnType type) const {
+  CHECK(IsOpen());
+  for (size_t ii = 0; ii < columns_.size(); ii++) {
+    if (columns_[ii].name != name)
+      continue;
+
+    CHECK(columns_[ii].type == type)
+      << "Column \"" << name << "\" has a different type.";
+    return data_ + offsets_[ii];
+  }
+
+  LOG(FATAL) << "No column \"" << name << "\".";
+  return NULL;
+}
+
+} // namespace radiation
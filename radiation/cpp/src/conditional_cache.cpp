@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a persistent, on-disk cache of sampled conditional entropy vectors
+// [h_{Z|X}] and their trajectory ids. See header for details.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <conditional_cache.h>
+#include <columnar_file.h>
+
+#include <glog/logging.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Bump this whenever the key or entry layout changes, so stale entries are
+// never matched.
+const Id64 kFormatVersion = 3;
+
+// Mix a 64-bit word into a running FNV-1a hash, one byte at a time.
+Id64 HashWord(Id64 hash, Id64 word) {
+  const Id64 kPrime = 1099511628211ULL;
+  for (unsigned int ii = 0; ii < 8; ii++) {
+    hash ^= (word >> (8 * ii)) & 0xff;
+    hash *= kPrime;
+  }
+
+  return hash;
+}
+
+// Mix in the exact bits of a double.
+Id64 HashDouble(Id64 hash, double value) {
+  Id64 word;
+  memcpy(&word, &value, sizeof(word));
+  return HashWord(hash, word);
+}
+
+// Temporary files get unique names within the process.
+std::atomic<unsigned int> num_temporary_files(0);
+} // namespace
+
+// Constructor/destructor.
+ConditionalCache::~ConditionalCache() {}
+ConditionalCache::ConditionalCache(const std::string& directory,
+                                   double quantum)
+  : directory_(directory),
+    quantum_(quantum) {
+  CHECK(quantum_ > 0.0);
+  if (mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST)
+    LOG(ERROR) << "Could not create " << directory_ << ": "
+               << strerror(errno);
+}
+
+// Key for the conditionals sampled from the given map and pose.
+Id64 ConditionalCache::Key(const GridMap2D& map, unsigned int num_samples,
+                           unsigned int num_steps, const GridPose2D& pose,
+                           double sensor_fov,
+                           EntropyEstimator estimator) const {
+  const Context2D& context = map.GetContext();
+  Id64 hash = 14695981039346656037ULL;
+  hash = HashWord(hash, kFormatVersion);
+
+  // Grid, movements, and obstacles.
+  hash = HashWord(hash, context.GetNumRows());
+  hash = HashWord(hash, context.GetNumCols());
+  for (unsigned int ii = 0; ii < context.GetNumDeltaXs(); ii++)
+    hash = HashDouble(hash, context.GetDeltaX(ii));
+  hash = HashWord(hash, context.GetNumDeltaXs());
+  for (unsigned int ii = 0; ii < context.GetNumDeltaYs(); ii++)
+    hash = HashDouble(hash, context.GetDeltaY(ii));
+  hash = HashWord(hash, context.GetNumDeltaYs());
+  for (unsigned int ii = 0; ii < context.GetNumDeltaAngles(); ii++)
+    hash = HashDouble(hash, context.GetDeltaAngle(ii));
+  hash = HashWord(hash, context.GetNumDeltaAngles());
+  hash = HashDouble(hash, context.GetAngularStep());
+
+  if (context.HasObstacles()) {
+    for (unsigned int jj = 0; jj < context.GetNumCols(); jj++)
+      for (unsigned int ii = 0; ii < context.GetNumRows(); ii++)
+        hash = HashWord(hash, context.IsObstacle(ii, jj));
+  }
+
+  // Problem parameters and starting pose.
+  hash = HashWord(hash, map.GetNumSources());
+  hash = HashWord(hash, num_samples);
+  hash = HashWord(hash, num_steps);
+  hash = HashDouble(hash, sensor_fov);
+  hash = HashDouble(hash, pose.GetX());
+  hash = HashDouble(hash, pose.GetY());
+  hash = HashDouble(hash, pose.GetAngle());
+  hash = HashWord(hash, static_cast<Id64>(estimator));
+
+  // Quantized belief, in column-major order.
+  const Eigen::MatrixXd& belief = map.GetImmutableBelief();
+  for (int jj = 0; jj < belief.cols(); jj++)
+    for (int ii = 0; ii < belief.rows(); ii++)
+      hash = HashWord(hash, static_cast<Id64>(
+                        llround(belief(ii, jj) / quantum_)));
+
+  return hash;
+}
+
+// Seed with which to sample the entry for the given key. Folds the key
+// into 32 bits, so every bit of the hash affects the seed.
+unsigned int ConditionalCache::SamplerSeed(Id64 key) {
+  return static_cast<unsigned int>(key ^ (key >> 32));
+}
+
+// Look up an entry.
+bool ConditionalCache::Lookup(Id64 key, Eigen::VectorXd& hzx,
+                              std::vector<Id64>& trajectory_ids) const {
+  const std::string path = EntryPath(key);
+  if (access(path.c_str(), R_OK) != 0)
+    return false;
+
+  ColumnarFile file;
+  if (!file.Open(path))
+    return false;
+
+  // Guard against files copied or renamed by hand.
+  const ColumnSpec* hzx_spec = file.FindColumn("hzx");
+  const ColumnSpec* ids_spec = file.FindColumn("trajectory_ids");
+  const auto entry_key = file.GetParameters().find("key");
+  if (hzx_spec == NULL || ids_spec == NULL ||
+      hzx_spec->type != ColumnType::kFloat64 ||
+      ids_spec->type != ColumnType::kUInt64 ||
+      hzx_spec->num_rows != ids_spec->num_rows ||
+      hzx_spec->width != 1 || ids_spec->width != 1 ||
+      entry_key == file.GetParameters().end() ||
+      entry_key->second != std::to_string(key)) {
+    LOG(WARNING) << "Ignoring malformed cache entry " << path << ".";
+    return false;
+  }
+
+  const size_t num_trajectories = hzx_spec->num_rows;
+  const double* hzx_data = file.GetData<double>("hzx");
+  const uint64_t* ids_data = file.GetData<uint64_t>("trajectory_ids");
+  hzx = Eigen::Map<const Eigen::VectorXd>(hzx_data, num_trajectories);
+  trajectory_ids.assign(ids_data, ids_data + num_trajectories);
+  return true;
+}
+
+// Store an entry, replacing any existing one.
+bool ConditionalCache::Store(Id64 key, const Eigen::VectorXd& hzx,
+                             const std::vector<Id64>& trajectory_ids) const {
+  CHECK(hzx.rows() == trajectory_ids.size());
+  const uint64_t num_trajectories = trajectory_ids.size();
+
+  std::vector<ColumnSpec> columns;
+  columns.push_back(ColumnSpec{"hzx", ColumnType::kFloat64,
+                               num_trajectories, 1});
+  columns.push_back(ColumnSpec{"trajectory_ids", ColumnType::kUInt64,
+                               num_trajectories, 1});
+
+  std::map<std::string, std::string> parameters;
+  parameters["key"] = std::to_string(key);
+
+  // Write everything to a temporary file first.
+  const std::string path = EntryPath(key);
+  const std::string temporary_path = path + ".tmp." +
+    std::to_string(getpid()) + "." + std::to_string(num_temporary_files++);
+  {
+    ColumnarFile file;
+    if (!file.Create(temporary_path, columns, parameters))
+      return false;
+
+    std::copy(hzx.data(), hzx.data() + num_trajectories,
+              file.GetMutableData<double>("hzx"));
+    std::copy(trajectory_ids.begin(), trajectory_ids.end(),
+              file.GetMutableData<uint64_t>("trajectory_ids"));
+  }
+
+  // Atomically move it into place.
+  if (rename(temporary_path.c_str(), path.c_str()) != 0) {
+    LOG(ERROR) << "Could not write " << path << ": " << strerror(errno);
+    unlink(temporary_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+// Path of the entry with the given key.
+std::string ConditionalCache::EntryPath(Id64 key) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.rcol",
+           static_cast<unsigned long long>(key));
+  return directory_ + "/" + name;
+}
+
+} // namespace radiation
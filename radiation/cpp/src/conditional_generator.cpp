@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Generates the conditionals used by the LP formulation, with sparse joint
+// counts and parallel sampling. See header for details.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <conditional_generator.h>
+#include <radix_codec.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+#include <movement_2d.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <future>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Hash functor for pairs of ids.
+struct PairHash {
+  template <typename A, typename B>
+  size_t operator()(const std::pair<A, B>& pair) const {
+    const Id64 kPrime = 1099511628211ULL;
+    const Id64 first = static_cast<Id64>(pair.first);
+    const Id64 second = static_cast<Id64>(pair.second);
+    return static_cast<size_t>((first * kPrime) ^ second);
+  }
+}; // struct PairHash
+
+// Joint counts of (trajectory, measurement) and (measurement, map) pairs.
+typedef std::unordered_map<std::pair<Id64, unsigned int>, double, PairHash>
+  TrajectoryCounts;
+typedef std::unordered_map<std::pair<unsigned int, Id64>, double, PairHash>
+  MapCounts;
+
+struct JointCounts {
+  TrajectoryCounts zx;
+  MapCounts zm;
+  size_t num_samples;
+}; // struct JointCounts
+
+// Draw samples on a snapshot of the given belief, and count them.
+void SampleJointCounts(const Context2D& context, const Eigen::MatrixXd& belief,
+                       unsigned int num_sources, double regularizer,
+                       const VisibilityCache2D& visibility,
+                       unsigned int num_samples, unsigned int num_steps,
+                       const GridPose2D& pose, double sensor_fov,
+                       unsigned int seed, unsigned int worker,
+                       JointCounts& counts) {
+  std::seed_seq seed_sequence({ seed, worker });
+  std::default_random_engine rng(seed_sequence);
+
+  GridMap2D snapshot(context, belief, num_sources, regularizer, visibility);
+  snapshot.Seed(rng());
+
+  const RadixCodec<Id64> trajectory_codec(TrajectoryBase(context), num_steps);
+  const RadixCodec<unsigned int> measurement_codec(num_sources + 1,
+                                                   num_steps);
+
+  std::vector<Source2D> sources;
+  std::vector<unsigned int> movement_digits(num_steps);
+  std::vector<unsigned int> measurement_digits(num_steps);
+  counts.num_samples = 0;
+
+  for (unsigned int ii = 0; ii < num_samples; ii++) {
+    // Generate random sources on the grid according to the belief.
+    if (!snapshot.GenerateSources(sources)) {
+      VLOG(1) << "Unable to generate sources. Skipping this sample.";
+      continue;
+    }
+
+    Id64 map_id = 0;
+    CHECK(EncodeMap(sources, context.GetNumRows(), context.GetNumCols(),
+                    map_id)) << "Map id overflow. Try fewer sources.";
+
+    // Pick a random trajectory starting at the given pose. At each step,
+    // take a measurement.
+    GridPose2D current_pose = pose;
+    unsigned int num_taken = 0;
+    while (num_taken < num_steps) {
+      const Movement2D step(context, rng);
+      if (current_pose.MoveBy(step)) {
+        const Sensor2D sensor(current_pose, sensor_fov);
+        movement_digits[num_taken] = MovementDigit(step, context);
+        measurement_digits[num_taken] = snapshot.Sense(sensor, sources);
+        num_taken++;
+      }
+    }
+
+    // Record this sample in both tables.
+    const Id64 trajectory_id = trajectory_codec.Encode(movement_digits.data());
+    const unsigned int measurement_id =
+      measurement_codec.Encode(measurement_digits.data());
+
+    counts.zx[std::make_pair(trajectory_id, measurement_id)] += 1.0;
+    counts.zm[std::make_pair(measurement_id, map_id)] += 1.0;
+    counts.num_samples++;
+  }
+}
+
+// Index each id by its position in the sorted list of distinct ids.
+template <typename IdType>
+void IndexIds(std::vector<IdType>& ids,
+              std::unordered_map<IdType, unsigned int>& index) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+  index.clear();
+  index.reserve(ids.size());
+  for (unsigned int ii = 0; ii < ids.size(); ii++)
+    index[ids[ii]] = ii;
+}
+} // namespace
+
+// Generate conditionals.
+void GenerateConditionals(const GridMap2D& map, unsigned int num_samples,
+                          unsigned int num_steps, const GridPose2D& pose,
+                          double sensor_fov, unsigned int num_threads,
+                          unsigned int seed, Conditionals& conditionals) {
+  const Context2D& context = map.GetContext();
+  const unsigned int num_sources = map.GetNumSources();
+  CHECK(RadixCodec<Id64>::Fits(TrajectoryBase(context), num_steps))
+    << "Trajectory id overflow. Try fewer steps.";
+  CHECK(RadixCodec<unsigned int>::Fits(num_sources + 1, num_steps))
+    << "Measurement id overflow. Try fewer steps.";
+
+  if (num_threads == 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  num_threads = std::max(1u, std::min(num_threads, num_samples));
+
+  // Sample in parallel. Every worker samples from its own snapshot of the
+  // belief, since each map's random number generator is not thread-safe.
+  // Snapshots share the map's visibility cache, which is.
+  const Eigen::MatrixXd& belief = map.GetImmutableBelief();
+  std::vector<JointCounts> counts(num_threads);
+  std::vector< std::future<void> > workers;
+
+  for (unsigned int ww = 0; ww < num_threads; ww++) {
+    const unsigned int worker_samples = num_samples / num_threads +
+      ((ww < num_samples % num_threads) ? 1 : 0);
+    workers.push_back(std::async(std::launch::async, [&, ww, worker_samples]() {
+          SampleJointCounts(context, belief, num_sources,
+                            map.GetRegularizer(), map.GetVisibility(),
+                            worker_samples, num_steps,
+                            pose, sensor_fov, seed, ww, counts[ww]);
+        }));
+  }
+
+  for (auto& worker : workers)
+    worker.get();
+
+  // Merge everything into the first worker's tables.
+  JointCounts& merged = counts[0];
+  for (unsigned int ww = 1; ww < num_threads; ww++) {
+    for (const auto& entry : counts[ww].zx)
+      merged.zx[entry.first] += entry.second;
+    for (const auto& entry : counts[ww].zm)
+      merged.zm[entry.first] += entry.second;
+
+    merged.num_samples += counts[ww].num_samples;
+    counts[ww] = JointCounts();
+  }
+
+  // Assign rows and columns to observed measurements and trajectories.
+  std::vector<Id64>& trajectory_ids = conditionals.trajectory_ids;
+  std::vector<unsigned int>& measurement_ids = conditionals.measurement_ids;
+  trajectory_ids.clear();
+  measurement_ids.clear();
+  for (const auto& entry : merged.zx) {
+    trajectory_ids.push_back(entry.first.first);
+    measurement_ids.push_back(entry.first.second);
+  }
+
+  std::unordered_map<Id64, unsigned int> trajectory_index;
+  std::unordered_map<unsigned int, unsigned int> measurement_index;
+  IndexIds(trajectory_ids, trajectory_index);
+  IndexIds(measurement_ids, measurement_index);
+
+  // Build [P_{Z|X}], normalizing so that all columns sum to unity.
+  std::vector<double> column_sums(trajectory_ids.size(), 0.0);
+  for (const auto& entry : merged.zx)
+    column_sums[trajectory_index[entry.first.first]] += entry.second;
+
+  std::vector< Eigen::Triplet<double> > triplets;
+  triplets.reserve(merged.zx.size());
+  for (const auto& entry : merged.zx) {
+    const unsigned int jj = trajectory_index[entry.first.first];
+    triplets.push_back(Eigen::Triplet<double>(
+      measurement_index[entry.first.second], jj,
+      entry.second / column_sums[jj]));
+  }
+
+  conditionals.pzx.resize(measurement_ids.size(), trajectory_ids.size());
+  conditionals.pzx.setFromTriplets(triplets.begin(), triplets.end());
+
+  // Compute [h_{M|Z}] from the (measurement, map) counts. With n_z samples
+  // of measurement z, of which n_zm had map m,
+  //   H(M | Z = z) = log(n_z) - sum_m n_zm log(n_zm) / n_z.
+  Eigen::VectorXd totals = Eigen::VectorXd::Zero(measurement_ids.size());
+  Eigen::VectorXd weighted_logs = Eigen::VectorXd::Zero(measurement_ids.size());
+  for (const auto& entry : merged.zm) {
+    const unsigned int ii = measurement_index[entry.first.first];
+    totals(ii) += entry.second;
+    weighted_logs(ii) += entry.second * log(entry.second);
+  }
+
+  conditionals.hzm.resize(measurement_ids.size());
+  for (unsigned int ii = 0; ii < measurement_ids.size(); ii++)
+    conditionals.hzm(ii) =
+      std::max(0.0, log(totals(ii)) - weighted_logs(ii) / totals(ii));
+
+  conditionals.num_samples = merged.num_samples;
+  conditionals.num_joint_entries = merged.zm.size();
+}
+
+} // namespace radiation
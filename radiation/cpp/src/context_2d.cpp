@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines the configuration shared by poses, movements, maps, and encoders on
+// a 2D grid: the grid dimensions, the set of allowed movements, and which
+// voxels are obstacles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <context_2d.h>
+
+#include <glog/logging.h>
+#include <math.h>
+#include <limits>
+
+namespace radiation {
+
+  // Constructor/destructor.
+  Context2D::~Context2D() {}
+  Context2D::Context2D(unsigned int num_rows, unsigned int num_cols)
+    : num_rows_(num_rows), num_cols_(num_cols),
+      delta_xs_({-1.0, 0.0, 1.0}),
+      delta_ys_({-1.0, 0.0, 1.0}),
+      delta_as_({-1.0, 0.0, 1.0}),
+      angular_step_(0.5),
+      obstacles_(num_rows * num_cols, false),
+      num_obstacles_(0) {}
+
+  // Setters.
+  void Context2D::SetDeltaXs(const std::vector<double>& delta_xs) {
+    CHECK(!delta_xs.empty());
+    delta_xs_ = delta_xs;
+  }
+
+  void Context2D::SetDeltaYs(const std::vector<double>& delta_ys) {
+    CHECK(!delta_ys.empty());
+    delta_ys_ = delta_ys;
+  }
+
+  void Context2D::SetDeltaAngles(const std::vector<double>& delta_as) {
+    CHECK(!delta_as.empty());
+    delta_as_ = delta_as;
+  }
+
+  void Context2D::SetAngularStep(double angular_step) {
+    angular_step_ = angular_step;
+  }
+
+  void Context2D::SetObstacle(unsigned int ii, unsigned int jj,
+                              bool obstacle) {
+    CHECK(ii < num_rows_ && jj < num_cols_);
+
+    const unsigned int idx = ii + jj * num_rows_;
+    if (obstacles_[idx] == obstacle)
+      return;
+
+    obstacles_[idx] = obstacle;
+    if (obstacle)
+      num_obstacles_++;
+    else
+      num_obstacles_--;
+  }
+
+  // Getters.
+  unsigned int Context2D::GetNumRows() const { return num_rows_; }
+  unsigned int Context2D::GetNumCols() const { return num_cols_; }
+
+  unsigned int Context2D::GetNumDeltaXs() const { return delta_xs_.size(); }
+  unsigned int Context2D::GetNumDeltaYs() const { return delta_ys_.size(); }
+  unsigned int Context2D::GetNumDeltaAngles() const { return delta_as_.size(); }
+  double Context2D::GetAngularStep() const { return angular_step_; }
+
+  double Context2D::GetDeltaX(unsigned int ii) const { return delta_xs_[ii]; }
+  double Context2D::GetDeltaY(unsigned int ii) const { return delta_ys_[ii]; }
+  double Context2D::GetDeltaAngle(unsigned int ii) const {
+    return angular_step_ * delta_as_[ii];
+  }
+
+  // Obstacles.
+  bool Context2D::IsObstacle(unsigned int ii, unsigned int jj) const {
+    return obstacles_[ii + jj * num_rows_];
+  }
+
+  bool Context2D::HasObstacles() const { return num_obstacles_ > 0; }
+
+  // Check whether the segment from (x, y) to the center of voxel (ii, jj)
+  // is clear.
+  bool Context2D::LineOfSight(double x, double y,
+                              unsigned int ii, unsigned int jj) const {
+    if (num_obstacles_ == 0)
+      return true;
+
+    // Direction to the target voxel center.
+    const double dx = static_cast<double>(ii) + 0.5 - x;
+    const double dy = static_cast<double>(jj) + 0.5 - y;
+
+    // Current voxel, and direction of each step.
+    int cx = static_cast<int>(floor(x));
+    int cy = static_cast<int>(floor(y));
+    const int step_x = (dx > 0.0) ? 1 : -1;
+    const int step_y = (dy > 0.0) ? 1 : -1;
+
+    // Parameter along the segment (from 0 at (x, y) to 1 at the target) at
+    // which we next cross a voxel boundary in each direction, and the change
+    // in parameter between successive boundaries.
+    const double kInfinity = std::numeric_limits<double>::infinity();
+    const double t_delta_x = (dx != 0.0) ? 1.0 / fabs(dx) : kInfinity;
+    const double t_delta_y = (dy != 0.0) ? 1.0 / fabs(dy) : kInfinity;
+    double t_max_x = (dx != 0.0) ?
+      ((step_x > 0) ? cx + 1.0 - x : x - cx) * t_delta_x : kInfinity;
+    double t_max_y = (dy != 0.0) ?
+      ((step_y > 0) ? cy + 1.0 - y : y - cy) * t_delta_y : kInfinity;
+
+    // Walk voxel by voxel. The target center is strictly inside its voxel,
+    // so we reach it within this many steps. If the segment passes exactly
+    // through a corner, step diagonally, since it only touches the two
+    // voxels beside the corner.
+    const double kTolerance = 1e-9;
+    const int target_x = static_cast<int>(ii);
+    const int target_y = static_cast<int>(jj);
+    const int max_steps = abs(target_x - cx) + abs(target_y - cy);
+    for (int step = 0; step < max_steps; step++) {
+      if (fabs(t_max_x - t_max_y) < kTolerance) {
+        cx += step_x;
+        cy += step_y;
+        t_max_x += t_delta_x;
+        t_max_y += t_delta_y;
+      } else if (t_max_x < t_max_y) {
+        cx += step_x;
+        t_max_x += t_delta_x;
+      } else {
+        cy += step_y;
+        t_max_y += t_delta_y;
+      }
+
+      if (cx == target_x && cy == target_y)
+        return true;
+
+      if (cx >= 0 && cy >= 0 &&
+          cx < static_cast<int>(num_rows_) &&
+          cy < static_cast<int>(num_cols_) &&
+          IsObstacle(cx, cy))
+        return false;
+    }
+
+    return true;
+  }
+
+} // namespace radiation
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines the configuration shared by poses, movements, maps, and encoders on
+// a 3D grid: the grid dimensions, the set of allowed movements, and which
+// voxels are obstacles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <context_3d.h>
+
+#include <glog/logging.h>
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <limits>
+
+namespace radiation {
+
+  // Constructor/destructor.
+  Context3D::~Context3D() {}
+  Context3D::Context3D(unsigned int num_rows, unsigned int num_cols,
+                       unsigned int num_layers)
+    : num_rows_(num_rows), num_cols_(num_cols), num_layers_(num_layers),
+      delta_xs_({-1.0, 0.0, 1.0}),
+      delta_ys_({-1.0, 0.0, 1.0}),
+      delta_zs_({-1.0, 0.0, 1.0}),
+      delta_as_({-1.0, 0.0, 1.0}),
+      angular_step_(0.5),
+      obstacles_(num_rows * num_cols * num_layers, false),
+      num_obstacles_(0) {}
+
+  // Setters.
+  void Context3D::SetDeltaXs(const std::vector<double>& delta_xs) {
+    CHECK(!delta_xs.empty());
+    delta_xs_ = delta_xs;
+  }
+
+  void Context3D::SetDeltaYs(const std::vector<double>& delta_ys) {
+    CHECK(!delta_ys.empty());
+    delta_ys_ = delta_ys;
+  }
+
+  void Context3D::SetDeltaZs(const std::vector<double>& delta_zs) {
+    CHECK(!delta_zs.empty());
+    delta_zs_ = delta_zs;
+  }
+
+  void Context3D::SetDeltaAngles(const std::vector<double>& delta_as) {
+    CHECK(!delta_as.empty());
+    delta_as_ = delta_as;
+  }
+
+  void Context3D::SetAngularStep(double angular_step) {
+    angular_step_ = angular_step;
+  }
+
+  void Context3D::SetObstacle(unsigned int ii, unsigned int jj,
+                              unsigned int kk, bool obstacle) {
+    CHECK(ii < num_rows_ && jj < num_cols_ && kk < num_layers_);
+
+    const unsigned int idx = ii + num_rows_ * (jj + num_cols_ * kk);
+    if (obstacles_[idx] == obstacle)
+      return;
+
+    obstacles_[idx] = obstacle;
+    if (obstacle)
+      num_obstacles_++;
+    else
+      num_obstacles_--;
+  }
+
+  // Getters.
+  unsigned int Context3D::GetNumRows() const { return num_rows_; }
+  unsigned int Context3D::GetNumCols() const { return num_cols_; }
+  unsigned int Context3D::GetNumLayers() const { return num_layers_; }
+
+  unsigned int Context3D::GetNumDeltaXs() const { return delta_xs_.size(); }
+  unsigned int Context3D::GetNumDeltaYs() const { return delta_ys_.size(); }
+  unsigned int Context3D::GetNumDeltaZs() const { return delta_zs_.size(); }
+  unsigned int Context3D::GetNumDeltaAngles() const { return delta_as_.size(); }
+  double Context3D::GetAngularStep() const { return angular_step_; }
+
+  double Context3D::GetDeltaX(unsigned int ii) const { return delta_xs_[ii]; }
+  double Context3D::GetDeltaY(unsigned int ii) const { return delta_ys_[ii]; }
+  double Context3D::GetDeltaZ(unsigned int ii) const { return delta_zs_[ii]; }
+  double Context3D::GetDeltaAngle(unsigned int ii) const {
+    return angular_step_ * delta_as_[ii];
+  }
+
+  // Obstacles.
+  bool Context3D::IsObstacle(unsigned int ii, unsigned int jj,
+                             unsigned int kk) const {
+    return obstacles_[ii + num_rows_ * (jj + num_cols_ * kk)];
+  }
+
+  bool Context3D::HasObstacles() const { return num_obstacles_ > 0; }
+
+  // Check whether the segment from (x, y, z) to the center of voxel
+  // (ii, jj, kk) is clear.
+  bool Context3D::LineOfSight(double x, double y, double z,
+                              unsigned int ii, unsigned int jj,
+                              unsigned int kk) const {
+    if (num_obstacles_ == 0)
+      return true;
+
+    // Start, direction to the target voxel center, current voxel, and
+    // direction of each step, per dimension.
+    const double start[3] = { x, y, z };
+    const double delta[3] = { static_cast<double>(ii) + 0.5 - x,
+                              static_cast<double>(jj) + 0.5 - y,
+                              static_cast<double>(kk) + 0.5 - z };
+    const int target[3] = { static_cast<int>(ii), static_cast<int>(jj),
+                            static_cast<int>(kk) };
+    const int size[3] = { static_cast<int>(num_rows_),
+                          static_cast<int>(num_cols_),
+                          static_cast<int>(num_layers_) };
+
+    // Parameter along the segment (from 0 at the start to 1 at the target)
+    // at which we next cross a voxel boundary in each dimension, and the
+    // change in parameter between successive boundaries.
+    const double kInfinity = std::numeric_limits<double>::infinity();
+    int cell[3];
+    int step[3];
+    double t_delta[3];
+    double t_max[3];
+    int max_steps = 0;
+    for (unsigned int dd = 0; dd < 3; dd++) {
+      cell[dd] = static_cast<int>(floor(start[dd]));
+      step[dd] = (delta[dd] > 0.0) ? 1 : -1;
+      t_delta[dd] = (delta[dd] != 0.0) ? 1.0 / fabs(delta[dd]) : kInfinity;
+      t_max[dd] = (delta[dd] != 0.0) ?
+        ((step[dd] > 0) ? cell[dd] + 1.0 - start[dd] : start[dd] - cell[dd]) *
+        t_delta[dd] : kInfinity;
+      max_steps += abs(target[dd] - cell[dd]);
+    }
+
+    // Walk voxel by voxel. If the segment passes exactly through an edge or
+    // corner, step across every boundary it meets there at once, since it
+    // only touches the voxels beside it.
+    const double kTolerance = 1e-9;
+    for (int nn = 0; nn < max_steps; nn++) {
+      const double t_next = std::min(t_max[0], std::min(t_max[1], t_max[2]));
+      for (unsigned int dd = 0; dd < 3; dd++) {
+        if (t_max[dd] - t_next < kTolerance) {
+          cell[dd] += step[dd];
+          t_max[dd] += t_delta[dd];
+        }
+      }
+
+      if (cell[0] == target[0] && cell[1] == target[1] &&
+          cell[2] == target[2])
+        return true;
+
+      if (cell[0] >= 0 && cell[1] >= 0 && cell[2] >= 0 &&
+          cell[0] < size[0] && cell[1] < size[1] && cell[2] < size[2] &&
+          IsObstacle(cell[0], cell[1], cell[2]))
+        return false;
+    }
+
+    return true;
+  }
+
+} // namespace radiation
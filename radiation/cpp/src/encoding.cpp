@@ -41,36 +41,280 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <encoding.h>
+#include <radix_codec.h>
 
 #include <glog/logging.h>
-#include <iostream>
+#include <algorithm>
 
 namespace radiation {
 
-  // Encode a sequence of movements as an unsigned integer.
-  unsigned int EncodeTrajectory(const std::vector<Movement2D>& movements) {
-    const unsigned int base =
-      Movement2D::GetNumDeltaXs() * Movement2D::GetNumDeltaYs() *
-      Movement2D::GetNumDeltaAngles();
+namespace {
+// Digits for a sequence of 2D or 3D movements.
+void TrajectoryDigits(const std::vector<Movement2D>& movements,
+                      const Context2D& context,
+                      std::vector<unsigned int>& digits) {
+  digits.clear();
+  for (const auto& movement : movements)
+    digits.push_back(MovementDigit(movement, context));
+}
+
+void TrajectoryDigits(const std::vector<Movement3D>& movements,
+                      const Context3D& context,
+                      std::vector<unsigned int>& digits) {
+  digits.clear();
+  for (const auto& movement : movements)
+    digits.push_back(MovementDigit(movement, context));
+}
+
+// Convert digits back into poses, starting from the initial pose.
+void DigitsToTrajectory(const std::vector<unsigned int>& digits,
+                        const GridPose2D& initial_pose,
+                        std::vector<GridPose2D>& trajectory) {
+  trajectory.clear();
+  const Context2D& context = initial_pose.GetContext();
+
+  GridPose2D current_pose = initial_pose;
+  for (const auto& digit : digits) {
+    const unsigned int x_id = digit % context.GetNumDeltaXs();
+    const unsigned int y_id =
+      (digit / context.GetNumDeltaXs()) % context.GetNumDeltaYs();
+    const unsigned int a_id =
+      digit / (context.GetNumDeltaXs() * context.GetNumDeltaYs());
+
+    CHECK(current_pose.MoveBy(Movement2D(context, x_id, y_id, a_id)));
+    trajectory.push_back(current_pose);
+  }
+}
+
+void DigitsToTrajectory(const std::vector<unsigned int>& digits,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory) {
+  trajectory.clear();
+  const Context3D& context = initial_pose.GetContext();
+  const unsigned int num_xy =
+    context.GetNumDeltaXs() * context.GetNumDeltaYs();
+  const unsigned int num_xyz = num_xy * context.GetNumDeltaZs();
+
+  GridPose3D current_pose = initial_pose;
+  for (const auto& digit : digits) {
+    const Movement3D step(context,
+                          digit % context.GetNumDeltaXs(),
+                          (digit / context.GetNumDeltaXs()) %
+                          context.GetNumDeltaYs(),
+                          (digit / num_xy) % context.GetNumDeltaZs(),
+                          digit / num_xyz);
+
+    CHECK(current_pose.MoveBy(step));
+    trajectory.push_back(current_pose);
+  }
+}
+
+// Decode many trajectory ids from one initial pose. Digits for all ids are
+// unpacked together, one step at a time, before walking each trajectory.
+template <typename IdType, typename PoseType>
+void DecodeTrajectoriesImpl(const std::vector<IdType>& ids,
+                            unsigned int num_steps,
+                            const PoseType& initial_pose,
+                            std::vector< std::vector<PoseType> >& trajectories) {
+  const RadixCodec<IdType> codec(TrajectoryBase(initial_pose.GetContext()),
+                                 num_steps);
+  std::vector<unsigned int> all_digits(ids.size() * num_steps);
+  codec.DecodeBatch(ids.data(), ids.size(), all_digits.data());
+
+  trajectories.resize(ids.size());
+  std::vector<unsigned int> digits(num_steps);
+  for (size_t ii = 0; ii < ids.size(); ii++) {
+    for (unsigned int ss = 0; ss < num_steps; ss++)
+      digits[ss] = all_digits[ss * ids.size() + ii];
+
+    DigitsToTrajectory(digits, initial_pose, trajectories[ii]);
+  }
+}
+
+// Digits for a list of sources, i.e. their column-major voxel indices.
+void MapDigits(const std::vector<Source2D>& sources, unsigned int num_rows,
+               std::vector<unsigned int>& digits) {
+  digits.clear();
+  for (const auto& source : sources)
+    digits.push_back(source.GetIndexX() + source.GetIndexY() * num_rows);
+}
+
+void DigitsToMap(const std::vector<unsigned int>& digits,
+                 unsigned int num_rows, std::vector<Source2D>& sources) {
+  sources.clear();
+  for (const auto& digit : digits)
+    sources.push_back(Source2D(digit % num_rows, digit / num_rows));
+}
+
+// Mix a 64-bit word into a running FNV-1a hash, one byte at a time.
+Id64 HashWord(Id64 hash, Id64 word) {
+  const Id64 kPrime = 1099511628211ULL;
+  for (unsigned int ii = 0; ii < 8; ii++) {
+    hash ^= (word >> (8 * ii)) & 0xff;
+    hash *= kPrime;
+  }
 
-    unsigned int id = 0;
-    unsigned int place_value = 1;
+  return hash;
+}
+} // namespace
+
+  // Base and digits for a sequence of 2D or 3D movements. Each movement's
+  // digit is its x index, plus y, (z,) and angle indices in increasing place
+  // value.
+  unsigned int TrajectoryBase(const Context2D& context) {
+    return context.GetNumDeltaXs() * context.GetNumDeltaYs() *
+      context.GetNumDeltaAngles();
+  }
 
-    for (size_t ii = 0; ii < movements.size(); ii++) {
-      const unsigned int x_id = movements[ii].GetIndexX();
-      const unsigned int y_id = movements[ii].GetIndexY();
-      const unsigned int a_id = movements[ii].GetIndexAngle();
+  unsigned int TrajectoryBase(const Context3D& context) {
+    return context.GetNumDeltaXs() * context.GetNumDeltaYs() *
+      context.GetNumDeltaZs() * context.GetNumDeltaAngles();
+  }
 
-      // Compute a unique identifier for this movement.
-      const unsigned int step_id =
-        x_id + y_id * Movement2D::GetNumDeltaXs() +
-        a_id * Movement2D::GetNumDeltaXs() * Movement2D::GetNumDeltaYs();
+  unsigned int MovementDigit(const Movement2D& movement,
+                             const Context2D& context) {
+    return movement.GetIndexX() + context.GetNumDeltaXs() *
+      (movement.GetIndexY() +
+       context.GetNumDeltaYs() * movement.GetIndexAngle());
+  }
 
-      // Update the overall trajectory id, and the place value.
-      id += step_id * place_value;
-      place_value *= base;
+  unsigned int MovementDigit(const Movement3D& movement,
+                             const Context3D& context) {
+    return movement.GetIndexX() + context.GetNumDeltaXs() *
+      (movement.GetIndexY() + context.GetNumDeltaYs() *
+       (movement.GetIndexZ() +
+        context.GetNumDeltaZs() * movement.GetIndexAngle()));
+  }
+
+  // Pack digits into an id, checking for overflow before each digit. Once the
+  // place value itself no longer fits, it is marked as zero, and only zero
+  // digits may follow.
+  template <typename IdType>
+  bool EncodeDigits(const std::vector<unsigned int>& digits,
+                    unsigned int base, IdType& id) {
+    CHECK(base > 0);
+    const IdType kMax = ~static_cast<IdType>(0);
+    const IdType kBase = static_cast<IdType>(base);
+
+    id = 0;
+    IdType place_value = 1;
+
+    for (size_t ii = 0; ii < digits.size(); ii++) {
+      CHECK(digits[ii] < base);
+
+      const IdType digit = static_cast<IdType>(digits[ii]);
+      if (digit > 0) {
+        if (place_value == 0 || digit > (kMax - id) / place_value)
+          return false;
+
+        id += digit * place_value;
+      }
+
+      if (place_value != 0)
+        place_value = (place_value > kMax / kBase) ? 0 : place_value * kBase;
     }
 
+    return true;
+  }
+
+  // Unpack digits from an id.
+  template <typename IdType>
+  void DecodeDigits(IdType id, unsigned int base, unsigned int num_digits,
+                    std::vector<unsigned int>& digits) {
+    CHECK(base > 0);
+    const IdType kBase = static_cast<IdType>(base);
+
+    digits.clear();
+    for (unsigned int ii = 0; ii < num_digits; ii++) {
+      digits.push_back(static_cast<unsigned int>(id % kBase));
+      id /= kBase;
+    }
+  }
+
+  // Variable-length key.
+  EncodingKey::~EncodingKey() {}
+  EncodingKey::EncodingKey()
+    : base_(1), num_digits_(0), digits_per_word_(1), hash_(0) {}
+  EncodingKey::EncodingKey(const std::vector<unsigned int>& digits,
+                           unsigned int base)
+    : base_(base), num_digits_(digits.size()), digits_per_word_(1) {
+    CHECK(base_ > 0);
+
+    // Find how many digits fit in each word, i.e. the largest k with
+    // base^k - 1 representable in 64 bits.
+    if (base_ == 1) {
+      digits_per_word_ = std::max(num_digits_, 1u);
+    } else {
+      Id64 place_value = base_;
+      while (place_value <= ~static_cast<Id64>(0) / base_) {
+        place_value *= base_;
+        digits_per_word_++;
+      }
+    }
+
+    // Pack each word.
+    for (size_t ii = 0; ii < digits.size(); ii += digits_per_word_) {
+      const std::vector<unsigned int> chunk(
+        digits.begin() + ii,
+        digits.begin() + std::min(digits.size(), ii + digits_per_word_));
+
+      Id64 word = 0;
+      CHECK(EncodeDigits(chunk, base_, word));
+      words_.push_back(word);
+    }
+
+    // Hash base, length, and words.
+    Id64 hash = 14695981039346656037ULL;
+    hash = HashWord(hash, base_);
+    hash = HashWord(hash, num_digits_);
+    for (const auto& word : words_)
+      hash = HashWord(hash, word);
+    hash_ = static_cast<size_t>(hash);
+  }
+
+  // Getters.
+  unsigned int EncodingKey::GetBase() const { return base_; }
+  unsigned int EncodingKey::GetNumDigits() const { return num_digits_; }
+  size_t EncodingKey::GetHash() const { return hash_; }
+
+  // Recover the digits.
+  void EncodingKey::GetDigits(std::vector<unsigned int>& digits) const {
+    digits.clear();
+
+    std::vector<unsigned int> chunk;
+    for (size_t ii = 0; ii < words_.size(); ii++) {
+      const unsigned int num_chunk_digits = std::min(
+        digits_per_word_,
+        num_digits_ - static_cast<unsigned int>(ii) * digits_per_word_);
+      DecodeDigits(words_[ii], base_, num_chunk_digits, chunk);
+      digits.insert(digits.end(), chunk.begin(), chunk.end());
+    }
+  }
+
+  // Comparison.
+  bool EncodingKey::operator==(const EncodingKey& other) const {
+    return hash_ == other.hash_ && base_ == other.base_ &&
+      num_digits_ == other.num_digits_ && words_ == other.words_;
+  }
+
+  bool EncodingKey::operator!=(const EncodingKey& other) const {
+    return !(*this == other);
+  }
+
+  bool EncodingKey::operator<(const EncodingKey& other) const {
+    if (base_ != other.base_)
+      return base_ < other.base_;
+    if (num_digits_ != other.num_digits_)
+      return num_digits_ < other.num_digits_;
+    return words_ < other.words_;
+  }
+
+  // Encode a sequence of movements as an unsigned integer.
+  unsigned int EncodeTrajectory(const std::vector<Movement2D>& movements,
+                                const Context2D& context) {
+    unsigned int id = 0;
+    CHECK(EncodeTrajectory(movements, context, id))
+      << "Trajectory id overflow. Use a wider id.";
     return id;
   }
 
@@ -78,60 +322,118 @@ namespace radiation {
   void DecodeTrajectory(unsigned int id, unsigned int num_steps,
                         const GridPose2D& initial_pose,
                         std::vector<GridPose2D>& trajectory) {
-    trajectory.clear();
-    const unsigned int base =
-      Movement2D::GetNumDeltaXs() * Movement2D::GetNumDeltaYs() *
-      Movement2D::GetNumDeltaAngles();
-
-    GridPose2D current_pose = initial_pose;
-    while (id > 0) {
-      const unsigned int remainder = id % base;
-
-      // Convert remainder to Movement2D.
-      const unsigned int x_id = remainder % Movement2D::GetNumDeltaXs();
-      const unsigned int y_id =
-        (remainder / Movement2D::GetNumDeltaXs()) % Movement2D::GetNumDeltaYs();
-      const unsigned int a_id =
-        remainder / (Movement2D::GetNumDeltaXs() * Movement2D::GetNumDeltaYs());
-
-      const Movement2D step(x_id, y_id, a_id);
-
-      // Append to trajectory.
-      GridPose2D next_pose = current_pose;
-      CHECK(next_pose.MoveBy(step));
-      trajectory.push_back(next_pose);
-
-      // Update 'id'.
-      id /= base;
-
-      // Reset 'current_pose'.
-      current_pose = next_pose;
-    }
+    DecodeTrajectory<unsigned int>(id, num_steps, initial_pose, trajectory);
+  }
 
-    // If the above does not recover enough poses, the last remainders were zero.
-    // Update 'trajectory' accordingly.
-    while (trajectory.size() < num_steps) {
-      GridPose2D next_pose = current_pose;
-      CHECK(next_pose.MoveBy(Movement2D(0, 0, 0)));
+  // Encode a sequence of 3D movements as an unsigned integer.
+  unsigned int EncodeTrajectory(const std::vector<Movement3D>& movements,
+                                const Context3D& context) {
+    unsigned int id = 0;
+    CHECK(EncodeTrajectory(movements, context, id))
+      << "Trajectory id overflow. Use a wider id.";
+    return id;
+  }
 
-      trajectory.push_back(next_pose);
-      current_pose = next_pose;
-    }
+  // Decode a 3D trajectory id into a sequence of poses.
+  void DecodeTrajectory(unsigned int id, unsigned int num_steps,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory) {
+    DecodeTrajectory<unsigned int>(id, num_steps, initial_pose, trajectory);
+  }
+
+  // Wide trajectory ids.
+  template <typename IdType>
+  bool EncodeTrajectory(const std::vector<Movement2D>& movements,
+                        const Context2D& context, IdType& id) {
+    std::vector<unsigned int> digits;
+    TrajectoryDigits(movements, context, digits);
+    return EncodeDigits(digits, TrajectoryBase(context), id);
+  }
+
+  template <typename IdType>
+  bool EncodeTrajectory(const std::vector<Movement3D>& movements,
+                        const Context3D& context, IdType& id) {
+    std::vector<unsigned int> digits;
+    TrajectoryDigits(movements, context, digits);
+    return EncodeDigits(digits, TrajectoryBase(context), id);
+  }
+
+  template <typename IdType>
+  void DecodeTrajectory(IdType id, unsigned int num_steps,
+                        const GridPose2D& initial_pose,
+                        std::vector<GridPose2D>& trajectory) {
+    std::vector<unsigned int> digits;
+    DecodeDigits(id, TrajectoryBase(initial_pose.GetContext()), num_steps,
+                 digits);
+    DigitsToTrajectory(digits, initial_pose, trajectory);
+  }
+
+  template <typename IdType>
+  void DecodeTrajectory(IdType id, unsigned int num_steps,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory) {
+    std::vector<unsigned int> digits;
+    DecodeDigits(id, TrajectoryBase(initial_pose.GetContext()), num_steps,
+                 digits);
+    DigitsToTrajectory(digits, initial_pose, trajectory);
+  }
+
+  // Decode many trajectory ids at once.
+  template <typename IdType>
+  void DecodeTrajectories(const std::vector<IdType>& ids,
+                          unsigned int num_steps,
+                          const GridPose2D& initial_pose,
+                          std::vector< std::vector<GridPose2D> >& trajectories) {
+    DecodeTrajectoriesImpl(ids, num_steps, initial_pose, trajectories);
+  }
+
+  template <typename IdType>
+  void DecodeTrajectories(const std::vector<IdType>& ids,
+                          unsigned int num_steps,
+                          const GridPose3D& initial_pose,
+                          std::vector< std::vector<GridPose3D> >& trajectories) {
+    DecodeTrajectoriesImpl(ids, num_steps, initial_pose, trajectories);
+  }
+
+  // Variable-length trajectory keys.
+  EncodingKey EncodeTrajectoryKey(const std::vector<Movement2D>& movements,
+                                  const Context2D& context) {
+    std::vector<unsigned int> digits;
+    TrajectoryDigits(movements, context, digits);
+    return EncodingKey(digits, TrajectoryBase(context));
+  }
+
+  EncodingKey EncodeTrajectoryKey(const std::vector<Movement3D>& movements,
+                                  const Context3D& context) {
+    std::vector<unsigned int> digits;
+    TrajectoryDigits(movements, context, digits);
+    return EncodingKey(digits, TrajectoryBase(context));
+  }
+
+  void DecodeTrajectory(const EncodingKey& key,
+                        const GridPose2D& initial_pose,
+                        std::vector<GridPose2D>& trajectory) {
+    CHECK(key.GetBase() == TrajectoryBase(initial_pose.GetContext()));
+    std::vector<unsigned int> digits;
+    key.GetDigits(digits);
+    DigitsToTrajectory(digits, initial_pose, trajectory);
+  }
+
+  void DecodeTrajectory(const EncodingKey& key,
+                        const GridPose3D& initial_pose,
+                        std::vector<GridPose3D>& trajectory) {
+    CHECK(key.GetBase() == TrajectoryBase(initial_pose.GetContext()));
+    std::vector<unsigned int> digits;
+    key.GetDigits(digits);
+    DigitsToTrajectory(digits, initial_pose, trajectory);
   }
 
   // Encode a sequence of measurements in an unsigned integer.
   unsigned int EncodeMeasurements(const std::vector<unsigned int>& measurements,
                                   unsigned int max_measurement) {
-    const unsigned int base = max_measurement + 1;
-
     unsigned int id = 0;
-    unsigned int place_value = 1;
-
-    for (size_t ii = 0; ii < measurements.size(); ii++) {
-      id += measurements[ii] * place_value;
-      place_value *= base;
-    }
-
+    CHECK(EncodeMeasurements(measurements, max_measurement, id))
+      << "Measurement id overflow. Use a wider id.";
     return id;
   }
 
@@ -139,65 +441,114 @@ namespace radiation {
   void DecodeMeasurements(unsigned int id, unsigned int max_measurement,
                           unsigned int num_measurements,
                           std::vector<unsigned int>& measurements) {
-    measurements.clear();
-    const unsigned int base = max_measurement + 1;
+    DecodeMeasurements<unsigned int>(id, max_measurement, num_measurements,
+                                     measurements);
+  }
 
-    while (id > 0) {
-      const unsigned int remainder = id % base;
-      measurements.push_back(remainder);
+  // Wide measurement ids.
+  template <typename IdType>
+  bool EncodeMeasurements(const std::vector<unsigned int>& measurements,
+                          unsigned int max_measurement, IdType& id) {
+    return EncodeDigits(measurements, max_measurement + 1, id);
+  }
 
-      // Update 'id'.
-      id /= base;
-    }
+  template <typename IdType>
+  void DecodeMeasurements(IdType id, unsigned int max_measurement,
+                          unsigned int num_measurements,
+                          std::vector<unsigned int>& measurements) {
+    DecodeDigits(id, max_measurement + 1, num_measurements, measurements);
+  }
 
-    // If not enough measurements, the rest must have been zero.
-    while (measurements.size() < num_measurements) {
-      measurements.push_back(0);
-    }
+  // Variable-length measurement keys.
+  EncodingKey EncodeMeasurementsKey(
+    const std::vector<unsigned int>& measurements,
+    unsigned int max_measurement) {
+    return EncodingKey(measurements, max_measurement + 1);
   }
 
   // Encode a list of sources (map) as an unsigned integer.
   unsigned int EncodeMap(const std::vector<Source2D>& sources,
                          unsigned int num_rows, unsigned int num_cols) {
-    const unsigned int base = num_rows * num_cols;
-
     unsigned int id = 0;
-    unsigned int place_value = 1;
-
-    for (size_t ii = 0; ii < sources.size(); ii++) {
-      const unsigned int source_id =
-        sources[ii].GetIndexX() + sources[ii].GetIndexY() * num_rows;
-
-      id += source_id * place_value;
-      place_value *= base;
-    }
-
+    CHECK(EncodeMap(sources, num_rows, num_cols, id))
+      << "Map id overflow. Use a wider id.";
     return id;
   }
 
   // Decode a map id into a list of sources.
   void DecodeMap(unsigned int id, unsigned int num_rows, unsigned int num_cols,
                  unsigned int num_sources, std::vector<Source2D>& sources) {
-    sources.clear();
-    const unsigned int base = num_rows * num_cols;
+    DecodeMap<unsigned int>(id, num_rows, num_cols, num_sources, sources);
+  }
 
-    while (id > 0) {
-      const unsigned int remainder = id % base;
+  // Wide map ids.
+  template <typename IdType>
+  bool EncodeMap(const std::vector<Source2D>& sources,
+                 unsigned int num_rows, unsigned int num_cols, IdType& id) {
+    std::vector<unsigned int> digits;
+    MapDigits(sources, num_rows, digits);
+    return EncodeDigits(digits, num_rows * num_cols, id);
+  }
 
-      // Unpack remainder into a source.
-      const unsigned int x_id = remainder % num_rows;
-      const unsigned int y_id = remainder / num_rows;
-      sources.push_back(Source2D(x_id, y_id));
+  template <typename IdType>
+  void DecodeMap(IdType id, unsigned int num_rows, unsigned int num_cols,
+                 unsigned int num_sources, std::vector<Source2D>& sources) {
+    std::vector<unsigned int> digits;
+    DecodeDigits(id, num_rows * num_cols, num_sources, digits);
+    DigitsToMap(digits, num_rows, sources);
+  }
 
-      // Update 'id'.
-      id /= base;
-    }
+  // Variable-length map keys.
+  EncodingKey EncodeMapKey(const std::vector<Source2D>& sources,
+                           unsigned int num_rows, unsigned int num_cols) {
+    std::vector<unsigned int> digits;
+    MapDigits(sources, num_rows, digits);
+    return EncodingKey(digits, num_rows * num_cols);
+  }
 
-    // If not enough sources, the remainders must have been zero.
-    const unsigned int zero = 0;
-    while (sources.size() < num_sources) {
-      sources.push_back(Source2D(zero, zero));
-    }
+  void DecodeMap(const EncodingKey& key, unsigned int num_rows,
+                 std::vector<Source2D>& sources) {
+    std::vector<unsigned int> digits;
+    key.GetDigits(digits);
+    DigitsToMap(digits, num_rows, sources);
   }
 
+  // Explicit instantiations.
+#define RADIATION_INSTANTIATE_ENCODING(IdType)                              \
+  template bool EncodeDigits<IdType>(const std::vector<unsigned int>&,      \
+                                     unsigned int, IdType&);                \
+  template void DecodeDigits<IdType>(IdType, unsigned int, unsigned int,    \
+                                     std::vector<unsigned int>&);           \
+  template bool EncodeTrajectory<IdType>(const std::vector<Movement2D>&,    \
+                                         const Context2D&, IdType&);        \
+  template bool EncodeTrajectory<IdType>(const std::vector<Movement3D>&,    \
+                                         const Context3D&, IdType&);        \
+  template void DecodeTrajectory<IdType>(IdType, unsigned int,              \
+                                         const GridPose2D&,                 \
+                                         std::vector<GridPose2D>&);         \
+  template void DecodeTrajectory<IdType>(IdType, unsigned int,              \
+                                         const GridPose3D&,                 \
+                                         std::vector<GridPose3D>&);         \
+  template void DecodeTrajectories<IdType>(                                 \
+    const std::vector<IdType>&, unsigned int, const GridPose2D&,            \
+    std::vector< std::vector<GridPose2D> >&);                               \
+  template void DecodeTrajectories<IdType>(                                 \
+    const std::vector<IdType>&, unsigned int, const GridPose3D&,            \
+    std::vector< std::vector<GridPose3D> >&);                               \
+  template bool EncodeMeasurements<IdType>(const std::vector<unsigned int>&,\
+                                           unsigned int, IdType&);          \
+  template void DecodeMeasurements<IdType>(IdType, unsigned int,            \
+                                           unsigned int,                    \
+                                           std::vector<unsigned int>&);     \
+  template bool EncodeMap<IdType>(const std::vector<Source2D>&,             \
+                                  unsigned int, unsigned int, IdType&);     \
+  template void DecodeMap<IdType>(IdType, unsigned int, unsigned int,       \
+                                  unsigned int, std::vector<Source2D>&);
+
+  RADIATION_INSTANTIATE_ENCODING(unsigned int)
+  RADIATION_INSTANTIATE_ENCODING(Id64)
+  RADIATION_INSTANTIATE_ENCODING(Id128)
+
+#undef RADIATION_INSTANTIATE_ENCODING
+
 } // namespace radiation
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Estimators of the entropy of a categorical distribution from a histogram
+// of raw counts. See header for details.
+//
+// Histograms are mostly zeros, so every estimator but the default makes one
+// pass that skips empty bins. The default, clipped plug-in, goes through the
+// vectorized CategoricalEntropy kernel instead. Logs use FastLog from
+// entropy_kernels.h, as the probability kernels do.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <entropy_estimators.h>
+#include <entropy_kernels.h>
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+#include <math.h>
+#include <algorithm>
+
+namespace radiation {
+
+namespace {
+// Names, indexed by estimator.
+const char* kNames[] = {
+  "clipped_plug_in", "plug_in", "miller_madow", "jackknife", "chao_shen"
+};
+const size_t kNumEstimators = sizeof(kNames) / sizeof(kNames[0]);
+
+// n log(n), with 0 log(0) = 0.
+double NLogN(double n) {
+  return (n > 0.0) ? n * FastLog(n) : 0.0;
+}
+} // namespace
+
+  // Estimate entropy from raw counts.
+  double EstimateEntropy(const double* counts, size_t n,
+                         EntropyEstimator estimator) {
+    // The default only needs the total, so hand the raw counts straight to
+    // the vectorized kernel along with the normalization.
+    if (estimator == EntropyEstimator::kClippedPlugIn) {
+      const double total =
+        Eigen::Map<const Eigen::VectorXd>(counts, n).sum();
+      if (total <= 0.0)
+        return 0.0;
+
+      return CategoricalEntropy(counts, n, 0.01, 1.0 - 0.01, 1.0 / total);
+    }
+
+    // Total count, number of nonzero bins, singletons, and sum of n log(n).
+    double total = 0.0, sum_nlogn = 0.0;
+    size_t num_nonzero = 0, num_singletons = 0;
+    for (size_t ii = 0; ii < n; ii++) {
+      const double count = counts[ii];
+      CHECK(count >= 0.0);
+      if (count == 0.0)
+        continue;
+
+      total += count;
+      sum_nlogn += NLogN(count);
+      num_nonzero++;
+      num_singletons += (count == 1.0);
+    }
+
+    if (total <= 0.0)
+      return 0.0;
+
+    // Plug-in estimate, log(N) - sum n log(n) / N.
+    const double plug_in = std::max(0.0, FastLog(total) - sum_nlogn / total);
+
+    switch (estimator) {
+    case EntropyEstimator::kClippedPlugIn:
+      break;  // Handled above.
+
+    case EntropyEstimator::kPlugIn:
+      return plug_in;
+
+    case EntropyEstimator::kMillerMadow:
+      return plug_in + (num_nonzero - 1.0) / (2.0 * total);
+
+    case EntropyEstimator::kJackknife: {
+      if (total < 2.0)
+        return plug_in;
+
+      // Removing one sample from bin ii only changes its n log(n) term, so
+      // every leave-one-out estimate comes from the totals above.
+      const double log_total = FastLog(total - 1.0);
+      double sum_loo = 0.0;
+      for (size_t ii = 0; ii < n; ii++) {
+        const double count = counts[ii];
+        if (count == 0.0)
+          continue;
+
+        const double loo_nlogn =
+          sum_nlogn - NLogN(count) + NLogN(count - 1.0);
+        sum_loo += count * (log_total - loo_nlogn / (total - 1.0));
+      }
+
+      return std::max(0.0, total * plug_in -
+                      (total - 1.0) / total * sum_loo);
+    }
+
+    case EntropyEstimator::kChaoShen: {
+      // Estimated sample coverage, kept positive when every bin is a
+      // singleton.
+      const double singletons = (num_singletons == total) ?
+        total - 1.0 : static_cast<double>(num_singletons);
+      const double coverage = 1.0 - singletons / total;
+      if (coverage <= 0.0)
+        return plug_in;
+
+      double entropy = 0.0;
+      for (size_t ii = 0; ii < n; ii++) {
+        if (counts[ii] == 0.0)
+          continue;
+
+        const double p = coverage * counts[ii] / total;
+        entropy -= p * FastLog(p) / (1.0 - pow(1.0 - p, total));
+      }
+
+      return entropy;
+    }
+    }
+
+    LOG(FATAL) << "Unknown entropy estimator.";
+    return 0.0;
+  }
+
+  // Convert between estimators and their names.
+  const char* EntropyEstimatorName(EntropyEstimator estimator) {
+    const size_t index = static_cast<size_t>(estimator);
+    CHECK(index < kNumEstimators);
+    return kNames[index];
+  }
+
+  bool ParseEntropyEstimator(const std::string& name,
+                             EntropyEstimator& estimator) {
+    for (size_t ii = 0; ii < kNumEstimators; ii++) {
+      if (name == kNames[ii]) {
+        estimator = static_cast<EntropyEstimator>(ii);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+} // namespace radiation
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Entropy kernels over contiguous arrays of probabilities. See header for
+// details.
+//
+// The vector code is written once against a handful of thin wrappers (Pack,
+// Add, Mul, ...) which map to AVX2 or SSE2 intrinsics depending on the
+// target. Without either, only the scalar path is compiled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <entropy_kernels.h>
+
+#include <glog/logging.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RADIATION_ENTROPY_KERNELS_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RADIATION_ENTROPY_KERNELS_SSE2
+#endif
+
+namespace radiation {
+
+namespace {
+// Constants for FastLog. log(2) is split so that exponent * kLn2Hi is exact.
+const uint64_t kMantissaMask = 0x000FFFFFFFFFFFFFULL;
+const uint64_t kOneBits = 0x3FF0000000000000ULL;
+const uint64_t kTwoTo52Bits = 0x4330000000000000ULL;
+const double kTwoTo52 = 4503599627370496.0;
+const double kSqrt2 = 1.41421356237309504880;
+const double kLn2Hi = 6.93147180369123816490e-01;
+const double kLn2Lo = 1.90821492927058770002e-10;
+
+// Coefficients 2 / (2k + 1) of the series for 2 atanh(s) / s in s^2.
+const double kLogCoefficients[] = {
+  2.0, 2.0 / 3.0, 2.0 / 5.0, 2.0 / 7.0,
+  2.0 / 9.0, 2.0 / 11.0, 2.0 / 13.0, 2.0 / 15.0
+};
+const int kNumLogCoefficients = 8;
+
+#if defined(RADIATION_ENTROPY_KERNELS_AVX2)
+typedef __m256d Pack;
+const size_t kPackSize = 4;
+inline Pack Set1(double x) { return _mm256_set1_pd(x); }
+inline Pack Set1Bits(uint64_t x) {
+  return _mm256_castsi256_pd(_mm256_set1_epi64x(static_cast<int64_t>(x)));
+}
+inline Pack Load(const double* p) { return _mm256_loadu_pd(p); }
+inline Pack Add(Pack a, Pack b) { return _mm256_add_pd(a, b); }
+inline Pack Sub(Pack a, Pack b) { return _mm256_sub_pd(a, b); }
+inline Pack Mul(Pack a, Pack b) { return _mm256_mul_pd(a, b); }
+inline Pack Div(Pack a, Pack b) { return _mm256_div_pd(a, b); }
+inline Pack Min(Pack a, Pack b) { return _mm256_min_pd(a, b); }
+inline Pack Max(Pack a, Pack b) { return _mm256_max_pd(a, b); }
+inline Pack And(Pack a, Pack b) { return _mm256_and_pd(a, b); }
+inline Pack Or(Pack a, Pack b) { return _mm256_or_pd(a, b); }
+inline Pack Greater(Pack a, Pack b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+inline Pack GreaterEq(Pack a, Pack b) {
+  return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+}
+inline Pack ShiftRight52(Pack a) {
+  return _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a), 52));
+}
+inline double HorizontalSum(Pack a) {
+  const __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(a),
+                                 _mm256_extractf128_pd(a, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+#elif defined(RADIATION_ENTROPY_KERNELS_SSE2)
+typedef __m128d Pack;
+const size_t kPackSize = 2;
+inline Pack Set1(double x) { return _mm_set1_pd(x); }
+inline Pack Set1Bits(uint64_t x) {
+  return _mm_castsi128_pd(_mm_set1_epi64x(static_cast<int64_t>(x)));
+}
+inline Pack Load(const double* p) { return _mm_loadu_pd(p); }
+inline Pack Add(Pack a, Pack b) { return _mm_add_pd(a, b); }
+inline Pack Sub(Pack a, Pack b) { return _mm_sub_pd(a, b); }
+inline Pack Mul(Pack a, Pack b) { return _mm_mul_pd(a, b); }
+inline Pack Div(Pack a, Pack b) { return _mm_div_pd(a, b); }
+inline Pack Min(Pack a, Pack b) { return _mm_min_pd(a, b); }
+inline Pack Max(Pack a, Pack b) { return _mm_max_pd(a, b); }
+inline Pack And(Pack a, Pack b) { return _mm_and_pd(a, b); }
+inline Pack Or(Pack a, Pack b) { return _mm_or_pd(a, b); }
+inline Pack Greater(Pack a, Pack b) { return _mm_cmpgt_pd(a, b); }
+inline Pack GreaterEq(Pack a, Pack b) { return _mm_cmpge_pd(a, b); }
+inline Pack ShiftRight52(Pack a) {
+  return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a), 52));
+}
+inline double HorizontalSum(Pack a) {
+  return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+}
+#endif
+
+#if defined(RADIATION_ENTROPY_KERNELS_AVX2) || \
+  defined(RADIATION_ENTROPY_KERNELS_SSE2)
+// Vector version of FastLog, following the scalar version step for step.
+inline Pack LogPack(Pack x) {
+  const Pack one = Set1(1.0);
+
+  // Biased exponent, converted to double by placing it in the mantissa of
+  // 2^52, and the mantissa scaled into [1, 2).
+  Pack exponent = Sub(Or(ShiftRight52(x), Set1Bits(kTwoTo52Bits)),
+                      Set1(kTwoTo52 + 1023.0));
+  Pack m = Or(And(x, Set1Bits(kMantissaMask)), Set1Bits(kOneBits));
+
+  // Move the mantissa into [sqrt(1/2), sqrt(2)).
+  const Pack big = Greater(m, Set1(kSqrt2));
+  m = Sub(m, And(big, Mul(m, Set1(0.5))));
+  exponent = Add(exponent, And(big, one));
+
+  const Pack s = Div(Sub(m, one), Add(m, one));
+  const Pack s2 = Mul(s, s);
+  Pack poly = Set1(kLogCoefficients[kNumLogCoefficients - 1]);
+  for (int kk = kNumLogCoefficients - 2; kk >= 0; kk--)
+    poly = Add(Mul(poly, s2), Set1(kLogCoefficients[kk]));
+
+  return Add(Mul(exponent, Set1(kLn2Hi)),
+             Add(Mul(exponent, Set1(kLn2Lo)), Mul(s, poly)));
+}
+#endif
+} // namespace
+
+  // Approximate natural log of a positive normal double.
+  double FastLog(double x) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    double exponent = static_cast<double>(bits >> 52) - 1023.0;
+
+    bits = (bits & kMantissaMask) | kOneBits;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+
+    // Move the mantissa into [sqrt(1/2), sqrt(2)).
+    const double big = (m > kSqrt2) ? 1.0 : 0.0;
+    m -= big * 0.5 * m;
+    exponent += big;
+
+    const double s = (m - 1.0) / (m + 1.0);
+    const double s2 = s * s;
+    double poly = kLogCoefficients[kNumLogCoefficients - 1];
+    for (int kk = kNumLogCoefficients - 2; kk >= 0; kk--)
+      poly = poly * s2 + kLogCoefficients[kk];
+
+    return exponent * kLn2Hi + (exponent * kLn2Lo + s * poly);
+  }
+
+  // Sum of Bernoulli entropies.
+  double SumBernoulliEntropies(const double* p, size_t n, double threshold) {
+    CHECK(threshold > 0.0);
+    const double lo = threshold;
+    const double hi = 1.0 - threshold;
+
+    double entropy = 0.0;
+    size_t ii = 0;
+
+#if defined(RADIATION_ENTROPY_KERNELS_AVX2) || \
+  defined(RADIATION_ENTROPY_KERNELS_SSE2)
+    const Pack lo_pack = Set1(lo);
+    const Pack hi_pack = Set1(hi);
+    const Pack one = Set1(1.0);
+    Pack sum = Set1(0.0);
+
+    for (; ii + kPackSize <= n; ii += kPackSize) {
+      const Pack x = Load(p + ii);
+      const Pack keep = And(Greater(x, lo_pack), Greater(hi_pack, x));
+      const Pack clamped = Min(Max(x, lo_pack), hi_pack);
+      const Pack complement = Sub(one, clamped);
+      const Pack term = Add(Mul(clamped, LogPack(clamped)),
+                            Mul(complement, LogPack(complement)));
+      sum = Sub(sum, And(keep, term));
+    }
+
+    entropy = HorizontalSum(sum);
+#endif
+
+    // Scalar tail, or everything if there is no vector path.
+    for (; ii < n; ii++) {
+      const double keep = (p[ii] > lo && p[ii] < hi) ? 1.0 : 0.0;
+      const double clamped = std::min(std::max(p[ii], lo), hi);
+      const double complement = 1.0 - clamped;
+      entropy -= keep * (clamped * FastLog(clamped) +
+                         complement * FastLog(complement));
+    }
+
+    return entropy;
+  }
+
+  // Categorical entropy.
+  double CategoricalEntropy(const double* p, size_t n,
+                            double min_p, double max_p, double scale) {
+    CHECK(min_p > 0.0);
+    CHECK(min_p <= max_p);
+
+    double entropy = 0.0;
+    size_t ii = 0;
+
+#if defined(RADIATION_ENTROPY_KERNELS_AVX2) || \
+  defined(RADIATION_ENTROPY_KERNELS_SSE2)
+    const Pack lo_pack = Set1(min_p);
+    const Pack hi_pack = Set1(max_p);
+    const Pack scale_pack = Set1(scale);
+    Pack sum = Set1(0.0);
+
+    for (; ii + kPackSize <= n; ii += kPackSize) {
+      const Pack x = Mul(Load(p + ii), scale_pack);
+      const Pack keep = And(GreaterEq(x, lo_pack), GreaterEq(hi_pack, x));
+      const Pack clamped = Min(Max(x, lo_pack), hi_pack);
+      sum = Sub(sum, And(keep, Mul(clamped, LogPack(clamped))));
+    }
+
+    entropy = HorizontalSum(sum);
+#endif
+
+    // Scalar tail, or everything if there is no vector path.
+    for (; ii < n; ii++) {
+      const double x = p[ii] * scale;
+      const double keep = (x >= min_p && x <= max_p) ? 1.0 : 0.0;
+      const double clamped = std::min(std::max(x, min_p), max_p);
+      entropy -= keep * clamped * FastLog(clamped);
+    }
+
+    return entropy;
+  }
+
+} // namespace radiation
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Runs a single headless ExplorerLP episode from a fixed seed, until the map
+// entropy drops below a threshold or an iteration limit is reached, and
+// records how long planning and belief updates took along the way.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <episode_runner.h>
+#include <explorer_lp.h>
+#include <context_2d.h>
+
+#include <glog/logging.h>
+#include <chrono>
+#include <vector>
+
+namespace radiation {
+
+// Run an episode.
+EpisodeMetrics RunEpisode(const EpisodeOptions& options) {
+  typedef std::chrono::steady_clock Clock;
+
+  Context2D context(options.num_rows, options.num_cols);
+  context.SetAngularStep(options.angular_step);
+
+  ExplorerLP explorer(context, options.num_sources, options.regularizer,
+                      options.num_steps, options.fov, options.num_samples,
+                      options.seed);
+  explorer.SetCache(options.cache);
+  explorer.SetEntropyEstimator(options.estimator);
+
+  EpisodeMetrics metrics;
+  metrics.num_iterations = 0;
+  metrics.reached_threshold = false;
+  metrics.planning_failed = false;
+  metrics.final_entropy = explorer.Entropy();
+  metrics.total_plan_time = 0.0;
+  metrics.total_update_time = 0.0;
+
+  while (metrics.num_iterations < options.max_iterations &&
+         metrics.final_entropy > options.entropy_threshold) {
+    // Plan ahead.
+    std::vector<GridPose2D> trajectory;
+    const Clock::time_point plan_start = Clock::now();
+    const bool planned = explorer.PlanAhead(trajectory);
+    const Clock::time_point plan_end = Clock::now();
+    metrics.total_plan_time +=
+      std::chrono::duration<double>(plan_end - plan_start).count();
+
+    if (!planned) {
+      VLOG(1) << "Episode with seed " << options.seed
+              << " could not plan. Stopping early.";
+      metrics.planning_failed = true;
+      break;
+    }
+
+    // Take a step.
+    metrics.final_entropy = explorer.TakeStep(trajectory);
+    metrics.total_update_time +=
+      std::chrono::duration<double>(Clock::now() - plan_end).count();
+    metrics.num_iterations++;
+  }
+
+  metrics.reached_threshold =
+    (metrics.final_entropy <= options.entropy_threshold);
+  metrics.total_samples = explorer.GetMap().GetNumSamplesDrawn();
+  metrics.total_solver_iterations = explorer.GetMap().GetNumSolverIterations();
+  return metrics;
+}
+
+} // namespace radiation
@@ -44,77 +44,376 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <explorer_lp.h>
+#include <quad_tree_2d.h>
+#include <radix_codec.h>
+#include <trajectory_sampler.h>
+#include <trace.h>
+#include <explorer_window.h>
 
 #include <GLUT/glut.h>
 #include <glog/logging.h>
 #include <gurobi_c++.h>
+#include <algorithm>
+#include <map>
 #include <random>
 #include <string>
 #include <math.h>
 
 namespace radiation {
 
+namespace {
+// When scoring candidates coarsely, partially visible quadtree nodes holding
+// more than this fraction of the total belief are refined past the coarse
+// level, and those holding less than the negligible fraction are not refined
+// at all.
+const double kRefineFraction = 0.1;
+const double kNegligibleFraction = 1e-3;
+
+// Entropy of a binomial random variable with 'n' trials and success
+// probability 'q'.
+double BinomialEntropy(unsigned int n, double q) {
+  if (q <= 0.0 || q >= 1.0)
+    return 0.0;
+
+  double entropy = 0.0;
+  double log_choose = 0.0;
+  for (unsigned int kk = 0; kk <= n; kk++) {
+    if (kk > 0)
+      log_choose += log(static_cast<double>(n - kk + 1)) -
+        log(static_cast<double>(kk));
+
+    const double log_p = log_choose + kk * log(q) + (n - kk) * log(1.0 - q);
+    entropy -= exp(log_p) * log_p;
+  }
+
+  return entropy;
+}
+} // namespace
+
 // Constructor/destructor.
 ExplorerLP::~ExplorerLP() {}
-ExplorerLP::ExplorerLP(unsigned int num_rows, unsigned int num_cols,
+ExplorerLP::ExplorerLP(const Context2D& context,
                        unsigned int num_sources, double regularizer,
                        unsigned int num_steps, double fov,
                        unsigned int num_samples)
-  : map_(num_rows, num_cols, num_sources, regularizer),
+  : ExplorerLP(context, num_sources, regularizer,
+               num_steps, fov, num_samples, std::random_device()()) {}
+ExplorerLP::ExplorerLP(const Context2D& context,
+                       unsigned int num_sources, double regularizer,
+                       unsigned int num_steps, double fov,
+                       unsigned int num_samples, unsigned int seed)
+  : context_(context),
     num_steps_(num_steps),
     num_samples_(num_samples),
-    pose_(0.0, 0.0, 0.0),
-    fov_(fov) {
-  // Set up a random number generator.
-  std::random_device rd;
-  std::default_random_engine rng(rd());
-  std::uniform_int_distribution<unsigned int> unif_rows(0, num_rows - 1);
-  std::uniform_int_distribution<unsigned int> unif_cols(0, num_cols - 1);
+    fov_(fov),
+    map_(context_, num_sources, regularizer),
+    pose_(context_, 0.0, 0.0, 0.0),
+    estimator_(EntropyEstimator::kClippedPlugIn) {
+  // Set up a random number generator, and use it to seed the map's.
+  std::default_random_engine rng(seed);
+  map_.Seed(rng());
+
+  std::uniform_int_distribution<unsigned int>
+    unif_rows(0, context_.GetNumRows() - 1);
+  std::uniform_int_distribution<unsigned int>
+    unif_cols(0, context_.GetNumCols() - 1);
   std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
 
-  // Choose random sources.
-  for (unsigned int ii = 0; ii < num_sources; ii++) {
-    const Source2D source(unif_rows(rng), unif_cols(rng));
-    sources_.push_back(source);
+  // Choose random sources and a random initial pose, away from obstacles.
+  while (sources_.size() < num_sources) {
+    const unsigned int ii = unif_rows(rng);
+    const unsigned int jj = unif_cols(rng);
+    if (!context_.IsObstacle(ii, jj))
+      sources_.push_back(Source2D(ii, jj));
   }
 
-  // Choose a random initial pose.
-  pose_ = GridPose2D(unif_rows(rng), unif_cols(rng), unif_angle(rng));
+  do {
+    pose_ = GridPose2D(context_, unif_rows(rng), unif_cols(rng),
+                       unif_angle(rng));
+  } while (context_.IsObstacle(pose_.GetIndexX(), pose_.GetIndexY()));
+
+  // Seed the planning random number generator.
+  rng_.seed(rng());
 }
 
 // Plan a new trajectory.
 bool ExplorerLP::PlanAhead(std::vector<GridPose2D>& trajectory) {
-  // Generate conditional entropy vector.
+  return PlanAhead(map_, pose_, trajectory);
+}
+
+// Plan a new trajectory starting from the given pose, using the given map.
+bool ExplorerLP::PlanAhead(GridMap2D& map, const GridPose2D& pose,
+                           std::vector<GridPose2D>& trajectory) const {
+  RADIATION_TRACE_SCOPE("ExplorerLP::PlanAhead");
+  if (cache_ == NULL)
+    return PlanTrajectory(map, num_samples_, num_steps_, pose, fov_,
+                          trajectory, estimator_);
+
+  // Only sample if the cache has not seen this configuration before. Sample
+  // with a seed derived from the key, so that a hit returns exactly what
+  // sampling would have, no matter which episode stored it. Then reseed, so
+  // the map's generator ends up in the same state either way.
   Eigen::VectorXd hzx;
-  std::vector<unsigned int> trajectory_ids;
-  map_.GenerateEntropyVector(num_samples_, num_steps_, pose_, fov_,
-                             hzx, trajectory_ids);
-  CHECK(hzx.rows() == trajectory_ids.size());
+  std::vector<Id64> trajectory_ids;
+  const unsigned int next_seed = map.DrawSeed();
+  const Id64 key = cache_->Key(map, num_samples_, num_steps_, pose, fov_,
+                               estimator_);
+  if (!cache_->Lookup(key, hzx, trajectory_ids)) {
+    map.Seed(ConditionalCache::SamplerSeed(key));
+    map.GenerateEntropyVector(num_samples_, num_steps_, pose, fov_,
+                              hzx, trajectory_ids, estimator_);
+    cache_->Store(key, hzx, trajectory_ids);
+  }
+
+  map.Seed(next_seed);
+  return SelectTrajectory(hzx, trajectory_ids, num_steps_, pose, trajectory);
+}
+
+// Plan a new trajectory coarse-to-fine.
+bool ExplorerLP::PlanAheadCoarseToFine(unsigned int num_candidates,
+                                       unsigned int num_finalists,
+                                       unsigned int level,
+                                       std::vector<GridPose2D>& trajectory,
+                                       unsigned int num_headings) {
+  CHECK(num_finalists > 0);
+
+  // Build a quadtree over the current belief.
+  const QuadTree2D tree(map_.GetImmutableBelief());
+  const unsigned int num_sources = map_.GetNumSources();
+  if (tree.GetSum() <= 0.0) {
+    VLOG(1) << "Belief is identically zero. Cannot plan.";
+    return false;
+  }
+
+  // Generate distinct random candidate trajectories. Candidates are keyed
+  // by variable-length ids, so long horizons cannot overflow.
+  std::map< EncodingKey, std::vector<GridPose2D> > candidates;
+  for (unsigned int ii = 0; ii < num_candidates; ii++) {
+    GridPose2D current_pose = pose_;
+    std::vector<Movement2D> movements;
+    std::vector<GridPose2D> poses;
+    while (movements.size() < num_steps_) {
+      const Movement2D step(context_, rng_);
+      if (current_pose.MoveBy(step)) {
+        movements.push_back(step);
+        poses.push_back(current_pose);
+      }
+    }
+
+    candidates.insert({EncodeTrajectoryKey(movements, context_), poses});
+  }
+
+  // Seed the candidates with the frontier trajectory. It stops early if it
+  // gets stuck, and every candidate must have exactly 'num_steps_' poses.
+  if (num_headings > 0) {
+    std::vector<Movement2D> movements;
+    std::vector<GridPose2D> poses;
+    PlanFrontier(num_headings, movements, poses);
+    if (poses.size() == num_steps_)
+      candidates.insert({EncodeTrajectoryKey(movements, context_), poses});
+  }
+
+  // Coarse pass. Since sources are drawn independently from belief, each
+  // measurement on its own is binomial, and the sum of their entropies is an
+  // upper bound on the entropy of the whole measurement sequence. Evaluate
+  // it against the coarse level of the tree, refined where the belief is
+  // concentrated, and through each sensor's view so that belief hidden by
+  // obstacles does not count.
+  VisibilityCache2D visibility(map_.GetVisibility());
+  const double max_mass = kRefineFraction * tree.GetSum();
+  const double min_mass = kNegligibleFraction * tree.GetSum();
+  std::vector< std::pair<double, const std::vector<GridPose2D>*> > scores;
+  for (const auto& entry : candidates) {
+    double score = 0.0;
+    for (const auto& pose : entry.second) {
+      const Sensor2D sensor(pose, fov_);
+      const double expected = tree.ExpectedMeasurement(
+        sensor, level, max_mass, min_mass, visibility.GetView(sensor));
+      score += BinomialEntropy(num_sources, expected / tree.GetSum());
+    }
+
+    scores.push_back({score, &entry.second});
+  }
+
+  const unsigned int num_kept =
+    std::min(num_finalists, static_cast<unsigned int>(scores.size()));
+  std::partial_sort(scores.begin(), scores.begin() + num_kept, scores.end(),
+                    [](const std::pair<double,
+                                       const std::vector<GridPose2D>*>& a,
+                       const std::pair<double,
+                                       const std::vector<GridPose2D>*>& b) {
+                      return a.first > b.first;
+                    });
+
+  // Fine pass. Sample sources at full resolution and record the joint
+  // distribution of measurements along each finalist, sensing through the
+  // map's visibility so that obstacles occlude exactly as they do in the
+  // update. Sensors and the measurement buffer are set up once, outside the
+  // sampling loop.
+  const unsigned int kNumMeasurements = pow(num_sources + 1, num_steps_);
+  const RadixCodec<unsigned int> codec(num_sources + 1, num_steps_);
+  std::vector<Eigen::VectorXd> counts(
+    num_kept, Eigen::VectorXd::Zero(kNumMeasurements));
+
+  std::vector<Sensor2D> sensors;
+  for (unsigned int jj = 0; jj < num_kept; jj++)
+    for (const auto& pose : *scores[jj].second)
+      sensors.push_back(Sensor2D(pose, fov_));
+
+  std::vector<Source2D> sources;
+  std::vector<unsigned int> measurements(num_steps_);
+  for (unsigned int ii = 0; ii < num_samples_; ii++) {
+    if (!tree.GenerateSources(rng_, num_sources, sources)) {
+      VLOG(1) << "Unable to generate sources. Skipping this sample.";
+      continue;
+    }
+
+    for (unsigned int jj = 0; jj < num_kept; jj++) {
+      const Sensor2D* finalist = &sensors[jj * num_steps_];
+      for (unsigned int kk = 0; kk < num_steps_; kk++)
+        measurements[kk] = visibility.Sense(finalist[kk], sources);
+
+      counts[jj](codec.Encode(measurements.data())) += 1.0;
+    }
+  }
 
-  // Compute the arg max of this conditional entropy vector.
+  // Pick the finalist with the largest conditional entropy, using the same
+  // estimator as GridMap2D::GenerateEntropyVector().
   double max_value = -1.0;
-  unsigned int trajectory_id = 0;
-  for (unsigned int ii = 0; ii < hzx.rows(); ii++) {
-    if (hzx(ii) > max_value) {
-      max_value = hzx(ii);
-      trajectory_id = trajectory_ids[ii];
+  unsigned int best = 0;
+  for (unsigned int jj = 0; jj < num_kept; jj++) {
+    if (counts[jj].sum() < 1.0)
+      continue;
+
+    const double entropy =
+      EstimateEntropy(counts[jj].data(), kNumMeasurements, estimator_);
+    if (entropy > max_value) {
+      max_value = entropy;
+      best = jj;
     }
   }
 
-  // Check that we found a valid trajectory (with non-negative entropy).
   if (max_value < 0.0) {
     VLOG(1) << "Could not find a positive conditional entropy trajectory.";
     return false;
   }
 
-  // Decode this trajectory id.
-  trajectory.clear();
-  DecodeTrajectory(trajectory_id, num_steps_, pose_, trajectory);
+  trajectory = *scores[best].second;
   return true;
 }
 
+// Plan a new trajectory greedily from the information field.
+bool ExplorerLP::PlanAheadFrontier(unsigned int num_headings,
+                                   std::vector<GridPose2D>& trajectory) {
+  std::vector<Movement2D> movements;
+  PlanFrontier(num_headings, movements, trajectory);
+  return trajectory.size() == num_steps_;
+}
+
+// Greedily build a frontier trajectory, along with its movements.
+void ExplorerLP::PlanFrontier(unsigned int num_headings,
+                              std::vector<Movement2D>& movements,
+                              std::vector<GridPose2D>& trajectory) {
+  CHECK(num_headings > 0);
+  movements.clear();
+  trajectory.clear();
+
+  if (field_ == NULL || field_->GetNumHeadings() != num_headings)
+    field_.reset(new InformationField2D(context_.GetNumRows(),
+                                        context_.GetNumCols(),
+                                        fov_, num_headings));
+
+  std::vector<Eigen::MatrixXd> means, variances;
+  field_->Compute(map_.GetImmutableBelief(), means, variances);
+
+  // Repeating a measurement from the same pose tells us little, even if its
+  // variance is high, so zero out the variance at every pose visited so far.
+  // Poses are identified by cell and nearest heading.
+  const auto visit = [&](const GridPose2D& pose) {
+    const unsigned int ii =
+      std::min(pose.GetIndexX(), context_.GetNumRows() - 1);
+    const unsigned int jj =
+      std::min(pose.GetIndexY(), context_.GetNumCols() - 1);
+    variances[field_->NearestHeading(pose.GetAngle())](ii, jj) = 0.0;
+  };
+
+  for (const auto& pose : past_poses_)
+    visit(pose);
+  visit(pose_);
+
+  // Find the most informative pose on the grid.
+  double best_variance = 0.0;
+  unsigned int best_row = 0, best_col = 0;
+  for (unsigned int hh = 0; hh < num_headings; hh++) {
+    Eigen::MatrixXd::Index row, col;
+    const double variance = variances[hh].maxCoeff(&row, &col);
+    if (variance > best_variance) {
+      best_variance = variance;
+      best_row = row;
+      best_col = col;
+    }
+  }
+
+  // Penalize distance to the best pose, so that the planner heads there when
+  // nearby poses are uninformative. Each cell of distance costs the best
+  // variance spread over the width plus height of the grid.
+  const double discount = best_variance /
+    static_cast<double>(context_.GetNumRows() + context_.GetNumCols());
+
+  // Score a pose by the variance at its cell and nearest heading.
+  const auto score = [&](const GridPose2D& pose) {
+    const unsigned int ii =
+      std::min(pose.GetIndexX(), context_.GetNumRows() - 1);
+    const unsigned int jj =
+      std::min(pose.GetIndexY(), context_.GetNumCols() - 1);
+    const double dx = static_cast<double>(ii) - best_row;
+    const double dy = static_cast<double>(jj) - best_col;
+    return variances[field_->NearestHeading(pose.GetAngle())](ii, jj) -
+      discount * sqrt(dx * dx + dy * dy);
+  };
+
+  // At each step, try every movement in the context and keep the best.
+  GridPose2D current_pose = pose_;
+  while (trajectory.size() < num_steps_) {
+    bool found = false;
+    double best_score = 0.0;
+    unsigned int best_x = 0, best_y = 0, best_a = 0;
+
+    for (unsigned int xx = 0; xx < context_.GetNumDeltaXs(); xx++) {
+      for (unsigned int yy = 0; yy < context_.GetNumDeltaYs(); yy++) {
+        for (unsigned int aa = 0; aa < context_.GetNumDeltaAngles(); aa++) {
+          GridPose2D next_pose = current_pose;
+          if (!next_pose.MoveBy(Movement2D(context_, xx, yy, aa)))
+            continue;
+
+          const double next_score = score(next_pose);
+          if (!found || next_score > best_score) {
+            found = true;
+            best_score = next_score;
+            best_x = xx;
+            best_y = yy;
+            best_a = aa;
+          }
+        }
+      }
+    }
+
+    if (!found) {
+      VLOG(1) << "No legal movement from the current pose.";
+      return;
+    }
+
+    const Movement2D step(context_, best_x, best_y, best_a);
+    CHECK(current_pose.MoveBy(step));
+    movements.push_back(step);
+    trajectory.push_back(current_pose);
+    visit(current_pose);
+  }
+}
+
 // Take a step along the given trajectory. Return resulting entropy.
 double ExplorerLP::TakeStep(const std::vector<GridPose2D>& trajectory) {
+  RADIATION_TRACE_SCOPE("ExplorerLP::TakeStep");
   CHECK(trajectory.size() > 0);
 
   // Update list of past poses.
@@ -133,85 +432,31 @@ double ExplorerLP::TakeStep(const std::vector<GridPose2D>& trajectory) {
 // Compute map entropy.
 double ExplorerLP::Entropy() const { return map_.Entropy(); }
 
-// Visualize the current belief state.
-void ExplorerLP::Visualize() const {
-  glClear(GL_COLOR_BUFFER_BIT);
-
-  // Display each grid cell as a GL_QUAD centered at the appropriate location,
-  // with a small 'epsilon' fudge factor between cells.
-  const Eigen::MatrixXd belief = map_.GetImmutableBelief();
-  const GLfloat kEpsilon = 0.02;
-
-  glBegin(GL_QUADS);
-  for (unsigned int ii = 0; ii < map_.GetNumRows(); ii++) {
-    for (unsigned int jj = 0; jj < map_.GetNumCols(); jj++) {
-      glColor3f(static_cast<GLfloat>(belief(ii, jj)),
-                static_cast<GLfloat>(belief(ii, jj)),
-                static_cast<GLfloat>(belief(ii, jj)));
-
-      // Bottom left, bottom right, top right, top left.
-      glVertex2f(static_cast<GLfloat>(ii) + kEpsilon,
-                 static_cast<GLfloat>(jj) + kEpsilon);
-      glVertex2f(static_cast<GLfloat>(ii) + 1.0 - kEpsilon,
-                 static_cast<GLfloat>(jj) + kEpsilon);
-      glVertex2f(static_cast<GLfloat>(ii) + 1.0 - kEpsilon,
-                 static_cast<GLfloat>(jj) + 1.0 - kEpsilon);
-      glVertex2f(static_cast<GLfloat>(ii) + kEpsilon,
-                 static_cast<GLfloat>(jj) + 1.0 - kEpsilon);
-    }
-  }
-  glEnd();
-
-  const GLfloat robot_x = static_cast<GLfloat>(pose_.GetX());
-  const GLfloat robot_y = static_cast<GLfloat>(pose_.GetY());
-  const GLfloat robot_a = static_cast<GLfloat>(pose_.GetAngle());
-  const unsigned int kNumVertices = 100;
-
-  // Display the field of view as a triangle fan.
-  const GLfloat kFovRadius =
-    sqrt(static_cast<GLfloat>(map_.GetNumRows() * map_.GetNumRows() +
-                            map_.GetNumCols() * map_.GetNumCols()));
-
-  glBegin(GL_TRIANGLE_FAN);
-  glColor4f(0.0, 0.2, 0.8, 0.2);
-  glVertex2f(robot_x, robot_y);
-  for (unsigned int ii = 0; ii <= kNumVertices; ii++) {
-    const GLfloat angle = robot_a + fov_ *
-      (-0.5 + static_cast<GLfloat>(ii) / static_cast<GLfloat>(kNumVertices));
-    glVertex2f(robot_x + kFovRadius * cos(angle),
-               robot_y + kFovRadius * sin(angle));
-  }
-  glEnd();
-
-  // Display a circle at the robot's current position. No circle primitive, so
-  // use a polygon with a bunch of vertices.
-  const GLfloat kRobotRadius = 0.5;
-
-  glBegin(GL_POLYGON);
-  glColor4f(0.0, 0.8, 0.2, 0.5);
-  for (unsigned int ii = 0; ii < kNumVertices; ii++) {
-    const GLfloat angle = 2.0 * M_PI *
-      static_cast<GLfloat>(ii) / static_cast<GLfloat>(kNumVertices);
-    glVertex2f(robot_x + kRobotRadius * cos(angle),
-               robot_y + kRobotRadius * sin(angle));
-  }
-  glEnd();
+// Get the map, current pose, and true sources.
+const GridMap2D& ExplorerLP::GetMap() const { return map_; }
+const GridPose2D& ExplorerLP::GetPose() const { return pose_; }
+const std::vector<Source2D>& ExplorerLP::GetSources() const {
+  return sources_;
+}
 
-  // Display a circle at the location of each source.
-  const GLfloat kSourceRadius = 0.2;
+// Set the cache of conditional entropy vectors.
+void ExplorerLP::SetCache(
+  const std::shared_ptr<const ConditionalCache>& cache) {
+  cache_ = cache;
+}
 
-  for (const auto& source : sources_) {
-    glBegin(GL_POLYGON);
-    glColor4f(0.8, 0.0, 0.2, 0.5);
+// Set the estimator of conditional entropies.
+void ExplorerLP::SetEntropyEstimator(EntropyEstimator estimator) {
+  estimator_ = estimator;
+}
 
-    for (unsigned int ii = 0; ii < kNumVertices; ii++) {
-      const GLfloat angle = 2.0 * M_PI *
-        static_cast<GLfloat>(ii) / static_cast<GLfloat>(kNumVertices);
-      glVertex2f(source.GetX() + kSourceRadius * cos(angle),
-                 source.GetY() + kSourceRadius * sin(angle));
-    }
-    glEnd();
-  }
+// Visualize the current belief state.
+void ExplorerLP::Visualize() const {
+  RADIATION_TRACE_SCOPE("ExplorerLP::Visualize");
+  glClear(GL_COLOR_BUFFER_BIT);
+  DrawBelief(map_.GetImmutableBelief(), context_);
+  DrawRobot(pose_, fov_);
+  DrawSources(sources_);
 }
 
 } // namespace radiation
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// OpenGL scaffolding shared by the interactive explorers. See header for
+// details.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <explorer_window.h>
+
+#include <GLUT/glut.h>
+#include <glog/logging.h>
+#include <iostream>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Number of vertices used to draw circles and fields of view.
+const unsigned int kNumVertices = 100;
+
+// The window's explorer and settings. GLUT callbacks are plain function
+// pointers, so these must be global.
+ExplorerCallbacks window_callbacks;
+unsigned int window_num_rows = 0;
+unsigned int window_num_cols = 0;
+unsigned int window_refresh_rate = 0;
+unsigned int window_num_iterations = 0;
+bool window_iterate_forever = false;
+unsigned int step_count = 0;
+
+// Draw a filled circle. No circle primitive, so use a polygon with a bunch
+// of vertices.
+void DrawCircle(GLfloat x, GLfloat y, GLfloat radius) {
+  glBegin(GL_POLYGON);
+  for (unsigned int ii = 0; ii < kNumVertices; ii++) {
+    const GLfloat angle = 2.0 * M_PI *
+      static_cast<GLfloat>(ii) / static_cast<GLfloat>(kNumVertices);
+    glVertex2f(x + radius * cos(angle), y + radius * sin(angle));
+  }
+  glEnd();
+}
+
+// Initialize OpenGL.
+void InitGL() {
+  // Set the "clearing" or background color as black/opaque.
+  glClearColor(0.0, 0.0, 0.0, 1.0);
+
+  // Set up alpha blending.
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glEnable( GL_BLEND );
+}
+
+// Timer callback. Re-render at the specified rate.
+void Timer(int value) {
+  glutPostRedisplay();
+  glutTimerFunc(window_refresh_rate, Timer, 0);
+}
+
+// Reshape the window to maintain the correct aspect ratio.
+void Reshape(GLsizei width, GLsizei height) {
+  if (height == 0)
+    height = 1;
+
+  // Compute aspect ratio fo the new window.
+  const GLfloat kAspectRatio =
+    static_cast<GLfloat>(width) / static_cast<GLfloat>(height);
+
+  // Set the viewport to cover the new window.
+  glViewport(0, 0, width, height);
+
+  // Set the clipping area to be a square in the positive quadrant.
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  if (width >= height) {
+    // Larger width than height.
+    gluOrtho2D(0.0, static_cast<GLfloat>(window_num_rows) * kAspectRatio,
+               0.0, static_cast<GLfloat>(window_num_cols));
+  } else {
+    // Larger height than width.
+    gluOrtho2D(0.0, static_cast<GLfloat>(window_num_rows),
+               0.0, static_cast<GLfloat>(window_num_cols) / kAspectRatio);
+  }
+}
+
+// Run a single iteration of the exploration algorithm.
+void SingleIteration() {
+  // Only step if we haven't exceeded the step count and the entropy is
+  // still large.
+  if ((window_iterate_forever || step_count < window_num_iterations) &&
+      (window_callbacks.entropy() > 1.0)) {
+    double entropy = 0.0;
+    if (!window_callbacks.step(entropy)) {
+      std::cout << "error in exploration" << std::endl << std::flush;
+      VLOG(1) << "Explorer encountered an error. Skipping this iteration.";
+      return;
+    }
+
+    step_count++;
+    std::cout << "Entropy after step " << step_count <<
+      " is " << entropy << "." << std::endl << std::flush;
+  }
+
+  // No matter what, visualize.
+  window_callbacks.visualize();
+
+  // Swap buffers.
+  glutSwapBuffers();
+}
+} // namespace
+
+  // Draw the belief grid.
+  void DrawBelief(const Eigen::MatrixXd& belief, const Context2D& context) {
+    // Display each grid cell as a GL_QUAD centered at the appropriate
+    // location, with a small 'epsilon' fudge factor between cells.
+    const GLfloat kEpsilon = 0.02;
+
+    glBegin(GL_QUADS);
+    for (unsigned int ii = 0; ii < belief.rows(); ii++) {
+      for (unsigned int jj = 0; jj < belief.cols(); jj++) {
+        // Obstacles are drawn in brown.
+        if (context.IsObstacle(ii, jj))
+          glColor3f(0.4, 0.25, 0.1);
+        else
+          glColor3f(static_cast<GLfloat>(belief(ii, jj)),
+                    static_cast<GLfloat>(belief(ii, jj)),
+                    static_cast<GLfloat>(belief(ii, jj)));
+
+        // Bottom left, bottom right, top right, top left.
+        glVertex2f(static_cast<GLfloat>(ii) + kEpsilon,
+                   static_cast<GLfloat>(jj) + kEpsilon);
+        glVertex2f(static_cast<GLfloat>(ii) + 1.0 - kEpsilon,
+                   static_cast<GLfloat>(jj) + kEpsilon);
+        glVertex2f(static_cast<GLfloat>(ii) + 1.0 - kEpsilon,
+                   static_cast<GLfloat>(jj) + 1.0 - kEpsilon);
+        glVertex2f(static_cast<GLfloat>(ii) + kEpsilon,
+                   static_cast<GLfloat>(jj) + 1.0 - kEpsilon);
+      }
+    }
+    glEnd();
+  }
+
+  // Draw a robot and its field of view.
+  void DrawRobot(const GridPose2D& pose, double fov) {
+    const Context2D& context = pose.GetContext();
+    const GLfloat robot_x = static_cast<GLfloat>(pose.GetX());
+    const GLfloat robot_y = static_cast<GLfloat>(pose.GetY());
+    const GLfloat robot_a = static_cast<GLfloat>(pose.GetAngle());
+
+    // Display the field of view as a triangle fan.
+    const GLfloat kFovRadius =
+      sqrt(static_cast<GLfloat>(context.GetNumRows() * context.GetNumRows() +
+                                context.GetNumCols() * context.GetNumCols()));
+
+    glBegin(GL_TRIANGLE_FAN);
+    glColor4f(0.0, 0.2, 0.8, 0.2);
+    glVertex2f(robot_x, robot_y);
+    for (unsigned int ii = 0; ii <= kNumVertices; ii++) {
+      const GLfloat angle = robot_a + fov *
+        (-0.5 + static_cast<GLfloat>(ii) / static_cast<GLfloat>(kNumVertices));
+      glVertex2f(robot_x + kFovRadius * cos(angle),
+                 robot_y + kFovRadius * sin(angle));
+    }
+    glEnd();
+
+    // Display a circle at the robot's current position.
+    const GLfloat kRobotRadius = 0.5;
+    glColor4f(0.0, 0.8, 0.2, 0.5);
+    DrawCircle(robot_x, robot_y, kRobotRadius);
+  }
+
+  // Draw a small circle at each source.
+  void DrawSources(const std::vector<Source2D>& sources) {
+    const GLfloat kSourceRadius = 0.2;
+
+    glColor4f(0.8, 0.0, 0.2, 0.5);
+    for (const auto& source : sources)
+      DrawCircle(source.GetX(), source.GetY(), kSourceRadius);
+  }
+
+  // Open a GLUT window and run its main loop.
+  void RunExplorerWindow(int* argc, char** argv, const std::string& title,
+                         unsigned int num_rows, unsigned int num_cols,
+                         unsigned int refresh_rate,
+                         unsigned int num_iterations, bool iterate_forever,
+                         const ExplorerCallbacks& callbacks) {
+    CHECK(callbacks.entropy && callbacks.step && callbacks.visualize);
+    window_callbacks = callbacks;
+    window_num_rows = num_rows;
+    window_num_cols = num_cols;
+    window_refresh_rate = refresh_rate;
+    window_num_iterations = num_iterations;
+    window_iterate_forever = iterate_forever;
+    step_count = 0;
+
+    // Set up OpenGL window.
+    glutInit(argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE);
+    glutInitWindowSize(320, 320);
+    glutInitWindowPosition(50, 50);
+    glutCreateWindow(title.c_str());
+    glutDisplayFunc(SingleIteration);
+    glutReshapeFunc(Reshape);
+    glutTimerFunc(0, Timer, 0);
+    InitGL();
+    glutMainLoop();
+  }
+
+} // namespace radiation
@@ -41,22 +41,24 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <grid_map_2d.h>
-#include <encoding.h>
 #include <cost_functors.h>
+#include <entropy_kernels.h>
+#include <trace.h>
 
 #include <ceres/ceres.h>
 #include <glog/logging.h>
 #include <math.h>
 #include <algorithm>
-#include <map>
 
 namespace radiation {
 
   GridMap2D::~GridMap2D() {}
-  GridMap2D::GridMap2D(unsigned int num_rows, unsigned int num_cols,
+  GridMap2D::GridMap2D(const Context2D& context,
                        unsigned int num_sources, double regularizer)
-    : num_rows_(num_rows), num_cols_(num_cols),
+    : context_(context), visibility_(context),
+      num_rows_(context.GetNumRows()), num_cols_(context.GetNumCols()),
       num_sources_(num_sources), regularizer_(regularizer),
+      num_samples_drawn_(0), num_solver_iterations_(0),
       rng_(rd_()) {
 
     // Initialize belief matrix to be uniform.
@@ -64,9 +66,42 @@ namespace radiation {
     belief_ /= num_rows_ * num_cols_;
   }
 
+  GridMap2D::GridMap2D(const Context2D& context, const Eigen::MatrixXd& belief,
+                       unsigned int num_sources, double regularizer)
+    : belief_(belief), context_(context), visibility_(context),
+      num_rows_(context.GetNumRows()), num_cols_(context.GetNumCols()),
+      num_sources_(num_sources), regularizer_(regularizer),
+      num_samples_drawn_(0), num_solver_iterations_(0),
+      rng_(rd_()) {
+    CHECK(belief_.rows() == num_rows_ && belief_.cols() == num_cols_);
+  }
+
+  GridMap2D::GridMap2D(const Context2D& context, const Eigen::MatrixXd& belief,
+                       unsigned int num_sources, double regularizer,
+                       const VisibilityCache2D& visibility)
+    : belief_(belief), context_(context), visibility_(visibility),
+      num_rows_(context.GetNumRows()), num_cols_(context.GetNumCols()),
+      num_sources_(num_sources), regularizer_(regularizer),
+      num_samples_drawn_(0), num_solver_iterations_(0),
+      rng_(rd_()) {
+    CHECK(belief_.rows() == num_rows_ && belief_.cols() == num_cols_);
+  }
+
   // Getters.
+  const Context2D& GridMap2D::GetContext() const { return context_; }
+  const VisibilityCache2D& GridMap2D::GetVisibility() const {
+    return visibility_;
+  }
   unsigned int GridMap2D::GetNumRows() const { return num_rows_; }
   unsigned int GridMap2D::GetNumCols() const { return num_cols_; }
+  unsigned int GridMap2D::GetNumSources() const { return num_sources_; }
+  double GridMap2D::GetRegularizer() const { return regularizer_; }
+
+  // Reseed the random number generator.
+  void GridMap2D::Seed(unsigned int seed) { rng_.seed(seed); }
+
+  // Draw a seed from the random number generator.
+  unsigned int GridMap2D::DrawSeed() { return rng_(); }
 
   // Generate random sources according to the current belief state.
   bool GridMap2D::GenerateSources(std::vector<Source2D>& sources) {
@@ -76,11 +111,11 @@ namespace radiation {
     // Choose 'num_sources_' random numbers in [0, 1], which will be sorted
     // and treated as evaluations of the CDF. Since they are uniform, the points
     // at which they occur ar distributed according to the current belief.
-    std::vector<double> cdf_evals;
+    cdf_evals_.resize(num_sources_);
     for (size_t ii = 0; ii < num_sources_; ii++)
-      cdf_evals.push_back(unif(rng_));
+      cdf_evals_[ii] = unif(rng_);
 
-    std::sort(cdf_evals.begin(), cdf_evals.end());
+    std::sort(cdf_evals_.begin(), cdf_evals_.end());
 
     // Walk the current belief distribution until we get to each 'cdf_eval'
     // and record which voxel we are in.
@@ -93,7 +128,7 @@ namespace radiation {
         current_cdf += belief_(ii, jj) / total_belief;
 
         // Check if we just passed the next 'cdf_eval'.
-        while (current_cdf >= cdf_evals[current_index]) {
+        while (current_cdf >= cdf_evals_[current_index]) {
           // Generate a new source here.
           sources.push_back(Source2D(ii, jj));
 
@@ -111,117 +146,35 @@ namespace radiation {
     return false;
   }
 
+  // Count the sources visible from the sensor.
+  unsigned int GridMap2D::Sense(const Sensor2D& sensor,
+                                const std::vector<Source2D>& sources) {
+    return visibility_.Sense(sensor, sources);
+  }
+
   // Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
   // is the entropy of Z given trajectory X = i, starting from the given pose.
   void GridMap2D::GenerateEntropyVector(
      unsigned int num_samples, unsigned int num_steps, const GridPose2D& pose,
      double sensor_fov, Eigen::VectorXd& hzx,
-     std::vector<unsigned int>& trajectory_ids) {
-    // Compute the number of possible measurement vectors.
-    const unsigned int kNumMeasurements = pow(num_sources_ + 1, num_steps);
-
-    // Create a map to keep track of counts for each trajectory.
-    std::map<unsigned int, Eigen::VectorXd> zx_samples;
-
-    // Generate a ton of sampled data.
-    for (unsigned int ii = 0; ii < num_samples; ii++) {
-      // Generate random sources on the grid according to the current 'belief',
-      // and compute a corresponding 'map_id' number based on which grid cells
-      // the sources lie in.
-      std::vector<Source2D> sources;
-      if (!GenerateSources(sources)) {
-        VLOG(1) << "Unable to generate sources. Skipping this sample.";
-        continue;
-      }
-
-      // Pick a random trajectory starting at the given pose. At each step,
-      // take a measurement and record the data.
-      GridPose2D current_pose = pose;
-      std::vector<Movement2D> movements;
-      std::vector<unsigned int> measurements;
-      while (movements.size() < num_steps) {
-        const Movement2D step;
-        if (current_pose.MoveBy(step)) {
-          movements.push_back(step);
-
-          const Sensor2D sensor(current_pose, sensor_fov);
-          measurements.push_back(sensor.Sense(sources));
-        }
-      }
-
-      // Compute trajectory and measurement sequence ids.
-      const unsigned int trajectory_id = EncodeTrajectory(movements);
-      const unsigned int measurement_id =
-        EncodeMeasurements(measurements, num_sources_);
-
-      // Record this sample in the 'zx_samples' map.
-      if (zx_samples.count(trajectory_id) == 0) {
-        Eigen::VectorXd counts = Eigen::VectorXd::Zero(kNumMeasurements);
-        counts(measurement_id) = 1.0;
-        zx_samples.insert({trajectory_id, counts});
-      } else {
-        zx_samples.at(trajectory_id)(measurement_id) += 1.0;
-      }
-    }
-
-    // Convert 'zx_samples' into a matrix joint distribution.
-    const unsigned int kNumTrajectories = zx_samples.size();
-    Eigen::MatrixXd pzx =
-      Eigen::MatrixXd::Zero(kNumMeasurements, kNumTrajectories);
-    trajectory_ids.clear();
-    trajectory_ids.reserve(kNumTrajectories);
-
-    unsigned int idx = 0;
-    for (auto pair = zx_samples.begin(); pair != zx_samples.end(); pair++) {
-      trajectory_ids.push_back(pair->first);
-      pzx.col(idx++) = pair->second;
-    }
-
-    // Normalize so that all columns sum to unity.
-    for (unsigned int jj = 0; jj < kNumTrajectories; jj++) {
-      const double zx_col_sum = pzx.col(jj).sum();
-      if (zx_col_sum < 1.0) {
-        VLOG(1) << "Encountered trajectory with no support in P_{Z|X}.";
-      } else {
-        pzx.col(jj) /= zx_col_sum;
-      }
-    }
-
-    // Compute [h_{Z|X}], the conditional entropy vector.
-    hzx.resize(kNumTrajectories);
-    for (unsigned int jj = 0; jj < kNumTrajectories; jj++) {
-      hzx(jj) = 0.0;
-
-      for (unsigned int ii = 0; ii < kNumMeasurements; ii++) {
-        const double p = pzx(ii, jj);
-
-        // Catch 'p' values near 0 or 1 to avoid numerical issues.
-        if (p < 0.01 || p > 1.0 - 0.01)
-          continue;
-
-        hzx(jj) -= p * log(p);
-      }
-
-      // Make sure entropies are non-negative.
-      CHECK(hzx(jj) >= 0.0);
-    }
+     std::vector<Id64>& trajectory_ids, EntropyEstimator estimator,
+     Eigen::MatrixXd* histogram) {
+    SampleEntropyVector(*this, rng_, num_samples, num_steps, pose, sensor_fov,
+                        scratch_, hzx, trajectory_ids, estimator, histogram);
+    num_samples_drawn_ += num_samples;
   }
 
   // Take a measurement from the given sensor and update belief accordingly.
   bool GridMap2D::Update(const Sensor2D& sensor,
                          const std::vector<Source2D>& sources,
                          bool solve) {
-    const unsigned int measurement = sensor.Sense(sources);
+    RADIATION_TRACE_SCOPE("GridMap2D::Update");
+    const unsigned int measurement = visibility_.Sense(sensor, sources);
     CHECK(measurement <= num_sources_);
 
-    // Identify all voxels in range and store.
+    // Identify all visible voxels and store.
     std::vector<unsigned int> voxels;
-    for (size_t ii = 0; ii < num_rows_; ii++) {
-      for (size_t jj = 0; jj < num_cols_; jj++) {
-        if (sensor.VoxelInView(ii, jj))
-          voxels.push_back(ii + jj * num_rows_);
-      }
-    }
+    visibility_.VisibleVoxels(sensor, voxels);
 
     viewed_.push_back(voxels);
     measurements_.push_back(measurement);
@@ -235,23 +188,27 @@ namespace radiation {
 
   // Compute entropy.
   double GridMap2D::Entropy() const {
-    double entropy = 0.0;
+    return SumBernoulliEntropies(belief_.data(), belief_.size(), 1e-8);
+  }
 
-    for (size_t ii = 0; ii < num_rows_; ii++) {
-      for (size_t jj = 0; jj < num_cols_; jj++) {
-        const double p = belief_(ii, jj);
-        const double bernoulli_entropy = (p > 1e-8 && p < 1.0 - 1e-8) ?
-          (-p * log(p) - (1.0 - p) * log(1.0 - p)) : 0.0;
+  // Compute the expected measurement from the given sensor under the current
+  // belief state.
+  double GridMap2D::ExpectedMeasurement(const Sensor2D& sensor) const {
+    std::vector<unsigned int> voxels;
+    visibility_.ComputeVisibleVoxels(sensor, voxels);
 
-        entropy += bernoulli_entropy;
-      }
-    }
+    // 'belief_' is column-major, so voxel indices index its data directly.
+    double expected = 0.0;
+    for (const auto& voxel : voxels)
+      expected += belief_.data()[voxel];
 
-    return entropy;
+    return expected;
   }
 
   // Solve least squares problem to update belief state.
   bool GridMap2D::SolveLeastSquares() {
+    RADIATION_TRACE_SCOPE("GridMap2D::SolveLeastSquares");
+
     // Create a non-linear least squares problem.
     ceres::Problem problem;
 
@@ -291,8 +248,12 @@ namespace radiation {
     options.trust_region_strategy_type = ceres::LEVENBERG_MARQUARDT;
 
     // Solve and return.
-    ceres::Solve(options, &problem, &summary);
+    {
+      RADIATION_TRACE_SCOPE("GridMap2D::SolveLeastSquares/solve");
+      ceres::Solve(options, &problem, &summary);
+    }
 
+    num_solver_iterations_ += summary.iterations.size();
     return summary.IsSolutionUsable();
   }
 
@@ -301,4 +262,13 @@ namespace radiation {
     return belief_;
   }
 
+  // Running totals, for profiling.
+  unsigned long long GridMap2D::GetNumSamplesDrawn() const {
+    return num_samples_drawn_;
+  }
+
+  unsigned long long GridMap2D::GetNumSolverIterations() const {
+    return num_solver_iterations_;
+  }
+
 } // namespace radiation
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 3D grid map whose belief is stored sparsely.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <grid_map_3d.h>
+#include <cost_functors.h>
+#include <entropy_kernels.h>
+
+#include <ceres/ceres.h>
+#include <glog/logging.h>
+#include <math.h>
+#include <algorithm>
+
+namespace radiation {
+
+  GridMap3D::~GridMap3D() {}
+  GridMap3D::GridMap3D(const Context3D& context,
+                       unsigned int num_sources, double regularizer,
+                       unsigned int num_headings,
+                       unsigned int max_cached_poses)
+    : context_(context),
+      num_rows_(context.GetNumRows()), num_cols_(context.GetNumCols()),
+      num_layers_(context.GetNumLayers()),
+      num_sources_(num_sources),
+      prior_(static_cast<double>(num_sources) /
+             (static_cast<double>(context.GetNumRows()) *
+              static_cast<double>(context.GetNumCols()) *
+              static_cast<double>(context.GetNumLayers()))),
+      regularizer_(regularizer),
+      num_headings_(num_headings),
+      max_cached_poses_(max_cached_poses),
+      rng_(rd_()) {
+    CHECK(num_rows_ > 0 && num_cols_ > 0 && num_layers_ > 0);
+    CHECK(num_headings_ > 0);
+    CHECK(max_cached_poses_ > 0);
+  }
+
+  // Getters.
+  const Context3D& GridMap3D::GetContext() const { return context_; }
+  unsigned int GridMap3D::GetNumRows() const { return num_rows_; }
+  unsigned int GridMap3D::GetNumCols() const { return num_cols_; }
+  unsigned int GridMap3D::GetNumLayers() const { return num_layers_; }
+  unsigned int GridMap3D::GetNumSources() const { return num_sources_; }
+  double GridMap3D::GetRegularizer() const { return regularizer_; }
+  double GridMap3D::GetPrior() const { return prior_; }
+  unsigned int GridMap3D::GetNumAllocated() const { return voxels_.size(); }
+  unsigned int GridMap3D::GetNumCachedPoses() const { return visible_.size(); }
+
+  // Reseed the random number generator.
+  void GridMap3D::Seed(unsigned int seed) { rng_.seed(seed); }
+
+  // Generate random sources according to the current belief state.
+  bool GridMap3D::GenerateSources(std::vector<Source3D>& sources) {
+    sources.clear();
+    if (num_sources_ == 0)
+      return true;
+
+    const unsigned int num_voxels = num_rows_ * num_cols_ * num_layers_;
+    const unsigned int num_background = num_voxels - voxels_.size();
+    double total_belief = prior_ * static_cast<double>(num_background);
+    for (const auto& p : belief_)
+      total_belief += p;
+
+    // Choose 'num_sources_' random numbers in [0, total], which will be
+    // sorted and treated as evaluations of the (unnormalized) CDF.
+    std::uniform_real_distribution<double> unif(0.0, total_belief);
+    cdf_evals_.resize(num_sources_);
+    for (size_t ii = 0; ii < num_sources_; ii++)
+      cdf_evals_[ii] = unif(rng_);
+
+    std::sort(cdf_evals_.begin(), cdf_evals_.end());
+
+    // Walk allocated voxels first.
+    unsigned int current_index = 0;
+    double current_cdf = 0.0;
+    const unsigned int slice = num_rows_ * num_cols_;
+
+    for (size_t ii = 0; ii < belief_.size(); ii++) {
+      current_cdf += belief_[ii];
+
+      // Check if we just passed the next 'cdf_eval'.
+      while (current_cdf >= cdf_evals_[current_index]) {
+        const unsigned int voxel = voxels_[ii];
+        sources.push_back(Source3D(voxel % num_rows_,
+                                   (voxel % slice) / num_rows_,
+                                   voxel / slice));
+
+        if (sources.size() == num_sources_)
+          return true;
+
+        current_index++;
+      }
+    }
+
+    // Remaining sources lie in the background, where belief is uniform.
+    // Draw voxels uniformly from the bounds and reject allocated ones.
+    if (num_background == 0)
+      return false;
+
+    std::uniform_int_distribution<unsigned int> unif_voxels(0, num_voxels - 1);
+    while (sources.size() < num_sources_) {
+      const unsigned int voxel = unif_voxels(rng_);
+      if (slots_.count(voxel) == 0)
+        sources.push_back(Source3D(voxel % num_rows_,
+                                   (voxel % slice) / num_rows_,
+                                   voxel / slice));
+    }
+
+    return true;
+  }
+
+  // Count the sources visible from the sensor.
+  unsigned int GridMap3D::Sense(const Sensor3D& sensor,
+                                const std::vector<Source3D>& sources) {
+    const std::vector<unsigned int>& visible = VisibleVoxels(sensor);
+
+    unsigned int count = 0;
+    for (const auto& source : sources) {
+      const unsigned int voxel = source.GetIndexX() +
+        num_rows_ * (source.GetIndexY() + num_cols_ * source.GetIndexZ());
+      if (std::binary_search(visible.begin(), visible.end(), voxel))
+        count++;
+    }
+
+    return count;
+  }
+
+  // Get the sorted indices of all voxels visible from the sensor. Snap the
+  // sensor to its voxel center and nearest heading, and look that up.
+  const std::vector<unsigned int>& GridMap3D::VisibleVoxels(
+    const Sensor3D& sensor) {
+    if (sensor.GetX() < 0.0 || sensor.GetX() >= num_rows_ ||
+        sensor.GetY() < 0.0 || sensor.GetY() >= num_cols_ ||
+        sensor.GetZ() < 0.0 || sensor.GetZ() >= num_layers_) {
+      sensor.VoxelsInView(num_rows_, num_cols_, num_layers_,
+                          uncached_visible_);
+      RemoveOccluded(sensor.GetX(), sensor.GetY(), sensor.GetZ(),
+                     uncached_visible_);
+      return uncached_visible_;
+    }
+
+    const unsigned int ii = static_cast<unsigned int>(sensor.GetX());
+    const unsigned int jj = static_cast<unsigned int>(sensor.GetY());
+    const unsigned int kk = static_cast<unsigned int>(sensor.GetZ());
+    const double kHeadingStep = 2.0 * M_PI / num_headings_;
+    double angle = fmod(sensor.GetAngle(), 2.0 * M_PI);
+    if (angle < 0.0)
+      angle += 2.0 * M_PI;
+    const unsigned int heading =
+      static_cast<unsigned int>(round(angle / kHeadingStep)) % num_headings_;
+
+    const Id64 voxel = ii + num_rows_ * (jj + num_cols_ * kk);
+    const Id64 key = voxel * num_headings_ + heading;
+
+    auto iter = visible_.find(key);
+    if (iter == visible_.end()) {
+      if (visible_order_.size() >= max_cached_poses_) {
+        visible_.erase(visible_order_.front());
+        visible_order_.pop_front();
+      }
+
+      iter = visible_.insert({key, VisibleSet()}).first;
+      visible_order_.push_back(key);
+    } else if (iter->second.fov == sensor.GetFov()) {
+      return iter->second.voxels;
+    }
+
+    const Sensor3D snapped(ii + 0.5, jj + 0.5, kk + 0.5,
+                           heading * kHeadingStep, sensor.GetFov());
+    iter->second.fov = sensor.GetFov();
+    snapped.VoxelsInView(num_rows_, num_cols_, num_layers_,
+                         iter->second.voxels);
+    RemoveOccluded(snapped.GetX(), snapped.GetY(), snapped.GetZ(),
+                   iter->second.voxels);
+    return iter->second.voxels;
+  }
+
+  // Remove voxels without a clear line of sight, keeping the rest in order.
+  void GridMap3D::RemoveOccluded(double x, double y, double z,
+                                 std::vector<unsigned int>& voxels) const {
+    if (!context_.HasObstacles())
+      return;
+
+    const unsigned int slice = num_rows_ * num_cols_;
+    voxels.erase(std::remove_if(
+      voxels.begin(), voxels.end(), [&](unsigned int voxel) {
+        return !context_.LineOfSight(x, y, z, voxel % num_rows_,
+                                     (voxel % slice) / num_rows_,
+                                     voxel / slice);
+      }), voxels.end());
+  }
+
+  // Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
+  // is the entropy of Z given trajectory X = i, starting from the given pose.
+  void GridMap3D::GenerateEntropyVector(
+     unsigned int num_samples, unsigned int num_steps, const GridPose3D& pose,
+     double sensor_fov, Eigen::VectorXd& hzx,
+     std::vector<Id64>& trajectory_ids, EntropyEstimator estimator) {
+    SampleEntropyVector(*this, rng_, num_samples, num_steps, pose, sensor_fov,
+                        scratch_, hzx, trajectory_ids, estimator);
+  }
+
+  // Take a measurement from the given sensor and update belief accordingly.
+  bool GridMap3D::Update(const Sensor3D& sensor,
+                         const std::vector<Source3D>& sources,
+                         bool solve) {
+    const unsigned int measurement = Sense(sensor, sources);
+    CHECK(measurement <= num_sources_);
+
+    // Allocate all visible voxels and record their slots.
+    const std::vector<unsigned int>& voxels = VisibleVoxels(sensor);
+    std::vector<unsigned int> slots;
+    slots.reserve(voxels.size());
+    for (const auto& voxel : voxels)
+      slots.push_back(FindOrAllocate(voxel));
+
+    viewed_.push_back(slots);
+    measurements_.push_back(measurement);
+
+    // Maybe solve.
+    if (solve)
+      return SolveLeastSquares();
+
+    return true;
+  }
+
+  // Compute entropy.
+  double GridMap3D::Entropy() const {
+    const unsigned int num_background =
+      num_rows_ * num_cols_ * num_layers_ - voxels_.size();
+    return static_cast<double>(num_background) *
+      SumBernoulliEntropies(&prior_, 1, 1e-8) +
+      SumBernoulliEntropies(belief_.data(), belief_.size(), 1e-8);
+  }
+
+  // Get the belief for a single voxel.
+  double GridMap3D::GetBelief(unsigned int ii, unsigned int jj,
+                              unsigned int kk) const {
+    CHECK(ii < num_rows_ && jj < num_cols_ && kk < num_layers_);
+
+    const auto iter = slots_.find(ii + num_rows_ * (jj + num_cols_ * kk));
+    if (iter == slots_.end())
+      return prior_;
+
+    return belief_[iter->second];
+  }
+
+  // Find the slot of a voxel, allocating it at the prior if necessary.
+  unsigned int GridMap3D::FindOrAllocate(unsigned int voxel) {
+    const auto iter = slots_.find(voxel);
+    if (iter != slots_.end())
+      return iter->second;
+
+    const unsigned int slot = voxels_.size();
+    slots_.insert({voxel, slot});
+    voxels_.push_back(voxel);
+    belief_.push_back(prior_);
+    return slot;
+  }
+
+  // Solve least squares problem to update belief state.
+  bool GridMap3D::SolveLeastSquares() {
+    const unsigned int num_allocated = belief_.size();
+    if (num_allocated == 0)
+      return true;
+
+    // Create a non-linear least squares problem.
+    ceres::Problem problem;
+
+    // Add residual blocks for each set of observed voxels and their
+    // associated measurements. Slots index directly into 'belief_', which is
+    // a single parameter block.
+    for (size_t ii = 0; ii < viewed_.size(); ii++) {
+      problem.AddResidualBlock(
+        BeliefError::Create(num_allocated, 1, &viewed_[ii], measurements_[ii]),
+        NULL, /* squared loss */
+        belief_.data());
+    }
+
+    // Add a final residual block to enforce consistancy across the entire
+    // grid. Unallocated voxels are held at the prior, so only the remaining
+    // number of sources is expected among allocated voxels.
+    const unsigned int num_background =
+      num_rows_ * num_cols_ * num_layers_ - num_allocated;
+    const double target = static_cast<double>(num_sources_) -
+      prior_ * static_cast<double>(num_background);
+    problem.AddResidualBlock(
+      BeliefRegularization::Create(num_allocated, 1, target,
+                                   regularizer_ * viewed_.size()),
+      NULL, /* squared loss */
+      belief_.data());
+
+    // Set bounds constraints. Each voxel's belief should be a probability
+    // between 0 and 1.
+    for (unsigned int ii = 0; ii < num_allocated; ii++) {
+      problem.SetParameterLowerBound(belief_.data(), ii, 0.0);
+      problem.SetParameterUpperBound(belief_.data(), ii, 1.0);
+    }
+
+    // Set up solver options.
+    ceres::Solver::Summary summary;
+    ceres::Solver::Options options;
+    options.linear_solver_type = ceres::CGNR;
+    options.function_tolerance = 1e-16;
+    options.gradient_tolerance = 1e-16;
+    options.trust_region_strategy_type = ceres::LEVENBERG_MARQUARDT;
+
+    // Solve and return.
+    ceres::Solve(options, &problem, &summary);
+
+    return summary.IsSolutionUsable();
+  }
+
+} // namespace radiation
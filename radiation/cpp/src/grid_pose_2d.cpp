@@ -47,24 +47,21 @@
 
 namespace radiation {
 
-  // Static dimensions.
-  unsigned int GridPose2D::num_rows_ = 10;
-  unsigned int GridPose2D::num_cols_ = 10;
-
   // Constructor/destructor.
   GridPose2D::~GridPose2D() {}
-  GridPose2D::GridPose2D(double x, double y, double a)
-    : x_(x), y_(y), a_(a) {}
-  GridPose2D::GridPose2D(unsigned int x, unsigned int y, double a)
-    : x_(static_cast<double>(x) + 0.5),
+  GridPose2D::GridPose2D(const Context2D& context,
+                         double x, double y, double a)
+    : context_(&context), x_(x), y_(y), a_(a) {}
+  GridPose2D::GridPose2D(const Context2D& context,
+                         unsigned int x, unsigned int y, double a)
+    : context_(&context),
+      x_(static_cast<double>(x) + 0.5),
       y_(static_cast<double>(y) + 0.5),
       a_(a) {}
 
-  // Static setters.
-  void GridPose2D::SetNumRows(unsigned int num_rows) { num_rows_ = num_rows; }
-  void GridPose2D::SetNumCols(unsigned int num_cols) { num_cols_ = num_cols; }
-
   // Getters.
+  const Context2D& GridPose2D::GetContext() const { return *context_; }
+
   double GridPose2D::GetX() const { return x_; }
   double GridPose2D::GetY() const { return y_; }
   double GridPose2D::GetAngle() const { return a_; }
@@ -84,11 +81,18 @@ namespace radiation {
     double new_a = a_ + movement.GetDeltaAngle();
 
     // Catch going out of bounds.
-    if ((new_x < 0.0) || (new_x > num_rows_) ||
-        (new_y < 0.0) || (new_y > num_cols_))
+    if ((new_x < 0.0) || (new_x > context_->GetNumRows()) ||
+        (new_y < 0.0) || (new_y > context_->GetNumCols()))
+      return false;
+
+    // Catch moving into an obstacle.
+    const unsigned int new_ii = static_cast<unsigned int>(new_x);
+    const unsigned int new_jj = static_cast<unsigned int>(new_y);
+    if (new_ii < context_->GetNumRows() && new_jj < context_->GetNumCols() &&
+        context_->IsObstacle(new_ii, new_jj))
       return false;
 
-    // Not going out of bounds, so update coordinates.
+    // Not going out of bounds or into an obstacle, so update coordinates.
     x_ = new_x;
     y_ = new_y;
     a_ = new_a;
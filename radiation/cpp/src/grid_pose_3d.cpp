@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a pose on the 3D grid, i.e. a position and a yaw angle.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <grid_pose_3d.h>
+
+#include <math.h>
+
+namespace radiation {
+
+  // Constructor/destructor.
+  GridPose3D::~GridPose3D() {}
+  GridPose3D::GridPose3D(const Context3D& context,
+                         double x, double y, double z, double a)
+    : context_(&context), x_(x), y_(y), z_(z), a_(a) {}
+  GridPose3D::GridPose3D(const Context3D& context,
+                         unsigned int x, unsigned int y, unsigned int z,
+                         double a)
+    : context_(&context),
+      x_(static_cast<double>(x) + 0.5),
+      y_(static_cast<double>(y) + 0.5),
+      z_(static_cast<double>(z) + 0.5),
+      a_(a) {}
+
+  // Getters.
+  const Context3D& GridPose3D::GetContext() const { return *context_; }
+
+  double GridPose3D::GetX() const { return x_; }
+  double GridPose3D::GetY() const { return y_; }
+  double GridPose3D::GetZ() const { return z_; }
+  double GridPose3D::GetAngle() const { return a_; }
+
+  unsigned int GridPose3D::GetIndexX() const {
+    return static_cast<unsigned int>(x_);
+  }
+
+  unsigned int GridPose3D::GetIndexY() const {
+    return static_cast<unsigned int>(y_);
+  }
+
+  unsigned int GridPose3D::GetIndexZ() const {
+    return static_cast<unsigned int>(z_);
+  }
+
+  // Move by the given amount if it is legal.
+  bool GridPose3D::MoveBy(const Movement3D& movement) {
+    double new_x = x_ + movement.GetDeltaX();
+    double new_y = y_ + movement.GetDeltaY();
+    double new_z = z_ + movement.GetDeltaZ();
+    double new_a = a_ + movement.GetDeltaAngle();
+
+    // Catch going out of bounds.
+    if ((new_x < 0.0) || (new_x > context_->GetNumRows()) ||
+        (new_y < 0.0) || (new_y > context_->GetNumCols()) ||
+        (new_z < 0.0) || (new_z > context_->GetNumLayers()))
+      return false;
+
+    // Catch moving into an obstacle.
+    const unsigned int new_ii = static_cast<unsigned int>(new_x);
+    const unsigned int new_jj = static_cast<unsigned int>(new_y);
+    const unsigned int new_kk = static_cast<unsigned int>(new_z);
+    if (new_ii < context_->GetNumRows() && new_jj < context_->GetNumCols() &&
+        new_kk < context_->GetNumLayers() &&
+        context_->IsObstacle(new_ii, new_jj, new_kk))
+      return false;
+
+    // Not going out of bounds or into an obstacle, so update coordinates.
+    x_ = new_x;
+    y_ = new_y;
+    z_ = new_z;
+    a_ = new_a;
+
+    // Make sure angle is in [0, 2 pi).
+    if (a_ < 0.0)
+      a_ += M_PI + M_PI;
+    else if (a_ > M_PI + M_PI)
+      a_ -= M_PI + M_PI;
+    return true;
+  }
+
+} // namespace radiation
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines fields of the expected measurement and its variance over every
+// (cell, heading) pose at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <information_field_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+
+#include <glog/logging.h>
+#include <unsupported/Eigen/FFT>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// In-place 2D discrete Fourier transform, applied to each column and then to
+// each row. The inverse transform is scaled by 1 / N.
+void Transform2D(Eigen::MatrixXcd& data, bool inverse) {
+  Eigen::FFT<double> fft;
+  Eigen::VectorXcd in, out;
+
+  for (int jj = 0; jj < data.cols(); jj++) {
+    in = data.col(jj);
+    if (inverse)
+      fft.inv(out, in);
+    else
+      fft.fwd(out, in);
+    data.col(jj) = out;
+  }
+
+  for (int ii = 0; ii < data.rows(); ii++) {
+    in = data.row(ii).transpose();
+    if (inverse)
+      fft.inv(out, in);
+    else
+      fft.fwd(out, in);
+    data.row(ii) = out.transpose();
+  }
+}
+} // namespace
+
+  InformationField2D::~InformationField2D() {}
+  InformationField2D::InformationField2D(unsigned int num_rows,
+                                         unsigned int num_cols,
+                                         double fov, unsigned int num_headings)
+    : num_rows_(num_rows), num_cols_(num_cols),
+      num_padded_rows_(2 * num_rows), num_padded_cols_(2 * num_cols),
+      fov_(fov), num_headings_(num_headings) {
+    CHECK(num_rows_ > 0 && num_cols_ > 0);
+    CHECK(num_headings_ > 0);
+
+    // Build each heading's kernel. Entry (dx, dy) is one if the voxel offset
+    // by (dx, dy) from the sensor's cell is in view. Offsets range over
+    // (-num_rows, num_rows) x (-num_cols, num_cols) and are stored
+    // circularly, which does not alias since the padded size is at least
+    // 2 * num_rows - 1 by 2 * num_cols - 1.
+    const int rows = static_cast<int>(num_rows_);
+    const int cols = static_cast<int>(num_cols_);
+    for (unsigned int hh = 0; hh < num_headings_; hh++) {
+      const Sensor2D sensor(0.5, 0.5, GetHeading(hh), fov_);
+
+      Eigen::MatrixXcd kernel =
+        Eigen::MatrixXcd::Zero(num_padded_rows_, num_padded_cols_);
+      for (int dy = 1 - cols; dy < cols; dy++) {
+        for (int dx = 1 - rows; dx < rows; dx++) {
+          const Source2D source(0.5 + dx, 0.5 + dy);
+          if (sensor.SourceInView(source))
+            kernel((dx + num_padded_rows_) % num_padded_rows_,
+                   (dy + num_padded_cols_) % num_padded_cols_) = 1.0;
+        }
+      }
+
+      Transform2D(kernel, false);
+      kernels_.push_back(kernel.conjugate());
+    }
+  }
+
+  // Getters.
+  unsigned int InformationField2D::GetNumRows() const { return num_rows_; }
+  unsigned int InformationField2D::GetNumCols() const { return num_cols_; }
+  unsigned int InformationField2D::GetNumHeadings() const {
+    return num_headings_;
+  }
+
+  double InformationField2D::GetHeading(unsigned int hh) const {
+    return 2.0 * M_PI * static_cast<double>(hh) /
+      static_cast<double>(num_headings_);
+  }
+
+  // Index of the heading nearest the given angle.
+  unsigned int InformationField2D::NearestHeading(double angle) const {
+    const double step = 2.0 * M_PI / static_cast<double>(num_headings_);
+    const long index = lround(angle / step) % static_cast<long>(num_headings_);
+    return static_cast<unsigned int>(
+      (index < 0) ? index + num_headings_ : index);
+  }
+
+  // Compute the expected measurement and its variance everywhere. Writing
+  // K for a kernel and P for the belief, the cross-correlation
+  // sum_d K(d) P(x + d) has transform conj(F[K]) * F[P].
+  void InformationField2D::Compute(
+    const Eigen::MatrixXd& belief, std::vector<Eigen::MatrixXd>& means,
+    std::vector<Eigen::MatrixXd>& variances) const {
+    CHECK(belief.rows() == num_rows_ && belief.cols() == num_cols_);
+
+    Eigen::MatrixXcd mean_transform =
+      Eigen::MatrixXcd::Zero(num_padded_rows_, num_padded_cols_);
+    Eigen::MatrixXcd variance_transform =
+      Eigen::MatrixXcd::Zero(num_padded_rows_, num_padded_cols_);
+    mean_transform.topLeftCorner(num_rows_, num_cols_) =
+      belief.cast< std::complex<double> >();
+    variance_transform.topLeftCorner(num_rows_, num_cols_) =
+      belief.cwiseProduct(Eigen::MatrixXd::Ones(num_rows_, num_cols_) - belief)
+      .cast< std::complex<double> >();
+    Transform2D(mean_transform, false);
+    Transform2D(variance_transform, false);
+
+    means.resize(num_headings_);
+    variances.resize(num_headings_);
+    Eigen::MatrixXcd product;
+    for (unsigned int hh = 0; hh < num_headings_; hh++) {
+      product = kernels_[hh].cwiseProduct(mean_transform);
+      Transform2D(product, true);
+      means[hh] = product.topLeftCorner(num_rows_, num_cols_).real();
+
+      product = kernels_[hh].cwiseProduct(variance_transform);
+      Transform2D(product, true);
+      variances[hh] = product.topLeftCorner(num_rows_, num_cols_).real();
+    }
+  }
+
+} // namespace radiation
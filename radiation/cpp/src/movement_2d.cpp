@@ -46,72 +46,44 @@
 
 namespace radiation {
 
-  // Static variables. Sets of dx, dy, da, where actually the real change in
-  // angle will be angular_step_ * delta_as_. Also a random number generator.
-  std::vector<double> Movement2D::delta_xs_ = {-1.0, 0.0, 1.0};
-  std::vector<double> Movement2D::delta_ys_ = {-1.0, 0.0, 1.0};
-  std::vector<double> Movement2D::delta_as_ = {-1.0, 0.0, 1.0};
-  double Movement2D::angular_step_ = 0.5;
-
-  std::random_device Movement2D::rd_;
-  std::default_random_engine Movement2D::rng_(rd_());
-
   // Constructor/destructor.
   Movement2D::~Movement2D() {}
-  Movement2D::Movement2D() {
+  Movement2D::Movement2D(const Context2D& context,
+                         std::default_random_engine& rng)
+    : context_(&context) {
     // Choose each index uniformly from the appropriate set.
-    std::uniform_int_distribution<unsigned int> unif_x(0, delta_xs_.size() - 1);
-    xx_ = unif_x(rng_);
-
-    std::uniform_int_distribution<unsigned int> unif_y(0, delta_ys_.size() - 1);
-    yy_ = unif_y(rng_);
-
-    std::uniform_int_distribution<unsigned int> unif_a(0, delta_as_.size() - 1);
-    aa_ = unif_a(rng_);
-  }
-  Movement2D::Movement2D(unsigned int x_id, unsigned int y_id, unsigned int a_id)
-    : xx_(x_id), yy_(y_id), aa_(a_id) {
-    CHECK((xx_ >= 0) && (xx_ < delta_xs_.size()));
-    CHECK((yy_ >= 0) && (yy_ < delta_ys_.size()));
-    CHECK((aa_ >= 0) && (aa_ < delta_as_.size()));
-  }
+    std::uniform_int_distribution<unsigned int>
+      unif_x(0, context_->GetNumDeltaXs() - 1);
+    xx_ = unif_x(rng);
 
-  // Static setters.
-  void Movement2D::SetDeltaXs(const std::vector<double>& delta_xs) {
-    delta_xs_.clear();
-    for (const auto& dx : delta_xs)
-      delta_xs_.push_back(dx);
-  }
+    std::uniform_int_distribution<unsigned int>
+      unif_y(0, context_->GetNumDeltaYs() - 1);
+    yy_ = unif_y(rng);
 
-  void Movement2D::SetDeltaYs(const std::vector<double>& delta_ys) {
-    delta_ys_.clear();
-    for (const auto& dy : delta_ys)
-      delta_ys_.push_back(dy);
+    std::uniform_int_distribution<unsigned int>
+      unif_a(0, context_->GetNumDeltaAngles() - 1);
+    aa_ = unif_a(rng);
   }
-
-  void Movement2D::SetDeltaAngles(const std::vector<double>& delta_as) {
-    delta_as_.clear();
-    for (const auto& da : delta_as)
-      delta_as_.push_back(da);
-  }
-
-  void Movement2D::SetAngularStep(double angular_step) {
-    angular_step_ = angular_step;
+  Movement2D::Movement2D(const Context2D& context,
+                         unsigned int x_id, unsigned int y_id,
+                         unsigned int a_id)
+    : context_(&context), xx_(x_id), yy_(y_id), aa_(a_id) {
+    CHECK(xx_ < context_->GetNumDeltaXs());
+    CHECK(yy_ < context_->GetNumDeltaYs());
+    CHECK(aa_ < context_->GetNumDeltaAngles());
   }
 
   // Getters.
-  unsigned int Movement2D::GetNumDeltaXs() { return delta_xs_.size(); }
-  unsigned int Movement2D::GetNumDeltaYs() { return delta_ys_.size(); }
-  unsigned int Movement2D::GetNumDeltaAngles() { return delta_as_.size(); }
+  const Context2D& Movement2D::GetContext() const { return *context_; }
 
   unsigned int Movement2D::GetIndexX() const { return xx_; }
   unsigned int Movement2D::GetIndexY() const { return yy_; }
   unsigned int Movement2D::GetIndexAngle() const { return aa_; }
 
-  double Movement2D::GetDeltaX() const { return delta_xs_[xx_]; }
-  double Movement2D::GetDeltaY() const { return delta_ys_[yy_]; }
+  double Movement2D::GetDeltaX() const { return context_->GetDeltaX(xx_); }
+  double Movement2D::GetDeltaY() const { return context_->GetDeltaY(yy_); }
   double Movement2D::GetDeltaAngle() const {
-    return angular_step_ * delta_as_[aa_];
+    return context_->GetDeltaAngle(aa_);
   }
 
 } // namespace radiation
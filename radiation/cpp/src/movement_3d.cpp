@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a movement on a 3D grid.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <movement_3d.h>
+
+#include <glog/logging.h>
+
+namespace radiation {
+
+  // Constructor/destructor.
+  Movement3D::~Movement3D() {}
+  Movement3D::Movement3D(const Context3D& context,
+                         std::default_random_engine& rng)
+    : context_(&context) {
+    // Choose each index uniformly from the appropriate set.
+    std::uniform_int_distribution<unsigned int>
+      unif_x(0, context_->GetNumDeltaXs() - 1);
+    xx_ = unif_x(rng);
+
+    std::uniform_int_distribution<unsigned int>
+      unif_y(0, context_->GetNumDeltaYs() - 1);
+    yy_ = unif_y(rng);
+
+    std::uniform_int_distribution<unsigned int>
+      unif_z(0, context_->GetNumDeltaZs() - 1);
+    zz_ = unif_z(rng);
+
+    std::uniform_int_distribution<unsigned int>
+      unif_a(0, context_->GetNumDeltaAngles() - 1);
+    aa_ = unif_a(rng);
+  }
+  Movement3D::Movement3D(const Context3D& context,
+                         unsigned int x_id, unsigned int y_id,
+                         unsigned int z_id, unsigned int a_id)
+    : context_(&context), xx_(x_id), yy_(y_id), zz_(z_id), aa_(a_id) {
+    CHECK(xx_ < context_->GetNumDeltaXs());
+    CHECK(yy_ < context_->GetNumDeltaYs());
+    CHECK(zz_ < context_->GetNumDeltaZs());
+    CHECK(aa_ < context_->GetNumDeltaAngles());
+  }
+
+  // Getters.
+  const Context3D& Movement3D::GetContext() const { return *context_; }
+
+  unsigned int Movement3D::GetIndexX() const { return xx_; }
+  unsigned int Movement3D::GetIndexY() const { return yy_; }
+  unsigned int Movement3D::GetIndexZ() const { return zz_; }
+  unsigned int Movement3D::GetIndexAngle() const { return aa_; }
+
+  double Movement3D::GetDeltaX() const { return context_->GetDeltaX(xx_); }
+  double Movement3D::GetDeltaY() const { return context_->GetDeltaY(yy_); }
+  double Movement3D::GetDeltaZ() const { return context_->GetDeltaZ(zz_); }
+  double Movement3D::GetDeltaAngle() const {
+    return context_->GetDeltaAngle(aa_);
+  }
+
+} // namespace radiation
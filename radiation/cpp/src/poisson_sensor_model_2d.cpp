@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a Poisson count model for a set of 2D sensor poses.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <poisson_sensor_model_2d.h>
+#include <sensor_2d.h>
+#include <visibility_cache_2d.h>
+
+#include <glog/logging.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+namespace radiation {
+
+  const double PoissonSensorModel2D::kMinDistanceSq = 0.25;
+  const unsigned int PoissonSensorModel2D::kMaxCount;
+  const double PoissonSensorModel2D::kMaxTabulatedRate = 32.0;
+  const double PoissonSensorModel2D::kSqrtRateStep = 0.002;
+  const double PoissonSensorModel2D::kPmfSqrtRateStep = 0.005;
+
+  PoissonSensorModel2D::~PoissonSensorModel2D() {}
+  PoissonSensorModel2D::PoissonSensorModel2D(
+    const Context2D& context, const std::vector<GridPose2D>& poses,
+    double fov, double strength, double background)
+    : num_rows_(context.GetNumRows()), num_cols_(context.GetNumCols()),
+      strength_(strength), background_(background),
+      sensitivity_(poses.size(), context.GetNumRows() * context.GetNumCols()) {
+    CHECK(strength_ >= 0.0);
+    CHECK(background_ >= 0.0);
+
+    // Compute weights for every voxel visible from each pose.
+    const VisibilityCache2D visibility(context);
+    std::vector< Eigen::Triplet<double> > weights;
+    std::vector<unsigned int> voxels;
+    for (size_t ii = 0; ii < poses.size(); ii++) {
+      const Sensor2D sensor(poses[ii], fov);
+      visibility.ComputeVisibleVoxels(sensor, voxels);
+
+      for (const auto& voxel : voxels) {
+        const double dx =
+          static_cast<double>(voxel % num_rows_) + 0.5 - sensor.GetX();
+        const double dy =
+          static_cast<double>(voxel / num_rows_) + 0.5 - sensor.GetY();
+        const double distance_sq = std::max(dx * dx + dy * dy, kMinDistanceSq);
+        weights.push_back(Eigen::Triplet<double>(ii, voxel,
+                                                 strength_ / distance_sq));
+      }
+    }
+
+    sensitivity_.setFromTriplets(weights.begin(), weights.end());
+    sensitivity_.makeCompressed();
+
+    // Tabulate log-factorials.
+    log_factorials_.resize(kMaxCount + 1);
+    log_factorials_[0] = 0.0;
+    for (unsigned int kk = 1; kk <= kMaxCount; kk++)
+      log_factorials_[kk] = log_factorials_[kk - 1] + log(kk);
+
+    // Tabulate entropies on the grid, with one extra point past the end for
+    // interpolation.
+    const unsigned int num_points =
+      static_cast<unsigned int>(sqrt(kMaxTabulatedRate) / kSqrtRateStep) + 2;
+    entropies_.resize(num_points);
+    for (unsigned int ii = 0; ii < num_points; ii++) {
+      const double sqrt_rate = ii * kSqrtRateStep;
+      entropies_[ii] = ComputeEntropy(sqrt_rate * sqrt_rate);
+    }
+
+    // Tabulate pmfs on their grid, again with one extra point.
+    const unsigned int num_pmf_points =
+      static_cast<unsigned int>(sqrt(kMaxTabulatedRate) / kPmfSqrtRateStep) + 2;
+    pmfs_.resize(num_pmf_points * (kMaxCount + 1));
+    for (unsigned int ii = 0; ii < num_pmf_points; ii++) {
+      const double sqrt_rate = ii * kPmfSqrtRateStep;
+      for (unsigned int kk = 0; kk <= kMaxCount; kk++)
+        pmfs_[ii * (kMaxCount + 1) + kk] =
+          exp(LogLikelihood(kk, sqrt_rate * sqrt_rate));
+    }
+  }
+
+  // Getters.
+  unsigned int PoissonSensorModel2D::GetNumPoses() const {
+    return sensitivity_.rows();
+  }
+
+  double PoissonSensorModel2D::GetStrength() const { return strength_; }
+  double PoissonSensorModel2D::GetBackground() const { return background_; }
+
+  const Eigen::SparseMatrix<double, Eigen::RowMajor>&
+  PoissonSensorModel2D::GetSensitivity() const {
+    return sensitivity_;
+  }
+
+  // Expected count rate at a single pose. Each lookup is a binary search in
+  // the pose's row of the sensitivity matrix.
+  double PoissonSensorModel2D::ExpectedCount(
+    unsigned int pose, const std::vector<Source2D>& sources) const {
+    CHECK(pose < GetNumPoses());
+
+    double rate = background_;
+    for (const auto& source : sources)
+      rate += sensitivity_.coeff(
+        pose, source.GetIndexX() + source.GetIndexY() * num_rows_);
+
+    return rate;
+  }
+
+  // Expected count rates at all poses.
+  void PoissonSensorModel2D::ExpectedCounts(
+    const std::vector<Source2D>& sources, Eigen::VectorXd& rates) const {
+    rates.resize(GetNumPoses());
+    for (unsigned int ii = 0; ii < GetNumPoses(); ii++)
+      rates(ii) = ExpectedCount(ii, sources);
+  }
+
+  void PoissonSensorModel2D::ExpectedCounts(const Eigen::MatrixXd& belief,
+                                            Eigen::VectorXd& rates) const {
+    CHECK(belief.rows() == num_rows_ && belief.cols() == num_cols_);
+
+    // 'belief' is column-major, so it lines up with the voxel indices.
+    rates = sensitivity_ *
+      Eigen::Map<const Eigen::VectorXd>(belief.data(), belief.size());
+    rates.array() += background_;
+  }
+
+  // Draw a random count at a single pose.
+  unsigned int PoissonSensorModel2D::Sense(
+    unsigned int pose, const std::vector<Source2D>& sources,
+    std::default_random_engine& rng) const {
+    const double rate = ExpectedCount(pose, sources);
+    if (rate <= 0.0)
+      return 0;
+
+    std::poisson_distribution<unsigned int> poisson(rate);
+    return poisson(rng);
+  }
+
+  // Poisson log-likelihood of a count given a rate.
+  double PoissonSensorModel2D::LogLikelihood(unsigned int count,
+                                             double rate) const {
+    if (rate <= 0.0)
+      return (count == 0) ? 0.0 : -std::numeric_limits<double>::infinity();
+
+    return count * log(rate) - rate - LogFactorial(count);
+  }
+
+  // Natural log of count!.
+  double PoissonSensorModel2D::LogFactorial(unsigned int count) const {
+    if (count <= kMaxCount)
+      return log_factorials_[count];
+
+    return lgamma(count + 1.0);
+  }
+
+  // Entropy of a Poisson random variable with the given rate.
+  double PoissonSensorModel2D::Entropy(double rate) const {
+    if (rate <= 0.0)
+      return 0.0;
+
+    // Asymptotic expansion for large rates.
+    if (rate >= kMaxTabulatedRate) {
+      const double inv_rate = 1.0 / rate;
+      return 0.5 * log(2.0 * M_PI * M_E * rate) -
+        inv_rate * (1.0 / 12.0 + inv_rate * (1.0 / 24.0 +
+                                             inv_rate * 19.0 / 360.0));
+    }
+
+    // Linearly interpolate between neighboring grid points.
+    const double position = sqrt(rate) / kSqrtRateStep;
+    const unsigned int ii = static_cast<unsigned int>(position);
+    const double fraction = position - ii;
+    return (1.0 - fraction) * entropies_[ii] + fraction * entropies_[ii + 1];
+  }
+
+  // Poisson probability of a count given a rate.
+  double PoissonSensorModel2D::Pmf(unsigned int count, double rate) const {
+    if (count > kMaxCount || rate >= kMaxTabulatedRate)
+      return exp(LogLikelihood(count, rate));
+    if (rate <= 0.0)
+      return (count == 0) ? 1.0 : 0.0;
+
+    const double position = sqrt(rate) / kPmfSqrtRateStep;
+    const unsigned int ii = static_cast<unsigned int>(position);
+    const double fraction = position - ii;
+    const double* row = &pmfs_[ii * (kMaxCount + 1)];
+    return (1.0 - fraction) * row[count] +
+      fraction * row[count + kMaxCount + 1];
+  }
+
+  // Add a weighted Poisson pmf to 'pmf'. Tabulated rates blend two
+  // neighboring rows of the table.
+  void PoissonSensorModel2D::AccumulatePmf(double rate, double weight,
+                                           double* pmf) const {
+    if (rate <= 0.0) {
+      pmf[0] += weight;
+      return;
+    }
+
+    if (rate >= kMaxTabulatedRate) {
+      for (unsigned int kk = 0; kk <= kMaxCount; kk++)
+        pmf[kk] += weight * exp(LogLikelihood(kk, rate));
+      return;
+    }
+
+    const double position = sqrt(rate) / kPmfSqrtRateStep;
+    const unsigned int ii = static_cast<unsigned int>(position);
+    const double fraction = position - ii;
+    const double lower_weight = (1.0 - fraction) * weight;
+    const double upper_weight = fraction * weight;
+    const double* lower = &pmfs_[ii * (kMaxCount + 1)];
+    const double* upper = lower + kMaxCount + 1;
+    for (unsigned int kk = 0; kk <= kMaxCount; kk++)
+      pmf[kk] += lower_weight * lower[kk] + upper_weight * upper[kk];
+  }
+
+  // Pmf of an equally weighted mixture of Poisson distributions.
+  void PoissonSensorModel2D::MixturePmf(const std::vector<double>& rates,
+                                        Eigen::VectorXd& pmf) const {
+    pmf = Eigen::VectorXd::Zero(kMaxCount + 1);
+    if (rates.empty())
+      return;
+
+    const double weight = 1.0 / static_cast<double>(rates.size());
+    for (const auto& rate : rates)
+      AccumulatePmf(rate, weight, pmf.data());
+  }
+
+  // Entropy of an equally weighted mixture of Poisson distributions.
+  double PoissonSensorModel2D::MixtureEntropy(
+    const std::vector<double>& rates) const {
+    Eigen::VectorXd pmf;
+    MixturePmf(rates, pmf);
+
+    double entropy = 0.0;
+    for (unsigned int kk = 0; kk <= kMaxCount; kk++)
+      if (pmf(kk) > 0.0)
+        entropy -= pmf(kk) * log(pmf(kk));
+
+    return entropy;
+  }
+
+  // Compute entropy by summing -p log p over counts up to kMaxCount, which
+  // covers all but a negligible tail for tabulated rates.
+  double PoissonSensorModel2D::ComputeEntropy(double rate) const {
+    if (rate <= 0.0)
+      return 0.0;
+
+    const double log_rate = log(rate);
+    double entropy = 0.0;
+    for (unsigned int kk = 0; kk <= kMaxCount; kk++) {
+      const double log_p = kk * log_rate - rate - log_factorials_[kk];
+      entropy -= exp(log_p) * log_p;
+    }
+
+    return entropy;
+  }
+
+} // namespace radiation
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a quadtree over a 2D belief map.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <quad_tree_2d.h>
+
+#include <glog/logging.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+namespace radiation {
+
+  QuadTree2D::~QuadTree2D() {}
+  QuadTree2D::QuadTree2D(const Eigen::MatrixXd& belief) {
+    Build(belief);
+  }
+
+  // Rebuild from a new belief matrix.
+  void QuadTree2D::Build(const Eigen::MatrixXd& belief) {
+    CHECK(belief.rows() > 0 && belief.cols() > 0);
+
+    nodes_.clear();
+    num_levels_ = 0;
+    BuildNode(belief, 0, 0, belief.rows(), belief.cols(), 0);
+  }
+
+  // Getters.
+  unsigned int QuadTree2D::GetNumLevels() const { return num_levels_; }
+  unsigned int QuadTree2D::GetNumNodes() const { return nodes_.size(); }
+  double QuadTree2D::GetSum() const { return nodes_[0].sum_; }
+  double QuadTree2D::GetEntropy() const { return nodes_[0].entropy_; }
+
+  const QuadTree2D::Node& QuadTree2D::GetNode(unsigned int id) const {
+    CHECK(id < nodes_.size());
+    return nodes_[id];
+  }
+
+  // Check whether a node is entirely in view, entirely out of view, or
+  // somewhere in between.
+  QuadTree2D::Visibility QuadTree2D::NodeInView(const Sensor2D& sensor,
+                                                unsigned int id) const {
+    const Node& node = GetNode(id);
+
+    if (node.children_.empty())
+      return sensor.VoxelInView(node.row_, node.col_) ? kInView : kOutOfView;
+
+    // A sensor inside the node sees its own voxel regardless of heading, so
+    // the cone tests below do not apply.
+    const double x = sensor.GetX();
+    const double y = sensor.GetY();
+    if (x >= node.row_ && x <= node.row_ + node.num_rows_ &&
+        y >= node.col_ && y <= node.col_ + node.num_cols_)
+      return kPartiallyInView;
+
+    // Centers of the corner voxels. Every voxel center lies in their convex
+    // hull.
+    const double xs[4] = { node.row_ + 0.5, node.row_ + node.num_rows_ - 0.5,
+                           node.row_ + 0.5, node.row_ + node.num_rows_ - 0.5 };
+    const double ys[4] = { node.col_ + 0.5, node.col_ + 0.5,
+                           node.col_ + node.num_cols_ - 0.5,
+                           node.col_ + node.num_cols_ - 0.5 };
+
+    // Directions of the right and left edges of the field of view.
+    const double half_fov = 0.5 * sensor.GetFov();
+    const double rx = cos(sensor.GetAngle() - half_fov);
+    const double ry = sin(sensor.GetAngle() - half_fov);
+    const double lx = cos(sensor.GetAngle() + half_fov);
+    const double ly = sin(sensor.GetAngle() + half_fov);
+
+    unsigned int num_in_view = 0;
+    bool right_of_right_edge = true;
+    bool left_of_left_edge = true;
+    for (unsigned int ii = 0; ii < 4; ii++) {
+      if (sensor.SourceInView(Source2D(xs[ii], ys[ii])))
+        num_in_view++;
+
+      const double vx = xs[ii] - x;
+      const double vy = ys[ii] - y;
+      if (rx * vy - ry * vx > 0.0)
+        right_of_right_edge = false;
+      if (lx * vy - ly * vx < 0.0)
+        left_of_left_edge = false;
+    }
+
+    // When the field of view is at most pi the cone is convex, so the node is
+    // in view if all its corners are, and out of view if all its corners lie
+    // beyond the same edge.
+    if (half_fov <= 0.5 * M_PI) {
+      if (num_in_view == 4)
+        return kInView;
+      if (right_of_right_edge || left_of_left_edge)
+        return kOutOfView;
+      return kPartiallyInView;
+    }
+
+    // Otherwise the region out of view is a convex cone bounded by both
+    // edges, so the node is out of view only if all corners lie in it.
+    if (half_fov > M_PI)
+      return kInView;
+    if (right_of_right_edge && left_of_left_edge)
+      return kOutOfView;
+    return kPartiallyInView;
+  }
+
+  // Compute the expected measurement from the given sensor, refining no
+  // deeper than the given level.
+  double QuadTree2D::ExpectedMeasurement(const Sensor2D& sensor,
+                                         unsigned int level) const {
+    return ExpectedMeasurement(sensor, level,
+                               std::numeric_limits<double>::infinity(), 0.0,
+                               nullptr, 0);
+  }
+
+  // Same as above, but refine by belief as well as by level, and account for
+  // obstacles through the sensor's view.
+  double QuadTree2D::ExpectedMeasurement(const Sensor2D& sensor,
+                                         unsigned int level,
+                                         double max_mass, double min_mass,
+                                         const std::vector<bool>* view) const {
+    if (view != nullptr)
+      CHECK_EQ(view->size(), nodes_[0].num_rows_ * nodes_[0].num_cols_);
+    return ExpectedMeasurement(sensor, level, max_mass, min_mass, view, 0);
+  }
+
+  double QuadTree2D::ExpectedMeasurement(const Sensor2D& sensor,
+                                         unsigned int level,
+                                         double max_mass, double min_mass,
+                                         const std::vector<bool>* view,
+                                         unsigned int id) const {
+    const Node& node = nodes_[id];
+
+    // Skip nodes with no belief; nothing below them can contribute.
+    if (node.sum_ <= 0.0)
+      return 0.0;
+
+    if (node.children_.empty())
+      return VoxelInView(sensor, view, node.row_, node.col_) ? node.sum_ : 0.0;
+
+    // The view only ever removes voxels from the field of view, so a node
+    // out of view stays out of view. A node in view may still be occluded.
+    const Visibility visibility = NodeInView(sensor, id);
+    if (visibility == kOutOfView)
+      return 0.0;
+    if (visibility == kInView && view == nullptr)
+      return node.sum_;
+
+    // Partially in view. Refine if allowed, otherwise estimate the fraction
+    // in view from the corner voxels.
+    if (node.sum_ > min_mass && (node.level_ < level || node.sum_ > max_mass)) {
+      double expected = 0.0;
+      for (const auto& child : node.children_)
+        expected += ExpectedMeasurement(sensor, level, max_mass, min_mass,
+                                        view, child);
+
+      return expected;
+    }
+
+    const unsigned int last_row = node.row_ + node.num_rows_ - 1;
+    const unsigned int last_col = node.col_ + node.num_cols_ - 1;
+    const unsigned int num_in_view =
+      VoxelInView(sensor, view, node.row_, node.col_) +
+      VoxelInView(sensor, view, last_row, node.col_) +
+      VoxelInView(sensor, view, node.row_, last_col) +
+      VoxelInView(sensor, view, last_row, last_col);
+
+    return 0.25 * static_cast<double>(num_in_view) * node.sum_;
+  }
+
+  // Check whether a voxel is in view, using the view if given.
+  bool QuadTree2D::VoxelInView(const Sensor2D& sensor,
+                               const std::vector<bool>* view,
+                               unsigned int ii, unsigned int jj) const {
+    if (view == nullptr)
+      return sensor.VoxelInView(ii, jj);
+    return (*view)[ii + jj * nodes_[0].num_rows_];
+  }
+
+  // Sample nodes at the given level with probability proportional to their
+  // belief, descending from the root.
+  void QuadTree2D::SampleNodes(std::default_random_engine& rng,
+                               unsigned int num_sources, unsigned int level,
+                               std::vector<unsigned int>& nodes) const {
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+
+    nodes.clear();
+    for (unsigned int ii = 0; ii < num_sources; ii++) {
+      unsigned int id = 0;
+
+      while (nodes_[id].level_ < level && !nodes_[id].children_.empty()) {
+        const Node& node = nodes_[id];
+
+        // Choose a child in proportion to its belief, falling back to its
+        // size if this subtree has no belief at all.
+        const bool use_size = (node.sum_ <= 0.0);
+        const double total = use_size ?
+          static_cast<double>(node.num_rows_ * node.num_cols_) : node.sum_;
+        const double target = unif(rng) * total;
+
+        double cdf = 0.0;
+        unsigned int next = node.children_.back();
+        for (const auto& child : node.children_) {
+          cdf += use_size ?
+            static_cast<double>(nodes_[child].num_rows_ *
+                                nodes_[child].num_cols_) :
+            nodes_[child].sum_;
+
+          if (cdf > target) {
+            next = child;
+            break;
+          }
+        }
+
+        id = next;
+      }
+
+      nodes.push_back(id);
+    }
+  }
+
+  // Generate random sources according to belief, by sampling leaves.
+  bool QuadTree2D::GenerateSources(std::default_random_engine& rng,
+                                   unsigned int num_sources,
+                                   std::vector<Source2D>& sources) const {
+    sources.clear();
+    if (GetSum() <= 0.0)
+      return false;
+
+    std::vector<unsigned int> leaves;
+    SampleNodes(rng, num_sources, num_levels_, leaves);
+
+    for (const auto& id : leaves)
+      sources.push_back(Source2D(nodes_[id].row_, nodes_[id].col_));
+
+    return true;
+  }
+
+  // Recursively build the subtree covering the given rectangle.
+  unsigned int QuadTree2D::BuildNode(const Eigen::MatrixXd& belief,
+                                     unsigned int row, unsigned int col,
+                                     unsigned int num_rows,
+                                     unsigned int num_cols,
+                                     unsigned int level) {
+    const unsigned int id = nodes_.size();
+    nodes_.push_back(Node());
+    nodes_[id].row_ = row;
+    nodes_[id].col_ = col;
+    nodes_[id].num_rows_ = num_rows;
+    nodes_[id].num_cols_ = num_cols;
+    nodes_[id].level_ = level;
+    num_levels_ = std::max(num_levels_, level + 1);
+
+    // Leaves hold a single voxel.
+    if (num_rows == 1 && num_cols == 1) {
+      const double p = belief(row, col);
+      nodes_[id].sum_ = p;
+      nodes_[id].entropy_ = (p > 1e-8 && p < 1.0 - 1e-8) ?
+        (-p * log(p) - (1.0 - p) * log(1.0 - p)) : 0.0;
+      return id;
+    }
+
+    // Split each dimension in half where possible.
+    const unsigned int top_rows = (num_rows + 1) / 2;
+    const unsigned int left_cols = (num_cols + 1) / 2;
+
+    std::vector<unsigned int> children;
+    children.push_back(
+      BuildNode(belief, row, col, top_rows, left_cols, level + 1));
+    if (num_rows > 1)
+      children.push_back(BuildNode(belief, row + top_rows, col,
+                                   num_rows - top_rows, left_cols, level + 1));
+    if (num_cols > 1)
+      children.push_back(BuildNode(belief, row, col + left_cols,
+                                   top_rows, num_cols - left_cols, level + 1));
+    if (num_rows > 1 && num_cols > 1)
+      children.push_back(BuildNode(belief, row + top_rows, col + left_cols,
+                                   num_rows - top_rows, num_cols - left_cols,
+                                   level + 1));
+
+    // Aggregate over children. Note that 'nodes_' may have been reallocated.
+    Node& node = nodes_[id];
+    node.children_ = children;
+    node.sum_ = 0.0;
+    node.entropy_ = 0.0;
+    for (const auto& child : children) {
+      node.sum_ += nodes_[child].sum_;
+      node.entropy_ += nodes_[child].entropy_;
+    }
+
+    return id;
+  }
+
+} // namespace radiation
@@ -44,9 +44,34 @@
 #include <sensor_2d.h>
 
 #include <math.h>
+#include <algorithm>
 
 namespace radiation {
 
+namespace {
+// Find the range of column indices [first, last] whose voxel centers
+// y = jj + 0.5 satisfy coeff * y > rhs, clipped to the grid. The range is
+// empty if first > last.
+void ColumnRange(double coeff, double rhs, unsigned int num_cols,
+                 int& first, int& last) {
+  first = 0;
+  last = static_cast<int>(num_cols) - 1;
+
+  // Clamp before converting to int, since the bound may be huge.
+  const double kMin = -1.0;
+  const double kMax = static_cast<double>(num_cols) + 1.0;
+  if (coeff > 0.0) {
+    const double bound = std::min(kMax, std::max(kMin, rhs / coeff - 0.5));
+    first = std::max(first, static_cast<int>(floor(bound)) + 1);
+  } else if (coeff < 0.0) {
+    const double bound = std::min(kMax, std::max(kMin, rhs / coeff - 0.5));
+    last = std::min(last, static_cast<int>(ceil(bound)) - 1);
+  } else if (rhs >= 0.0) {
+    last = -1;
+  }
+}
+} // namespace
+
   Sensor2D::~Sensor2D() {}
   Sensor2D::Sensor2D(double x, double y, double a, double fov)
     : x_(x), y_(y), a_(a), fov_(fov) {}
@@ -57,6 +82,7 @@ namespace radiation {
   double Sensor2D::GetX() const { return x_; }
   double Sensor2D::GetY() const { return y_; }
   double Sensor2D::GetAngle() const { return a_; }
+  double Sensor2D::GetFov() const { return fov_; }
 
   unsigned int Sensor2D::GetIndexX() const {
     return static_cast<unsigned int>(x_);
@@ -111,4 +137,97 @@ namespace radiation {
     return false;
   }
 
+  // Find all voxels in view on a grid of the given size. Each edge of the
+  // field of view is a line through the sensor, and each row of voxels meets
+  // the half-plane on the inner side of an edge in a single range of columns.
+  // Voxels whose centers are clearly inside both half-planes (or either one,
+  // if the field of view exceeds pi) are in view; those within a small
+  // margin of an edge are checked against VoxelInView directly.
+  void Sensor2D::VoxelsInView(unsigned int num_rows, unsigned int num_cols,
+                              std::vector<unsigned int>& voxels) const {
+    voxels.clear();
+
+    // Nothing is behind a sensor whose field of view is a full circle, but
+    // exactly 2 pi leaves out the ray directly behind it.
+    const double half_fov = 0.5 * fov_;
+    if (half_fov >= M_PI) {
+      for (unsigned int ii = 0; ii < num_rows; ii++) {
+        for (unsigned int jj = 0; jj < num_cols; jj++) {
+          if (half_fov > M_PI || VoxelInView(ii, jj))
+            voxels.push_back(ii + jj * num_rows);
+        }
+      }
+
+      return;
+    }
+
+    // Directions of the right and left edges of the field of view. A point
+    // v relative to the sensor is inside the right edge if r x v > 0, and
+    // inside the left edge if l x v < 0.
+    const double rx = cos(a_ - half_fov);
+    const double ry = sin(a_ - half_fov);
+    const double lx = cos(a_ + half_fov);
+    const double ly = sin(a_ + half_fov);
+    const bool convex = (half_fov <= 0.5 * M_PI);
+    const double kMargin = 1e-6;
+
+    for (unsigned int ii = 0; ii < num_rows; ii++) {
+      const double vx = static_cast<double>(ii) + 0.5 - x_;
+
+      // Ranges for r x v > -margin and l x v < margin (loose), and for
+      // r x v > margin and l x v < -margin (tight).
+      int loose_r_first, loose_r_last, loose_l_first, loose_l_last;
+      int tight_r_first, tight_r_last, tight_l_first, tight_l_last;
+      ColumnRange(rx, -kMargin + rx * y_ + ry * vx, num_cols,
+                  loose_r_first, loose_r_last);
+      ColumnRange(-lx, -kMargin - lx * y_ - ly * vx, num_cols,
+                  loose_l_first, loose_l_last);
+      ColumnRange(rx, kMargin + rx * y_ + ry * vx, num_cols,
+                  tight_r_first, tight_r_last);
+      ColumnRange(-lx, kMargin - lx * y_ - ly * vx, num_cols,
+                  tight_l_first, tight_l_last);
+
+      // The field of view is the intersection of the two half-planes if it
+      // is convex, and their union otherwise, so there are at most two
+      // candidate ranges per row. Collect them in increasing order.
+      std::pair<int, int> ranges[2];
+      unsigned int num_ranges = 0;
+      if (convex) {
+        ranges[num_ranges++] =
+          std::make_pair(std::max(loose_r_first, loose_l_first),
+                         std::min(loose_r_last, loose_l_last));
+      } else {
+        std::pair<int, int> first(loose_r_first, loose_r_last);
+        std::pair<int, int> second(loose_l_first, loose_l_last);
+        if (second.first < first.first)
+          std::swap(first, second);
+
+        if (first.first > first.second) {
+          ranges[num_ranges++] = second;
+        } else if (second.first > second.second) {
+          ranges[num_ranges++] = first;
+        } else if (second.first <= first.second + 1) {
+          ranges[num_ranges++] = std::make_pair(
+            first.first, std::max(first.second, second.second));
+        } else {
+          ranges[num_ranges++] = first;
+          ranges[num_ranges++] = second;
+        }
+      }
+
+      for (unsigned int rr = 0; rr < num_ranges; rr++) {
+        const std::pair<int, int>& range = ranges[rr];
+        for (int jj = range.first; jj <= range.second; jj++) {
+          const bool inside_r = (jj >= tight_r_first && jj <= tight_r_last);
+          const bool inside_l = (jj >= tight_l_first && jj <= tight_l_last);
+          const bool inside = convex ?
+            (inside_r && inside_l) : (inside_r || inside_l);
+
+          if (inside || VoxelInView(ii, jj))
+            voxels.push_back(ii + jj * num_rows);
+        }
+      }
+    }
+  }
+
 } // namespace radiation
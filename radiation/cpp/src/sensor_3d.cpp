@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 3D radiation sensor with a conic field of view.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sensor_3d.h>
+
+#include <math.h>
+#include <algorithm>
+
+namespace radiation {
+
+  Sensor3D::~Sensor3D() {}
+  Sensor3D::Sensor3D(double x, double y, double z, double a, double fov)
+    : x_(x), y_(y), z_(z), a_(a), fov_(fov) {}
+  Sensor3D::Sensor3D(const GridPose3D& pose, double fov)
+    : x_(pose.GetX()), y_(pose.GetY()), z_(pose.GetZ()),
+      a_(pose.GetAngle()), fov_(fov) {}
+
+  // Getters.
+  double Sensor3D::GetX() const { return x_; }
+  double Sensor3D::GetY() const { return y_; }
+  double Sensor3D::GetZ() const { return z_; }
+  double Sensor3D::GetAngle() const { return a_; }
+  double Sensor3D::GetFov() const { return fov_; }
+
+  // Sense the specified sources. Count the number in view.
+  unsigned int Sensor3D::Sense(const std::vector<Source3D>& sources) const {
+    unsigned int count = 0;
+
+    for (const auto& source : sources) {
+      if (SourceInView(source))
+        count++;
+    }
+
+    return count;
+  }
+
+  // Check if a source or voxel is in view.
+  bool Sensor3D::VoxelInView(unsigned int ii, unsigned int jj,
+                             unsigned int kk) const {
+    return SourceInView(Source3D(ii, jj, kk));
+  }
+
+  bool Sensor3D::SourceInView(const Source3D& source) const {
+    // Get unit vector to source.
+    double dx = source.GetX() - x_;
+    double dy = source.GetY() - y_;
+    double dz = source.GetZ() - z_;
+    double norm = sqrt(dx * dx + dy * dy + dz * dz);
+
+    if (norm < 1e-8)
+      return true;
+
+    dx /= norm;
+    dy /= norm;
+    dz /= norm;
+
+    // In view if the angle between this vector and the cone's axis is within
+    // half the field of view.
+    double angle_to_source = acos(dx * cos(a_) + dy * sin(a_));
+    if (angle_to_source < 0.5 * fov_)
+      return true;
+
+    return false;
+  }
+
+  // Find all voxels in view on a grid of the given size. Writing h for the
+  // component of the offset to a voxel along the axis, r for its horizontal
+  // length, and c for cos(fov / 2) > 0, a voxel is in view iff h > 0 and
+  // dz^2 < h^2 / c^2 - r^2. Candidates from a slightly widened interval are
+  // checked exactly so the result matches VoxelInView.
+  void Sensor3D::VoxelsInView(unsigned int num_rows, unsigned int num_cols,
+                              unsigned int num_layers,
+                              std::vector<unsigned int>& voxels) const {
+    voxels.clear();
+    const unsigned int slice = num_rows * num_cols;
+
+    // Wide fields of view are not convex, so test every voxel.
+    if (fov_ >= M_PI) {
+      for (unsigned int kk = 0; kk < num_layers; kk++)
+        for (unsigned int jj = 0; jj < num_cols; jj++)
+          for (unsigned int ii = 0; ii < num_rows; ii++)
+            if (VoxelInView(ii, jj, kk))
+              voxels.push_back(ii + jj * num_rows + kk * slice);
+      return;
+    }
+
+    const double kMargin = 1e-6;
+    const double c = cos(0.5 * fov_);
+    const double ux = cos(a_);
+    const double uy = sin(a_);
+
+    for (unsigned int jj = 0; jj < num_cols; jj++) {
+      const double dy = static_cast<double>(jj) + 0.5 - y_;
+
+      for (unsigned int ii = 0; ii < num_rows; ii++) {
+        const double dx = static_cast<double>(ii) + 0.5 - x_;
+        const double h = dx * ux + dy * uy;
+        if (h < -kMargin)
+          continue;
+
+        const double bound_sq = h * h / (c * c) - dx * dx - dy * dy;
+        if (bound_sq < -kMargin)
+          continue;
+
+        // Range of layers whose centers z = kk + 0.5 satisfy |z - z_| < bound.
+        const double bound = sqrt(std::max(0.0, bound_sq)) + kMargin;
+        const double lo = z_ - bound - 0.5;
+        const double hi = z_ + bound - 0.5;
+        if (hi < 0.0 || lo > static_cast<double>(num_layers) - 1.0)
+          continue;
+
+        const unsigned int first =
+          static_cast<unsigned int>(std::max(0.0, ceil(lo)));
+        const unsigned int last = static_cast<unsigned int>(
+          std::min(static_cast<double>(num_layers) - 1.0, floor(hi)));
+
+        for (unsigned int kk = first; kk <= last; kk++) {
+          if (VoxelInView(ii, jj, kk))
+            voxels.push_back(ii + jj * num_rows + kk * slice);
+        }
+      }
+    }
+
+    std::sort(voxels.begin(), voxels.end());
+  }
+
+} // namespace radiation
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Cooperative exploration on a 2D grid with a team of robots sharing a single
+// belief map. Each robot's candidate trajectories are sampled in parallel (one
+// thread per robot, each on its own snapshot of the shared belief). Robots
+// then choose trajectories one at a time, in order, discounting candidates
+// whose views overlap those already claimed by earlier robots. All robots'
+// measurements are folded into a single belief solve per step.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <team_explorer_lp.h>
+#include <visibility_cache_2d.h>
+#include <explorer_window.h>
+
+#include <GLUT/glut.h>
+#include <glog/logging.h>
+#include <algorithm>
+#include <future>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+// Constructor/destructor.
+TeamExplorerLP::~TeamExplorerLP() {}
+TeamExplorerLP::TeamExplorerLP(const Context2D& context,
+                               unsigned int num_robots,
+                               unsigned int num_sources, double regularizer,
+                               unsigned int num_steps, double fov,
+                               unsigned int num_samples,
+                               unsigned int num_candidates)
+  : TeamExplorerLP(context, num_robots, num_sources, regularizer, num_steps,
+                   fov, num_samples, num_candidates, std::random_device()()) {}
+TeamExplorerLP::TeamExplorerLP(const Context2D& context,
+                               unsigned int num_robots,
+                               unsigned int num_sources, double regularizer,
+                               unsigned int num_steps, double fov,
+                               unsigned int num_samples,
+                               unsigned int num_candidates,
+                               unsigned int seed)
+  : context_(context),
+    num_steps_(num_steps),
+    num_samples_(num_samples),
+    fov_(fov),
+    num_candidates_(num_candidates),
+    map_(context_, num_sources, regularizer),
+    past_poses_(num_robots),
+    estimator_(EntropyEstimator::kClippedPlugIn) {
+  CHECK(num_robots > 0);
+  CHECK(num_candidates > 0);
+
+  // Set up a random number generator, and use it to seed the map's.
+  std::default_random_engine rng(seed);
+  map_.Seed(rng());
+  std::uniform_int_distribution<unsigned int>
+    unif_rows(0, context_.GetNumRows() - 1);
+  std::uniform_int_distribution<unsigned int>
+    unif_cols(0, context_.GetNumCols() - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  // Choose random sources and a random initial pose for each robot, away
+  // from obstacles.
+  while (sources_.size() < num_sources) {
+    const unsigned int ii = unif_rows(rng);
+    const unsigned int jj = unif_cols(rng);
+    if (!context_.IsObstacle(ii, jj))
+      sources_.push_back(Source2D(ii, jj));
+  }
+
+  while (poses_.size() < num_robots) {
+    const GridPose2D pose(context_, unif_rows(rng), unif_cols(rng),
+                          unif_angle(rng));
+    if (!context_.IsObstacle(pose.GetIndexX(), pose.GetIndexY()))
+      poses_.push_back(pose);
+  }
+
+  // Seed the planning random number generator.
+  rng_.seed(rng());
+}
+
+// Plan a new trajectory for each robot.
+bool TeamExplorerLP::PlanAhead(
+  std::vector< std::vector<GridPose2D> >& trajectories) {
+  const size_t num_robots = poses_.size();
+
+  // Every worker samples from its own snapshot of the shared belief, since
+  // each map's random number generator is not thread-safe. Snapshots share
+  // the map's visibility cache, which is.
+  const Eigen::MatrixXd belief = map_.GetImmutableBelief();
+  const unsigned int num_sources = map_.GetNumSources();
+  const double regularizer = map_.GetRegularizer();
+
+  // Generate conditional entropy vectors for all robots in parallel.
+  std::vector<Eigen::VectorXd> hzxs(num_robots);
+  std::vector< std::vector<Id64> > trajectory_ids(num_robots);
+  std::vector< std::future<void> > workers;
+
+  for (size_t rr = 0; rr < num_robots; rr++) {
+    const unsigned int seed = rng_();
+    workers.push_back(std::async(std::launch::async, [&, rr, seed]() {
+          GridMap2D snapshot(context_, belief, num_sources, regularizer,
+                             map_.GetVisibility());
+          snapshot.Seed(seed);
+          snapshot.GenerateEntropyVector(num_samples_, num_steps_, poses_[rr],
+                                         fov_, hzxs[rr], trajectory_ids[rr],
+                                         estimator_);
+        }));
+  }
+
+  for (auto& worker : workers)
+    worker.get();
+
+  // Choose trajectories sequentially. Each robot's score for a candidate is
+  // its conditional entropy, discounted by the fraction of the belief mass in
+  // view that has already been claimed by an earlier robot.
+  std::vector<bool> claimed(map_.GetNumRows() * map_.GetNumCols(), false);
+  trajectories.clear();
+
+  for (size_t rr = 0; rr < num_robots; rr++) {
+    const Eigen::VectorXd& hzx = hzxs[rr];
+    CHECK(hzx.rows() == trajectory_ids[rr].size());
+
+    // Only consider the top 'num_candidates_' candidates.
+    std::vector<unsigned int> order(hzx.rows());
+    for (unsigned int ii = 0; ii < order.size(); ii++)
+      order[ii] = ii;
+
+    const size_t kNumCandidates =
+      std::min(static_cast<size_t>(num_candidates_), order.size());
+    std::partial_sort(order.begin(), order.begin() + kNumCandidates,
+                      order.end(), [&hzx](unsigned int a, unsigned int b) {
+                        return hzx(a) > hzx(b);
+                      });
+
+    // Decode all candidates at once.
+    std::vector<Id64> candidate_ids(kNumCandidates);
+    for (size_t kk = 0; kk < kNumCandidates; kk++)
+      candidate_ids[kk] = trajectory_ids[rr][order[kk]];
+
+    std::vector< std::vector<GridPose2D> > candidates;
+    DecodeTrajectories(candidate_ids, num_steps_, poses_[rr], candidates);
+
+    double max_score = -1.0;
+    std::vector<GridPose2D> best_trajectory;
+    for (size_t kk = 0; kk < kNumCandidates; kk++) {
+      const std::vector<GridPose2D>& trajectory = candidates[kk];
+
+      std::vector<bool> viewed(claimed.size(), false);
+      MarkViewed(trajectory, viewed);
+
+      double total_mass = 0.0;
+      double claimed_mass = 0.0;
+      for (size_t ii = 0; ii < viewed.size(); ii++) {
+        if (!viewed[ii])
+          continue;
+
+        total_mass += belief.data()[ii];
+        if (claimed[ii])
+          claimed_mass += belief.data()[ii];
+      }
+
+      const double overlap =
+        (total_mass > 1e-8) ? claimed_mass / total_mass : 0.0;
+      const double score = hzx(order[kk]) * (1.0 - overlap);
+
+      if (score > max_score) {
+        max_score = score;
+        best_trajectory = trajectory;
+      }
+    }
+
+    // Check that we found a valid trajectory (with non-negative score).
+    if (max_score < 0.0) {
+      VLOG(1) << "Could not find a positive conditional entropy trajectory "
+              << "for robot " << rr << ".";
+      return false;
+    }
+
+    // Claim everything this robot will see.
+    MarkViewed(best_trajectory, claimed);
+    trajectories.push_back(best_trajectory);
+  }
+
+  return true;
+}
+
+// Move each robot one step along its trajectory, and update the shared map
+// with all measurements at once. Return resulting entropy.
+double TeamExplorerLP::TakeStep(
+  const std::vector< std::vector<GridPose2D> >& trajectories) {
+  CHECK(trajectories.size() == poses_.size());
+
+  for (size_t rr = 0; rr < poses_.size(); rr++) {
+    CHECK(trajectories[rr].size() > 0);
+
+    // Update list of past poses and the current pose.
+    past_poses_[rr].push_back(poses_[rr]);
+    poses_[rr] = trajectories[rr][0];
+
+    // Record the measurement, but only solve once all robots have measured.
+    const Sensor2D sensor(poses_[rr], fov_);
+    map_.Update(sensor, sources_, rr + 1 == poses_.size());
+  }
+
+  return map_.Entropy();
+}
+
+// Compute map entropy.
+double TeamExplorerLP::Entropy() const { return map_.Entropy(); }
+
+// Set the estimator of conditional entropies.
+void TeamExplorerLP::SetEntropyEstimator(EntropyEstimator estimator) {
+  estimator_ = estimator;
+}
+
+// Mark all voxels viewed along the given trajectory.
+void TeamExplorerLP::MarkViewed(const std::vector<GridPose2D>& trajectory,
+                                std::vector<bool>& viewed) const {
+  const unsigned int num_rows = map_.GetNumRows();
+  const unsigned int num_cols = map_.GetNumCols();
+  CHECK(viewed.size() == num_rows * num_cols);
+
+  VisibilityCache2D visibility(map_.GetVisibility());
+  std::vector<unsigned int> voxels;
+  for (const auto& pose : trajectory) {
+    const Sensor2D sensor(pose, fov_);
+    visibility.VisibleVoxels(sensor, voxels);
+
+    for (const auto& voxel : voxels)
+      viewed[voxel] = true;
+  }
+}
+
+// Visualize the current belief state.
+void TeamExplorerLP::Visualize() const {
+  glClear(GL_COLOR_BUFFER_BIT);
+  DrawBelief(map_.GetImmutableBelief(), context_);
+  for (const auto& pose : poses_)
+    DrawRobot(pose, fov_);
+  DrawSources(sources_);
+}
+
+} // namespace radiation
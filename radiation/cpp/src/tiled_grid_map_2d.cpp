@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a 2D grid map whose belief is stored in fixed-size square tiles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <tiled_grid_map_2d.h>
+#include <cost_functors.h>
+#include <entropy_kernels.h>
+#include <trace.h>
+
+#include <ceres/ceres.h>
+#include <glog/logging.h>
+#include <math.h>
+#include <algorithm>
+
+namespace radiation {
+
+  const unsigned int TiledGridMap2D::kTileSize;
+
+  TiledGridMap2D::~TiledGridMap2D() {}
+  TiledGridMap2D::TiledGridMap2D(const Context2D& context,
+                                 unsigned int num_sources, double regularizer)
+    : num_allocated_voxels_(0),
+      context_(&context), visibility_(new VisibilityCache2D(context)),
+      num_rows_(context.GetNumRows()), num_cols_(context.GetNumCols()),
+      num_sources_(num_sources),
+      prior_(static_cast<double>(num_sources) /
+             static_cast<double>(num_rows_ * num_cols_)),
+      regularizer_(regularizer),
+      rng_(rd_()) {
+    CHECK(num_rows_ > 0 && num_cols_ > 0);
+  }
+
+  // Getters.
+  const Context2D& TiledGridMap2D::GetContext() const { return *context_; }
+  unsigned int TiledGridMap2D::GetNumRows() const { return num_rows_; }
+  unsigned int TiledGridMap2D::GetNumCols() const { return num_cols_; }
+  unsigned int TiledGridMap2D::GetNumSources() const { return num_sources_; }
+  double TiledGridMap2D::GetRegularizer() const { return regularizer_; }
+  double TiledGridMap2D::GetPrior() const { return prior_; }
+  unsigned int TiledGridMap2D::GetNumTiles() const { return tiles_.size(); }
+
+  // Reseed the random number generator.
+  void TiledGridMap2D::Seed(unsigned int seed) { rng_.seed(seed); }
+
+  // Grow the map bounds, and rescale the prior so that the expected number
+  // of sources is unchanged. Voxels in allocated tiles which come into bounds
+  // are set to the new prior, like every background voxel.
+  void TiledGridMap2D::Grow(const Context2D& context) {
+    const unsigned int num_rows = context.GetNumRows();
+    const unsigned int num_cols = context.GetNumCols();
+    CHECK(num_rows >= num_rows_ && num_cols >= num_cols_);
+
+    // Line of sight depends on the whole context, so start a new cache.
+    context_ = &context;
+    visibility_.reset(new VisibilityCache2D(context));
+    if (num_rows == num_rows_ && num_cols == num_cols_)
+      return;
+
+    // Belief held by allocated tiles within the old bounds.
+    double allocated = 0.0;
+    for (const auto& entry : tiles_)
+      allocated += entry.second.sum_;
+
+    const unsigned int old_rows = num_rows_;
+    const unsigned int old_cols = num_cols_;
+    num_rows_ = num_rows;
+    num_cols_ = num_cols;
+    RefreshAllTiles();
+
+    // Offsets of voxels in allocated tiles which just came into bounds.
+    std::vector< std::pair<Tile*, unsigned int> > added;
+    for (auto& entry : tiles_) {
+      const unsigned int row_offset = entry.first.first * kTileSize;
+      const unsigned int col_offset = entry.first.second * kTileSize;
+      const unsigned int tile_rows = TileRowsInBounds(entry.first);
+      const unsigned int tile_cols = TileColsInBounds(entry.first);
+      for (unsigned int jj = 0; jj < tile_cols; jj++) {
+        for (unsigned int ii = 0; ii < tile_rows; ii++) {
+          if (row_offset + ii >= old_rows || col_offset + jj >= old_cols)
+            added.push_back(std::make_pair(&entry.second,
+                                           ii + jj * kTileSize));
+        }
+      }
+    }
+
+    // Spread the remaining mass evenly over the background and new voxels.
+    const double num_unallocated =
+      static_cast<double>(NumBackgroundVoxels() + added.size());
+    prior_ = std::min(1.0, std::max(0.0, (num_sources_ - allocated) /
+                                    num_unallocated));
+
+    for (const auto& voxel : added)
+      voxel.first->belief_[voxel.second] = prior_;
+
+    RefreshAllTiles();
+  }
+
+  // Generate random sources according to the current belief state.
+  bool TiledGridMap2D::GenerateSources(std::vector<Source2D>& sources) {
+    sources.clear();
+    if (num_sources_ == 0)
+      return true;
+
+    const unsigned int num_background = NumBackgroundVoxels();
+    double total_belief = prior_ * static_cast<double>(num_background);
+    for (const auto& entry : tiles_)
+      total_belief += entry.second.sum_;
+
+    // Choose 'num_sources_' random numbers in [0, total], which will be
+    // sorted and treated as evaluations of the (unnormalized) CDF.
+    std::uniform_real_distribution<double> unif(0.0, total_belief);
+    cdf_evals_.resize(num_sources_);
+    for (size_t ii = 0; ii < num_sources_; ii++)
+      cdf_evals_[ii] = unif(rng_);
+
+    std::sort(cdf_evals_.begin(), cdf_evals_.end());
+
+    // Walk allocated tiles first, skipping over any tile whose cached sum
+    // does not reach the next 'cdf_eval'.
+    unsigned int current_index = 0;
+    double current_cdf = 0.0;
+
+    for (const auto& entry : tiles_) {
+      const Tile& tile = entry.second;
+      if (current_cdf + tile.sum_ < cdf_evals_[current_index]) {
+        current_cdf += tile.sum_;
+        continue;
+      }
+
+      const unsigned int row_offset = entry.first.first * kTileSize;
+      const unsigned int col_offset = entry.first.second * kTileSize;
+      const unsigned int tile_rows = TileRowsInBounds(entry.first);
+      const unsigned int tile_cols = TileColsInBounds(entry.first);
+      for (unsigned int jj = 0; jj < tile_cols; jj++) {
+        for (unsigned int ii = 0; ii < tile_rows; ii++) {
+          current_cdf += tile.belief_[ii + jj * kTileSize];
+
+          // Check if we just passed the next 'cdf_eval'.
+          while (current_cdf >= cdf_evals_[current_index]) {
+            sources.push_back(Source2D(row_offset + ii, col_offset + jj));
+
+            if (sources.size() == num_sources_)
+              return true;
+
+            current_index++;
+          }
+        }
+      }
+    }
+
+    // Remaining sources lie in the background, where belief is uniform.
+    // Draw voxels uniformly from the bounds and reject those which lie in an
+    // allocated tile.
+    if (num_background == 0)
+      return false;
+
+    std::uniform_int_distribution<unsigned int> unif_rows(0, num_rows_ - 1);
+    std::uniform_int_distribution<unsigned int> unif_cols(0, num_cols_ - 1);
+    while (sources.size() < num_sources_) {
+      const unsigned int ii = unif_rows(rng_);
+      const unsigned int jj = unif_cols(rng_);
+      if (tiles_.count(TileKey(ii / kTileSize, jj / kTileSize)) == 0)
+        sources.push_back(Source2D(ii, jj));
+    }
+
+    return true;
+  }
+
+  // Count the sources visible from the sensor.
+  unsigned int TiledGridMap2D::Sense(const Sensor2D& sensor,
+                                     const std::vector<Source2D>& sources) {
+    return visibility_->Sense(sensor, sources);
+  }
+
+  // Generate entropy vector [h_{Z|X}], where the i-entry of [h_{Z|X}]
+  // is the entropy of Z given trajectory X = i, starting from the given pose.
+  void TiledGridMap2D::GenerateEntropyVector(
+     unsigned int num_samples, unsigned int num_steps, const GridPose2D& pose,
+     double sensor_fov, Eigen::VectorXd& hzx,
+     std::vector<Id64>& trajectory_ids, EntropyEstimator estimator) {
+    SampleEntropyVector(*this, rng_, num_samples, num_steps, pose, sensor_fov,
+                        scratch_, hzx, trajectory_ids, estimator);
+  }
+
+  // Take a measurement from the given sensor and update belief accordingly.
+  bool TiledGridMap2D::Update(const Sensor2D& sensor,
+                              const std::vector<Source2D>& sources,
+                              bool solve) {
+    RADIATION_TRACE_SCOPE("TiledGridMap2D::Update");
+    Measurement measurement;
+    measurement.measurement_ = visibility_->Sense(sensor, sources);
+    CHECK(measurement.measurement_ <= num_sources_);
+
+    // Identify all visible voxels, group them by tile, and allocate any
+    // tile that has at least one voxel in view.
+    std::vector<unsigned int> voxels;
+    visibility_->VisibleVoxels(sensor, voxels);
+
+    std::map< TileKey, std::vector<unsigned int> > offsets;
+    for (const auto& voxel : voxels) {
+      const unsigned int ii = voxel % num_rows_;
+      const unsigned int jj = voxel / num_rows_;
+      offsets[TileKey(ii / kTileSize, jj / kTileSize)].push_back(
+        ii % kTileSize + (jj % kTileSize) * kTileSize);
+    }
+
+    for (const auto& entry : offsets) {
+      FindOrAllocateTile(entry.first);
+      measurement.tiles_.push_back(entry.first);
+      measurement.offsets_.push_back(entry.second);
+    }
+
+    measurements_.push_back(measurement);
+
+    // Maybe solve.
+    if (solve)
+      return SolveLeastSquares();
+
+    return true;
+  }
+
+  // Compute entropy.
+  double TiledGridMap2D::Entropy() const {
+    double entropy = static_cast<double>(NumBackgroundVoxels()) *
+      SumBernoulliEntropies(&prior_, 1, 1e-8);
+
+    for (const auto& entry : tiles_)
+      entropy += entry.second.entropy_;
+
+    return entropy;
+  }
+
+  // Compute the expected measurement from the given sensor under the current
+  // belief state.
+  double TiledGridMap2D::ExpectedMeasurement(const Sensor2D& sensor) const {
+    std::vector<unsigned int> voxels;
+    visibility_->ComputeVisibleVoxels(sensor, voxels);
+
+    double expected = 0.0;
+    for (const auto& voxel : voxels)
+      expected += GetBelief(voxel % num_rows_, voxel / num_rows_);
+
+    return expected;
+  }
+
+  // Get belief at a single voxel.
+  double TiledGridMap2D::GetBelief(unsigned int ii, unsigned int jj) const {
+    CHECK(ii < num_rows_ && jj < num_cols_);
+
+    const auto iter = tiles_.find(TileKey(ii / kTileSize, jj / kTileSize));
+    if (iter == tiles_.end())
+      return prior_;
+
+    return iter->second.belief_[ii % kTileSize + (jj % kTileSize) * kTileSize];
+  }
+
+  // Copy the whole map into a dense matrix.
+  void TiledGridMap2D::GetBelief(Eigen::MatrixXd& belief) const {
+    belief = Eigen::MatrixXd::Constant(num_rows_, num_cols_, prior_);
+
+    for (const auto& entry : tiles_) {
+      const unsigned int row_offset = entry.first.first * kTileSize;
+      const unsigned int col_offset = entry.first.second * kTileSize;
+      const unsigned int tile_rows = TileRowsInBounds(entry.first);
+      const unsigned int tile_cols = TileColsInBounds(entry.first);
+
+      for (unsigned int jj = 0; jj < tile_cols; jj++)
+        for (unsigned int ii = 0; ii < tile_rows; ii++)
+          belief(row_offset + ii, col_offset + jj) =
+            entry.second.belief_[ii + jj * kTileSize];
+    }
+  }
+
+  // Solve least squares problem to update belief state.
+  bool TiledGridMap2D::SolveLeastSquares() {
+    // Create a non-linear least squares problem.
+    ceres::Problem problem;
+
+    // Add residual blocks for each measurement. Each one depends only on the
+    // tiles that it viewed.
+    for (size_t ii = 0; ii < measurements_.size(); ii++) {
+      const Measurement& measurement = measurements_[ii];
+
+      std::vector<double*> blocks;
+      for (const auto& key : measurement.tiles_)
+        blocks.push_back(tiles_.at(key).belief_.data());
+
+      if (blocks.empty())
+        continue;
+
+      problem.AddResidualBlock(
+        TiledBeliefError::Create(kTileSize, &measurement.offsets_,
+                                 measurement.measurement_),
+        NULL, /* squared loss */
+        blocks);
+    }
+
+    // Add a final residual block to enforce consistancy across the entire grid,
+    // i.e. that the expected number of sources matches the specified number.
+    // Background voxels are held fixed at the prior.
+    std::vector<double*> blocks;
+    std::vector< std::pair<unsigned int, unsigned int> > extents;
+    for (auto& entry : tiles_) {
+      blocks.push_back(entry.second.belief_.data());
+      extents.push_back(std::make_pair(TileRowsInBounds(entry.first),
+                                       TileColsInBounds(entry.first)));
+    }
+
+    if (blocks.empty())
+      return true;
+
+    const double target = static_cast<double>(num_sources_) -
+      prior_ * static_cast<double>(NumBackgroundVoxels());
+    problem.AddResidualBlock(
+      TiledBeliefRegularization::Create(kTileSize, extents, target,
+                                        regularizer_ * measurements_.size()),
+      NULL, /* squared loss */
+      blocks);
+
+    // Set bounds constraints. Each voxel's belief should be a probability
+    // between 0 and 1.
+    for (const auto& block : blocks) {
+      for (unsigned int ii = 0; ii < kTileSize * kTileSize; ii++) {
+        problem.SetParameterLowerBound(block, ii, 0.0);
+        problem.SetParameterUpperBound(block, ii, 1.0);
+      }
+    }
+
+    // Set up solver options. The Jacobian has one column per allocated voxel
+    // but is mostly empty, so use an iterative solver rather than forming
+    // a dense factorization.
+    ceres::Solver::Summary summary;
+    ceres::Solver::Options options;
+    options.linear_solver_type = ceres::CGNR;
+    options.function_tolerance = 1e-16;
+    options.gradient_tolerance = 1e-16;
+    options.trust_region_strategy_type = ceres::LEVENBERG_MARQUARDT;
+
+    // Solve, refresh cached sums and entropies, and return.
+    ceres::Solve(options, &problem, &summary);
+    RefreshAllTiles();
+
+    return summary.IsSolutionUsable();
+  }
+
+  // Find the tile with the given key, allocating it at the prior if needed.
+  TiledGridMap2D::Tile& TiledGridMap2D::FindOrAllocateTile(const TileKey& key) {
+    auto iter = tiles_.find(key);
+    if (iter != tiles_.end())
+      return iter->second;
+
+    Tile& tile = tiles_[key];
+    tile.belief_.assign(kTileSize * kTileSize, prior_);
+    RefreshTile(key, tile);
+
+    num_allocated_voxels_ += TileRowsInBounds(key) * TileColsInBounds(key);
+    return tile;
+  }
+
+  // Number of rows/columns of the given tile which lie inside the bounds.
+  unsigned int TiledGridMap2D::TileRowsInBounds(const TileKey& key) const {
+    const unsigned int first_row = key.first * kTileSize;
+    return (first_row >= num_rows_) ?
+      0 : std::min(kTileSize, num_rows_ - first_row);
+  }
+
+  unsigned int TiledGridMap2D::TileColsInBounds(const TileKey& key) const {
+    const unsigned int first_col = key.second * kTileSize;
+    return (first_col >= num_cols_) ?
+      0 : std::min(kTileSize, num_cols_ - first_col);
+  }
+
+  // Recompute cached sum and entropy for a tile, one column at a time since
+  // only the in-bounds part of each column is contiguous.
+  void TiledGridMap2D::RefreshTile(const TileKey& key, Tile& tile) const {
+    const unsigned int tile_rows = TileRowsInBounds(key);
+    const unsigned int tile_cols = TileColsInBounds(key);
+
+    tile.sum_ = 0.0;
+    tile.entropy_ = 0.0;
+    for (unsigned int jj = 0; jj < tile_cols; jj++) {
+      const double* column = tile.belief_.data() + jj * kTileSize;
+      for (unsigned int ii = 0; ii < tile_rows; ii++)
+        tile.sum_ += column[ii];
+      tile.entropy_ += SumBernoulliEntropies(column, tile_rows, 1e-8);
+    }
+  }
+
+  // Recompute all caches, e.g. after solving or growing.
+  void TiledGridMap2D::RefreshAllTiles() {
+    num_allocated_voxels_ = 0;
+    for (auto& entry : tiles_) {
+      RefreshTile(entry.first, entry.second);
+      num_allocated_voxels_ +=
+        TileRowsInBounds(entry.first) * TileColsInBounds(entry.first);
+    }
+  }
+
+  // Number of in-bounds voxels not covered by any allocated tile.
+  unsigned int TiledGridMap2D::NumBackgroundVoxels() const {
+    return num_rows_ * num_cols_ - num_allocated_voxels_;
+  }
+
+} // namespace radiation
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Lightweight tracing of hot paths, with Chrome trace-event output. See
+// header for details.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <trace.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace radiation {
+
+namespace {
+// Number of events each thread keeps. Must be a power of two.
+const uint64_t kBufferSize = 1 << 16;
+
+struct TraceEvent {
+  const char* name;
+  uint64_t start;
+  uint64_t end;
+}; // struct TraceEvent
+
+// Ring buffer of one thread's events. Only its own thread writes to it.
+struct TraceBuffer {
+  explicit TraceBuffer(unsigned int thread_id)
+    : thread_id_(thread_id), num_events_(0), events_(kBufferSize) {}
+
+  const unsigned int thread_id_;
+  std::atomic<uint64_t> num_events_;
+  std::vector<TraceEvent> events_;
+}; // struct TraceBuffer
+
+// Every buffer ever handed out. A buffer outlives the thread that used it,
+// so its events can still be written, and then goes on the free list to be
+// reused by the next new thread. The number of buffers is therefore bounded
+// by the peak number of live threads that trace, not the total.
+std::mutex buffers_mutex;
+std::vector< std::unique_ptr<TraceBuffer> > buffers;
+std::vector<TraceBuffer*> free_buffers;
+
+// Hand the calling thread a free buffer, or a new one if none is free.
+TraceBuffer* AcquireBuffer() {
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  if (!free_buffers.empty()) {
+    TraceBuffer* buffer = free_buffers.back();
+    free_buffers.pop_back();
+    return buffer;
+  }
+
+  buffers.emplace_back(new TraceBuffer(buffers.size()));
+  return buffers.back().get();
+}
+
+// Return a buffer to the free list, keeping its events.
+void ReleaseBuffer(TraceBuffer* buffer) {
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  free_buffers.push_back(buffer);
+}
+
+// Owns the calling thread's buffer, and releases it when the thread exits.
+struct BufferHolder {
+  BufferHolder() : buffer_(AcquireBuffer()) {}
+  ~BufferHolder() { ReleaseBuffer(buffer_); }
+
+  TraceBuffer* const buffer_;
+}; // struct BufferHolder
+
+// Escape a string for JSON.
+std::string Escape(const char* name) {
+  std::string escaped;
+  for (const char* c = name; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\')
+      escaped += '\\';
+    escaped += *c;
+  }
+
+  return escaped;
+}
+} // namespace
+
+// Monotonic clock, in nanoseconds.
+uint64_t TraceClock() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Record a complete event on the calling thread's buffer.
+void RecordTraceEvent(const char* name, uint64_t start, uint64_t end) {
+  static thread_local const BufferHolder holder;
+  TraceBuffer* const buffer = holder.buffer_;
+
+  const uint64_t index =
+    buffer->num_events_.load(std::memory_order_relaxed);
+  TraceEvent& event = buffer->events_[index & (kBufferSize - 1)];
+  event.name = name;
+  event.start = start;
+  event.end = end;
+  buffer->num_events_.store(index + 1, std::memory_order_release);
+}
+
+// Write all recorded events as Chrome trace-event JSON.
+bool WriteTrace(const std::string& path) {
+  std::ofstream file(path.c_str());
+  if (!file.is_open()) {
+    LOG(ERROR) << "Could not open " << path << ".";
+    return false;
+  }
+
+  // Chrome expects microseconds. Times are relative to the earliest event.
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  uint64_t origin = std::numeric_limits<uint64_t>::max();
+  for (const auto& buffer : buffers) {
+    const uint64_t num_events =
+      buffer->num_events_.load(std::memory_order_acquire);
+    for (uint64_t ii = num_events - std::min(num_events, kBufferSize);
+         ii < num_events; ii++)
+      origin = std::min(origin, buffer->events_[ii & (kBufferSize - 1)].start);
+  }
+
+  file << std::fixed << std::setprecision(3)
+       << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (const auto& buffer : buffers) {
+    const uint64_t num_events =
+      buffer->num_events_.load(std::memory_order_acquire);
+    for (uint64_t ii = num_events - std::min(num_events, kBufferSize);
+         ii < num_events; ii++) {
+      const TraceEvent& event = buffer->events_[ii & (kBufferSize - 1)];
+      file << (first ? "\n" : ",\n")
+           << "{\"name\":\"" << Escape(event.name) << "\",\"ph\":\"X\","
+           << "\"pid\":0,\"tid\":" << buffer->thread_id_ << ","
+           << "\"ts\":" << (event.start - origin) / 1000.0 << ","
+           << "\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+      first = false;
+    }
+  }
+
+  file << "\n]}\n";
+  return file.good();
+}
+
+// Number of buffers allocated so far.
+size_t GetNumTraceBuffers() {
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  return buffers.size();
+}
+
+// Discard all recorded events.
+void ClearTrace() {
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  for (const auto& buffer : buffers)
+    buffer->num_events_.store(0, std::memory_order_release);
+}
+
+} // namespace radiation
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Defines a cache of the voxels visible from each sensor pose, accounting
+// for obstacles in the given context.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <visibility_cache_2d.h>
+
+#include <glog/logging.h>
+
+namespace radiation {
+
+  VisibilityCache2D::~VisibilityCache2D() {}
+  VisibilityCache2D::VisibilityCache2D(const Context2D& context,
+                                       unsigned int max_cached,
+                                       unsigned int max_views)
+    : context_(context), max_cached_(max_cached), max_views_(max_views),
+      table_(new Table) {
+    CHECK(max_cached_ > 0);
+    CHECK(max_views_ > 0);
+    table_->cells.resize(context_.GetNumRows() * context_.GetNumCols());
+  }
+
+  VisibilityCache2D::VisibilityCache2D(const VisibilityCache2D& other)
+    : context_(other.context_), max_cached_(other.max_cached_),
+      max_views_(other.max_views_), table_(other.table_) {}
+
+  // Get the indices of all voxels visible from the sensor, computing and
+  // caching line of sight if necessary.
+  void VisibilityCache2D::VisibleVoxels(const Sensor2D& sensor,
+                                        std::vector<unsigned int>& voxels) {
+    if (!context_.HasObstacles()) {
+      ComputeVisibleVoxels(sensor, voxels);
+      return;
+    }
+
+    const std::shared_ptr<const LineOfSightMap> visible = Lookup(sensor);
+    if (!visible) {
+      ComputeVisibleVoxels(sensor, voxels);
+      return;
+    }
+
+    sensor.VoxelsInView(context_.GetNumRows(), context_.GetNumCols(), voxels);
+
+    unsigned int num_visible = 0;
+    for (const auto& voxel : voxels) {
+      if ((*visible)[voxel])
+        voxels[num_visible++] = voxel;
+    }
+
+    voxels.resize(num_visible);
+  }
+
+  // Same as above, but never touches the cache. Rasterize the field of view
+  // and drop any voxel without a clear line of sight.
+  void VisibilityCache2D::ComputeVisibleVoxels(
+    const Sensor2D& sensor, std::vector<unsigned int>& voxels) const {
+    const unsigned int num_rows = context_.GetNumRows();
+    sensor.VoxelsInView(num_rows, context_.GetNumCols(), voxels);
+
+    if (!context_.HasObstacles())
+      return;
+
+    unsigned int num_visible = 0;
+    for (const auto& voxel : voxels) {
+      if (context_.LineOfSight(sensor.GetX(), sensor.GetY(),
+                               voxel % num_rows, voxel / num_rows))
+        voxels[num_visible++] = voxel;
+    }
+
+    voxels.resize(num_visible);
+  }
+
+  // Get this copy's view from the sensor. On a miss, rasterize the visible
+  // voxels once (through the shared cache if the sensor is at a voxel
+  // center) and keep them as a bitmap. Start over once the table is full.
+  const VisibilityCache2D::View*
+  VisibilityCache2D::GetView(const Sensor2D& sensor) {
+    if (!context_.HasObstacles())
+      return nullptr;
+
+    const ViewKey key = { sensor.GetX(), sensor.GetY(), sensor.GetAngle(),
+                          sensor.GetFov() };
+    const auto iter = views_.find(key);
+    if (iter != views_.end())
+      return &iter->second;
+
+    if (views_.size() >= max_views_)
+      views_.clear();
+
+    VisibleVoxels(sensor, voxels_);
+    View& view = views_[key];
+    view.assign(context_.GetNumRows() * context_.GetNumCols(), false);
+    for (const auto& voxel : voxels_)
+      view[voxel] = true;
+
+    return &view;
+  }
+
+  // Count the sources visible from the sensor.
+  unsigned int VisibilityCache2D::Sense(const Sensor2D& sensor,
+                                        const std::vector<Source2D>& sources) {
+    return Sense(sensor, GetView(sensor), sources);
+  }
+
+  // Count the sources visible from the sensor, given its view.
+  unsigned int VisibilityCache2D::Sense(
+    const Sensor2D& sensor, const View* view,
+    const std::vector<Source2D>& sources) const {
+    if (view == nullptr)
+      return sensor.Sense(sources);
+
+    const unsigned int num_rows = context_.GetNumRows();
+    unsigned int count = 0;
+    for (const auto& source : sources)
+      count += (*view)[source.GetIndexX() + source.GetIndexY() * num_rows];
+
+    return count;
+  }
+
+  // Number of cached cells, and number of this copy's views.
+  unsigned int VisibilityCache2D::GetNumCached() const {
+    std::lock_guard<std::mutex> lock(table_->mutex);
+    return table_->order.size();
+  }
+
+  unsigned int VisibilityCache2D::GetNumViews() const {
+    return views_.size();
+  }
+
+  // Clear the cache, and this copy's views.
+  void VisibilityCache2D::Clear() {
+    std::lock_guard<std::mutex> lock(table_->mutex);
+    for (const auto& cell : table_->order)
+      table_->cells[cell].reset();
+    table_->order.clear();
+    views_.clear();
+  }
+
+  // Find the bitmap for the sensor's cell, computing it if necessary. The ray
+  // casts happen outside the lock, so other threads are only held up by the
+  // bookkeeping; if two threads compute the same cell, the first one wins.
+  std::shared_ptr<const VisibilityCache2D::LineOfSightMap>
+  VisibilityCache2D::Lookup(const Sensor2D& sensor) {
+    const unsigned int num_rows = context_.GetNumRows();
+    const unsigned int num_cols = context_.GetNumCols();
+    if (sensor.GetX() < 0.0 || sensor.GetY() < 0.0)
+      return nullptr;
+
+    const unsigned int ii = sensor.GetIndexX();
+    const unsigned int jj = sensor.GetIndexY();
+    if (ii >= num_rows || jj >= num_cols ||
+        sensor.GetX() != static_cast<double>(ii) + 0.5 ||
+        sensor.GetY() != static_cast<double>(jj) + 0.5)
+      return nullptr;
+
+    const unsigned int cell = ii + jj * num_rows;
+    {
+      std::lock_guard<std::mutex> lock(table_->mutex);
+      if (table_->cells[cell])
+        return table_->cells[cell];
+    }
+
+    std::shared_ptr<LineOfSightMap> visible(
+      new LineOfSightMap(num_rows * num_cols));
+    for (unsigned int voxel = 0; voxel < num_rows * num_cols; voxel++)
+      (*visible)[voxel] = context_.LineOfSight(sensor.GetX(), sensor.GetY(),
+                                               voxel % num_rows,
+                                               voxel / num_rows);
+
+    std::lock_guard<std::mutex> lock(table_->mutex);
+    if (table_->cells[cell])
+      return table_->cells[cell];
+
+    if (table_->order.size() >= max_cached_) {
+      table_->cells[table_->order.front()].reset();
+      table_->order.pop_front();
+    }
+
+    table_->cells[cell] = visible;
+    table_->order.push_back(cell);
+    return visible;
+  }
+
+} // namespace radiation
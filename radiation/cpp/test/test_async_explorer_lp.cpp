@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for AsyncExplorerLP.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <async_explorer_lp.h>
+#include <context_2d.h>
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Problem parameters shared by all tests.
+const unsigned int kNumRows = 6;
+const unsigned int kNumCols = 6;
+const unsigned int kNumSources = 1;
+const unsigned int kNumSteps = 2;
+const unsigned int kNumSamples = 1000;
+const double kFov = 0.25 * M_PI;
+const unsigned int kNumIterations = 10;
+} // namespace
+
+// Test that pipelined steps reduce entropy, and that a speculative plan is
+// discarded exactly when the real measurement diverges from the expected one
+// by more than the threshold.
+TEST(AsyncExplorerLP, TestReplanOnDivergence) {
+  const double kReplanThreshold = 0.5;
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(0.25 * M_PI);
+
+  AsyncExplorerLP explorer(context, kNumSources, 1.0, kNumSteps, kFov,
+                           kNumSamples, kReplanThreshold, 0);
+
+  const double initial_entropy = explorer.Entropy();
+  double entropy = initial_entropy;
+  for (unsigned int ii = 0; ii < kNumIterations; ii++) {
+    const unsigned int num_replanned = explorer.GetNumReplanned();
+    ASSERT_TRUE(explorer.PipelinedStep(entropy));
+    EXPECT_NEAR(entropy, explorer.Entropy(), 1e-12);
+
+    const bool replanned = explorer.GetNumReplanned() > num_replanned;
+    EXPECT_EQ(replanned, explorer.GetLastDivergence() > kReplanThreshold);
+  }
+
+  EXPECT_EQ(explorer.GetNumAccepted() + explorer.GetNumReplanned(),
+            kNumIterations);
+  EXPECT_LT(entropy, initial_entropy);
+}
+
+// Test that an unreachable threshold never replans, and a negative one
+// always does.
+TEST(AsyncExplorerLP, TestReplanThresholds) {
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(0.25 * M_PI);
+
+  AsyncExplorerLP never(context, kNumSources, 1.0, kNumSteps, kFov,
+                        kNumSamples, std::numeric_limits<double>::infinity(),
+                        1);
+  AsyncExplorerLP always(context, kNumSources, 1.0, kNumSteps, kFov,
+                         kNumSamples, -1.0, 1);
+
+  double entropy = 0.0;
+  for (unsigned int ii = 0; ii < kNumIterations; ii++) {
+    ASSERT_TRUE(never.PipelinedStep(entropy));
+    ASSERT_TRUE(always.PipelinedStep(entropy));
+  }
+
+  EXPECT_EQ(never.GetNumReplanned(), 0u);
+  EXPECT_EQ(never.GetNumAccepted(), kNumIterations);
+  EXPECT_EQ(always.GetNumReplanned(), kNumIterations);
+  EXPECT_EQ(always.GetNumAccepted(), 0u);
+}
+
+} // namespace radiation
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for ColumnarFile.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <columnar_file.h>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+namespace radiation {
+
+namespace {
+// Make a unique temporary file name.
+std::string TemporaryPath() {
+  char path[] = "/tmp/test_columnar_file_XXXXXX";
+  const int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  close(fd);
+  return std::string(path);
+}
+} // namespace
+
+// Write a few columns and parameters, and read them back.
+TEST(ColumnarFile, TestRoundTrip) {
+  const std::string path = TemporaryPath();
+  const size_t kNumRows = 100;
+  const size_t kWidth = 3;
+
+  std::map<std::string, std::string> parameters;
+  parameters["num_rows"] = "100";
+  parameters["note"] = "a = b";
+
+  {
+    std::vector<ColumnSpec> columns;
+    columns.push_back(ColumnSpec{"ids", ColumnType::kUInt64, kNumRows, 1});
+    columns.push_back(ColumnSpec{"values", ColumnType::kFloat32,
+                                 kNumRows, kWidth});
+    columns.push_back(ColumnSpec{"empty", ColumnType::kUInt8, 0, 4});
+
+    ColumnarFile file;
+    ASSERT_TRUE(file.Create(path, columns, parameters));
+
+    uint64_t* ids = file.GetMutableData<uint64_t>("ids");
+    float* values = file.GetMutableData<float>("values");
+    for (size_t ii = 0; ii < kNumRows; ii++) {
+      ids[ii] = ii * 1000000007ULL;
+      for (size_t jj = 0; jj < kWidth; jj++)
+        values[ii * kWidth + jj] = 0.5f * ii + jj;
+    }
+  }
+
+  ColumnarFile file;
+  ASSERT_TRUE(file.Open(path));
+  EXPECT_EQ(file.GetColumns().size(), 3);
+  EXPECT_EQ(file.GetParameters(), parameters);
+
+  const ColumnSpec* spec = file.FindColumn("values");
+  ASSERT_TRUE(spec != NULL);
+  EXPECT_TRUE(spec->type == ColumnType::kFloat32);
+  EXPECT_EQ(spec->num_rows, kNumRows);
+  EXPECT_EQ(spec->width, kWidth);
+  EXPECT_TRUE(file.FindColumn("missing") == NULL);
+  EXPECT_EQ(file.FindColumn("empty")->num_rows, 0);
+
+  const uint64_t* ids = file.GetData<uint64_t>("ids");
+  const float* values = file.GetData<float>("values");
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(values) % 64, 0);
+  for (size_t ii = 0; ii < kNumRows; ii++) {
+    EXPECT_EQ(ids[ii], ii * 1000000007ULL);
+    for (size_t jj = 0; jj < kWidth; jj++)
+      EXPECT_EQ(values[ii * kWidth + jj], 0.5f * ii + jj);
+  }
+
+  file.Close();
+  unlink(path.c_str());
+}
+
+// Files which are not columnar files should be rejected.
+TEST(ColumnarFile, TestInvalidFile) {
+  const std::string path = TemporaryPath();
+
+  FILE* stream = fopen(path.c_str(), "w");
+  ASSERT_TRUE(stream != NULL);
+  for (size_t ii = 0; ii < 128; ii++)
+    fputc('x', stream);
+  fclose(stream);
+
+  ColumnarFile file;
+  EXPECT_FALSE(file.Open(path));
+  EXPECT_FALSE(file.IsOpen());
+
+  unlink(path.c_str());
+  EXPECT_FALSE(file.Open(path));
+}
+
+} // namespace radiation
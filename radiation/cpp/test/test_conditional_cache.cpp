@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for ConditionalCache.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <conditional_cache.h>
+#include <explorer_lp.h>
+#include <grid_map_2d.h>
+#include <grid_pose_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+#include <context_2d.h>
+
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <memory>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Make a unique temporary directory.
+std::string TemporaryDirectory() {
+  char path[] = "/tmp/test_conditional_cache_XXXXXX";
+  CHECK(mkdtemp(path) != NULL);
+  return std::string(path);
+}
+
+// Remove a directory and every entry in it.
+void RemoveDirectory(const std::string& directory) {
+  DIR* dir = opendir(directory.c_str());
+  CHECK(dir != NULL);
+  for (struct dirent* entry = readdir(dir); entry != NULL;
+       entry = readdir(dir)) {
+    const std::string name(entry->d_name);
+    if (name != "." && name != "..")
+      unlink((directory + "/" + name).c_str());
+  }
+
+  closedir(dir);
+  rmdir(directory.c_str());
+}
+
+// Count the entries in a directory.
+unsigned int CountEntries(const std::string& directory) {
+  DIR* dir = opendir(directory.c_str());
+  CHECK(dir != NULL);
+  unsigned int count = 0;
+  for (struct dirent* entry = readdir(dir); entry != NULL;
+       entry = readdir(dir)) {
+    const std::string name(entry->d_name);
+    if (name != "." && name != "..")
+      count++;
+  }
+
+  closedir(dir);
+  return count;
+}
+
+// Explorer which starts from a fixed pose, whatever its seed.
+class PinnedExplorerLP : public ExplorerLP {
+ public:
+  PinnedExplorerLP(const Context2D& context, unsigned int seed)
+    : ExplorerLP(context, 1, 1.0, 2, 0.25 * M_PI, 300, seed) {
+    pose_ = GridPose2D(context_, 2u, 2u, 0.0);
+  }
+}; // class PinnedExplorerLP
+} // namespace
+
+// Keys should depend on the configuration and belief, but not on anything
+// else, such as the state of the map's random number generator.
+TEST(ConditionalCache, TestKey) {
+  const std::string directory = TemporaryDirectory();
+  const ConditionalCache cache(directory);
+
+  const Context2D context(5, 5);
+  GridMap2D map1(context, 2, 1.0);
+  GridMap2D map2(context, 2, 1.0);
+  map1.Seed(1);
+  map2.Seed(2);
+
+  const GridPose2D pose(context, 2.0, 2.0, 0.0);
+  const GridPose2D other_pose(context, 1.0, 2.0, 0.0);
+  const Id64 key = cache.Key(map1, 1000, 2, pose, 0.5);
+  EXPECT_EQ(key, cache.Key(map2, 1000, 2, pose, 0.5));
+  EXPECT_NE(key, cache.Key(map1, 2000, 2, pose, 0.5));
+  EXPECT_NE(key, cache.Key(map1, 1000, 3, pose, 0.5));
+  EXPECT_NE(key, cache.Key(map1, 1000, 2, other_pose, 0.5));
+  EXPECT_NE(key, cache.Key(map1, 1000, 2, pose, 0.6));
+  EXPECT_NE(key, cache.Key(map1, 1000, 2, pose, 0.5,
+                           EntropyEstimator::kMillerMadow));
+
+  // Updating the belief changes the key.
+  const std::vector<Source2D> sources(1, Source2D(2.0, 4.0));
+  map1.Update(Sensor2D(pose, M_PI), sources, true);
+  EXPECT_NE(key, cache.Key(map1, 1000, 2, pose, 0.5));
+
+  // So do obstacles.
+  Context2D blocked(5, 5);
+  blocked.SetObstacle(0, 0);
+  const GridMap2D blocked_map(blocked, 2, 1.0);
+  EXPECT_NE(key, cache.Key(blocked_map, 1000, 2, pose, 0.5));
+
+  rmdir(directory.c_str());
+}
+
+// Stored entries should be returned exactly, and missing ones not at all.
+TEST(ConditionalCache, TestStoreAndLookup) {
+  const std::string directory = TemporaryDirectory();
+  const ConditionalCache cache(directory);
+
+  const Context2D context(5, 5);
+  GridMap2D map(context, 1, 1.0);
+  map.Seed(0);
+  const GridPose2D pose(context, 2.0, 2.0, 0.0);
+
+  Eigen::VectorXd hzx;
+  std::vector<Id64> trajectory_ids;
+  map.GenerateEntropyVector(500, 2, pose, 0.5, hzx, trajectory_ids);
+
+  const Id64 key = cache.Key(map, 500, 2, pose, 0.5);
+  Eigen::VectorXd cached_hzx;
+  std::vector<Id64> cached_ids;
+  EXPECT_FALSE(cache.Lookup(key, cached_hzx, cached_ids));
+  ASSERT_TRUE(cache.Store(key, hzx, trajectory_ids));
+  ASSERT_TRUE(cache.Lookup(key, cached_hzx, cached_ids));
+  EXPECT_TRUE(cached_hzx == hzx);
+  EXPECT_TRUE(cached_ids == trajectory_ids);
+  EXPECT_FALSE(cache.Lookup(key + 1, cached_hzx, cached_ids));
+
+  // A second cache on the same directory sees the same entry.
+  const ConditionalCache other_cache(directory);
+  ASSERT_TRUE(other_cache.Lookup(key, cached_hzx, cached_ids));
+  EXPECT_TRUE(cached_ids == trajectory_ids);
+
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.rcol",
+           static_cast<unsigned long long>(key));
+  unlink((directory + name).c_str());
+  rmdir(directory.c_str());
+}
+
+// A seeded episode should plan exactly the same trajectories whether the
+// cache starts out cold or warm, and an episode with another seed should
+// reuse entries for configurations it shares.
+TEST(ConditionalCache, TestWarmMatchesCold) {
+  const std::string directory = TemporaryDirectory();
+  const std::shared_ptr<const ConditionalCache> cache(
+    new ConditionalCache(directory));
+  const unsigned int kNumIterations = 3;
+
+  Context2D context(5, 5);
+  context.SetAngularStep(0.25 * M_PI);
+
+  std::vector< std::vector<GridPose2D> > plans[2];
+  for (unsigned int run = 0; run < 2; run++) {
+    PinnedExplorerLP explorer(context, 7);
+    explorer.SetCache(cache);
+
+    for (unsigned int ii = 0; ii < kNumIterations; ii++) {
+      std::vector<GridPose2D> trajectory;
+      ASSERT_TRUE(explorer.PlanAhead(trajectory));
+      explorer.TakeStep(trajectory);
+      plans[run].push_back(trajectory);
+    }
+  }
+
+  for (unsigned int ii = 0; ii < kNumIterations; ii++) {
+    ASSERT_EQ(plans[0][ii].size(), plans[1][ii].size());
+    for (size_t jj = 0; jj < plans[0][ii].size(); jj++) {
+      EXPECT_EQ(plans[0][ii][jj].GetX(), plans[1][ii][jj].GetX());
+      EXPECT_EQ(plans[0][ii][jj].GetY(), plans[1][ii][jj].GetY());
+      EXPECT_EQ(plans[0][ii][jj].GetAngle(), plans[1][ii][jj].GetAngle());
+    }
+  }
+
+  // Another episode starts from the same pose and prior, so its first plan
+  // is a hit, and matches the first episode's.
+  const unsigned int num_entries = CountEntries(directory);
+  EXPECT_GT(num_entries, 0u);
+  PinnedExplorerLP other(context, 8);
+  other.SetCache(cache);
+  std::vector<GridPose2D> trajectory;
+  ASSERT_TRUE(other.PlanAhead(trajectory));
+  EXPECT_EQ(CountEntries(directory), num_entries);
+  ASSERT_EQ(trajectory.size(), plans[0][0].size());
+  for (size_t jj = 0; jj < trajectory.size(); jj++) {
+    EXPECT_EQ(trajectory[jj].GetX(), plans[0][0][jj].GetX());
+    EXPECT_EQ(trajectory[jj].GetY(), plans[0][0][jj].GetY());
+    EXPECT_EQ(trajectory[jj].GetAngle(), plans[0][0][jj].GetAngle());
+  }
+
+  RemoveDirectory(directory);
+}
+
+} // namespace radiation
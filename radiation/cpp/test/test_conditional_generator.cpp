@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for GenerateConditionals.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <conditional_generator.h>
+#include <grid_map_2d.h>
+#include <grid_pose_2d.h>
+#include <context_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+// Check the structure of the conditionals, and that they do not depend on
+// how samples are split across threads beyond the seed.
+TEST(ConditionalGenerator, TestConditionals) {
+  const unsigned int kNumSamples = 2000;
+  const unsigned int kNumSteps = 2;
+  const unsigned int kNumSources = 2;
+
+  const Context2D context(5, 5);
+  const GridMap2D map(context, kNumSources, 1.0);
+  const GridPose2D pose(context, 2.0, 2.0, 0.0);
+
+  Conditionals conditionals;
+  GenerateConditionals(map, kNumSamples, kNumSteps, pose, 0.5 * M_PI, 3, 0,
+                       conditionals);
+  EXPECT_EQ(conditionals.num_samples, kNumSamples);
+  EXPECT_LE(conditionals.num_joint_entries, kNumSamples);
+
+  // Ids are sorted and label every row and column.
+  const Eigen::MatrixXd pzx(conditionals.pzx);
+  ASSERT_EQ(pzx.cols(), conditionals.trajectory_ids.size());
+  ASSERT_EQ(pzx.rows(), conditionals.measurement_ids.size());
+  ASSERT_EQ(conditionals.hzm.rows(), pzx.rows());
+  for (size_t ii = 1; ii < conditionals.trajectory_ids.size(); ii++)
+    EXPECT_LT(conditionals.trajectory_ids[ii - 1],
+              conditionals.trajectory_ids[ii]);
+  for (size_t ii = 1; ii < conditionals.measurement_ids.size(); ii++)
+    EXPECT_LT(conditionals.measurement_ids[ii - 1],
+              conditionals.measurement_ids[ii]);
+
+  // Columns of P_{Z|X} are distributions.
+  for (int jj = 0; jj < pzx.cols(); jj++) {
+    EXPECT_NEAR(pzx.col(jj).sum(), 1.0, 1e-12);
+    EXPECT_GE(pzx.col(jj).minCoeff(), 0.0);
+  }
+
+  // Map entropies are bounded by the entropy of a uniform map.
+  const double kMaxEntropy = kNumSources * log(25.0);
+  for (int ii = 0; ii < conditionals.hzm.rows(); ii++) {
+    EXPECT_GE(conditionals.hzm(ii), 0.0);
+    EXPECT_LE(conditionals.hzm(ii), kMaxEntropy + 1e-12);
+  }
+
+  // Same seed and threads, same result.
+  Conditionals repeated;
+  GenerateConditionals(map, kNumSamples, kNumSteps, pose, 0.5 * M_PI, 3, 0,
+                       repeated);
+  EXPECT_TRUE(repeated.trajectory_ids == conditionals.trajectory_ids);
+  EXPECT_TRUE(repeated.measurement_ids == conditionals.measurement_ids);
+  EXPECT_TRUE(Eigen::MatrixXd(repeated.pzx) == pzx);
+  EXPECT_TRUE(repeated.hzm == conditionals.hzm);
+}
+
+// With a single possible map, nothing is left to learn from measurements.
+TEST(ConditionalGenerator, TestKnownMap) {
+  const Context2D context(4, 4);
+  Eigen::MatrixXd belief = Eigen::MatrixXd::Zero(4, 4);
+  belief(1, 2) = 1.0;
+  const GridMap2D map(context, belief, 1, 1.0);
+  const GridPose2D pose(context, 0.0, 0.0, 0.0);
+
+  Conditionals conditionals;
+  GenerateConditionals(map, 500, 2, pose, 0.5 * M_PI, 2, 1, conditionals);
+  EXPECT_EQ(conditionals.num_joint_entries,
+            conditionals.measurement_ids.size());
+  for (int ii = 0; ii < conditionals.hzm.rows(); ii++)
+    EXPECT_NEAR(conditionals.hzm(ii), 0.0, 1e-12);
+}
+
+} // namespace radiation
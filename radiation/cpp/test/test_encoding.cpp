@@ -42,8 +42,10 @@
 
 #include <encoding.h>
 #include <movement_2d.h>
+#include <context_2d.h>
 
 #include <gtest/gtest.h>
+#include <unordered_set>
 #include <vector>
 #include <random>
 #include <iostream>
@@ -59,13 +61,16 @@ TEST(Encoding, TestTrajectory) {
   const unsigned int kNumSteps = 5;
   const unsigned int kAngularStep = 0.5 * M_PI;
 
-  // Set static variables.
-  Movement2D::SetAngularStep(kAngularStep);
-  GridPose2D::SetNumRows(kNumRows);
-  GridPose2D::SetNumCols(kNumCols);
+  // Set up grid dimensions and movements.
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(kAngularStep);
+
+  // Random number generator for sampling movements.
+  std::random_device rd;
+  std::default_random_engine rng(rd());
 
   // Set initial position to be at the center.
-  const GridPose2D initial_pose(kNumRows / 2, kNumCols / 2, 0.0);
+  const GridPose2D initial_pose(context, kNumRows / 2, kNumCols / 2, 0.0);
 
   for (unsigned int ii = 0; ii < kNumTrials; ii++) {
     GridPose2D current_pose = initial_pose;
@@ -74,7 +79,7 @@ TEST(Encoding, TestTrajectory) {
     std::vector<Movement2D> movements;
     std::vector<GridPose2D> trajectory;
     while (trajectory.size() < kNumSteps) {
-      const Movement2D step;
+      const Movement2D step(context, rng);
 
       if (current_pose.MoveBy(step)) {
         movements.push_back(step);
@@ -83,7 +88,7 @@ TEST(Encoding, TestTrajectory) {
     }
 
     // Encode this trajectory.
-    const unsigned int trajectory_id = EncodeTrajectory(movements);
+    const unsigned int trajectory_id = EncodeTrajectory(movements, context);
 
     // Decode the id back into a trajectory.
     std::vector<GridPose2D> decoded_trajectory;
@@ -104,6 +109,73 @@ TEST(Encoding, TestTrajectory) {
   }
 }
 
+// Test that trajectories on two differently-configured grids can be
+// generated and decoded side by side without interfering.
+TEST(Encoding, TestIndependentContexts) {
+  const unsigned int kNumTrials = 100;
+  const unsigned int kNumSteps = 4;
+
+  Context2D small(4, 6);
+  small.SetAngularStep(0.5 * M_PI);
+  Context2D large(20, 15);
+  large.SetAngularStep(0.1 * M_PI);
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+
+  for (unsigned int ii = 0; ii < kNumTrials; ii++) {
+    const GridPose2D small_initial(small, 1.0, 2.0, 0.0);
+    const GridPose2D large_initial(large, 10.0, 7.0, 0.0);
+    GridPose2D small_pose = small_initial;
+    GridPose2D large_pose = large_initial;
+
+    // Interleave random steps on both grids.
+    std::vector<Movement2D> small_movements, large_movements;
+    std::vector<GridPose2D> small_trajectory, large_trajectory;
+    while (small_trajectory.size() < kNumSteps ||
+           large_trajectory.size() < kNumSteps) {
+      const Movement2D small_step(small, rng);
+      const Movement2D large_step(large, rng);
+
+      if (small_trajectory.size() < kNumSteps &&
+          small_pose.MoveBy(small_step)) {
+        small_movements.push_back(small_step);
+        small_trajectory.push_back(small_pose);
+      }
+
+      if (large_trajectory.size() < kNumSteps &&
+          large_pose.MoveBy(large_step)) {
+        large_movements.push_back(large_step);
+        large_trajectory.push_back(large_pose);
+      }
+    }
+
+    // Each pose must respect the bounds of its own grid.
+    for (const auto& pose : small_trajectory) {
+      EXPECT_LE(pose.GetX(), static_cast<double>(small.GetNumRows()));
+      EXPECT_LE(pose.GetY(), static_cast<double>(small.GetNumCols()));
+    }
+
+    // Decode both trajectories and compare.
+    std::vector<GridPose2D> small_decoded, large_decoded;
+    DecodeTrajectory(EncodeTrajectory(small_movements, small), kNumSteps,
+                     small_initial, small_decoded);
+    DecodeTrajectory(EncodeTrajectory(large_movements, large), kNumSteps,
+                     large_initial, large_decoded);
+
+    ASSERT_EQ(small_decoded.size(), kNumSteps);
+    ASSERT_EQ(large_decoded.size(), kNumSteps);
+    for (size_t jj = 0; jj < kNumSteps; jj++) {
+      EXPECT_NEAR(small_trajectory[jj].GetX(), small_decoded[jj].GetX(), 1e-8);
+      EXPECT_NEAR(small_trajectory[jj].GetAngle(),
+                  small_decoded[jj].GetAngle(), 1e-8);
+      EXPECT_NEAR(large_trajectory[jj].GetY(), large_decoded[jj].GetY(), 1e-8);
+      EXPECT_NEAR(large_trajectory[jj].GetAngle(),
+                  large_decoded[jj].GetAngle(), 1e-8);
+    }
+  }
+}
+
 // Test encoding/decoding for sources.
 TEST(Encoding, TestSources) {
   const unsigned int kNumTrials = 100;
@@ -175,4 +247,94 @@ TEST(Encoding, TestMeasurements) {
   }
 }
 
+// Test that ids are checked for overflow at exactly the right boundary.
+TEST(Encoding, TestOverflow) {
+  // 32 binary digits fill an unsigned int exactly.
+  std::vector<unsigned int> digits(32, 1);
+  unsigned int id32 = 0;
+  EXPECT_TRUE(EncodeDigits(digits, 2, id32));
+  EXPECT_EQ(id32, ~0u);
+
+  // A 33rd digit only fits if it is zero.
+  digits.push_back(0);
+  EXPECT_TRUE(EncodeDigits(digits, 2, id32));
+  digits.back() = 1;
+  EXPECT_FALSE(EncodeDigits(digits, 2, id32));
+
+  // 27^7 does not fit in 32 bits, but does in 64, and 27^20 fits in 128.
+  std::vector<unsigned int> moves(7, 26);
+  EXPECT_FALSE(EncodeDigits(moves, 27, id32));
+
+  Id64 id64 = 0;
+  EXPECT_TRUE(EncodeDigits(moves, 27, id64));
+  std::vector<unsigned int> decoded;
+  DecodeDigits(id64, 27, 7, decoded);
+  EXPECT_EQ(decoded, moves);
+
+  moves.assign(20, 26);
+  EXPECT_FALSE(EncodeDigits(moves, 27, id64));
+
+  Id128 id128 = 0;
+  EXPECT_TRUE(EncodeDigits(moves, 27, id128));
+  DecodeDigits(id128, 27, 20, decoded);
+  EXPECT_EQ(decoded, moves);
+}
+
+// Test wide and variable-length trajectory ids over a long horizon.
+TEST(Encoding, TestLongTrajectory) {
+  const unsigned int kNumSteps = 40;
+  const unsigned int kNumTrials = 20;
+
+  const Context2D context(100, 100);
+  const GridPose2D initial_pose(context, 50u, 50u, 0.0);
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+
+  std::unordered_set<EncodingKey, EncodingKeyHash> keys;
+  for (unsigned int ii = 0; ii < kNumTrials; ii++) {
+    GridPose2D current_pose = initial_pose;
+    std::vector<Movement2D> movements;
+    std::vector<GridPose2D> trajectory;
+    while (trajectory.size() < kNumSteps) {
+      const Movement2D step(context, rng);
+      if (current_pose.MoveBy(step)) {
+        movements.push_back(step);
+        trajectory.push_back(current_pose);
+      }
+    }
+
+    // Too long for 128 bits, so use a key.
+    Id128 id = 0;
+    EXPECT_FALSE(EncodeTrajectory(movements, context, id));
+
+    const EncodingKey key = EncodeTrajectoryKey(movements, context);
+    EXPECT_EQ(key.GetNumDigits(), kNumSteps);
+    EXPECT_TRUE(key == EncodeTrajectoryKey(movements, context));
+    keys.insert(key);
+
+    std::vector<GridPose2D> decoded;
+    DecodeTrajectory(key, initial_pose, decoded);
+    ASSERT_EQ(decoded.size(), kNumSteps);
+    for (size_t jj = 0; jj < kNumSteps; jj++) {
+      EXPECT_NEAR(trajectory[jj].GetX(), decoded[jj].GetX(), 1e-8);
+      EXPECT_NEAR(trajectory[jj].GetY(), decoded[jj].GetY(), 1e-8);
+      EXPECT_NEAR(trajectory[jj].GetAngle(), decoded[jj].GetAngle(), 1e-8);
+    }
+
+    // The first few steps fit in 64 bits.
+    const std::vector<Movement2D> prefix(movements.begin(),
+                                         movements.begin() + 10);
+    Id64 prefix_id = 0;
+    ASSERT_TRUE(EncodeTrajectory(prefix, context, prefix_id));
+    DecodeTrajectory(prefix_id, 10, initial_pose, decoded);
+    ASSERT_EQ(decoded.size(), 10u);
+    EXPECT_NEAR(trajectory[9].GetX(), decoded[9].GetX(), 1e-8);
+    EXPECT_NEAR(trajectory[9].GetY(), decoded[9].GetY(), 1e-8);
+  }
+
+  // Random 40-step trajectories essentially never collide.
+  EXPECT_EQ(keys.size(), kNumTrials);
+}
+
 } // namespace radiation
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for entropy estimators.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <entropy_estimators.h>
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+const double kPrecision = 1e-10;
+
+// Plug-in entropy of the given counts, computed directly.
+double PlugIn(const std::vector<double>& counts) {
+  double total = 0.0;
+  for (const auto& count : counts)
+    total += count;
+
+  double entropy = 0.0;
+  for (const auto& count : counts) {
+    if (count > 0.0)
+      entropy -= (count / total) * log(count / total);
+  }
+
+  return entropy;
+}
+} // namespace
+
+// Check closed forms on small histograms.
+TEST(EntropyEstimators, TestClosedForms) {
+  const std::vector<double> counts = { 3.0, 0.0, 1.0, 2.0, 0.0, 4.0 };
+  const double total = 10.0;
+  const double plug_in = PlugIn(counts);
+
+  EXPECT_NEAR(EstimateEntropy(counts.data(), counts.size(),
+                              EntropyEstimator::kPlugIn),
+              plug_in, kPrecision);
+  EXPECT_NEAR(EstimateEntropy(counts.data(), counts.size(),
+                              EntropyEstimator::kMillerMadow),
+              plug_in + 3.0 / (2.0 * total), kPrecision);
+
+  // Jackknife, by actually leaving out each sample in turn.
+  double sum_loo = 0.0;
+  for (size_t ii = 0; ii < counts.size(); ii++) {
+    if (counts[ii] == 0.0)
+      continue;
+
+    std::vector<double> loo = counts;
+    loo[ii] -= 1.0;
+    sum_loo += counts[ii] * PlugIn(loo);
+  }
+
+  EXPECT_NEAR(EstimateEntropy(counts.data(), counts.size(),
+                              EntropyEstimator::kJackknife),
+              total * plug_in - (total - 1.0) / total * sum_loo, kPrecision);
+
+  // Chao-Shen, with one singleton, so coverage is 0.9.
+  double chao_shen = 0.0;
+  for (const auto& count : counts) {
+    if (count == 0.0)
+      continue;
+
+    const double p = 0.9 * count / total;
+    chao_shen -= p * log(p) / (1.0 - pow(1.0 - p, total));
+  }
+
+  EXPECT_NEAR(EstimateEntropy(counts.data(), counts.size(),
+                              EntropyEstimator::kChaoShen),
+              chao_shen, kPrecision);
+
+  // Every p here is within [0.01, 0.99], so nothing is clipped...
+  EXPECT_NEAR(EstimateEntropy(counts.data(), counts.size(),
+                              EntropyEstimator::kClippedPlugIn),
+              plug_in, kPrecision);
+
+  // ...but bins with p below 0.01 or above 0.99 are.
+  const std::vector<double> skewed = { 995.0, 5.0 };
+  EXPECT_EQ(EstimateEntropy(skewed.data(), skewed.size(),
+                            EntropyEstimator::kClippedPlugIn), 0.0);
+
+  const std::vector<double> rare = { 200.0, 199.0, 1.0 };
+  EXPECT_NEAR(EstimateEntropy(rare.data(), rare.size(),
+                              EntropyEstimator::kClippedPlugIn),
+              -0.5 * log(0.5) - 0.4975 * log(0.4975), kPrecision);
+}
+
+// Check degenerate histograms.
+TEST(EntropyEstimators, TestDegenerate) {
+  const std::vector<double> empty(4, 0.0);
+  const std::vector<double> single = { 0.0, 5.0, 0.0 };
+  for (unsigned int ii = 0; ii <= 4; ii++) {
+    const EntropyEstimator estimator = static_cast<EntropyEstimator>(ii);
+    EXPECT_EQ(EstimateEntropy(empty.data(), empty.size(), estimator), 0.0);
+    EXPECT_NEAR(EstimateEntropy(single.data(), single.size(), estimator),
+                0.0, kPrecision);
+  }
+}
+
+// Check that the corrected estimators are less biased than plug-in on a
+// sparsely sampled uniform distribution.
+TEST(EntropyEstimators, TestBias) {
+  const unsigned int kNumBins = 64;
+  const unsigned int kNumSamples = 64;
+  const unsigned int kNumTrials = 200;
+  const double truth = log(static_cast<double>(kNumBins));
+
+  std::default_random_engine rng(0);
+  std::uniform_int_distribution<unsigned int> unif(0, kNumBins - 1);
+
+  const EntropyEstimator estimators[] = {
+    EntropyEstimator::kPlugIn, EntropyEstimator::kMillerMadow,
+    EntropyEstimator::kJackknife, EntropyEstimator::kChaoShen
+  };
+  double bias[4] = { 0.0, 0.0, 0.0, 0.0 };
+  for (unsigned int ii = 0; ii < kNumTrials; ii++) {
+    std::vector<double> counts(kNumBins, 0.0);
+    for (unsigned int jj = 0; jj < kNumSamples; jj++)
+      counts[unif(rng)] += 1.0;
+
+    for (unsigned int kk = 0; kk < 4; kk++)
+      bias[kk] += (EstimateEntropy(counts.data(), kNumBins, estimators[kk]) -
+                   truth) / kNumTrials;
+  }
+
+  EXPECT_LT(bias[0], -0.3);
+  for (unsigned int kk = 1; kk < 4; kk++)
+    EXPECT_LT(fabs(bias[kk]), fabs(bias[0]));
+}
+
+// Check that names round trip.
+TEST(EntropyEstimators, TestNames) {
+  for (unsigned int ii = 0; ii <= 4; ii++) {
+    const EntropyEstimator estimator = static_cast<EntropyEstimator>(ii);
+    EntropyEstimator parsed;
+    ASSERT_TRUE(ParseEntropyEstimator(EntropyEstimatorName(estimator),
+                                      parsed));
+    EXPECT_EQ(parsed, estimator);
+  }
+
+  EntropyEstimator parsed;
+  EXPECT_FALSE(ParseEntropyEstimator("nsb", parsed));
+}
+
+} // namespace radiation
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for entropy kernels.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <entropy_kernels.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+// Test FastLog against log over many orders of magnitude.
+TEST(EntropyKernels, TestFastLog) {
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(-300.0, 300.0);
+
+  for (unsigned int ii = 0; ii < 100000; ii++) {
+    const double x = pow(10.0, unif(rng));
+    EXPECT_NEAR(FastLog(x), log(x), 1e-13 * std::max(1.0, fabs(log(x))));
+  }
+
+  // Edges of the mantissa reduction.
+  const double kEdges[] = { 1.0, 0.5, 2.0, sqrt(2.0), sqrt(0.5), 1e-8,
+                            1.0 - 1e-8, 0.01, 0.99 };
+  for (const auto& x : kEdges)
+    EXPECT_NEAR(FastLog(x), log(x), 1e-13);
+}
+
+// Test both kernels against reference loops, for random arrays of every
+// length up to a few vector widths, including values on and beyond each
+// threshold, and with inputs scaled by the categorical kernel.
+TEST(EntropyKernels, TestKernels) {
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+
+  const double kSpecial[] = { 0.0, 1.0, 1e-9, 1e-8, 1.0 - 1e-8, 0.01, 0.99,
+                              0.005, 0.995 };
+  const size_t kNumSpecial = sizeof(kSpecial) / sizeof(kSpecial[0]);
+
+  for (size_t n = 0; n < 20; n++) {
+    std::vector<double> p(n);
+    for (size_t ii = 0; ii < n; ii++)
+      p[ii] = (ii % 3 == 0) ? kSpecial[(n + ii) % kNumSpecial] : unif(rng);
+
+    double bernoulli = 0.0;
+    double categorical = 0.0;
+    for (const auto& x : p) {
+      if (x > 1e-8 && x < 1.0 - 1e-8)
+        bernoulli -= x * log(x) + (1.0 - x) * log(1.0 - x);
+      if (x >= 0.01 && x <= 0.99)
+        categorical -= x * log(x);
+    }
+
+    EXPECT_NEAR(SumBernoulliEntropies(p.data(), n), bernoulli, 1e-12);
+    EXPECT_NEAR(CategoricalEntropy(p.data(), n, 0.01, 0.99), categorical,
+                1e-12);
+
+    // Scaling by a power of two is exact, so unnormalized inputs must hit
+    // the thresholds identically.
+    std::vector<double> counts(p);
+    for (auto& x : counts)
+      x *= 4.0;
+
+    EXPECT_NEAR(CategoricalEntropy(counts.data(), n, 0.01, 0.99, 0.25),
+                categorical, 1e-12);
+  }
+}
+
+} // namespace radiation
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for ExplorerLP.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <explorer_lp.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <grid_map_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+// Test that once the bottom half of the grid (low rows) has been seen to be
+// empty, the frontier planner heads up, toward the unexplored top half.
+TEST(ExplorerLP, TestFrontierHeadsToUnexplored) {
+  const unsigned int kNumRows = 12;
+  const unsigned int kNumCols = 12;
+  const unsigned int kNumSources = 1;
+  const unsigned int kNumSteps = 3;
+  const unsigned int kNumHeadings = 8;
+  const double kFov = 0.25 * M_PI;
+
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(0.25 * M_PI);
+
+  // Find a seed which puts the source in the top half, so that nothing seen
+  // from the bottom half measures it.
+  unsigned int seed = 0;
+  while (ExplorerLP(context, kNumSources, 1.0, kNumSteps, kFov, 10, seed)
+         .GetSources()[0].GetIndexX() < kNumRows / 2)
+    seed++;
+
+  ExplorerLP explorer(context, kNumSources, 1.0, kNumSteps, kFov, 10, seed);
+
+  // Look down from the middle row of every column, then park in the bottom
+  // half, facing down.
+  for (unsigned int jj = 0; jj < kNumCols; jj++) {
+    const std::vector<GridPose2D> step(
+      1, GridPose2D(context, kNumRows / 2 - 1, jj, M_PI));
+    explorer.TakeStep(step);
+  }
+
+  const GridPose2D start(context, 2u, kNumCols / 2, M_PI);
+  explorer.TakeStep(std::vector<GridPose2D>(1, start));
+  EXPECT_LT(explorer.GetMap().GetImmutableBelief().topRows(kNumRows / 2).sum(),
+            0.1);
+
+  // The frontier trajectory never drops below the start, and ends up
+  // looking into the unexplored half, which the start pose cannot see.
+  std::vector<GridPose2D> trajectory;
+  ASSERT_TRUE(explorer.PlanAheadFrontier(kNumHeadings, trajectory));
+  ASSERT_EQ(trajectory.size(), kNumSteps);
+  for (const auto& pose : trajectory)
+    EXPECT_GE(pose.GetX(), start.GetX());
+
+  const GridMap2D& map = explorer.GetMap();
+  EXPECT_LT(map.ExpectedMeasurement(Sensor2D(start, kFov)), 1e-3);
+  EXPECT_GT(map.ExpectedMeasurement(Sensor2D(trajectory.back(), kFov)),
+            0.05);
+
+  // Coarse-to-fine planning seeded with the frontier trajectory still
+  // returns a full trajectory.
+  ASSERT_TRUE(explorer.PlanAheadCoarseToFine(20, 5, 1, trajectory,
+                                             kNumHeadings));
+  EXPECT_EQ(trajectory.size(), kNumSteps);
+}
+
+} // namespace radiation
@@ -43,6 +43,7 @@
 #include <grid_map_2d.h>
 #include <sensor_2d.h>
 #include <source_2d.h>
+#include <context_2d.h>
 
 #include <gtest/gtest.h>
 #include <vector>
@@ -61,9 +62,8 @@ TEST(GridMap2D, TestEmptyMap) {
   const double kRegularizer = 0.0;
   const unsigned int kNumUpdates = 10;
 
-  // Set static variables.
-  GridPose2D::SetNumRows(kNumRows);
-  GridPose2D::SetNumCols(kNumCols);
+  // Set up grid dimensions.
+  const Context2D context(kNumRows, kNumCols);
 
   // Make random number generators.
   std::random_device rd;
@@ -74,13 +74,13 @@ TEST(GridMap2D, TestEmptyMap) {
   // Place an omnidirectional sensor at the origin.
   const double kAngle = 0.0;
   const double kFov = 2.0 * M_PI;
-  const GridPose2D sensor_pose(0.0, 0.0, kAngle);
+  const GridPose2D sensor_pose(context, 0.0, 0.0, kAngle);
   const Sensor2D sensor(sensor_pose, kFov);
 
   // Update a bunch of times, and check that the maps' 'belief' has
   // converged to zero.
   std::vector<Source2D> empty_sources;
-  GridMap2D map(kNumRows, kNumCols, kNumSources, kRegularizer);
+  GridMap2D map(context, kNumSources, kRegularizer);
 
   double belief_norm = map.GetImmutableBelief().norm();
   for (unsigned int ii = 0; ii < kNumUpdates; ii++) {
@@ -98,6 +98,42 @@ TEST(GridMap2D, TestEmptyMap) {
       EXPECT_NEAR(belief(ii, jj), 0.0, 1e-4);
 }
 
+// Test that a map constructed from a belief snapshot matches the original.
+TEST(GridMap2D, TestSnapshot) {
+  const unsigned int kNumRows = 5;
+  const unsigned int kNumCols = 5;
+  const unsigned int kNumSources = 2;
+  const double kRegularizer = 1.0;
+
+  // Set up grid dimensions.
+  const Context2D context(kNumRows, kNumCols);
+
+  // Update the original map once so that belief is no longer uniform.
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(1u, 1u));
+  sources.push_back(Source2D(3u, 4u));
+
+  GridMap2D map(context, kNumSources, kRegularizer);
+  const Sensor2D sensor(GridPose2D(context, 0.0, 0.0, 0.25 * M_PI), 0.2 * M_PI);
+  EXPECT_TRUE(map.Update(sensor, sources, true));
+
+  // Take a snapshot and check that belief and expected measurements match.
+  const GridMap2D snapshot(context, map.GetImmutableBelief(),
+                           kNumSources, kRegularizer);
+  EXPECT_EQ(snapshot.GetNumRows(), kNumRows);
+  EXPECT_EQ(snapshot.GetNumCols(), kNumCols);
+  EXPECT_EQ(snapshot.GetNumSources(), kNumSources);
+  EXPECT_NEAR((snapshot.GetImmutableBelief() -
+               map.GetImmutableBelief()).norm(), 0.0, 1e-12);
+  EXPECT_NEAR(snapshot.ExpectedMeasurement(sensor),
+              map.ExpectedMeasurement(sensor), 1e-12);
+
+  // An omnidirectional sensor sees the whole map.
+  const Sensor2D omni(GridPose2D(context, 0.0, 0.0, 0.0), 2.0 * M_PI);
+  EXPECT_NEAR(snapshot.ExpectedMeasurement(omni),
+              snapshot.GetImmutableBelief().sum(), 1e-12);
+}
+
 // Test that we can detect sources randomly located across the grid.
 TEST(GridMap2D, TestConvergenceSingleSource) {
   const unsigned int kNumRows = 5;
@@ -106,9 +142,8 @@ TEST(GridMap2D, TestConvergenceSingleSource) {
   const double kRegularizer = 1.0;
   const unsigned int kNumUpdates = 100;
 
-  // Set static variables.
-  GridPose2D::SetNumRows(kNumRows);
-  GridPose2D::SetNumCols(kNumCols);
+  // Set up grid dimensions.
+  const Context2D context(kNumRows, kNumCols);
 
   // Make random number generators.
   std::random_device rd;
@@ -123,14 +158,15 @@ TEST(GridMap2D, TestConvergenceSingleSource) {
     sources.push_back(Source2D(unif_rows(rng), unif_cols(rng)));
 
   // Create a new map.
-  GridMap2D map(kNumRows, kNumCols, kNumSources, kRegularizer);
+  GridMap2D map(context, kNumSources, kRegularizer);
 
   // Iterate the specified number of times. Each time, choose a random sensor
   // pose and take a measurement. Update the map and repeat.
   const double kFov = 0.2 * M_PI;
   double entropy = map.Entropy();
   for (unsigned int ii = 0; ii < kNumUpdates; ii++) {
-    const GridPose2D pose(unif_rows(rng), unif_cols(rng), unif_angle(rng));
+    const GridPose2D pose(context, unif_rows(rng), unif_cols(rng),
+                          unif_angle(rng));
     const Sensor2D sensor(pose, kFov);
 
     EXPECT_TRUE(map.Update(sensor, sources, true));
@@ -170,9 +206,8 @@ TEST(GridMap2D, TestConvergenceMultipleSources) {
   const double kRegularizer = 1.0;
   const unsigned int kNumUpdates = 200;
 
-  // Set static variables.
-  GridPose2D::SetNumRows(kNumRows);
-  GridPose2D::SetNumCols(kNumCols);
+  // Set up grid dimensions.
+  const Context2D context(kNumRows, kNumCols);
 
   // Make random number generators.
   std::random_device rd;
@@ -187,14 +222,15 @@ TEST(GridMap2D, TestConvergenceMultipleSources) {
     sources.push_back(Source2D(unif_rows(rng), unif_cols(rng)));
 
   // Create a new map.
-  GridMap2D map(kNumRows, kNumCols, kNumSources, kRegularizer);
+  GridMap2D map(context, kNumSources, kRegularizer);
 
   // Iterate the specified number of times. Each time, choose a random sensor
   // pose and take a measurement. Update the map and repeat.
   const double kFov = 0.2 * M_PI;
   double entropy = map.Entropy();
   for (unsigned int ii = 0; ii < kNumUpdates; ii++) {
-    const GridPose2D pose(unif_rows(rng), unif_cols(rng), unif_angle(rng));
+    const GridPose2D pose(context, unif_rows(rng), unif_cols(rng),
+                          unif_angle(rng));
     const Sensor2D sensor(pose, kFov);
 
     EXPECT_TRUE(map.Update(sensor, sources, true));
@@ -237,10 +273,9 @@ TEST(GridMap2D, TestDistributionConvergence) {
   const double kFov = 0.2 * M_PI;
   const double kPrecision = 0.02;
 
-  // Set static variables.
-  GridPose2D::SetNumRows(kNumRows);
-  GridPose2D::SetNumCols(kNumCols);
-  Movement2D::SetAngularStep(kAngularStep);
+  // Set up grid dimensions and movements.
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(kAngularStep);
 
   // Make random number generators.
   std::random_device rd;
@@ -250,14 +285,15 @@ TEST(GridMap2D, TestDistributionConvergence) {
   std::uniform_int_distribution<unsigned int> unif_angle(0.0, 2.0 * M_PI);
 
   // Create a new map.
-  GridMap2D map(kNumRows, kNumCols, kNumSources, 0.0 /* regularizer */);
+  GridMap2D map(context, kNumSources, 0.0 /* regularizer */);
 
   // Create a random initial pose.
-  const GridPose2D pose(unif_rows(rng), unif_cols(rng), unif_angle(rng));
+  const GridPose2D pose(context, unif_rows(rng), unif_cols(rng),
+                        unif_angle(rng));
 
   // Generate conditional entropies twice.
   Eigen::VectorXd hzx1, hzx2;
-  std::vector<unsigned int> trajectory_ids1, trajectory_ids2;
+  std::vector<Id64> trajectory_ids1, trajectory_ids2;
 
   map.GenerateEntropyVector(kNumSamples, kNumSteps, pose, kFov,
                             hzx1, trajectory_ids1);
@@ -286,4 +322,35 @@ TEST(GridMap2D, TestDistributionConvergence) {
   }
 }
 
+// Test that the sample histogram behind an entropy vector has a column of
+// counts per trajectory, and that every sample is counted at most once.
+TEST(GridMap2D, TestHistogram) {
+  const unsigned int kNumRows = 5;
+  const unsigned int kNumCols = 5;
+  const unsigned int kNumSources = 1;
+  const unsigned int kNumSteps = 2;
+  const unsigned int kNumSamples = 1000;
+  const double kFov = 0.2 * M_PI;
+
+  // Set up grid dimensions and movements.
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(0.25 * M_PI);
+
+  GridMap2D map(context, kNumSources, 1.0 /* regularizer */);
+  const GridPose2D pose(context, 2u, 2u, 0.0);
+
+  Eigen::VectorXd hzx;
+  std::vector<Id64> trajectory_ids;
+  Eigen::MatrixXd histogram;
+  map.GenerateEntropyVector(kNumSamples, kNumSteps, pose, kFov, hzx,
+                            trajectory_ids, EntropyEstimator::kClippedPlugIn,
+                            &histogram);
+
+  ASSERT_EQ(histogram.cols(), static_cast<int>(trajectory_ids.size()));
+  ASSERT_EQ(hzx.rows(), histogram.cols());
+  for (int jj = 0; jj < histogram.cols(); jj++)
+    EXPECT_GE(histogram.col(jj).sum(), 1.0);
+  EXPECT_LE(histogram.sum(), kNumSamples);
+}
+
 } // namespace radiation
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for GridMap3D, Sensor3D, and 3D trajectory encoding.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <grid_map_3d.h>
+#include <context_3d.h>
+#include <sensor_3d.h>
+#include <source_3d.h>
+#include <movement_3d.h>
+#include <encoding.h>
+#include <trajectory_sampler.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Reference line of sight, by stepping finely along the segment, as in
+// test_visibility_cache_2d.cpp. Samples are offset so that they never land
+// exactly on a voxel edge or corner, which the segment only touches.
+bool SampledLineOfSight(const Context3D& context, double x, double y,
+                        double z, unsigned int ii, unsigned int jj,
+                        unsigned int kk) {
+  const unsigned int kNumSteps = 2000;
+  const double kOffset = 0.318;
+  const double dx = static_cast<double>(ii) + 0.5 - x;
+  const double dy = static_cast<double>(jj) + 0.5 - y;
+  const double dz = static_cast<double>(kk) + 0.5 - z;
+
+  for (unsigned int step = 0; step < kNumSteps; step++) {
+    const double t = (static_cast<double>(step) + kOffset) / kNumSteps;
+    const unsigned int cx = static_cast<unsigned int>(x + t * dx);
+    const unsigned int cy = static_cast<unsigned int>(y + t * dy);
+    const unsigned int cz = static_cast<unsigned int>(z + t * dz);
+    if ((cx == ii && cy == jj && cz == kk) ||
+        (cx == static_cast<unsigned int>(x) &&
+         cy == static_cast<unsigned int>(y) &&
+         cz == static_cast<unsigned int>(z)))
+      continue;
+
+    if (context.IsObstacle(cx, cy, cz))
+      return false;
+  }
+
+  return true;
+}
+} // namespace
+
+// Test that a wall blocks line of sight, and that traversal matches a
+// brute-force reference among random obstacles.
+TEST(Context3D, TestLineOfSight) {
+  const unsigned int kNumRows = 8;
+  const unsigned int kNumCols = 8;
+  const unsigned int kNumLayers = 5;
+  const unsigned int kNumObstacles = 30;
+  const unsigned int kNumTrials = 10;
+
+  Context3D context(kNumRows, kNumCols, kNumLayers);
+  EXPECT_FALSE(context.HasObstacles());
+  EXPECT_TRUE(context.LineOfSight(0.5, 0.5, 0.5, 7, 7, 4));
+
+  // A wall across row 4, with a gap in the top layer.
+  for (unsigned int jj = 0; jj < kNumCols; jj++)
+    for (unsigned int kk = 0; kk + 1 < kNumLayers; kk++)
+      context.SetObstacle(4, jj, kk);
+  EXPECT_TRUE(context.HasObstacles());
+
+  EXPECT_FALSE(context.LineOfSight(0.5, 0.5, 0.5, 7, 0, 0));
+  EXPECT_FALSE(context.LineOfSight(1.5, 3.5, 2.5, 6, 3, 2));
+  EXPECT_TRUE(context.LineOfSight(1.5, 3.5, 4.5, 6, 3, 4));
+  EXPECT_TRUE(context.LineOfSight(0.5, 0.5, 0.5, 4, 0, 0));
+
+  for (unsigned int jj = 0; jj < kNumCols; jj++)
+    for (unsigned int kk = 0; kk + 1 < kNumLayers; kk++)
+      context.SetObstacle(4, jj, kk, false);
+  EXPECT_FALSE(context.HasObstacles());
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_int_distribution<unsigned int> unif_rows(0, kNumRows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, kNumCols - 1);
+  std::uniform_int_distribution<unsigned int> unif_layers(0, kNumLayers - 1);
+  for (unsigned int ii = 0; ii < kNumObstacles; ii++)
+    context.SetObstacle(unif_rows(rng), unif_cols(rng), unif_layers(rng));
+
+  for (unsigned int trial = 0; trial < kNumTrials; trial++) {
+    const double x = unif_rows(rng) + 0.5;
+    const double y = unif_cols(rng) + 0.5;
+    const double z = unif_layers(rng) + 0.5;
+    for (unsigned int ii = 0; ii < kNumRows; ii++)
+      for (unsigned int jj = 0; jj < kNumCols; jj++)
+        for (unsigned int kk = 0; kk < kNumLayers; kk++)
+          EXPECT_EQ(context.LineOfSight(x, y, z, ii, jj, kk),
+                    SampledLineOfSight(context, x, y, z, ii, jj, kk))
+            << "from (" << x << ", " << y << ", " << z << ") to ("
+            << ii << ", " << jj << ", " << kk << ")";
+  }
+}
+
+// Test that the conic field of view is rasterized exactly.
+TEST(Sensor3D, TestVoxelsInView) {
+  const unsigned int kNumRows = 13;
+  const unsigned int kNumCols = 9;
+  const unsigned int kNumLayers = 7;
+  const unsigned int kNumTrials = 50;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif_x(-2.0, kNumRows + 2.0);
+  std::uniform_real_distribution<double> unif_y(-2.0, kNumCols + 2.0);
+  std::uniform_real_distribution<double> unif_z(-2.0, kNumLayers + 2.0);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+  std::uniform_real_distribution<double> unif_fov(0.05, 1.5 * M_PI);
+
+  for (unsigned int tt = 0; tt < kNumTrials; tt++) {
+    const Sensor3D sensor(unif_x(rng), unif_y(rng), unif_z(rng),
+                          unif_angle(rng), unif_fov(rng));
+
+    std::vector<unsigned int> expected;
+    for (unsigned int kk = 0; kk < kNumLayers; kk++)
+      for (unsigned int jj = 0; jj < kNumCols; jj++)
+        for (unsigned int ii = 0; ii < kNumRows; ii++)
+          if (sensor.VoxelInView(ii, jj, kk))
+            expected.push_back(ii + kNumRows * (jj + kNumCols * kk));
+
+    std::vector<unsigned int> voxels;
+    sensor.VoxelsInView(kNumRows, kNumCols, kNumLayers, voxels);
+    EXPECT_EQ(voxels, expected);
+  }
+}
+
+// Test that 3D trajectories survive an encode/decode round trip.
+TEST(Encoding, TestTrajectory3D) {
+  const unsigned int kNumSteps = 3;
+  const Context3D context(10, 10, 10);
+  const GridPose3D initial_pose(context, 5u, 5u, 5u, 0.0);
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+
+  std::vector<Movement3D> movements;
+  std::vector<GridPose3D> expected;
+  GridPose3D pose = initial_pose;
+  for (unsigned int ii = 0; ii < kNumSteps; ii++) {
+    const Movement3D step(context, rng);
+    ASSERT_TRUE(pose.MoveBy(step));
+    movements.push_back(step);
+    expected.push_back(pose);
+  }
+
+  std::vector<GridPose3D> trajectory;
+  DecodeTrajectory(EncodeTrajectory(movements, context), kNumSteps,
+                   initial_pose, trajectory);
+  ASSERT_EQ(trajectory.size(), kNumSteps);
+  for (unsigned int ii = 0; ii < kNumSteps; ii++) {
+    EXPECT_NEAR(trajectory[ii].GetX(), expected[ii].GetX(), 1e-12);
+    EXPECT_NEAR(trajectory[ii].GetY(), expected[ii].GetY(), 1e-12);
+    EXPECT_NEAR(trajectory[ii].GetZ(), expected[ii].GetZ(), 1e-12);
+    EXPECT_NEAR(trajectory[ii].GetAngle(), expected[ii].GetAngle(), 1e-12);
+  }
+}
+
+// Test that only viewed voxels are allocated, that sensing through the cache
+// agrees with the sensor, and that entropy accounts for the background.
+TEST(GridMap3D, TestAllocatesViewedVoxels) {
+  const unsigned int kNumRows = 8;
+  const unsigned int kNumCols = 8;
+  const unsigned int kNumLayers = 4;
+  const unsigned int kNumSources = 2;
+  const unsigned int kNumVoxels = kNumRows * kNumCols * kNumLayers;
+  const unsigned int kNumSamples = 100;
+
+  const Context3D context(kNumRows, kNumCols, kNumLayers);
+  GridMap3D map(context, kNumSources, 0.01);
+
+  const double p = map.GetPrior();
+  const double prior_entropy = -p * log(p) - (1.0 - p) * log(1.0 - p);
+  EXPECT_EQ(map.GetNumAllocated(), 0u);
+  EXPECT_NEAR(map.Entropy(), kNumVoxels * prior_entropy, 1e-8);
+
+  std::vector<Source3D> sources;
+  sources.push_back(Source3D(6u, 1u, 1u));
+  sources.push_back(Source3D(1u, 6u, 3u));
+  const Sensor3D sensor(GridPose3D(context, 0u, 1u, 1u, 0.0), 0.2 * M_PI);
+  EXPECT_EQ(map.Sense(sensor, sources), sensor.Sense(sources));
+  EXPECT_EQ(map.GetNumCachedPoses(), 1u);
+
+  EXPECT_TRUE(map.Update(sensor, sources, true));
+  const std::vector<unsigned int>& visible = map.VisibleVoxels(sensor);
+  EXPECT_EQ(map.GetNumAllocated(), visible.size());
+  EXPECT_EQ(map.GetNumCachedPoses(), 1u);
+  EXPECT_NEAR(map.GetBelief(1, 6, 3), p, 1e-12);
+
+  // Total belief over the viewed voxels matches the measurement, and
+  // entropy is the sum over viewed voxels and the background.
+  double total = 0.0;
+  double entropy = (kNumVoxels - visible.size()) * prior_entropy;
+  for (const auto& voxel : visible) {
+    const double q = map.GetBelief(voxel % kNumRows,
+                                   (voxel / kNumRows) % kNumCols,
+                                   voxel / (kNumRows * kNumCols));
+    total += q;
+    if (q > 1e-8 && q < 1.0 - 1e-8)
+      entropy -= q * log(q) + (1.0 - q) * log(1.0 - q);
+  }
+  EXPECT_NEAR(total, 1.0, 0.1);
+  EXPECT_NEAR(map.Entropy(), entropy, 1e-6);
+
+  // Sampled sources always lie within bounds.
+  for (unsigned int ii = 0; ii < kNumSamples; ii++) {
+    std::vector<Source3D> sampled;
+    ASSERT_TRUE(map.GenerateSources(sampled));
+    ASSERT_EQ(sampled.size(), kNumSources);
+    for (const auto& source : sampled) {
+      EXPECT_LT(source.GetIndexX(), kNumRows);
+      EXPECT_LT(source.GetIndexY(), kNumCols);
+      EXPECT_LT(source.GetIndexZ(), kNumLayers);
+    }
+  }
+}
+
+// Test that obstacles hide what lies behind them, from sensing and from
+// updates, and block movement.
+TEST(GridMap3D, TestOcclusion) {
+  const unsigned int kNumRows = 12;
+  const unsigned int kNumCols = 6;
+  const unsigned int kNumLayers = 4;
+  const unsigned int kWall = 6;
+
+  Context3D context(kNumRows, kNumCols, kNumLayers);
+  for (unsigned int jj = 0; jj < kNumCols; jj++)
+    for (unsigned int kk = 0; kk < kNumLayers; kk++)
+      context.SetObstacle(kWall, jj, kk);
+
+  GridMap3D map(context, 2, 0.01);
+  std::vector<Source3D> sources;
+  sources.push_back(Source3D(3u, 2u, 1u));
+  sources.push_back(Source3D(9u, 2u, 1u));
+  const Sensor3D sensor(GridPose3D(context, 1u, 2u, 1u, 0.0), 0.5 * M_PI);
+  EXPECT_EQ(sensor.Sense(sources), 2u);
+  EXPECT_EQ(map.Sense(sensor, sources), 1u);
+
+  const std::vector<unsigned int>& visible = map.VisibleVoxels(sensor);
+  EXPECT_FALSE(visible.empty());
+  for (const auto& voxel : visible)
+    EXPECT_LE(voxel % kNumRows, kWall);
+
+  EXPECT_TRUE(map.Update(sensor, sources, true));
+  EXPECT_NEAR(map.GetBelief(9, 2, 1), map.GetPrior(), 1e-12);
+
+  // Poses cannot move into the wall, but can move away from it.
+  GridPose3D pose(context, 5u, 2u, 1u, 0.0);
+  EXPECT_FALSE(pose.MoveBy(Movement3D(context, 2, 1, 1, 1)));
+  EXPECT_TRUE(pose.MoveBy(Movement3D(context, 0, 1, 1, 1)));
+}
+
+// Test that the visible set cache is keyed on voxel and heading, and bounded.
+TEST(GridMap3D, TestBoundedCache) {
+  const unsigned int kNumHeadings = 8;
+  const unsigned int kMaxCached = 2;
+  const Context3D context(6, 6, 3);
+  GridMap3D map(context, 1, 1.0, kNumHeadings, kMaxCached);
+
+  // Poses in the same voxel, with headings in the same bin, share an entry
+  // computed from the voxel center and the bin's heading.
+  const Sensor3D center(GridPose3D(context, 1u, 2u, 1u, 0.0), 0.3 * M_PI);
+  const Sensor3D offset(1.2, 2.9, 1.7, 0.1, 0.3 * M_PI);
+  std::vector<unsigned int> expected;
+  center.VoxelsInView(6, 6, 3, expected);
+  EXPECT_EQ(map.VisibleVoxels(center), expected);
+  EXPECT_EQ(map.VisibleVoxels(offset), expected);
+  EXPECT_EQ(map.GetNumCachedPoses(), 1u);
+
+  // A different field of view replaces the entry.
+  const Sensor3D wide(GridPose3D(context, 1u, 2u, 1u, 0.0), 0.6 * M_PI);
+  wide.VoxelsInView(6, 6, 3, expected);
+  EXPECT_EQ(map.VisibleVoxels(wide), expected);
+  EXPECT_EQ(map.GetNumCachedPoses(), 1u);
+
+  // Other headings and voxels add entries, up to the bound.
+  for (unsigned int hh = 0; hh < kNumHeadings; hh++) {
+    const Sensor3D sensor(GridPose3D(context, 3u, 3u, 1u,
+                                     2.0 * M_PI * hh / kNumHeadings),
+                          0.3 * M_PI);
+    sensor.VoxelsInView(6, 6, 3, expected);
+    EXPECT_EQ(map.VisibleVoxels(sensor), expected);
+    EXPECT_LE(map.GetNumCachedPoses(), kMaxCached);
+  }
+
+  EXPECT_EQ(map.GetNumCachedPoses(), kMaxCached);
+
+  // Sensors outside the map are never cached.
+  const Sensor3D outside(-1.0, 2.5, 1.5, 0.0, 0.3 * M_PI);
+  outside.VoxelsInView(6, 6, 3, expected);
+  EXPECT_EQ(map.VisibleVoxels(outside), expected);
+  EXPECT_EQ(map.GetNumCachedPoses(), kMaxCached);
+}
+
+// Test that a single source is localized from random seeded measurements.
+TEST(GridMap3D, TestConvergenceSingleSource) {
+  const unsigned int kNumRows = 5;
+  const unsigned int kNumCols = 5;
+  const unsigned int kNumLayers = 3;
+  const unsigned int kNumSources = 1;
+  const double kRegularizer = 1.0;
+  const unsigned int kNumUpdates = 100;
+  const double kFov = 0.3 * M_PI;
+
+  // Set up grid dimensions.
+  const Context3D context(kNumRows, kNumCols, kNumLayers);
+
+  // Make seeded random number generators.
+  std::default_random_engine rng(0);
+  std::uniform_int_distribution<unsigned int> unif_rows(0, kNumRows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, kNumCols - 1);
+  std::uniform_int_distribution<unsigned int> unif_layers(0, kNumLayers - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  // Choose a random source location.
+  std::vector<Source3D> sources;
+  sources.push_back(Source3D(unif_rows(rng), unif_cols(rng),
+                             unif_layers(rng)));
+
+  // Create a new map.
+  GridMap3D map(context, kNumSources, kRegularizer);
+  map.Seed(rng());
+
+  // Iterate the specified number of times. Each time, choose a random sensor
+  // pose and take a measurement. Update the map and repeat.
+  double entropy = map.Entropy();
+  for (unsigned int ii = 0; ii < kNumUpdates; ii++) {
+    const GridPose3D pose(context, unif_rows(rng), unif_cols(rng),
+                          unif_layers(rng), unif_angle(rng));
+    const Sensor3D sensor(pose, kFov);
+
+    EXPECT_TRUE(map.Update(sensor, sources, true));
+
+    // Make sure entropy has not increased by much.
+    const double updated_entropy = map.Entropy();
+    EXPECT_LE(updated_entropy, 2.0 * entropy);
+    entropy = updated_entropy;
+  }
+
+  // Check that belief has converged to the truth.
+  for (unsigned int kk = 0; kk < kNumLayers; kk++) {
+    for (unsigned int jj = 0; jj < kNumCols; jj++) {
+      for (unsigned int ii = 0; ii < kNumRows; ii++) {
+        if (sources[0].GetIndexX() == ii && sources[0].GetIndexY() == jj &&
+            sources[0].GetIndexZ() == kk)
+          EXPECT_GE(map.GetBelief(ii, jj, kk), 1.0 - 1e-4);
+        else
+          EXPECT_LE(map.GetBelief(ii, jj, kk), 1e-4);
+      }
+    }
+  }
+}
+
+// Test that the shared planner runs on a 3D map.
+TEST(GridMap3D, TestPlanTrajectory) {
+  const unsigned int kNumRows = 6;
+  const unsigned int kNumCols = 6;
+  const unsigned int kNumLayers = 3;
+  const unsigned int kNumSources = 1;
+  const unsigned int kNumSteps = 2;
+  const unsigned int kNumSamples = 200;
+
+  const Context3D context(kNumRows, kNumCols, kNumLayers);
+  GridMap3D map(context, kNumSources, 1.0);
+  map.Seed(0);
+
+  const GridPose3D pose(context, 3u, 3u, 1u, 0.0);
+  std::vector<GridPose3D> trajectory;
+  ASSERT_TRUE(PlanTrajectory(map, kNumSamples, kNumSteps, pose,
+                             0.5 * M_PI, trajectory));
+  ASSERT_EQ(trajectory.size(), kNumSteps);
+  for (const auto& step : trajectory) {
+    EXPECT_LE(step.GetX(), kNumRows);
+    EXPECT_LE(step.GetY(), kNumCols);
+    EXPECT_LE(step.GetZ(), kNumLayers);
+  }
+}
+
+} // namespace radiation
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for InformationField2D.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <information_field_2d.h>
+#include <sensor_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+// Test that fields computed by FFT match direct summation over the voxels in
+// view from every cell center.
+TEST(InformationField2D, TestMatchesDirect) {
+  const unsigned int kNumRows = 11;
+  const unsigned int kNumCols = 7;
+  const unsigned int kNumHeadings = 8;
+  const double kFov = 0.3 * M_PI;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  Eigen::MatrixXd belief(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      belief(ii, jj) = unif(rng);
+
+  const InformationField2D field(kNumRows, kNumCols, kFov, kNumHeadings);
+  std::vector<Eigen::MatrixXd> means, variances;
+  field.Compute(belief, means, variances);
+  ASSERT_EQ(means.size(), kNumHeadings);
+  ASSERT_EQ(variances.size(), kNumHeadings);
+
+  for (unsigned int hh = 0; hh < kNumHeadings; hh++) {
+    for (unsigned int ii = 0; ii < kNumRows; ii++) {
+      for (unsigned int jj = 0; jj < kNumCols; jj++) {
+        const Sensor2D sensor(ii + 0.5, jj + 0.5, field.GetHeading(hh), kFov);
+
+        double mean = 0.0, variance = 0.0;
+        for (unsigned int kk = 0; kk < kNumRows; kk++) {
+          for (unsigned int ll = 0; ll < kNumCols; ll++) {
+            if (!sensor.VoxelInView(kk, ll))
+              continue;
+
+            const double p = belief(kk, ll);
+            mean += p;
+            variance += p * (1.0 - p);
+          }
+        }
+
+        EXPECT_NEAR(means[hh](ii, jj), mean, 1e-9);
+        EXPECT_NEAR(variances[hh](ii, jj), variance, 1e-9);
+      }
+    }
+  }
+}
+
+// Test that angles map to the nearest heading, wrapping around.
+TEST(InformationField2D, TestNearestHeading) {
+  const InformationField2D field(3, 3, 0.5 * M_PI, 4);
+  EXPECT_EQ(field.NearestHeading(0.0), 0u);
+  EXPECT_EQ(field.NearestHeading(0.5 * M_PI + 0.1), 1u);
+  EXPECT_EQ(field.NearestHeading(2.0 * M_PI - 0.1), 0u);
+  EXPECT_EQ(field.NearestHeading(-0.5 * M_PI), 3u);
+}
+
+} // namespace radiation
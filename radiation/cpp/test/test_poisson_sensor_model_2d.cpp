@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for PoissonSensorModel2D.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <poisson_sensor_model_2d.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+// Test that precomputed weights follow the inverse-square law within the
+// field of view, and that expected counts agree for sources and beliefs.
+TEST(PoissonSensorModel2D, TestExpectedCounts) {
+  const unsigned int kNumRows = 12;
+  const unsigned int kNumCols = 10;
+  const double kFov = 0.4 * M_PI;
+  const double kStrength = 2.0;
+  const double kBackground = 0.1;
+
+  const Context2D context(kNumRows, kNumCols);
+  std::vector<GridPose2D> poses;
+  poses.push_back(GridPose2D(context, 0.0, 0.0, 0.25 * M_PI));
+  poses.push_back(GridPose2D(context, 6u, 5u, M_PI));
+  poses.push_back(GridPose2D(context, 11u, 2u, 0.5 * M_PI));
+  const PoissonSensorModel2D model(context, poses, kFov,
+                                   kStrength, kBackground);
+  ASSERT_EQ(model.GetNumPoses(), poses.size());
+
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(4u, 4u));
+  sources.push_back(Source2D(1u, 7u));
+  sources.push_back(Source2D(6u, 5u));
+
+  Eigen::MatrixXd belief = Eigen::MatrixXd::Zero(kNumRows, kNumCols);
+  for (const auto& source : sources)
+    belief(source.GetIndexX(), source.GetIndexY()) += 1.0;
+
+  Eigen::VectorXd from_sources, from_belief;
+  model.ExpectedCounts(sources, from_sources);
+  model.ExpectedCounts(belief, from_belief);
+
+  for (size_t ii = 0; ii < poses.size(); ii++) {
+    const Sensor2D sensor(poses[ii], kFov);
+    double expected = kBackground;
+    for (const auto& source : sources) {
+      if (!sensor.SourceInView(source))
+        continue;
+
+      const double dx = source.GetX() - sensor.GetX();
+      const double dy = source.GetY() - sensor.GetY();
+      expected += kStrength / std::max(dx * dx + dy * dy,
+                                       PoissonSensorModel2D::kMinDistanceSq);
+    }
+
+    EXPECT_NEAR(model.ExpectedCount(ii, sources), expected, 1e-12);
+    EXPECT_NEAR(from_sources(ii), expected, 1e-12);
+    EXPECT_NEAR(from_belief(ii), expected, 1e-12);
+  }
+}
+
+// Test tabulated log-factorials, likelihoods, and entropies.
+TEST(PoissonSensorModel2D, TestTables) {
+  const Context2D context(4, 4);
+  const PoissonSensorModel2D model(context, std::vector<GridPose2D>(),
+                                   0.5 * M_PI, 1.0, 0.0);
+
+  for (unsigned int kk = 0; kk < 2 * PoissonSensorModel2D::kMaxCount; kk++)
+    EXPECT_NEAR(model.LogFactorial(kk), lgamma(kk + 1.0), 1e-8 * (kk + 1));
+
+  const double rates[] = { 0.0, 0.003, 0.5, 1.234, 7.0, 31.99, 40.0, 100.0 };
+  for (const double rate : rates) {
+    // Direct summation of -p log p.
+    double entropy = 0.0;
+    double total = 0.0;
+    for (unsigned int kk = 0; kk < 1000; kk++) {
+      const double p = exp(model.LogLikelihood(kk, rate));
+      total += p;
+      if (p > 0.0)
+        entropy -= p * log(p);
+    }
+
+    EXPECT_NEAR(total, 1.0, 1e-8);
+    EXPECT_NEAR(model.Entropy(rate), entropy, 1e-4 + 1e-4 * entropy);
+  }
+}
+
+// Test tabulated pmfs, and mixtures of them, against direct evaluation.
+TEST(PoissonSensorModel2D, TestMixturePmf) {
+  const Context2D context(4, 4);
+  const PoissonSensorModel2D model(context, std::vector<GridPose2D>(),
+                                   0.5 * M_PI, 1.0, 0.0);
+  const unsigned int kMaxCount = PoissonSensorModel2D::kMaxCount;
+
+  const double rates[] = { 0.0, 0.003, 0.5, 1.234, 7.0, 31.99, 40.0 };
+  for (const double rate : rates) {
+    for (unsigned int kk = 0; kk < 2 * kMaxCount; kk++)
+      EXPECT_NEAR(model.Pmf(kk, rate), exp(model.LogLikelihood(kk, rate)),
+                  1e-5);
+
+    // A mixture of one rate is just its pmf, whose entropy is tabulated.
+    const std::vector<double> single(1, rate);
+    Eigen::VectorXd pmf;
+    model.MixturePmf(single, pmf);
+    ASSERT_EQ(static_cast<unsigned int>(pmf.size()), kMaxCount + 1);
+    EXPECT_NEAR(pmf.sum(), 1.0, 1e-6);
+    EXPECT_NEAR(model.MixtureEntropy(single), model.Entropy(rate), 1e-4);
+  }
+
+  // A mixture of many sampled rates matches direct summation.
+  std::default_random_engine rng(0);
+  std::uniform_real_distribution<double> unif(0.0, 20.0);
+  std::vector<double> sampled(200);
+  for (auto& rate : sampled)
+    rate = unif(rng);
+
+  Eigen::VectorXd pmf;
+  model.MixturePmf(sampled, pmf);
+  double entropy = 0.0;
+  for (unsigned int kk = 0; kk <= kMaxCount; kk++) {
+    double expected = 0.0;
+    for (const auto& rate : sampled)
+      expected += exp(model.LogLikelihood(kk, rate)) / sampled.size();
+
+    EXPECT_NEAR(pmf(kk), expected, 1e-5);
+    if (expected > 0.0)
+      entropy -= expected * log(expected);
+  }
+
+  EXPECT_NEAR(model.MixtureEntropy(sampled), entropy, 1e-4);
+  EXPECT_GT(model.MixtureEntropy(sampled), model.Entropy(10.0));
+}
+
+} // namespace radiation
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for QuadTree2D.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <quad_tree_2d.h>
+#include <grid_map_2d.h>
+#include <context_2d.h>
+#include <sensor_2d.h>
+#include <visibility_cache_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <limits>
+#include <math.h>
+
+namespace radiation {
+
+// Test that aggregates match the underlying belief.
+TEST(QuadTree2D, TestAggregates) {
+  const unsigned int kNumRows = 13;
+  const unsigned int kNumCols = 7;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+
+  Eigen::MatrixXd belief(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      belief(ii, jj) = unif(rng);
+
+  // Load the same belief into a map so we can compare entropies.
+  const Context2D context(kNumRows, kNumCols);
+  const GridMap2D map(context, belief, 1, 1.0);
+  const QuadTree2D tree(belief);
+
+  EXPECT_NEAR(tree.GetSum(), belief.sum(), 1e-8);
+  EXPECT_NEAR(tree.GetEntropy(), map.Entropy(), 1e-8);
+
+  // Every node's sum must equal the sum over its rectangle.
+  for (unsigned int ii = 0; ii < tree.GetNumNodes(); ii++) {
+    const QuadTree2D::Node& node = tree.GetNode(ii);
+    EXPECT_LT(node.level_, tree.GetNumLevels());
+    EXPECT_NEAR(node.sum_, belief.block(node.row_, node.col_,
+                                        node.num_rows_,
+                                        node.num_cols_).sum(), 1e-8);
+  }
+}
+
+// Test that coarse visibility never contradicts the per-voxel test, and that
+// expected measurements are exact at the finest level.
+TEST(QuadTree2D, TestVisibility) {
+  const unsigned int kNumRows = 20;
+  const unsigned int kNumCols = 17;
+  const unsigned int kNumTrials = 100;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  std::uniform_real_distribution<double> unif_x(0.0, kNumRows);
+  std::uniform_real_distribution<double> unif_y(0.0, kNumCols);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+  std::uniform_real_distribution<double> unif_fov(0.0, 1.5 * M_PI);
+
+  Eigen::MatrixXd belief(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      belief(ii, jj) = unif(rng);
+
+  const Context2D context(kNumRows, kNumCols);
+  const GridMap2D map(context, belief, 1, 1.0);
+  const QuadTree2D tree(belief);
+
+  for (unsigned int trial = 0; trial < kNumTrials; trial++) {
+    const Sensor2D sensor(unif_x(rng), unif_y(rng), unif_angle(rng),
+                          unif_fov(rng));
+
+    for (unsigned int ii = 0; ii < tree.GetNumNodes(); ii++) {
+      const QuadTree2D::Node& node = tree.GetNode(ii);
+      const QuadTree2D::Visibility visibility = tree.NodeInView(sensor, ii);
+      if (visibility == QuadTree2D::kPartiallyInView)
+        continue;
+
+      for (unsigned int jj = 0; jj < node.num_rows_; jj++) {
+        for (unsigned int kk = 0; kk < node.num_cols_; kk++) {
+          EXPECT_EQ(sensor.VoxelInView(node.row_ + jj, node.col_ + kk),
+                    visibility == QuadTree2D::kInView);
+        }
+      }
+    }
+
+    EXPECT_NEAR(tree.ExpectedMeasurement(sensor, tree.GetNumLevels()),
+                map.ExpectedMeasurement(sensor), 1e-8);
+  }
+}
+
+// Test that sampled sources follow the belief distribution.
+TEST(QuadTree2D, TestSampling) {
+  const unsigned int kNumRows = 6;
+  const unsigned int kNumCols = 5;
+  const unsigned int kNumSamples = 100000;
+  const double kPrecision = 0.01;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+
+  Eigen::MatrixXd belief(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      belief(ii, jj) = unif(rng);
+
+  const QuadTree2D tree(belief);
+
+  Eigen::MatrixXd counts = Eigen::MatrixXd::Zero(kNumRows, kNumCols);
+  std::vector<Source2D> sources;
+  ASSERT_TRUE(tree.GenerateSources(rng, kNumSamples, sources));
+  ASSERT_EQ(sources.size(), kNumSamples);
+  for (const auto& source : sources)
+    counts(source.GetIndexX(), source.GetIndexY()) += 1.0;
+
+  counts /= static_cast<double>(kNumSamples);
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      EXPECT_NEAR(counts(ii, jj), belief(ii, jj) / belief.sum(), kPrecision);
+
+  // Coarse samples stop at the requested level.
+  std::vector<unsigned int> nodes;
+  tree.SampleNodes(rng, 100, 1, nodes);
+  for (const auto& id : nodes)
+    EXPECT_LE(tree.GetNode(id).level_, 1u);
+}
+
+// Test that refinement follows the belief: a node holding most of the belief
+// is refined past the coarse level, and negligible nodes are not refined.
+TEST(QuadTree2D, TestMassRefinement) {
+  const unsigned int kNumRows = 32;
+  const unsigned int kNumCols = 32;
+  const double kBackground = 1e-7;
+  const double kInfinity = std::numeric_limits<double>::infinity();
+
+  // Nearly all belief sits in one voxel, just inside the field of view.
+  Eigen::MatrixXd belief =
+    Eigen::MatrixXd::Constant(kNumRows, kNumCols, kBackground);
+  belief(20, 17) = 1.0;
+
+  const Context2D context(kNumRows, kNumCols);
+  const GridMap2D map(context, belief, 1, 1.0);
+  const QuadTree2D tree(belief);
+  const Sensor2D sensor(GridPose2D(context, 20u, 2u, 0.5 * M_PI),
+                        0.1 * M_PI);
+  ASSERT_TRUE(sensor.VoxelInView(20, 17));
+
+  // Refining by mass alone, from the root, finds the source exactly, up to
+  // the background belief left unrefined.
+  const double exact = map.ExpectedMeasurement(sensor);
+  EXPECT_NEAR(tree.ExpectedMeasurement(sensor, 0, 0.5, 1e-3, nullptr), exact,
+              kNumRows * kNumCols * kBackground);
+  EXPECT_NEAR(tree.ExpectedMeasurement(sensor, 0, 0.0, 0.0, nullptr), exact,
+              1e-8);
+
+  // Without mass refinement the coarse estimate is off by far more, and a
+  // minimum mass above the total stops refinement at the root.
+  EXPECT_GT(std::abs(tree.ExpectedMeasurement(sensor, 1) - exact), 0.1);
+  EXPECT_EQ(tree.ExpectedMeasurement(sensor, tree.GetNumLevels(),
+                                     kInfinity, 2.0, nullptr),
+            tree.ExpectedMeasurement(sensor, 0));
+}
+
+// Test that expected measurements through a sensor's view account for
+// obstacles, exactly at the deepest level.
+TEST(QuadTree2D, TestOcclusion) {
+  const unsigned int kNumRows = 20;
+  const unsigned int kNumCols = 17;
+  const unsigned int kNumTrials = 50;
+  const double kInfinity = std::numeric_limits<double>::infinity();
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  std::uniform_int_distribution<unsigned int> unif_rows(0, kNumRows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, kNumCols - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int jj = 3; jj < kNumCols; jj++)
+    context.SetObstacle(10, jj);
+
+  Eigen::MatrixXd belief(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      belief(ii, jj) = unif(rng);
+
+  const GridMap2D map(context, belief, 1, 1.0);
+  const QuadTree2D tree(belief);
+  VisibilityCache2D visibility(context);
+
+  for (unsigned int trial = 0; trial < kNumTrials; trial++) {
+    const Sensor2D sensor(GridPose2D(context, unif_rows(rng), unif_cols(rng),
+                                     unif_angle(rng)), 0.5 * M_PI);
+    const VisibilityCache2D::View* view = visibility.GetView(sensor);
+    ASSERT_TRUE(view != nullptr);
+
+    const double exact = map.ExpectedMeasurement(sensor);
+    EXPECT_NEAR(tree.ExpectedMeasurement(sensor, tree.GetNumLevels(),
+                                         kInfinity, 0.0, view), exact, 1e-8);
+    EXPECT_NEAR(tree.ExpectedMeasurement(sensor, 0, 0.0, 0.0, view), exact,
+                1e-8);
+    EXPECT_LE(tree.ExpectedMeasurement(sensor, 0, 0.0, 0.0, view),
+              tree.ExpectedMeasurement(sensor, tree.GetNumLevels()) + 1e-8);
+  }
+}
+
+} // namespace radiation
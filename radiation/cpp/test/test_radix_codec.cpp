@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for RadixCodec.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <radix_codec.h>
+#include <encoding.h>
+#include <context_2d.h>
+#include <movement_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+
+namespace radiation {
+
+namespace {
+// Check single and batch round trips against EncodeDigits/DecodeDigits, for
+// random digits in the given base.
+template <typename IdType>
+void CheckRoundTrip(unsigned int base, unsigned int num_digits,
+                    std::default_random_engine& rng) {
+  const size_t kNumIds = 37;
+  const RadixCodec<IdType> codec(base, num_digits);
+  std::uniform_int_distribution<unsigned int> unif(0, base - 1);
+
+  // Random digits in structure-of-arrays layout, with the largest id first.
+  std::vector<unsigned int> digits(num_digits * kNumIds);
+  for (size_t ii = 0; ii < digits.size(); ii++)
+    digits[ii] = (ii % kNumIds == 0) ? base - 1 : unif(rng);
+
+  std::vector<IdType> ids(kNumIds);
+  codec.EncodeBatch(digits.data(), kNumIds, ids.data());
+
+  for (size_t ii = 0; ii < kNumIds; ii++) {
+    std::vector<unsigned int> id_digits(num_digits);
+    for (unsigned int dd = 0; dd < num_digits; dd++)
+      id_digits[dd] = digits[dd * kNumIds + ii];
+
+    IdType expected_id = 0;
+    ASSERT_TRUE(EncodeDigits(id_digits, base, expected_id));
+    EXPECT_TRUE(ids[ii] == expected_id);
+    EXPECT_TRUE(codec.Encode(digits.data() + ii, kNumIds) == expected_id);
+
+    std::vector<unsigned int> decoded(num_digits);
+    codec.Decode(ids[ii], decoded.data());
+    EXPECT_EQ(decoded, id_digits);
+  }
+
+  std::vector<unsigned int> decoded(digits.size());
+  codec.DecodeBatch(ids.data(), kNumIds, decoded.data());
+  EXPECT_EQ(decoded, digits);
+}
+} // namespace
+
+// Test which (base, number of digits) pairs fit.
+TEST(RadixCodec, TestFits) {
+  EXPECT_TRUE(RadixCodec<unsigned int>::Fits(2, 32));
+  EXPECT_FALSE(RadixCodec<unsigned int>::Fits(2, 33));
+  EXPECT_TRUE(RadixCodec<unsigned int>::Fits(65536, 2));
+  EXPECT_FALSE(RadixCodec<unsigned int>::Fits(65537, 2));
+  EXPECT_TRUE(RadixCodec<Id64>::Fits(2, 64));
+  EXPECT_FALSE(RadixCodec<Id64>::Fits(2, 65));
+  EXPECT_TRUE(RadixCodec<Id64>::Fits(27, 13));
+  EXPECT_FALSE(RadixCodec<Id64>::Fits(27, 14));
+  EXPECT_TRUE(RadixCodec<Id128>::Fits(27, 26));
+  EXPECT_FALSE(RadixCodec<Id128>::Fits(27, 27));
+  EXPECT_TRUE(RadixCodec<Id64>::Fits(1, 1000));
+}
+
+// Test round trips over a range of bases, including ones that need several
+// 32-bit chunks per id.
+TEST(RadixCodec, TestRoundTrip) {
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+
+  CheckRoundTrip<unsigned int>(2, 32, rng);
+  CheckRoundTrip<unsigned int>(9, 10, rng);
+  CheckRoundTrip<unsigned int>(65536, 2, rng);
+  CheckRoundTrip<unsigned int>(1, 5, rng);
+  CheckRoundTrip<Id64>(2, 64, rng);
+  CheckRoundTrip<Id64>(27, 13, rng);
+  CheckRoundTrip<Id64>(100000, 3, rng);
+  CheckRoundTrip<Id64>(4294967295u, 2, rng);
+  CheckRoundTrip<Id128>(27, 26, rng);
+  CheckRoundTrip<Id128>(3, 80, rng);
+}
+
+// Test that batch trajectory decoding matches decoding one id at a time.
+TEST(RadixCodec, TestDecodeTrajectories) {
+  const unsigned int kNumRows = 10;
+  const unsigned int kNumCols = 10;
+  const unsigned int kNumSteps = 8;
+  const unsigned int kNumTrajectories = 20;
+
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(0.5 * M_PI);
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+
+  const GridPose2D initial_pose(context, kNumRows / 2, kNumCols / 2, 0.0);
+  std::vector<Id64> ids;
+  for (unsigned int ii = 0; ii < kNumTrajectories; ii++) {
+    GridPose2D current_pose = initial_pose;
+    std::vector<Movement2D> movements;
+    while (movements.size() < kNumSteps) {
+      const Movement2D step(context, rng);
+      if (current_pose.MoveBy(step))
+        movements.push_back(step);
+    }
+
+    Id64 id = 0;
+    ASSERT_TRUE(EncodeTrajectory(movements, context, id));
+    ids.push_back(id);
+  }
+
+  std::vector< std::vector<GridPose2D> > trajectories;
+  DecodeTrajectories(ids, kNumSteps, initial_pose, trajectories);
+  ASSERT_EQ(trajectories.size(), kNumTrajectories);
+
+  for (unsigned int ii = 0; ii < kNumTrajectories; ii++) {
+    std::vector<GridPose2D> expected;
+    DecodeTrajectory(ids[ii], kNumSteps, initial_pose, expected);
+    ASSERT_EQ(trajectories[ii].size(), kNumSteps);
+
+    for (unsigned int ss = 0; ss < kNumSteps; ss++) {
+      EXPECT_NEAR(trajectories[ii][ss].GetX(), expected[ss].GetX(), 1e-8);
+      EXPECT_NEAR(trajectories[ii][ss].GetY(), expected[ss].GetY(), 1e-8);
+      EXPECT_NEAR(trajectories[ii][ss].GetAngle(), expected[ss].GetAngle(),
+                  1e-8);
+    }
+  }
+}
+
+} // namespace radiation
@@ -42,6 +42,7 @@
 
 #include <sensor_2d.h>
 #include <source_2d.h>
+#include <context_2d.h>
 
 #include <gtest/gtest.h>
 #include <vector>
@@ -57,9 +58,8 @@ TEST(Sensor2D, TestDetectSources) {
   const unsigned int kNumCols = 10;
   const unsigned int kNumSources = 1000;
 
-  // Set static variables.
-  GridPose2D::SetNumRows(kNumRows);
-  GridPose2D::SetNumCols(kNumCols);
+  // Set up grid dimensions.
+  const Context2D context(kNumRows, kNumCols);
 
   // Make random number generators.
   std::random_device rd;
@@ -70,7 +70,7 @@ TEST(Sensor2D, TestDetectSources) {
 
   // Always place the sensor at the same pose.
   const double kAngle = 0.25 * M_PI;
-  const GridPose2D sensor_pose(0.0, 0.0, kAngle);
+  const GridPose2D sensor_pose(context, 0.0, 0.0, kAngle);
 
   // Generate a buch of random sources.
   std::vector<Source2D> sources;
@@ -98,4 +98,47 @@ TEST(Sensor2D, TestDetectSources) {
   EXPECT_EQ(sensor.Sense(sources), total_count);
 }
 
+// Test that rasterizing the field of view finds exactly the voxels in view.
+TEST(Sensor2D, TestVoxelsInView) {
+  const unsigned int kNumRows = 23;
+  const unsigned int kNumCols = 17;
+  const unsigned int kNumTrials = 1000;
+
+  // Make random number generators. Allow sensors outside the grid, and
+  // fields of view beyond pi and 2 pi.
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_real_distribution<double> unif_x(-5.0, kNumRows + 5.0);
+  std::uniform_real_distribution<double> unif_y(-5.0, kNumCols + 5.0);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+  std::uniform_real_distribution<double> unif_fov(0.0, 2.2 * M_PI);
+
+  for (unsigned int ii = 0; ii < kNumTrials; ii++) {
+    // Every few trials, place the sensor at a voxel center pointing along an
+    // axis, where the edges of the field of view pass through voxel centers.
+    const bool aligned = (ii % 4 == 0);
+    const double x = aligned ?
+      static_cast<double>(static_cast<unsigned int>(unif_x(rng) + 5.0) %
+                          kNumRows) + 0.5 : unif_x(rng);
+    const double y = aligned ?
+      static_cast<double>(static_cast<unsigned int>(unif_y(rng) + 5.0) %
+                          kNumCols) + 0.5 : unif_y(rng);
+    const double angle = aligned ?
+      0.25 * M_PI * static_cast<double>(ii % 8) : unif_angle(rng);
+    const double fov = aligned ?
+      0.5 * M_PI * static_cast<double>(ii % 5) : unif_fov(rng);
+    const Sensor2D sensor(x, y, angle, fov);
+
+    std::vector<unsigned int> expected;
+    for (unsigned int jj = 0; jj < kNumRows; jj++)
+      for (unsigned int kk = 0; kk < kNumCols; kk++)
+        if (sensor.VoxelInView(jj, kk))
+          expected.push_back(jj + kk * kNumRows);
+
+    std::vector<unsigned int> voxels;
+    sensor.VoxelsInView(kNumRows, kNumCols, voxels);
+    EXPECT_EQ(voxels, expected);
+  }
+}
+
 } // namespace radiation
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for TeamExplorerLP.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <team_explorer_lp.h>
+#include <context_2d.h>
+#include <grid_pose_2d.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Problem parameters shared by all tests.
+const unsigned int kNumRows = 8;
+const unsigned int kNumCols = 8;
+const unsigned int kNumSources = 1;
+const unsigned int kNumSteps = 2;
+const unsigned int kNumSamples = 2000;
+const unsigned int kNumCandidates = 10;
+const double kFov = 0.25 * M_PI;
+const double kEntropyThreshold = 1.0;
+const unsigned int kMaxIterations = 40;
+
+// Explore with a team of the given size until entropy falls below the
+// threshold, and return the number of steps taken.
+unsigned int StepsToConverge(const Context2D& context,
+                             unsigned int num_robots, unsigned int seed) {
+  TeamExplorerLP explorer(context, num_robots, kNumSources, 1.0, kNumSteps,
+                          kFov, kNumSamples, kNumCandidates, seed);
+
+  unsigned int num_iterations = 0;
+  while (explorer.Entropy() > kEntropyThreshold &&
+         num_iterations < kMaxIterations) {
+    std::vector< std::vector<GridPose2D> > trajectories;
+    EXPECT_TRUE(explorer.PlanAhead(trajectories));
+    EXPECT_EQ(trajectories.size(), num_robots);
+
+    explorer.TakeStep(trajectories);
+    num_iterations++;
+  }
+
+  return num_iterations;
+}
+} // namespace
+
+// Test that on seeded maps, a team of two robots (the first of which starts
+// where a lone robot would) localizes the source in no more steps in total
+// than one robot alone, and that both always converge. Any single map may
+// favor the lone robot by a step, so compare totals.
+TEST(TeamExplorerLP, TestConvergence) {
+  Context2D context(kNumRows, kNumCols);
+  context.SetAngularStep(0.25 * M_PI);
+
+  const unsigned int kSeeds[] = { 1, 2, 3, 4, 5 };
+  unsigned int total_solo_steps = 0;
+  unsigned int total_team_steps = 0;
+  for (const auto& seed : kSeeds) {
+    const unsigned int solo_steps = StepsToConverge(context, 1, seed);
+    const unsigned int team_steps = StepsToConverge(context, 2, seed);
+    EXPECT_LT(solo_steps, kMaxIterations);
+    EXPECT_LT(team_steps, kMaxIterations);
+
+    total_solo_steps += solo_steps;
+    total_team_steps += team_steps;
+  }
+
+  EXPECT_LE(total_team_steps, total_solo_steps);
+}
+
+} // namespace radiation
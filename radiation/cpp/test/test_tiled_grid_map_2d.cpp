@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for TiledGridMap2D.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <tiled_grid_map_2d.h>
+#include <grid_map_2d.h>
+#include <context_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+#include <trajectory_sampler.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Reference entropy of a dense belief matrix.
+double DenseEntropy(const Eigen::MatrixXd& belief) {
+  double entropy = 0.0;
+  for (int ii = 0; ii < belief.rows(); ii++) {
+    for (int jj = 0; jj < belief.cols(); jj++) {
+      const double p = belief(ii, jj);
+      if (p > 1e-8 && p < 1.0 - 1e-8)
+        entropy -= p * log(p) + (1.0 - p) * log(1.0 - p);
+    }
+  }
+
+  return entropy;
+}
+} // namespace
+
+// Test that an untouched tiled map matches a dense map.
+TEST(TiledGridMap2D, TestMatchesDense) {
+  const unsigned int kNumRows = 37;
+  const unsigned int kNumCols = 21;
+  const unsigned int kNumSources = 3;
+
+  const Context2D context(kNumRows, kNumCols);
+  const GridMap2D dense(context, kNumSources, 1.0);
+  const TiledGridMap2D tiled(context, kNumSources, 1.0);
+
+  EXPECT_EQ(tiled.GetNumTiles(), 0u);
+  EXPECT_NEAR(tiled.Entropy(), dense.Entropy(), 1e-8);
+
+  const Sensor2D sensor(GridPose2D(context, 0.0, 0.0, 0.25 * M_PI),
+                        0.3 * M_PI);
+  EXPECT_NEAR(tiled.ExpectedMeasurement(sensor),
+              dense.ExpectedMeasurement(sensor), 1e-8);
+
+  Eigen::MatrixXd belief;
+  tiled.GetBelief(belief);
+  EXPECT_NEAR((belief - dense.GetImmutableBelief()).norm(), 0.0, 1e-12);
+}
+
+// Test that only viewed tiles are allocated, and that cached sums and
+// entropies agree with the dense representation.
+TEST(TiledGridMap2D, TestAllocatesViewedTiles) {
+  const unsigned int kNumRows = 64;
+  const unsigned int kNumCols = 64;
+  const unsigned int kNumSources = 2;
+  const unsigned int kNumSamples = 100;
+
+  const Context2D context(kNumRows, kNumCols);
+  TiledGridMap2D map(context, kNumSources, 1.0);
+
+  // A narrow sensor looking along the bottom edge only sees one row of tiles.
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(40u, 1u));
+  sources.push_back(Source2D(50u, 50u));
+  const Sensor2D sensor(GridPose2D(context, 0.0, 0.5, 0.0), 0.01 * M_PI);
+  EXPECT_TRUE(map.Update(sensor, sources, false));
+
+  const unsigned int kNumTileRows = kNumRows / TiledGridMap2D::kTileSize;
+  EXPECT_GT(map.GetNumTiles(), 0u);
+  EXPECT_LE(map.GetNumTiles(), kNumTileRows);
+
+  Eigen::MatrixXd belief;
+  map.GetBelief(belief);
+  EXPECT_NEAR(map.Entropy(), DenseEntropy(belief), 1e-6);
+  double expected = 0.0;
+  for (unsigned int ii = 0; ii < kNumRows; ii++)
+    for (unsigned int jj = 0; jj < kNumCols; jj++)
+      if (sensor.VoxelInView(ii, jj))
+        expected += belief(ii, jj);
+  EXPECT_NEAR(map.ExpectedMeasurement(sensor), expected, 1e-8);
+
+  // Sampled sources always lie within bounds.
+  for (unsigned int ii = 0; ii < kNumSamples; ii++) {
+    std::vector<Source2D> sampled;
+    ASSERT_TRUE(map.GenerateSources(sampled));
+    ASSERT_EQ(sampled.size(), kNumSources);
+    for (const auto& source : sampled) {
+      EXPECT_LT(source.GetIndexX(), kNumRows);
+      EXPECT_LT(source.GetIndexY(), kNumCols);
+    }
+  }
+}
+
+// Test that growing the map keeps existing belief, spreads the prior over
+// the new voxels, and preserves the expected number of sources.
+TEST(TiledGridMap2D, TestGrow) {
+  const unsigned int kNumRows = 40;
+  const unsigned int kNumCols = 40;
+  const unsigned int kNumSources = 1;
+
+  const Context2D context(kNumRows, kNumCols);
+  TiledGridMap2D map(context, kNumSources, 1.0);
+
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(35u, 2u));
+
+  // Look along the diagonal, away from the source, so only some tiles are
+  // allocated and the background still holds some belief.
+  const Sensor2D sensor(GridPose2D(context, 0.0, 0.0, 0.25 * M_PI), 0.2 * M_PI);
+  EXPECT_TRUE(map.Update(sensor, sources, true));
+
+  const unsigned int num_tiles = map.GetNumTiles();
+  const double viewed = map.GetBelief(3, 3);
+  const double prior = map.GetPrior();
+
+  const Context2D grown(2 * kNumRows, kNumCols + 5);
+  map.Grow(grown);
+  EXPECT_EQ(&map.GetContext(), &grown);
+  EXPECT_EQ(map.GetNumRows(), 2 * kNumRows);
+  EXPECT_EQ(map.GetNumCols(), kNumCols + 5);
+  EXPECT_EQ(map.GetNumTiles(), num_tiles);
+  EXPECT_NEAR(map.GetBelief(3, 3), viewed, 1e-12);
+
+  // The prior shrinks, and voxels that came into bounds inside an allocated
+  // tile on the diagonal and outside of any tile both hold it.
+  EXPECT_GT(map.GetPrior(), 0.0);
+  EXPECT_LT(map.GetPrior(), prior);
+  EXPECT_NEAR(map.GetBelief(kNumRows, kNumCols - 5), map.GetPrior(), 1e-12);
+  EXPECT_NEAR(map.GetBelief(2 * kNumRows - 1, kNumCols + 4),
+              map.GetPrior(), 1e-12);
+
+  // Expected number of sources is unchanged, and cached entropy still
+  // matches the dense belief.
+  Eigen::MatrixXd belief;
+  map.GetBelief(belief);
+  EXPECT_NEAR(belief.sum(), kNumSources, 1e-9);
+  EXPECT_NEAR(map.Entropy(), DenseEntropy(belief), 1e-6);
+
+  // Growing again, and updating afterwards, keeps the total in check.
+  const Context2D grown_again(2 * kNumRows + 3, 2 * kNumCols);
+  map.Grow(grown_again);
+  map.GetBelief(belief);
+  EXPECT_NEAR(belief.sum(), kNumSources, 1e-9);
+
+  const Sensor2D far_sensor(GridPose2D(grown_again, 30.0, 30.0, 0.0), 0.2 * M_PI);
+  EXPECT_TRUE(map.Update(far_sensor, sources, true));
+  map.GetBelief(belief);
+  EXPECT_NEAR(belief.sum(), kNumSources, 0.1);
+}
+
+// Test that we can detect a source randomly located across the grid.
+TEST(TiledGridMap2D, TestConvergenceSingleSource) {
+  const unsigned int kNumRows = 5;
+  const unsigned int kNumCols = 5;
+  const unsigned int kNumSources = 1;
+  const double kRegularizer = 1.0;
+  const unsigned int kNumUpdates = 100;
+
+  const Context2D context(kNumRows, kNumCols);
+
+  // Make random number generators.
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_int_distribution<unsigned int> unif_rows(0, kNumRows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, kNumCols - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  // Choose a random source location.
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(unif_rows(rng), unif_cols(rng)));
+
+  // Update from random sensor poses.
+  TiledGridMap2D map(context, kNumSources, kRegularizer);
+  const double kFov = 0.2 * M_PI;
+  for (unsigned int ii = 0; ii < kNumUpdates; ii++) {
+    const GridPose2D pose(context, unif_rows(rng), unif_cols(rng),
+                          unif_angle(rng));
+    EXPECT_TRUE(map.Update(Sensor2D(pose, kFov), sources, true));
+  }
+
+  // Check that belief has converged to the truth.
+  for (unsigned int ii = 0; ii < kNumRows; ii++) {
+    for (unsigned int jj = 0; jj < kNumCols; jj++) {
+      if (sources[0].GetIndexX() == ii && sources[0].GetIndexY() == jj)
+        EXPECT_GE(map.GetBelief(ii, jj), 1.0 - 1e-4);
+      else
+        EXPECT_LE(map.GetBelief(ii, jj), 1e-4);
+    }
+  }
+}
+
+// Test that a wall hides the voxels behind it: sensing matches the dense
+// map, and no tile behind the wall is allocated or learned about.
+TEST(TiledGridMap2D, TestOcclusion) {
+  const unsigned int kNumRows = 40;
+  const unsigned int kNumCols = 40;
+  const unsigned int kNumSources = 1;
+  const unsigned int kWall = 8;
+
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int jj = 0; jj < kNumCols; jj++)
+    context.SetObstacle(kWall, jj);
+
+  GridMap2D dense(context, kNumSources, 1.0);
+  TiledGridMap2D tiled(context, kNumSources, 1.0);
+
+  // The source sits right in front of the sensor, but behind the wall.
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(20u, 4u));
+  const Sensor2D sensor(GridPose2D(context, 2.5, 4.5, 0.0), 0.2 * M_PI);
+  EXPECT_EQ(tiled.Sense(sensor, sources), 0u);
+  EXPECT_EQ(tiled.Sense(sensor, sources), dense.Sense(sensor, sources));
+  EXPECT_NEAR(tiled.ExpectedMeasurement(sensor),
+              dense.ExpectedMeasurement(sensor), 1e-8);
+
+  const double prior = tiled.GetPrior();
+  EXPECT_TRUE(tiled.Update(sensor, sources, true));
+  EXPECT_EQ(tiled.GetNumTiles(), 1u);
+  EXPECT_LT(tiled.GetBelief(4, 4), prior);
+  EXPECT_NEAR(tiled.GetBelief(20, 4), tiled.GetPrior(), 1e-12);
+}
+
+// Test that the shared planner runs on a tiled map with obstacles, and keeps
+// the trajectory in bounds and off the obstacles.
+TEST(TiledGridMap2D, TestPlanTrajectory) {
+  const unsigned int kNumRows = 20;
+  const unsigned int kNumCols = 20;
+  const unsigned int kNumSources = 1;
+  const unsigned int kNumSteps = 3;
+  const unsigned int kNumSamples = 200;
+
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int ii = 5; ii < 15; ii++)
+    context.SetObstacle(ii, 12);
+
+  TiledGridMap2D map(context, kNumSources, 1.0);
+  map.Seed(0);
+
+  const GridPose2D pose(context, 10.5, 10.5, 0.0);
+  std::vector<GridPose2D> trajectory;
+  ASSERT_TRUE(PlanTrajectory(map, kNumSamples, kNumSteps, pose,
+                             0.25 * M_PI, trajectory));
+  ASSERT_EQ(trajectory.size(), kNumSteps);
+  for (const auto& step : trajectory) {
+    ASSERT_LT(step.GetIndexX(), kNumRows);
+    ASSERT_LT(step.GetIndexY(), kNumCols);
+    EXPECT_FALSE(context.IsObstacle(step.GetIndexX(), step.GetIndexY()));
+  }
+}
+
+} // namespace radiation
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for tracing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <trace.h>
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace radiation {
+
+namespace {
+// Count occurrences of a substring.
+size_t Count(const std::string& text, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + 1))
+    count++;
+
+  return count;
+}
+} // namespace
+
+// Events from several threads should all be written, with proper nesting.
+TEST(Trace, TestWriteTrace) {
+  ClearTrace();
+  {
+    const ScopedTrace outer("outer");
+    const ScopedTrace inner("inner \"quoted\"");
+  }
+
+  std::thread worker([]() { const ScopedTrace event("worker"); });
+  worker.join();
+
+  char path[] = "/tmp/test_trace_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  ASSERT_TRUE(WriteTrace(path));
+
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string json = contents.str();
+  unlink(path);
+
+  EXPECT_EQ(json.find("{\"displayTimeUnit\""), 0);
+  EXPECT_EQ(Count(json, "\"ph\":\"X\""), 3);
+  EXPECT_EQ(Count(json, "\"name\":\"outer\""), 1);
+  EXPECT_EQ(Count(json, "\"name\":\"inner \\\"quoted\\\"\""), 1);
+  EXPECT_EQ(Count(json, "\"name\":\"worker\""), 1);
+
+  // Cleared traces are empty.
+  ClearTrace();
+  ASSERT_TRUE(WriteTrace(path));
+  std::ifstream empty_file(path);
+  std::stringstream empty_contents;
+  empty_contents << empty_file.rdbuf();
+  EXPECT_EQ(Count(empty_contents.str(), "\"ph\""), 0);
+  unlink(path);
+}
+
+// Buffers of exited threads should be reused, so many short-lived threads
+// only ever need as many buffers as run at once, and keep all their events.
+TEST(Trace, TestReuseBuffers) {
+  const unsigned int kNumBatches = 32;
+  const unsigned int kNumThreadsPerBatch = 4;
+
+  ClearTrace();
+  const size_t num_buffers = GetNumTraceBuffers();
+  for (unsigned int ii = 0; ii < kNumBatches; ii++) {
+    std::vector<std::thread> workers;
+    for (unsigned int jj = 0; jj < kNumThreadsPerBatch; jj++)
+      workers.push_back(std::thread([]() { const ScopedTrace event("w"); }));
+    for (auto& worker : workers)
+      worker.join();
+  }
+
+  EXPECT_LE(GetNumTraceBuffers(), num_buffers + kNumThreadsPerBatch);
+
+  char path[] = "/tmp/test_trace_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  ASSERT_TRUE(WriteTrace(path));
+
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  unlink(path);
+  EXPECT_EQ(Count(contents.str(), "\"name\":\"w\""),
+            kNumBatches * kNumThreadsPerBatch);
+  ClearTrace();
+}
+
+} // namespace radiation
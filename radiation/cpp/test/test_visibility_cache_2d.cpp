@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2015, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Author: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Unit tests for obstacles, line of sight, and VisibilityCache2D.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <visibility_cache_2d.h>
+#include <context_2d.h>
+#include <grid_map_2d.h>
+#include <sensor_2d.h>
+#include <source_2d.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace radiation {
+
+namespace {
+// Reference line of sight, by stepping finely along the segment. Samples
+// are offset so that they never land exactly on a voxel corner, which the
+// segment only touches.
+bool SampledLineOfSight(const Context2D& context, double x, double y,
+                        unsigned int ii, unsigned int jj) {
+  const unsigned int kNumSteps = 10000;
+  const double kOffset = 0.318;
+  const double dx = static_cast<double>(ii) + 0.5 - x;
+  const double dy = static_cast<double>(jj) + 0.5 - y;
+
+  for (unsigned int step = 0; step < kNumSteps; step++) {
+    const double t = (static_cast<double>(step) + kOffset) / kNumSteps;
+    const double px = x + t * dx;
+    const double py = y + t * dy;
+    if (px < 0.0 || py < 0.0 ||
+        px >= context.GetNumRows() || py >= context.GetNumCols())
+      continue;
+
+    const unsigned int cx = static_cast<unsigned int>(px);
+    const unsigned int cy = static_cast<unsigned int>(py);
+    if ((cx == ii && cy == jj) ||
+        (cx == static_cast<unsigned int>(x) &&
+         cy == static_cast<unsigned int>(y)))
+      continue;
+
+    if (context.IsObstacle(cx, cy))
+      return false;
+  }
+
+  return true;
+}
+} // namespace
+
+// Test that a wall blocks line of sight, and nothing else does.
+TEST(VisibilityCache2D, TestLineOfSight) {
+  const unsigned int kNumRows = 10;
+  const unsigned int kNumCols = 10;
+  Context2D context(kNumRows, kNumCols);
+  EXPECT_FALSE(context.HasObstacles());
+  EXPECT_TRUE(context.LineOfSight(0.5, 0.5, 9, 9));
+
+  // A wall across row 5, with a gap at column 9.
+  for (unsigned int jj = 0; jj < kNumCols - 1; jj++)
+    context.SetObstacle(5, jj);
+  EXPECT_TRUE(context.HasObstacles());
+
+  EXPECT_FALSE(context.LineOfSight(0.5, 0.5, 9, 0));
+  EXPECT_FALSE(context.LineOfSight(2.5, 4.5, 7, 4));
+  EXPECT_TRUE(context.LineOfSight(0.5, 0.5, 4, 8));
+  EXPECT_TRUE(context.LineOfSight(4.5, 9.5, 6, 9));
+
+  // The wall itself is visible.
+  EXPECT_TRUE(context.LineOfSight(0.5, 0.5, 5, 0));
+
+  // Removing obstacles restores visibility.
+  for (unsigned int jj = 0; jj < kNumCols - 1; jj++)
+    context.SetObstacle(5, jj, false);
+  EXPECT_FALSE(context.HasObstacles());
+  EXPECT_TRUE(context.LineOfSight(0.5, 0.5, 9, 0));
+}
+
+// Test that cached visible sets and sensing match a brute-force reference.
+TEST(VisibilityCache2D, TestVisibleVoxels) {
+  const unsigned int kNumRows = 15;
+  const unsigned int kNumCols = 12;
+  const unsigned int kNumObstacles = 20;
+  const unsigned int kNumTrials = 50;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_int_distribution<unsigned int> unif_rows(0, kNumRows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, kNumCols - 1);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+  std::uniform_real_distribution<double> unif_fov(0.0, 2.0 * M_PI);
+
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumObstacles; ii++)
+    context.SetObstacle(unif_rows(rng), unif_cols(rng));
+
+  VisibilityCache2D cache(context);
+  for (unsigned int trial = 0; trial < kNumTrials; trial++) {
+    const GridPose2D pose(context, unif_rows(rng), unif_cols(rng),
+                          unif_angle(rng));
+    const Sensor2D sensor(pose, unif_fov(rng));
+
+    std::vector<unsigned int> expected;
+    for (unsigned int ii = 0; ii < kNumRows; ii++)
+      for (unsigned int jj = 0; jj < kNumCols; jj++)
+        if (sensor.VoxelInView(ii, jj) &&
+            SampledLineOfSight(context, pose.GetX(), pose.GetY(), ii, jj))
+          expected.push_back(ii + jj * kNumRows);
+
+    // Compare as sets, since cached sets come back sorted.
+    std::vector<unsigned int> computed, cached;
+    cache.ComputeVisibleVoxels(sensor, computed);
+    cache.VisibleVoxels(sensor, cached);
+    std::sort(expected.begin(), expected.end());
+    std::sort(computed.begin(), computed.end());
+    std::sort(cached.begin(), cached.end());
+    EXPECT_EQ(computed, expected);
+    EXPECT_EQ(cached, expected);
+
+    // Sensing counts exactly the visible sources.
+    std::vector<Source2D> sources;
+    unsigned int num_visible = 0;
+    for (unsigned int ii = 0; ii < 5; ii++) {
+      sources.push_back(Source2D(unif_rows(rng), unif_cols(rng)));
+      const unsigned int voxel = sources.back().GetIndexX() +
+        sources.back().GetIndexY() * kNumRows;
+      if (std::binary_search(expected.begin(), expected.end(), voxel))
+        num_visible++;
+    }
+
+    EXPECT_EQ(cache.Sense(sensor, sources), num_visible);
+  }
+
+  EXPECT_GT(cache.GetNumCached(), 0u);
+  EXPECT_LE(cache.GetNumCached(), kNumTrials);
+  cache.Clear();
+  EXPECT_EQ(cache.GetNumCached(), 0u);
+}
+
+// Test that the cache is keyed on cell, bounded, and shared by copies and
+// snapshots, and that sensors off a voxel center bypass it.
+TEST(VisibilityCache2D, TestBoundedShared) {
+  const unsigned int kNumRows = 8;
+  const unsigned int kNumCols = 8;
+  const unsigned int kMaxCached = 2;
+
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int jj = 2; jj < kNumCols; jj++)
+    context.SetObstacle(4, jj);
+
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(6u, 6u));
+  sources.push_back(Source2D(6u, 1u));
+  sources.push_back(Source2D(2u, 6u));
+
+  VisibilityCache2D cache(context, kMaxCached);
+  const VisibilityCache2D copy(cache);
+
+  // Only the source in front of the wall is visible, and any heading from
+  // the same cell shares one entry.
+  const Sensor2D omni(GridPose2D(context, 1u, 5u, 0.0), 2.5 * M_PI);
+  const Sensor2D narrow(GridPose2D(context, 1u, 5u, M_PI), 0.5 * M_PI);
+  EXPECT_EQ(cache.Sense(omni, sources), 1u);
+  EXPECT_EQ(cache.Sense(narrow, sources), 0u);
+  EXPECT_EQ(copy.GetNumCached(), 1u);
+
+  // Off-center sensors agree with a direct ray cast, and are not cached.
+  const Sensor2D corner(1.0, 5.0, 0.0, 2.5 * M_PI);
+  std::vector<unsigned int> cached, computed;
+  cache.VisibleVoxels(corner, cached);
+  cache.ComputeVisibleVoxels(corner, computed);
+  EXPECT_EQ(cached, computed);
+  EXPECT_EQ(cache.GetNumCached(), 1u);
+
+  // The oldest cell is evicted once the cache is full.
+  for (unsigned int ii = 0; ii < 4; ii++) {
+    const Sensor2D sensor(GridPose2D(context, ii, 0u, 0.0), 2.5 * M_PI);
+    cache.VisibleVoxels(sensor, cached);
+    cache.ComputeVisibleVoxels(sensor, computed);
+    EXPECT_EQ(cached, computed);
+    EXPECT_LE(cache.GetNumCached(), kMaxCached);
+  }
+
+  EXPECT_EQ(copy.GetNumCached(), kMaxCached);
+  EXPECT_EQ(cache.Sense(omni, sources), 1u);
+
+  // Snapshots of a map share its cache.
+  GridMap2D map(context, 1, 1.0);
+  GridMap2D snapshot(context, map.GetImmutableBelief(), 1, 1.0,
+                     map.GetVisibility());
+  EXPECT_EQ(snapshot.Sense(omni, sources), 1u);
+  EXPECT_EQ(map.GetVisibility().GetNumCached(), 1u);
+}
+
+// Test that each copy keeps its own bounded views, and that sensing through
+// them matches a brute-force reference, including off-center sensors.
+TEST(VisibilityCache2D, TestViews) {
+  const unsigned int kNumRows = 12;
+  const unsigned int kNumCols = 10;
+  const unsigned int kNumObstacles = 15;
+  const unsigned int kNumTrials = 40;
+  const unsigned int kMaxViews = 8;
+
+  std::random_device rd;
+  std::default_random_engine rng(rd());
+  std::uniform_int_distribution<unsigned int> unif_rows(0, kNumRows - 1);
+  std::uniform_int_distribution<unsigned int> unif_cols(0, kNumCols - 1);
+  std::uniform_real_distribution<double> unif_x(0.0, kNumRows);
+  std::uniform_real_distribution<double> unif_y(0.0, kNumCols);
+  std::uniform_real_distribution<double> unif_angle(0.0, 2.0 * M_PI);
+
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int ii = 0; ii < kNumObstacles; ii++)
+    context.SetObstacle(unif_rows(rng), unif_cols(rng));
+
+  VisibilityCache2D cache(context, 1024, kMaxViews);
+  for (unsigned int trial = 0; trial < kNumTrials; trial++) {
+    const Sensor2D sensor(unif_x(rng), unif_y(rng), unif_angle(rng),
+                          0.5 * M_PI);
+
+    std::vector<Source2D> sources;
+    unsigned int num_visible = 0;
+    for (unsigned int ii = 0; ii < 6; ii++) {
+      sources.push_back(Source2D(unif_rows(rng), unif_cols(rng)));
+      const Source2D& source = sources.back();
+      if (sensor.SourceInView(source) &&
+          SampledLineOfSight(context, sensor.GetX(), sensor.GetY(),
+                             source.GetIndexX(), source.GetIndexY()))
+        num_visible++;
+    }
+
+    // Sensing twice from the same pose reuses one view.
+    EXPECT_EQ(cache.Sense(sensor, sources), num_visible);
+    const unsigned int num_views = cache.GetNumViews();
+    EXPECT_EQ(cache.Sense(sensor, cache.GetView(sensor), sources),
+              num_visible);
+    EXPECT_EQ(cache.GetNumViews(), num_views);
+    EXPECT_LE(num_views, kMaxViews);
+  }
+
+  // Copies share cells but not views, and there are no views without
+  // obstacles.
+  const VisibilityCache2D copy(cache);
+  EXPECT_EQ(copy.GetNumViews(), 0u);
+  EXPECT_EQ(copy.GetNumCached(), cache.GetNumCached());
+
+  const Context2D open(kNumRows, kNumCols);
+  VisibilityCache2D open_cache(open);
+  EXPECT_TRUE(open_cache.GetView(Sensor2D(1.5, 1.5, 0.0, M_PI)) == nullptr);
+}
+
+// Test that a map behind a wall learns nothing about what lies beyond it.
+TEST(VisibilityCache2D, TestOccludedUpdate) {
+  const unsigned int kNumRows = 6;
+  const unsigned int kNumCols = 3;
+  const unsigned int kNumSources = 1;
+
+  // Wall across row 3.
+  Context2D context(kNumRows, kNumCols);
+  for (unsigned int jj = 0; jj < kNumCols; jj++)
+    context.SetObstacle(3, jj);
+
+  // A source behind the wall is not seen by an omnidirectional sensor.
+  std::vector<Source2D> sources;
+  sources.push_back(Source2D(5u, 1u));
+  const Sensor2D sensor(GridPose2D(context, 1u, 1u, 0.0), 2.5 * M_PI);
+
+  GridMap2D map(context, kNumSources, 1.0);
+  EXPECT_NEAR(map.ExpectedMeasurement(sensor),
+              map.GetImmutableBelief().topRows(4).sum(), 1e-12);
+  EXPECT_TRUE(map.Update(sensor, sources, true));
+
+  // Everything up to and including the wall was seen to be empty, so the
+  // regularizer pushes all the mass beyond the wall.
+  const Eigen::MatrixXd& belief = map.GetImmutableBelief();
+  EXPECT_NEAR(belief.topRows(4).sum(), 0.0, 1e-4);
+  EXPECT_NEAR(belief.bottomRows(2).sum(),
+              static_cast<double>(kNumSources), 1e-4);
+
+  // Poses may not move into the wall.
+  GridPose2D pose(context, 2u, 1u, 0.0);
+  EXPECT_FALSE(pose.MoveBy(Movement2D(context, 2, 1, 1)));
+  EXPECT_TRUE(pose.MoveBy(Movement2D(context, 0, 1, 1)));
+}
+
+} // namespace radiation
@@ -0,0 +1,140 @@
+"""
+Copyright (c) 2015, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+   3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+Please contact the author(s) of this library if you have any questions.
+Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+"""
+
+###########################################################################
+#
+# Read and write the binary columnar format defined in
+# cpp/include/columnar_file.h. Columns are loaded as read-only np.memmap
+# arrays of shape (rows, width), so nothing is read until it is used.
+#
+###########################################################################
+
+import numpy as np
+import struct
+
+kMagic = b"RADCOL01"
+kVersion = 1
+kHeaderSize = 64
+kDescriptorSize = 64
+kAlignment = 64
+
+# Element type codes, as in ColumnType.
+kTypes = {1 : "<u1", 2 : "<u2", 3 : "<u4", 4 : "<u8",
+          5 : "<i4", 6 : "<i8", 7 : "<f4", 8 : "<f8"}
+kCodes = dict((np.dtype(v), k) for k, v in kTypes.items())
+
+# Round up to the next multiple of kAlignment.
+def Align(offset):
+    return (offset + kAlignment - 1) // kAlignment * kAlignment
+
+# Load a file. Returns a dictionary of columns and a dictionary of
+# (string) parameters.
+def Load(path):
+    with open(path, "rb") as f:
+        header = f.read(kHeaderSize)
+        if len(header) < kHeaderSize or header[:8] != kMagic:
+            raise IOError("%s is not a columnar file." % path)
+
+        version, num_columns, params_offset, params_size = \
+            struct.unpack("<IIQQ", header[8:32])
+        if version != kVersion:
+            raise IOError("%s has unsupported version %d." % (path, version))
+
+        descriptors = f.read(kDescriptorSize * num_columns)
+        f.seek(params_offset)
+        params_text = f.read(params_size).decode("utf-8")
+
+    params = {}
+    for line in params_text.splitlines():
+        if "=" in line:
+            key, value = line.split("=", 1)
+            params[key] = value
+
+    columns = {}
+    for ii in range(num_columns):
+        descriptor = descriptors[ii * kDescriptorSize :
+                                 (ii + 1) * kDescriptorSize]
+        name = descriptor[:32].split(b"\0", 1)[0].decode("utf-8")
+        code, _, rows, width, offset = struct.unpack("<IIQQQ",
+                                                     descriptor[32:])
+        dtype = np.dtype(kTypes[code])
+
+        # np.memmap cannot map empty arrays.
+        if rows * width == 0:
+            columns[name] = np.zeros((rows, width), dtype=dtype)
+        else:
+            columns[name] = np.memmap(path, dtype=dtype, mode="r",
+                                      offset=offset, shape=(rows, width))
+
+    return columns, params
+
+# Save a dictionary of 1D or 2D arrays and a dictionary of parameters.
+def Save(path, columns, params={}):
+    names = sorted(columns.keys())
+    arrays = []
+    for name in names:
+        array = np.asarray(columns[name])
+        if array.ndim == 1:
+            array = array.reshape(-1, 1)
+        assert array.ndim == 2
+        assert len(name.encode("utf-8")) < 32
+        array = np.ascontiguousarray(array,
+                                     dtype=array.dtype.newbyteorder("<"))
+        arrays.append(array)
+
+    params_text = "".join("%s=%s\n" % (k, params[k])
+                          for k in sorted(params.keys())).encode("utf-8")
+    params_offset = kHeaderSize + kDescriptorSize * len(names)
+
+    offsets = []
+    offset = Align(params_offset + len(params_text))
+    for array in arrays:
+        offsets.append(offset)
+        offset = Align(offset + array.nbytes)
+
+    with open(path, "wb") as f:
+        f.write(struct.pack("<8sIIQQ", kMagic, kVersion, len(names),
+                            params_offset, len(params_text)).ljust(
+                                kHeaderSize, b"\0"))
+        for name, array, offset in zip(names, arrays, offsets):
+            f.write(name.encode("utf-8").ljust(32, b"\0"))
+            f.write(struct.pack("<IIQQQ", kCodes[array.dtype], 0,
+                                array.shape[0], array.shape[1], offset))
+        f.write(params_text)
+
+        for array, offset in zip(arrays, offsets):
+            f.write(b"\0" * (offset - f.tell()))
+            f.write(array.tobytes())
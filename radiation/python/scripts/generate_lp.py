@@ -42,13 +42,17 @@ Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
 
 from problem import Problem
 from grid_pose_2d import GridPose2D
+import columnar
 
 import numpy as np
+import hashlib
 import math
+import os
 
 # Files to save to.
 pzx_file = "pzx_5x5_1000.csv"
 hzm_file = "hmz_5x5_1000.csv"
+cache_directory = "lp_cache"
 
 # Define hyperparameters.
 kNumSamples = 1000
@@ -66,9 +70,37 @@ kSensorParams = {"x" : kNumRows/2,
 problem = Problem(kNumRows, kNumCols, kNumSources, kNumSteps,
                   kAngularStep, kSensorParams, kNumSamples)
 
-# Generate conditionals from the specified pose.
+# Generate conditionals from the specified pose, unless they are already
+# cached. Cache entries are columnar files keyed by a hash of everything
+# that determines the conditionals, and are renamed into place once
+# complete so concurrent runs never see partial entries.
 pose = GridPose2D(kNumRows, kNumCols, kNumRows/2, kNumCols/2, 0.0)
-(pzx, hzm, trajectory_ids) = problem.GenerateConditionals(pose)
+params = {"num_samples" : kNumSamples, "num_rows" : kNumRows,
+          "num_cols" : kNumCols, "num_sources" : kNumSources,
+          "num_steps" : kNumSteps, "angular_step" : repr(kAngularStep),
+          "sensor" : repr(sorted(kSensorParams.items())),
+          "pose" : repr((pose.x_, pose.y_, pose.angle_))}
+key = hashlib.sha1(repr(sorted(params.items())).encode("utf-8"))
+cache_file = os.path.join(cache_directory, key.hexdigest()[:16] + ".rcol")
+
+if os.path.exists(cache_file):
+    print "Loading conditionals from " + cache_file + "."
+    columns, _ = columnar.Load(cache_file)
+    pzx = np.array(columns["pzx"])
+    hzm = np.array(columns["hzm"])
+    trajectory_ids = np.array(columns["trajectory_ids"][:, 0], dtype=int)
+else:
+    (pzx, hzm, trajectory_ids) = problem.GenerateConditionals(pose)
+
+    if not os.path.isdir(cache_directory):
+        os.makedirs(cache_directory)
+    temporary_file = cache_file + ".tmp.%d" % os.getpid()
+    columnar.Save(temporary_file,
+                  {"pzx" : pzx, "hzm" : hzm,
+                   "trajectory_ids" : np.array(trajectory_ids,
+                                               dtype=np.uint64)},
+                  params)
+    os.rename(temporary_file, cache_file)
 
 print "P_{Z|X} shape: " + str(pzx.shape)
 print "h_{M|Z} shape: " + str(hzm.shape)
@@ -45,6 +45,7 @@ from grid_pose_2d import GridPose2D
 from source_2d import Source2D
 from sensor_2d import Sensor2D
 from encoding import *
+import columnar
 
 import numpy as np
 import math
@@ -53,6 +54,7 @@ import math
 maps_file = "maps.csv"
 trajectories_file = "trajectories.csv"
 measurements_file = "measurements.csv"
+dataset_file = "random_walks.rcol"
 
 # Define hyperparameters.
 kNumSimulations = 100000
@@ -114,4 +116,12 @@ for ii in range(kNumSimulations):
 np.savetxt(maps_file, maps, delimiter=",")
 np.savetxt(trajectories_file, trajectories, delimiter=",")
 np.savetxt(measurements_file, measurements, delimiter=",")
+columnar.Save(dataset_file,
+              {"maps" : maps.astype(np.uint64),
+               "trajectories" : trajectories.astype(np.uint32),
+               "measurements" : measurements.astype(np.uint32)},
+              {"num_simulations" : kNumSimulations, "num_rows" : kNumRows,
+               "num_cols" : kNumCols, "num_sources" : kNumSources,
+               "num_steps" : kNumSteps, "num_angles" : kNumAngles,
+               "fov" : kSensorParams["fov"]})
 print "Successfully saved to disk."
@@ -0,0 +1,81 @@
+"""
+Copyright (c) 2015, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+   3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+Please contact the author(s) of this library if you have any questions.
+Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+"""
+
+
+###########################################################################
+#
+# Run ExplorerLP using the C++ library. Build it with -DBUILD_PYTHON=ON,
+# which puts the radiation_cpp module in this package's directory.
+#
+###########################################################################
+
+import numpy as np
+import math
+
+from radiation_cpp import Context2D, ExplorerLP
+
+# Create a grid map with only a couple sources.
+kNumRows = 5
+kNumCols = 5
+kNumSources = 2
+kNumSteps = 3
+kNumSamples = 10000
+kRegularizer = 1.0
+kSeed = 0
+
+# Set up sensor parameters.
+kAngularStep = 0.4 * math.pi
+kFieldOfView = 0.3 * math.pi
+
+# Create an explorer.
+context = Context2D(kNumRows, kNumCols)
+context.SetAngularStep(kAngularStep)
+explorer = ExplorerLP(context, kNumSources, kRegularizer, kNumSteps,
+                      kFieldOfView, kNumSamples, kSeed)
+
+# For the specified number of iterations, plan ahead and update.
+kNumIterations = 10
+entropy = explorer.Entropy()
+for ii in range(kNumIterations):
+    trajectory = explorer.PlanAhead()
+    entropy = explorer.TakeStep(trajectory)
+
+    # The belief is a read-only view into the C++ map, so this is free.
+    belief = explorer.GetMap().GetBelief()
+    print("Step %d: entropy = %f, max belief = %f" %
+          (ii, entropy, np.max(belief)))
+
+print("Final entropy = %f" % entropy)
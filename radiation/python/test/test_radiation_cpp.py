@@ -0,0 +1,114 @@
+"""
+Copyright (c) 2015, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+   3. Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+Please contact the author(s) of this library if you have any questions.
+Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+"""
+
+###########################################################################
+#
+# Smoke test for the 'radiation_cpp' extension module, built from
+# cpp/bindings/ when BUILD_PYTHON is enabled. Skipped if it is not built.
+#
+###########################################################################
+
+import numpy as np
+import math
+from unittest import SkipTest
+
+try:
+    import radiation_cpp
+except ImportError:
+    radiation_cpp = None
+
+""" Test that we can construct an explorer, plan, and take one step. """
+def test_explorer_lp_step():
+    if radiation_cpp is None:
+        raise SkipTest("radiation_cpp is not built.")
+
+    kNrows = 10
+    kNcols = 10
+    kNsources = 1
+    kAlpha = 1.0
+    kNsteps = 1
+    kFov = 0.25 * math.pi
+    kNsamples = 10
+    kSeed = 1
+
+    context = radiation_cpp.Context2D(kNrows, kNcols)
+    context.SetAngularStep(0.25 * math.pi)
+    explorer = radiation_cpp.ExplorerLP(context, kNsources, kAlpha, kNsteps,
+                                        kFov, kNsamples, kSeed)
+    assert len(explorer.GetSources()) == kNsources
+
+    # The initial belief is a read-only view summing to the number of sources.
+    belief = explorer.GetMap().GetBelief()
+    assert belief.shape == (kNrows, kNcols)
+    assert abs(belief.sum() - kNsources) < 1e-8
+
+    trajectory = explorer.PlanAhead()
+    assert len(trajectory) == kNsteps
+
+    entropy = explorer.TakeStep(trajectory)
+    assert np.isfinite(entropy)
+    assert abs(entropy - explorer.Entropy()) < 1e-8
+
+    pose = explorer.GetPose()
+    assert pose.GetIndexX() == trajectory[0].GetIndexX()
+    assert pose.GetIndexY() == trajectory[0].GetIndexY()
+
+""" Test that sample histograms come back as column-major count arrays. """
+def test_sample_histogram():
+    if radiation_cpp is None:
+        raise SkipTest("radiation_cpp is not built.")
+
+    kNrows = 10
+    kNcols = 10
+    kNsources = 1
+    kAlpha = 1.0
+    kNsteps = 2
+    kFov = 0.25 * math.pi
+    kNsamples = 100
+
+    context = radiation_cpp.Context2D(kNrows, kNcols)
+    context.SetAngularStep(0.25 * math.pi)
+    grid = radiation_cpp.GridMap2D(context, kNsources, kAlpha)
+    pose = radiation_cpp.GridPose2D(context, 5.5, 5.5, 0.0)
+
+    histogram, trajectory_ids = grid.SampleHistogram(kNsamples, kNsteps,
+                                                     pose, kFov)
+    assert histogram.shape[1] == len(trajectory_ids)
+    assert histogram.flags["F_CONTIGUOUS"]
+
+    # Each sample is counted at most once, under the trajectory it followed.
+    assert np.all(histogram.sum(axis=0) >= 1)
+    assert histogram.sum() <= kNsamples